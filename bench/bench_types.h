@@ -0,0 +1,27 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* The firmware headers use kernel-style types; define them for userspace benchmarks and tests */
+
+#ifndef BENCH_TYPES_H
+#define BENCH_TYPES_H
+
+#include <stdint.h>
+
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+typedef int8_t s8;
+typedef int16_t s16;
+typedef int32_t s32;
+typedef int64_t s64;
+
+#ifndef BIT
+#define BIT(nr)  (1UL << (nr))
+#endif
+#ifndef __packed
+#define __packed __attribute__((packed))
+#endif
+
+#endif /* BENCH_TYPES_H */
@@ -0,0 +1,158 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* Benchmark of cuc_pkt encode and decode for every CUC_CMD_*.
+ *
+ * encode builds the request packet with cuc_xport_req_init(). dispatch submits the
+ * request to a cuc_xport whose send does nothing, hands the response to
+ * cuc_xport_dispatch() and reaps the status with cuc_xport_wait(), so it times the
+ * transport's own matching and decoding plus its queue bookkeeping. The responses
+ * come from the simulated uC, which is timed as well ("uc_handle"); commands that
+ * need uC state, such as an update in progress for FIRMWARE_UPDATE_DOWNLOAD or an
+ * EEPROM at 0x50 for the I2C commands, get it before they are timed. Results are
+ * printed one JSON object per line.
+ *
+ * cc -O2 -Ilib/casuc -Ilib/craypldm -include bench/bench_types.h \
+ *    bench/codec_bench.c -o codec_bench
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "cuc_sim.h"
+
+#define ROUNDS  200000
+
+static double now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+struct cmd_case {
+	const char *name;
+	u8 cmd;
+	u8 len;
+	u8 data[CUC_DATA_BYTES];
+};
+
+static int null_send(void *priv, const struct cuc_pkt *pkt)
+{
+	(void)priv;
+	(void)pkt;
+	return 0;
+}
+
+/* Put r on the wire of x, answer it with rsp and reap it; returns the status */
+static int dispatch(struct cuc_xport *x, struct cuc_xport_req *r, const struct cuc_pkt *rsp)
+{
+	if (cuc_xport_submit(x, &r, 1) < 0)
+		return -EBUSY;
+	cuc_xport_dispatch(x, rsp);
+	return cuc_xport_wait(x, r);
+}
+
+#define CASE(c, ...) { #c, c, sizeof((u8[]){ __VA_ARGS__ }), { __VA_ARGS__ } }
+#define CASE0(c) { #c, c, 0, { 0 } }
+
+int main(void)
+{
+	static struct cmd_case cases[] = {
+		CASE0(CUC_CMD_PING),
+		CASE0(CUC_CMD_BOARD_INFO),
+		/* bus, addr, type, count, offset */
+		CASE(CUC_CMD_I2C_READ, 0, 0x50, I2C_RANDOM_ADDR8_READ, 32, 0, 0),
+		/* bus, addr, count, then the address pointer and three data bytes */
+		CASE(CUC_CMD_I2C_WRITE, 0, 0x50, 4, 0, 1, 2, 3),
+		CASE0(CUC_CMD_GET_LOG),
+		CASE0(CUC_CMD_GET_FRU),
+		CASE(CUC_CMD_SET_FAN_PWM, 50),
+		CASE0(CUC_CMD_GET_FAN_RPM),
+		CASE0(CUC_CMD_GET_MAC),
+		CASE(CUC_CMD_QSFP_READ, 0, 0, 0, 128),
+		CASE(CUC_CMD_QSFP_WRITE, 0, 0, 127, 1, 0),
+		CASE(CUC_CMD_QSFP_RESET, 0),
+		CASE(CUC_CMD_GET_INTR, 0),
+		CASE(CUC_CMD_CLEAR_ISR, 0, 0, 0, 0, 0),
+		CASE(CUC_CMD_UPDATE_IER, 0, 0, 0, 0, 0, 0, 0, 0, 0),
+		/* GetSensorReading of sensor 1 */
+		CASE(CUC_CMD_PLDM, 0x81, PLDM_TYPE_PLATFORM_MONITORING_AND_CONTROL, PLDM_CMD_GET_SENSOR_READING, 1, 0, 0),
+		CASE(CUC_CMD_FIRMWARE_UPDATE_START, 0, 0, 0, 1, 0, FW_SLOT_RECOVERY),
+		CASE(CUC_CMD_FIRMWARE_VERSION, FW_UC_APPLICATION, 0, 0, 0),
+		{ "CUC_CMD_FIRMWARE_UPDATE_DOWNLOAD", CUC_CMD_FIRMWARE_UPDATE_DOWNLOAD, CUC_DATA_BYTES, { 0 } },
+		CASE0(CUC_CMD_FIRMWARE_UPDATE_STATUS),
+		CASE0(CUC_CMD_RESET),
+		CASE(CUC_CMD_SET_LED, 0, 0, LED_FAST_GRN_YEL),
+		CASE0(CUC_CMD_GET_NIC_ID),
+		CASE0(CUC_CMD_GET_TIMINGS),
+	};
+	static struct cuc_sim sim;
+	static u8 eeprom[256];
+	static const struct cuc_xport_ops ops = {
+		.kind = CUC_XPORT_SIM,
+		.max_inflight = 1,
+		.send = null_send,
+	};
+	struct cuc_firmware_update_start_req start;
+	struct cuc_xport_req r;
+	struct cuc_xport x;
+	struct cuc_pkt rsp;
+	unsigned int c, i;
+	volatile int sink = 0;
+	double t0, t1, t2, t3;
+
+	cuc_sim_init(&sim, CUC_BOARD_TYPE_WASHINGTON, 1, 2);
+	cuc_sim_set_fw_version(&sim, FW_UC_APPLICATION, 0, CUC_SIM_FW_RUNNING, "1.5.0");
+	cuc_sim_add_i2c_dev(&sim, 0, 0x50, 0, eeprom, sizeof(eeprom));
+	cuc_xport_init(&x, &ops, NULL);
+
+	for (c = 0; c < sizeof(cases) / sizeof(cases[0]); c++) {
+		const struct cmd_case *k = &cases[c];
+		u8 fwu_status;
+		u32 fwu_received;
+		int status;
+
+		if (k->cmd == CUC_CMD_FIRMWARE_UPDATE_DOWNLOAD) {
+			/* Room for every timed chunk */
+			memset(&start, 0, sizeof(start));
+			start.size = (ROUNDS / 10) * CUC_DATA_BYTES;
+			cuc_xport_req_init(&r, CUC_CMD_FIRMWARE_UPDATE_START, &start, sizeof(start));
+			cuc_sim_handle(&sim, &r.req, &rsp);
+		}
+		fwu_status = sim.fwu_status;
+		fwu_received = sim.fwu_received;
+
+		t0 = now_ns();
+		for (i = 0; i < ROUNDS; i++) {
+			cuc_xport_req_init(&r, k->cmd, k->data, k->len);
+			sink += r.req.count;
+		}
+		t1 = now_ns();
+
+		/* Restore the simulator state that a command changes so every round does the same work */
+		for (i = 0; i < ROUNDS / 10; i++) {
+			cuc_sim_handle(&sim, &r.req, &rsp);
+			sim.log_count = 0;
+			sim.fwu_status = fwu_status;
+			sim.fwu_received = fwu_received;
+		}
+		t2 = now_ns();
+
+		status = dispatch(&x, &r, &rsp);
+		for (i = 0; i < ROUNDS; i++)
+			sink += dispatch(&x, &r, &rsp);
+		t3 = now_ns();
+		sim.fwu_status = FWU_STATUS_IDLE;
+
+		printf("{\"bench\":\"cuc_codec\",\"cmd\":\"%s\",\"req_bytes\":%u,\"rsp_bytes\":%u,\"rsp_status\":%d,"
+		       "\"encode_ns\":%.2f,\"uc_handle_ns\":%.2f,\"dispatch_ns\":%.2f}\n",
+		       k->name, k->len, cuc_xport_rsp_len(&r), status, (t1 - t0) / ROUNDS, (t2 - t1) / (ROUNDS / 10),
+		       (t3 - t2) / ROUNDS);
+	}
+	(void)sink;
+	return 0;
+}
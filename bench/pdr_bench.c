@@ -0,0 +1,294 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* Benchmark of PLDM PDR and FRU data handling.
+ *
+ *  - pdr_walk: a full GetPDR walk of a simulated repository with
+ *    pldm_pdr_walk(), including the multipart reassembly of records larger than
+ *    one response;
+ *  - numeric_pdr_parse: pldm_conv_table_add() and pldm_thr_table_add() for each
+ *    pldm_data_size, i.e. decoding the conversion and threshold fields of a
+ *    numeric sensor PDR;
+ *  - fru_walk: walking the field TLVs of a FRU record table;
+ *  - fru_index: pldm_fru_index_build() on the same table, then the lookups an
+ *    asset inventory does per NIC.
+ *
+ * The simulator adds no latency, so pdr_walk measures host-side cost only. Results
+ * are printed one JSON object per line.
+ *
+ * cc -O2 -Ilib/casuc -Ilib/craypldm -include bench/bench_types.h \
+ *    bench/pdr_bench.c -o pdr_bench -lm
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "cuc_sim.h"
+#include "pldm_fru.h"
+#include "pldm_pdr_cache.h"
+#include "pldm_sensor_conv.h"
+#include "pldm_threshold.h"
+
+#define NSENSORS      4096
+#define PARSE_ROUNDS  200
+#define WALK_ROUNDS   50
+#define FRU_ROUNDS    200000
+#define OEM_PDR_LEN   700
+
+static double now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static const char *size_name[] = { "uint8", "sint8", "uint16", "sint16", "uint32", "sint32" };
+
+static void numeric_pdr(struct numeric_sensor_pdr *p, u32 handle, u16 sensor_id, unsigned int size)
+{
+	float res = 0.5f, off = 1.0f, interval = 1.0f;
+
+	memset(p, 0, sizeof(*p));
+	p->hdr.record_handle = handle;
+	p->hdr.pdr_type = PLDM_PDR_NUMERIC_SENSOR;
+	p->hdr.record_change_number = 1;
+	p->hdr.data_length = sizeof(*p) - sizeof(p->hdr);
+	p->sensor_id = sensor_id;
+	p->sensor_data_size = (u8)size;
+	p->base_unit = PLDM_UNIT_DEGREES_C;
+	p->unit_modifier = -3;
+	p->is_linear = 1;
+	memcpy(&p->resolution, &res, sizeof(res));
+	memcpy(&p->offset, &off, sizeof(off));
+	/* The layout of the rest depends on the data size */
+	if (size <= PLDM_DATA_SIZE_SINT8) {
+		p->ssd.ssd8.supported_thresholds = 0x3f;
+		memcpy(&p->ssd.ssd8.update_interval, &interval, sizeof(interval));
+	} else if (size <= PLDM_DATA_SIZE_SINT16) {
+		p->ssd.ssd16.supported_thresholds = 0x3f;
+		memcpy(&p->ssd.ssd16.update_interval, &interval, sizeof(interval));
+	} else {
+		p->ssd.ssd32.supported_thresholds = 0x3f;
+		memcpy(&p->ssd.ssd32.update_interval, &interval, sizeof(interval));
+	}
+}
+
+/* Numeric sensors of every size, their names, and OEM records that need several GetPDR parts */
+static size_t build_repo(u8 *buf, unsigned int nnumeric, unsigned int noem)
+{
+	size_t off = 0;
+	u32 h = 1;
+	unsigned int i, k;
+
+	for (i = 0; i < nnumeric; i++) {
+		struct numeric_sensor_pdr p;
+		struct aux_name_pdr a;
+		char name[24];
+
+		numeric_pdr(&p, h++, (u16)(100 + i), i % PLDM_DATA_SIZE_COUNT);
+		memcpy(buf + off, &p, sizeof(p));
+		off += sizeof(p);
+
+		memset(&a, 0, sizeof(a));
+		a.hdr.record_handle = h++;
+		a.hdr.pdr_type = PLDM_PDR_SENSOR_AUXILIARY_NAMES;
+		a.hdr.data_length = sizeof(a) - sizeof(a.hdr);
+		a.sensor_id = (u16)(100 + i);
+		a.sensor_count = 1;
+		a.name_string_count = 1;
+		a.name_language_tag[0] = 'e';
+		a.name_language_tag[1] = 'n';
+		snprintf(name, sizeof(name), "sensor_%u", i);
+		for (k = 0; name[k]; k++)
+			a.sensor_name[k] = (u16)name[k];
+		memcpy(buf + off, &a, sizeof(a));
+		off += sizeof(a);
+	}
+	for (i = 0; i < noem; i++) {
+		struct pdr_hdr hdr = { 0 };
+
+		hdr.record_handle = h++;
+		hdr.pdr_type = PLDM_PDR_OEM;
+		hdr.record_change_number = 1;
+		hdr.data_length = OEM_PDR_LEN;
+		memcpy(buf + off, &hdr, sizeof(hdr));
+		memset(buf + off + sizeof(hdr), (int)i, OEM_PDR_LEN);
+		off += sizeof(hdr) + OEM_PDR_LEN;
+	}
+	return off;
+}
+
+static void bench_walk(const char *name, unsigned int nnumeric, unsigned int noem)
+{
+	static u8 repo[CUC_SIM_MAX_PDRS * (sizeof(struct pdr_hdr) + OEM_PDR_LEN)];
+	static struct cuc_sim sim;
+	struct cuc_xport_ops ops;
+	struct cuc_xport x;
+	struct pldm_requester rq;
+	struct pldm_pdr_buf buf = { 0 };
+	struct pldm_pdr_cache c;
+	size_t len = build_repo(repo, nnumeric, noem);
+	unsigned int r;
+	double t0, t1;
+	int rc = 0;
+
+	cuc_sim_init(&sim, CUC_BOARD_TYPE_WASHINGTON, 1, 2);
+	cuc_sim_set_pdr_repo(&sim, repo, len);
+	cuc_sim_xport_init(&x, &ops, &sim);
+	pldm_rq_init(&rq, &x);
+
+	memset(&c, 0, sizeof(c));
+	t0 = now_ns();
+	for (r = 0; r < WALK_ROUNDS && !rc; r++) {
+		buf.len = 0;
+		rc = pldm_pdr_walk(&rq, &buf, &c);
+	}
+	t1 = now_ns();
+
+	printf("{\"bench\":\"pdr_walk\",\"repo\":\"%s\",\"records\":%u,\"bytes\":%zu,\"requests_per_record\":%.2f,"
+	       "\"us_per_record\":%.3f,\"mb_per_s\":%.1f,\"ok\":%s}\n", name, sim.num_pdrs, len,
+	       c.fetched ? (double)c.requests / c.fetched : 0.0, c.fetched ? (t1 - t0) / 1e3 / c.fetched : 0.0,
+	       len * (double)WALK_ROUNDS / ((t1 - t0) / 1e9) / 1e6, rc || buf.len != len ? "false" : "true");
+	free(buf.p);
+}
+
+static void bench_parse(void)
+{
+	static struct numeric_sensor_pdr pdr[NSENSORS];
+	unsigned int size, i, r;
+
+	for (size = 0; size < PLDM_DATA_SIZE_COUNT; size++) {
+		double t0, t1;
+		long ok = 0;
+
+		for (i = 0; i < NSENSORS; i++)
+			numeric_pdr(&pdr[i], i + 1, (u16)i, size);
+
+		t0 = now_ns();
+		for (r = 0; r < PARSE_ROUNDS; r++) {
+			struct pldm_conv_table ct;
+			struct pldm_thr_table tt;
+
+			pldm_conv_table_init(&ct);
+			pldm_thr_table_init(&tt);
+			for (i = 0; i < NSENSORS; i++)
+				ok += pldm_conv_table_add(&ct, &pdr[i]) >= 0 && pldm_thr_table_add(&tt, &pdr[i]) >= 0;
+			pldm_thr_table_fini(&tt);
+			pldm_conv_table_fini(&ct);
+		}
+		t1 = now_ns();
+
+		printf("{\"bench\":\"numeric_pdr_parse\",\"size\":\"%s\",\"ns_per_pdr\":%.2f,\"ok\":%s}\n",
+		       size_name[size], (t1 - t0) / PARSE_ROUNDS / NSENSORS,
+		       ok == (long)PARSE_ROUNDS * NSENSORS ? "true" : "false");
+	}
+}
+
+/* FRU record table with 'nrec' General records of 'nfields' fields each */
+static size_t build_fru(u8 *buf, unsigned int nrec, unsigned int nfields)
+{
+	size_t off = 0;
+	unsigned int i, f;
+
+	for (i = 0; i < nrec; i++) {
+		struct pldm_fru_record rec = { (u16)(i + 1), PLDM_FRU_RECORD_GENERAL, (u8)nfields, 1 };
+
+		memcpy(buf + off, &rec, sizeof(rec));
+		off += sizeof(rec);
+		for (f = 0; f < nfields; f++) {
+			u8 len = (u8)(6 + (i * 7 + f * 5) % 24);
+
+			buf[off++] = (u8)(PLDM_FRU_FIELD_CHASSIS_TYPE + f % PLDM_FRU_FIELD_VENDOR_IANA);
+			buf[off++] = len;
+			memset(buf + off, 'a' + f % 26, len);
+			off += len;
+		}
+	}
+	return off;
+}
+
+/* Returns the number of fields, or -1 if a TLV runs past the end of the table */
+static long fru_walk(const u8 *p, size_t len, size_t *value_bytes)
+{
+	size_t off = 0;
+	long fields = 0;
+
+	*value_bytes = 0;
+	while (off + sizeof(struct pldm_fru_record) <= len) {
+		const struct pldm_fru_record *rec = (const struct pldm_fru_record *)(p + off);
+		unsigned int f, n = rec->num_fields;
+
+		off += sizeof(*rec);
+		for (f = 0; f < n; f++) {
+			const struct pldm_fru_field *fld = (const struct pldm_fru_field *)(p + off);
+
+			if (off + sizeof(*fld) > len || off + sizeof(*fld) + fld->length > len)
+				return -1;
+			*value_bytes += fld->length;
+			off += sizeof(*fld) + fld->length;
+			fields++;
+		}
+	}
+	return off == len ? fields : -1;
+}
+
+static void bench_fru(void)
+{
+	static u8 buf[16 * 1024];
+	size_t len = build_fru(buf, 8, 14), bytes = 0;
+	volatile long fields = 0;
+	unsigned int r;
+	double t0, t1;
+
+	t0 = now_ns();
+	for (r = 0; r < FRU_ROUNDS; r++)
+		fields = fru_walk(buf, len, &bytes);
+	t1 = now_ns();
+
+	printf("{\"bench\":\"fru_walk\",\"table_bytes\":%zu,\"fields\":%ld,\"ns_per_field\":%.2f,\"mb_per_s\":%.1f}\n",
+	       len, (long)fields, fields > 0 ? (t1 - t0) / FRU_ROUNDS / fields : 0.0,
+	       len * (double)FRU_ROUNDS / ((t1 - t0) / 1e9) / 1e6);
+}
+
+static void bench_fru_index(void)
+{
+	static const u8 fields[] = {
+		PLDM_FRU_FIELD_SERIAL_NUMBER, PLDM_FRU_FIELD_PART_NUMBER, PLDM_FRU_FIELD_MANUFACTURER,
+		PLDM_FRU_FIELD_MODEL, PLDM_FRU_FIELD_VERSION,
+	};
+	static u8 buf[16 * 1024];
+	size_t len = build_fru(buf, 8, 14);
+	struct pldm_fru_index ix;
+	volatile unsigned long bytes = 0;
+	unsigned int r, f;
+	double t0, t1, t2;
+	int rc = 0;
+
+	t0 = now_ns();
+	for (r = 0; r < FRU_ROUNDS; r++)
+		rc |= pldm_fru_index_build(&ix, buf, len);
+	t1 = now_ns();
+	for (r = 0; r < FRU_ROUNDS; r++)
+		for (f = 0; f < sizeof(fields); f++)
+			bytes += pldm_fru_lookup(&ix, &ix.set[r % ix.nsets], PLDM_FRU_RECORD_GENERAL, fields[f]).len;
+	t2 = now_ns();
+
+	printf("{\"bench\":\"fru_index\",\"table_bytes\":%zu,\"fields\":%u,\"build_ns\":%.2f,"
+	       "\"ns_per_field\":%.2f,\"lookup_ns\":%.2f,\"ok\":%s}\n", len, ix.nfields,
+	       (t1 - t0) / FRU_ROUNDS, (t1 - t0) / FRU_ROUNDS / ix.nfields,
+	       (t2 - t1) / FRU_ROUNDS / sizeof(fields), rc || !bytes ? "false" : "true");
+}
+
+int main(void)
+{
+	bench_walk("numeric", 120, 0);
+	bench_walk("multipart", 0, 64);
+	bench_walk("mixed", 96, 32);
+	bench_parse();
+	bench_fru();
+	bench_fru_index();
+	return 0;
+}
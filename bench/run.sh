@@ -0,0 +1,38 @@
+#!/bin/bash
+# SPDX-License-Identifier: MIT
+# Copyright 2026 Hewlett Packard Enterprise Development LP
+#
+# Build and run every benchmark. Each result is one JSON object per line on
+# stdout, tagged with the commit and host so CI can track results over time:
+#
+#   bench/run.sh > results.jsonl
+#
+# CC and CFLAGS may be overridden from the environment.
+
+set -euo pipefail
+
+top=$(cd "$(dirname "$0")/.." && pwd)
+out=$(mktemp -d)
+trap 'rm -rf "$out"' EXIT
+
+CC=${CC:-cc}
+CFLAGS=${CFLAGS:--O2}
+common=(-I"$top/lib/casuc" -I"$top/lib/craypldm" -include "$top/bench/bench_types.h")
+
+commit=$(git -C "$top" rev-parse --short HEAD 2>/dev/null || echo unknown)
+host=$(uname -n)
+
+build() {
+	local name=$1
+	shift
+	$CC $CFLAGS "$@" "${common[@]}" "$top/bench/$name.c" -o "$out/$name" -lm
+}
+
+build codec_bench
+build pdr_bench
+build xport_bench
+build sensor_conv_bench -ffp-contract=off
+
+for b in codec_bench pdr_bench sensor_conv_bench xport_bench; do
+	"$out/$b" | sed "s/^{/{\"commit\":\"$commit\",\"host\":\"$host\",/"
+done
@@ -0,0 +1,91 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* Benchmark and cross-check of the batch sensor converter in pldm_sensor_conv.h.
+ *
+ * Every kernel is checked bit-for-bit against pldm_sensor_convert() before it is
+ * timed. Results are printed one JSON object per line.
+ *
+ * cc -O2 -ffp-contract=off -Ilib/casuc -Ilib/craypldm -include bench/bench_types.h \
+ *    bench/sensor_conv_bench.c -o sensor_conv_bench -lm
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "pldm_sensor_conv.h"
+
+#define NSENSORS  4096
+#define ROUNDS    2000
+
+static double now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static const char *isa_name[] = { "auto", "scalar", "sse4.1", "avx2" };
+static const char *size_name[] = { "uint8", "sint8", "uint16", "sint16", "uint32", "sint32" };
+
+int main(void)
+{
+	static struct numeric_sensor_pdr pdr[NSENSORS];
+	static union sensor_value raw[NSENSORS];
+	static double ref[NSENSORS];
+	struct pldm_conv_table t;
+	unsigned int i, size, isa, bad = 0;
+	u32 seed = 1;
+
+	for (size = 0; size < PLDM_DATA_SIZE_COUNT; size++) {
+		pldm_conv_table_init(&t);
+		for (i = 0; i < NSENSORS; i++) {
+			float res = 0.001f * (1 + i % 97), off = -40.0f + (i % 13);
+			long h;
+
+			memset(&pdr[i], 0, sizeof(pdr[i]));
+			pdr[i].sensor_id = (u16)i;
+			pdr[i].sensor_data_size = (u8)size;
+			pdr[i].is_linear = i % 61 != 0;
+			pdr[i].unit_modifier = (s8)(-(int)(i % 7));
+			pdr[i].base_unit = PLDM_UNIT_DEGREES_C;
+			memcpy(&pdr[i].resolution, &res, sizeof(res));
+			memcpy(&pdr[i].offset, &off, sizeof(off));
+
+			seed = seed * 1103515245 + 12345;
+			raw[i].value_UINT32 = seed;
+			ref[i] = pldm_sensor_convert(&pdr[i], raw[i]);
+
+			h = pldm_conv_table_add(&t, &pdr[i]);
+			pldm_conv_table_set(&t, (u32)h, raw[i]);
+		}
+
+		for (isa = PLDM_CONV_ISA_SCALAR; isa <= PLDM_CONV_ISA_AVX2; isa++) {
+			struct pldm_conv_group *g = &t.group[size];
+			double t0, t1;
+			unsigned int r;
+
+			if (pldm_conv_batch(isa, size, g->raw, g->res, g->off, g->scale, g->value, g->value_f, g->n))
+				continue;
+			for (i = 0; i < NSENSORS; i++) {
+				if (memcmp(&g->value[i], &ref[i], sizeof(double))) {
+					bad++;
+					break;
+				}
+			}
+
+			t0 = now_ns();
+			for (r = 0; r < ROUNDS; r++)
+				pldm_conv_batch(isa, size, g->raw, g->res, g->off, g->scale, g->value, g->value_f, g->n);
+			t1 = now_ns();
+			printf("{\"bench\":\"sensor_conv\",\"size\":\"%s\",\"isa\":\"%s\",\"ns_per_reading\":%.3f,"
+			       "\"match\":%s}\n", size_name[size], isa_name[isa], (t1 - t0) / ROUNDS / NSENSORS,
+			       i == NSENSORS ? "true" : "false");
+		}
+		pldm_conv_table_fini(&t);
+	}
+	return bad ? 1 : 0;
+}
@@ -0,0 +1,166 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* End-to-end load test of the cuc_xport engine against the simulated uC.
+ *
+ * A closed loop keeps 'window' requests of one command in flight and resubmits each
+ * one as it completes. It reports commands per second and the p50/p99/p999
+ * latency from submit to completion. With no options it sweeps a set of link
+ * latencies and windows. Results are printed one JSON object per line.
+ *
+ *   -l us    link round-trip latency       -s us    uC service time per request
+ *   -j us    uC service time jitter        -b B/s   link bandwidth, 0 = unlimited
+ *   -w n     requests in flight            -n n     requests to complete
+ *   -c cmd   CUC_CMD_* number (default CUC_CMD_GET_FAN_RPM)
+ *
+ * cc -O2 -Ilib/casuc -Ilib/craypldm -include bench/bench_types.h \
+ *    bench/xport_bench.c -o xport_bench
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "cuc_sim.h"
+
+struct load {
+	struct cuc_xport *x;
+	u32 *lat_us;
+	unsigned int target;
+	unsigned int submitted;
+	unsigned int completed;
+	unsigned int errors;
+	u8 cmd;
+};
+
+static void req_done(struct cuc_xport_req *r)
+{
+	struct load *l = (struct load *)r->priv;
+
+	l->lat_us[l->completed++] = (u32)(cuc_xport_now_us() - r->submit_us);
+	if (r->status < 0)
+		l->errors++;
+	if (l->submitted < l->target) {
+		cuc_xport_req_init(r, l->cmd, NULL, 0);
+		r->done = req_done;
+		r->priv = l;
+		l->submitted++;
+		cuc_xport_submit(l->x, &r, 1);
+	}
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+	u32 x = *(const u32 *)a, y = *(const u32 *)b;
+
+	return (x > y) - (x < y);
+}
+
+static int run(u8 cmd, const struct cuc_sim_cmd_cfg *cfg, u32 bus_bytes_per_sec, unsigned int window,
+	       unsigned int count)
+{
+	static struct cuc_sim sim;
+	static struct cuc_xport_req reqs[CUC_XPORT_MAX_INFLIGHT];
+	struct cuc_xport_ops ops;
+	struct cuc_xport x;
+	struct load l;
+	unsigned int i;
+	u64 t0, t1;
+
+	if (window < 1 || window > CUC_XPORT_MAX_INFLIGHT)
+		return -1;
+	cuc_sim_init(&sim, CUC_BOARD_TYPE_WASHINGTON, 1, 2);
+	cuc_sim_set_cmd_cfg(&sim, -1, cfg);
+	sim.bus_bytes_per_sec = bus_bytes_per_sec;
+	cuc_sim_xport_init(&x, &ops, &sim);
+	x.window = window;
+
+	memset(&l, 0, sizeof(l));
+	l.x = &x;
+	l.cmd = cmd;
+	l.target = count;
+	l.lat_us = (u32 *)malloc(count * sizeof(*l.lat_us));
+	if (!l.lat_us)
+		return -1;
+
+	t0 = cuc_xport_now_us();
+	for (i = 0; i < window && l.submitted < count; i++) {
+		struct cuc_xport_req *r = &reqs[i];
+
+		cuc_xport_req_init(r, cmd, NULL, 0);
+		r->done = req_done;
+		r->priv = &l;
+		l.submitted++;
+		cuc_xport_submit(&x, &r, 1);
+	}
+	while (l.completed < count)
+		if (cuc_xport_progress(&x, 100000) < 0)
+			break;
+	t1 = cuc_xport_now_us();
+
+	qsort(l.lat_us, l.completed, sizeof(*l.lat_us), cmp_u32);
+	printf("{\"bench\":\"xport\",\"cmd\":%u,\"latency_us\":%u,\"service_us\":%u,\"jitter_us\":%u,"
+	       "\"bus_bytes_per_sec\":%u,\"window\":%u,\"requests\":%u,\"errors\":%u,\"cmds_per_sec\":%.0f,"
+	       "\"p50_us\":%u,\"p99_us\":%u,\"p999_us\":%u,\"max_us\":%u}\n",
+	       cmd, cfg->latency_us, cfg->service_us, cfg->jitter_us, bus_bytes_per_sec, window, l.completed,
+	       l.errors, l.completed / ((t1 - t0) / 1e6),
+	       l.lat_us[(u64)(l.completed - 1) * 500 / 1000], l.lat_us[(u64)(l.completed - 1) * 990 / 1000],
+	       l.lat_us[(u64)(l.completed - 1) * 999 / 1000], l.lat_us[l.completed - 1]);
+	free(l.lat_us);
+	return l.completed == count ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+	static const u32 sweep_latency[] = { 0, 100, 1000 };
+	static const unsigned int sweep_window[] = { 1, 4, 16, 32 };
+	struct cuc_sim_cmd_cfg cfg = { 0 };
+	unsigned int window = 0, count = 0, i, j;
+	u32 bus = 0;
+	int cmd = CUC_CMD_GET_FAN_RPM, opt, rc = 0;
+
+	while ((opt = getopt(argc, argv, "l:s:j:b:w:n:c:")) != -1) {
+		switch (opt) {
+		case 'l':
+			cfg.latency_us = (u32)strtoul(optarg, NULL, 0);
+			break;
+		case 's':
+			cfg.service_us = (u32)strtoul(optarg, NULL, 0);
+			break;
+		case 'j':
+			cfg.jitter_us = (u32)strtoul(optarg, NULL, 0);
+			break;
+		case 'b':
+			bus = (u32)strtoul(optarg, NULL, 0);
+			break;
+		case 'w':
+			window = (unsigned int)strtoul(optarg, NULL, 0);
+			break;
+		case 'n':
+			count = (unsigned int)strtoul(optarg, NULL, 0);
+			break;
+		case 'c':
+			cmd = (int)strtol(optarg, NULL, 0);
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-l us] [-s us] [-j us] [-b bytes/s] [-w window] [-n count] [-c cmd]\n",
+				argv[0]);
+			return 2;
+		}
+	}
+
+	if (optind > 1)
+		return run((u8)cmd, &cfg, bus, window ? window : 1, count ? count : 10000) ? 1 : 0;
+
+	/* Default sweep: zero-latency engine overhead, then a fast and a slow link */
+	for (i = 0; i < sizeof(sweep_latency) / sizeof(sweep_latency[0]); i++) {
+		for (j = 0; j < sizeof(sweep_window) / sizeof(sweep_window[0]); j++) {
+			cfg.latency_us = sweep_latency[i];
+			cfg.service_us = sweep_latency[i] ? 20 : 0;
+			cfg.jitter_us = sweep_latency[i] / 10;
+			rc |= run((u8)cmd, &cfg, 0, sweep_window[j], sweep_latency[i] >= 1000 ? 2000 : 20000);
+		}
+	}
+	return rc;
+}
@@ -20,6 +20,29 @@ This package contains header files for Cassini firmware
 mkdir -p %{buildroot}%{_includedir}
 install -D -m 644 lib/casuc/cuc_cxi.h %{buildroot}%{_includedir}/cuc_cxi.h
 install -D -m 644 lib/craypldm/pldm_cxi.h %{buildroot}%{_includedir}/pldm_cxi.h
+install -D -m 644 lib/casuc/cuc_xport.h %{buildroot}%{_includedir}/cuc_xport.h
+install -D -m 644 lib/casuc/cuc_sim.h %{buildroot}%{_includedir}/cuc_sim.h
+install -D -m 644 lib/craypldm/pldm_pdr_cache.h %{buildroot}%{_includedir}/pldm_pdr_cache.h
+install -D -m 644 lib/craypldm/pldm_sensor_poll.h %{buildroot}%{_includedir}/pldm_sensor_poll.h
+install -D -m 644 lib/craypldm/pldm_sensor_conv.h %{buildroot}%{_includedir}/pldm_sensor_conv.h
+install -D -m 644 lib/craypldm/pldm_threshold.h %{buildroot}%{_includedir}/pldm_threshold.h
+install -D -m 644 lib/casuc/cuc_view.hpp %{buildroot}%{_includedir}/cuc_view.hpp
+install -D -m 644 lib/casuc/cuc_fwu.h %{buildroot}%{_includedir}/cuc_fwu.h
+install -D -m 644 lib/casuc/cuc_qsfp_cache.h %{buildroot}%{_includedir}/cuc_qsfp_cache.h
+install -D -m 644 lib/casuc/cuc_intr.h %{buildroot}%{_includedir}/cuc_intr.h
+install -D -m 644 lib/casuc/cuc_log.h %{buildroot}%{_includedir}/cuc_log.h
+install -D -m 644 lib/casuc/cuc_timings.h %{buildroot}%{_includedir}/cuc_timings.h
+install -D -m 644 lib/casuc/cuc_fw_inventory.h %{buildroot}%{_includedir}/cuc_fw_inventory.h
+install -D -m 644 lib/casuc/cuc_board.hpp %{buildroot}%{_includedir}/cuc_board.hpp
+install -D -m 644 lib/casuc/cuc_stats.h %{buildroot}%{_includedir}/cuc_stats.h
+install -D -m 644 lib/craypldm/pldm_fru.h %{buildroot}%{_includedir}/pldm_fru.h
+install -D -m 644 lib/craypldm/pldm_sensor_names.h %{buildroot}%{_includedir}/pldm_sensor_names.h
+install -D -m 644 lib/craypldm/pldm_entity.h %{buildroot}%{_includedir}/pldm_entity.h
+install -D -m 644 lib/craypldm/pldm_requester.h %{buildroot}%{_includedir}/pldm_requester.h
+install -D -m 644 lib/casuc/cuc_i2c_bulk.h %{buildroot}%{_includedir}/cuc_i2c_bulk.h
+install -D -m 644 lib/casuc/cuc_sched.h %{buildroot}%{_includedir}/cuc_sched.h
+install -D -m 644 lib/casuc/cuc_co.hpp %{buildroot}%{_includedir}/cuc_co.hpp
+install -D -m 644 lib/casuc/cuc_sensor_shm.h %{buildroot}%{_includedir}/cuc_sensor_shm.h
 
 %files
 %defattr(-, root, root)
@@ -0,0 +1,310 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* This file provides compile-time board profiles for the CUC_BOARD_TYPE_* boards.
+ *
+ * Each board is one small type that gives its CUC_BOARD_TYPE_*, its Cassini
+ * generation and the board-specific voltage regulator and MFPGA firmware targets,
+ * as named by enum casuc_fw_target. profile<Board> derives the rest as constexpr
+ * tables:
+ *
+ *  - fw_targets: the components common to every blob, plus the board's own;
+ *  - fw_target_mask / regulator_mask: the same as BIT(target) masks.
+ *
+ * Nothing in the uC interface ties a board type to a NIC count, so the profiles do
+ * not carry one: timing_mask() gives the enum cuc_timing_entries the uC reports for
+ * a NIC count learned at run time.
+ *
+ * At compile time each target list is checked against CAS1_BLOB_FW_TARGETS or
+ * CAS2_BLOB_FW_TARGETS, and the generation against is_cas1_board_type() and
+ * is_cas2_board_type(). The profiles are also checked to cover every board type
+ * exactly once.
+ *
+ * dispatch() turns a runtime board_type from cuc_board_info_rsp into a call of a
+ * generic lambda with profile<Board>, so a loop written inside it is instantiated
+ * once per board and does not branch on the board type per iteration.
+ * for_each_fw_target<P>() unrolls over a profile's targets with each target as a
+ * compile-time constant. Adding a board means adding one type and listing it in
+ * 'all'.
+ *
+ * Like the C headers, this expects the u8..s64 types, BIT() and __packed to be
+ * provided by the includer. Requires C++17.
+ */
+
+#ifndef CUC_BOARD_HPP
+#define CUC_BOARD_HPP
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "cuc_cxi.h"
+
+namespace cuc {
+namespace board {
+
+/* Targets versioned on every board */
+inline constexpr std::array<u8, 7> common_fw_targets = {
+	FW_UC_APPLICATION, FW_UC_BOOTLOADER, FW_QSPI_BLOB, FW_OPROM, FW_CSR1, FW_CSR2, FW_SRDS,
+};
+
+inline constexpr std::array<u8, 10> cas1_blob_fw_targets = { CAS1_BLOB_FW_TARGETS };
+inline constexpr std::array<u8, 19> cas2_blob_fw_targets = { CAS2_BLOB_FW_TARGETS };
+
+static_assert(FW_NUM_ENTRIES <= 32, "firmware target masks are 32 bits");
+static_assert(TIMING_NUM_ENTRIES <= 32, "timing masks are 32 bits");
+
+/* Board definitions */
+
+struct sawtooth {
+	static constexpr int type = CUC_BOARD_TYPE_SAWTOOTH;
+	static constexpr const char *name = "sawtooth";
+	static constexpr bool cas2 = false;
+	static constexpr std::array<u8, 1> regulators = { FW_ISL68124_SAW };
+	static constexpr std::array<u8, 0> mfpga = {};
+};
+
+struct brazos {
+	static constexpr int type = CUC_BOARD_TYPE_BRAZOS;
+	static constexpr const char *name = "brazos";
+	static constexpr bool cas2 = false;
+	static constexpr std::array<u8, 2> regulators = { FW_ISL68124_BRZ, FW_IR38060_QSFP_BRZ };
+	static constexpr std::array<u8, 0> mfpga = {};
+};
+
+struct washington {
+	static constexpr int type = CUC_BOARD_TYPE_WASHINGTON;
+	static constexpr const char *name = "washington";
+	static constexpr bool cas2 = true;
+	static constexpr std::array<u8, 3> regulators = { FW_TDA38740_WAS, FW_IR38060_WAS, FW_IR38063_WAS };
+	static constexpr std::array<u8, 1> mfpga = { FW_MFPGA_WAS };
+};
+
+struct kennebec {
+	static constexpr int type = CUC_BOARD_TYPE_KENNEBEC;
+	static constexpr const char *name = "kennebec";
+	static constexpr bool cas2 = true;
+	static constexpr std::array<u8, 3> regulators = { FW_TDA38740_KEN, FW_IR38060_KEN, FW_IR38063_KEN };
+	static constexpr std::array<u8, 0> mfpga = {};
+};
+
+/* enum casuc_fw_target has no Pangani-specific components */
+struct pangani {
+	static constexpr int type = CUC_BOARD_TYPE_PANGANI;
+	static constexpr const char *name = "pangani";
+	static constexpr bool cas2 = true;
+	static constexpr std::array<u8, 0> regulators = {};
+	static constexpr std::array<u8, 0> mfpga = {};
+};
+
+struct souhegan {
+	static constexpr int type = CUC_BOARD_TYPE_SOUHEGAN;
+	static constexpr const char *name = "souhegan";
+	static constexpr bool cas2 = true;
+	static constexpr std::array<u8, 4> regulators = {
+		FW_TDA38740_SOU, FW_IR38063_0_SOU, FW_IR38063_1_SOU, FW_IR38063_2_SOU,
+	};
+	static constexpr std::array<u8, 1> mfpga = { FW_MFPGA_SOU };
+};
+
+/* Every known board, in any order */
+using all = std::tuple<sawtooth, brazos, washington, kennebec, pangani, souhegan>;
+
+namespace detail {
+
+template <std::size_t A, std::size_t B, std::size_t C>
+constexpr std::array<u8, A + B + C> concat(const std::array<u8, A> &a, const std::array<u8, B> &b,
+					   const std::array<u8, C> &c)
+{
+	std::array<u8, A + B + C> r{};
+	std::size_t n = 0;
+
+	for (std::size_t i = 0; i < A; i++)
+		r[n++] = a[i];
+	for (std::size_t i = 0; i < B; i++)
+		r[n++] = b[i];
+	for (std::size_t i = 0; i < C; i++)
+		r[n++] = c[i];
+	return r;
+}
+
+template <std::size_t N>
+constexpr u32 mask_of(const std::array<u8, N> &a)
+{
+	u32 m = 0;
+
+	for (std::size_t i = 0; i < N; i++)
+		m |= 1u << a[i];
+	return m;
+}
+
+template <std::size_t N>
+constexpr bool unique(const std::array<u8, N> &a)
+{
+	for (std::size_t i = 0; i < N; i++)
+		for (std::size_t j = i + 1; j < N; j++)
+			if (a[i] == a[j])
+				return false;
+	return true;
+}
+
+template <typename Tuple, std::size_t... I>
+constexpr bool types_unique(std::index_sequence<I...>)
+{
+	constexpr int types[] = { std::tuple_element_t<I, Tuple>::type... };
+
+	for (std::size_t i = 0; i < sizeof...(I); i++)
+		for (std::size_t j = i + 1; j < sizeof...(I); j++)
+			if (types[i] == types[j])
+				return false;
+	return true;
+}
+
+/* Every CUC_BOARD_TYPE_* from SAWTOOTH to SOUHEGAN has a profile */
+template <typename Tuple, std::size_t... I>
+constexpr bool covers_all(std::index_sequence<I...>)
+{
+	for (int t = CUC_BOARD_TYPE_SAWTOOTH; t <= CUC_BOARD_TYPE_SOUHEGAN; t++)
+		if (!((std::tuple_element_t<I, Tuple>::type == t) || ...))
+			return false;
+	return true;
+}
+
+} /* namespace detail */
+
+/**
+ * struct profile - Compile-time tables of one board
+ */
+template <typename Board>
+struct profile {
+	using board = Board;
+
+	static constexpr int type = Board::type;
+	static constexpr const char *name = Board::name;
+	static constexpr bool cas2 = Board::cas2;
+
+	static constexpr auto fw_targets = detail::concat(common_fw_targets, Board::regulators, Board::mfpga);
+	static constexpr u32 fw_target_mask = detail::mask_of(fw_targets);
+	static constexpr u32 regulator_mask = detail::mask_of(Board::regulators);
+	static constexpr u32 mfpga_mask = detail::mask_of(Board::mfpga);
+
+	static constexpr bool has_fw_target(unsigned int t)
+	{
+		return t < FW_NUM_ENTRIES && (fw_target_mask & (1u << t));
+	}
+
+	static_assert(Board::cas2 == is_cas2_board_type(Board::type) &&
+		      !Board::cas2 == is_cas1_board_type(Board::type), "board generation");
+	static_assert(detail::unique(fw_targets), "duplicate firmware target");
+	static_assert((fw_target_mask & ~(cas2 ? detail::mask_of(cas2_blob_fw_targets)
+					       : detail::mask_of(cas1_blob_fw_targets))) == 0,
+		      "firmware target not in the board generation's blob");
+};
+
+static_assert(detail::types_unique<all>(std::make_index_sequence<std::tuple_size_v<all>>()),
+	      "two profiles share a board type");
+static_assert(detail::covers_all<all>(std::make_index_sequence<std::tuple_size_v<all>>()),
+	      "a board type has no profile");
+
+/* The enum cuc_timing_entries reported by a uC serving 'num_nics' NICs */
+constexpr u32 timing_mask(unsigned int num_nics)
+{
+	constexpr u32 nic1 = (1u << TIMING_PERST_NIC_1_N_DEASSERTED) | (1u << TIMING_UC_CASSINI_RDY_NIC_1) |
+			     (1u << TIMING_PCIE_LINK_UP_NIC_1);
+
+	return ((1u << TIMING_NUM_ENTRIES) - 1) & ~(num_nics < 2 ? nic1 : 0u);
+}
+
+/**
+ * struct info - Runtime copy of a profile, for code that cannot be templated
+ */
+struct info {
+	int type;
+	const char *name;
+	bool cas2;
+	u32 fw_target_mask;
+	u32 regulator_mask;
+	u32 mfpga_mask;
+};
+
+template <typename Board>
+constexpr info info_of()
+{
+	using P = profile<Board>;
+
+	return info{ P::type, P::name, P::cas2, P::fw_target_mask, P::regulator_mask, P::mfpga_mask };
+}
+
+namespace detail {
+
+template <std::size_t... I>
+constexpr std::array<info, sizeof...(I)> make_infos(std::index_sequence<I...>)
+{
+	return { info_of<std::tuple_element_t<I, all>>()... };
+}
+
+template <typename F, std::size_t I = 0>
+constexpr auto dispatch(int type, F &&f) -> std::optional<decltype(f(profile<std::tuple_element_t<0, all>>()))>
+{
+	if constexpr (I == std::tuple_size_v<all>) {
+		(void)type;
+		(void)f;
+		return std::nullopt;
+	} else {
+		using B = std::tuple_element_t<I, all>;
+
+		if (type == B::type)
+			return f(profile<B>());
+		return dispatch<F, I + 1>(type, std::forward<F>(f));
+	}
+}
+
+} /* namespace detail */
+
+/* Every profile as an info, in the order of 'all' */
+inline constexpr auto infos = detail::make_infos(std::make_index_sequence<std::tuple_size_v<all>>());
+
+/* The info for a runtime board type, or nullptr */
+constexpr const info *find(int type)
+{
+	for (const info &i : infos)
+		if (i.type == type)
+			return &i;
+	return nullptr;
+}
+
+/**
+ * dispatch() - Call f(profile<Board>()) for a runtime board type
+ *
+ * Every instantiation of f must return the same type.
+ *
+ * Return: What f returns, or std::nullopt for an unknown board type
+ */
+template <typename F>
+constexpr auto dispatch(int type, F &&f)
+{
+	return detail::dispatch(type, std::forward<F>(f));
+}
+
+/**
+ * for_each_fw_target() - Call f(std::integral_constant<u8, target>()) for each of a profile's targets
+ */
+template <typename P, typename F, std::size_t... I>
+constexpr void for_each_fw_target(F &&f, std::index_sequence<I...>)
+{
+	(f(std::integral_constant<u8, P::fw_targets[I]>()), ...);
+}
+
+template <typename P, typename F>
+constexpr void for_each_fw_target(F &&f)
+{
+	for_each_fw_target<P>(std::forward<F>(f), std::make_index_sequence<P::fw_targets.size()>());
+}
+
+} /* namespace board */
+} /* namespace cuc */
+
+#endif /* CUC_BOARD_HPP */
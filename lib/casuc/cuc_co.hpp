@@ -0,0 +1,1050 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* This file provides a C++20 coroutine API for uC and PLDM exchanges.
+ *
+ * A multi-step operation (a multipart GetPDR walk, a firmware update, a sequence of
+ * QSFP reads) is written as straight-line code in a cuc::co::task, with a co_await
+ * at every uC round trip. While it waits, its thread drives the other tasks, so one
+ * thread can keep hundreds of exchanges in flight across all the uCs it owns instead
+ * of needing one thread per blocking call.
+ *
+ * cuc::co::loop is a single-threaded event loop on top of cuc_xport.h. The basic
+ * awaitable is loop::exec(), which submits one caller-owned struct cuc_xport_req
+ * and resumes the task when it completes. Any CUC_CMD_* can be issued that way, and
+ * loop::exec_all() awaits a whole window of requests. PLDM commands go through
+ * pldm_exec(), which gives each transaction its own instance ID from the endpoint's
+ * struct pldm_requester. An ID whose request timed out, or was cancelled once sent,
+ * stays quarantined for one more timeout period.
+ *
+ * Nothing is allocated per operation: awaiters and requests live in the coroutine
+ * frame, and frames are recycled through a per-thread pool. Operations can be given
+ * a cancel_token. Cancelling completes unsent requests and sleeps right away with
+ * -ECANCELED. A request already on the wire completes with -ECANCELED when the uC
+ * answers or it times out (see cuc_xport_cancel()). Timeouts are the transport's,
+ * per request via cuc_xport_req.timeout_us.
+ *
+ * To use several threads, give each thread its own loop and a disjoint set of
+ * transports; a struct cuc_xport must only be driven by one thread. Tasks report
+ * errors as negative errno values, like the C headers, and do not throw.
+ *
+ * Like the C headers, this expects the u8..s64 types, BIT() and __packed to be
+ * provided by the includer. Requires C++20.
+ */
+
+#ifndef CUC_CO_HPP
+#define CUC_CO_HPP
+
+#include <cerrno>
+#include <coroutine>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include <unistd.h>
+
+#include "cuc_cxi.h"
+#include "cuc_fwu.h"
+#include "cuc_qsfp_cache.h"
+#include "cuc_xport.h"
+#include "pldm_cxi.h"
+#include "pldm_pdr_cache.h"
+#include "pldm_requester.h"
+#include "pldm_sensor_poll.h"
+
+namespace cuc {
+namespace co {
+
+class loop;
+
+namespace detail {
+
+/* Per-thread free lists of coroutine frames, by size class */
+struct frame_pool {
+	static constexpr std::size_t granule = 256;
+	static constexpr std::size_t classes = 16;
+
+	struct node {
+		node *next;
+	};
+	node *free[classes] = {};
+
+	~frame_pool()
+	{
+		for (auto &head : free) {
+			while (head) {
+				node *n = head;
+
+				head = n->next;
+				::operator delete(n);
+			}
+		}
+	}
+};
+
+inline frame_pool &pool()
+{
+	static thread_local frame_pool p;
+	return p;
+}
+
+inline void *frame_alloc(std::size_t n)
+{
+	std::size_t c = (n + frame_pool::granule - 1) / frame_pool::granule;
+	frame_pool &p = pool();
+
+	if (c < frame_pool::classes && p.free[c]) {
+		frame_pool::node *f = p.free[c];
+
+		p.free[c] = f->next;
+		return f;
+	}
+	return ::operator new(c < frame_pool::classes ? c * frame_pool::granule : n);
+}
+
+inline void frame_free(void *f, std::size_t n)
+{
+	std::size_t c = (n + frame_pool::granule - 1) / frame_pool::granule;
+
+	if (c >= frame_pool::classes) {
+		::operator delete(f);
+		return;
+	}
+	frame_pool &p = pool();
+	frame_pool::node *node = static_cast<frame_pool::node *>(f);
+
+	node->next = p.free[c];
+	p.free[c] = node;
+}
+
+} /* namespace detail */
+
+/**
+ * struct waiter - A suspended coroutine queued for resumption by the loop
+ */
+struct waiter {
+	std::coroutine_handle<> h;
+	waiter *next = nullptr;
+};
+
+/**
+ * class cancel_token - Cancels every operation it was passed to
+ */
+class cancel_token {
+public:
+	struct entry {
+		void (*fn)(entry *e) = nullptr;
+		entry *prev = nullptr;
+		entry *next = nullptr;
+	};
+
+	bool cancelled() const { return cancelled_; }
+
+	/* No operation is registered */
+	bool empty() const { return !head_; }
+
+	void cancel()
+	{
+		cancelled_ = true;
+		while (head_) {
+			entry *e = head_;
+
+			remove(e);
+			e->fn(e);
+		}
+	}
+
+	void add(entry *e)
+	{
+		e->prev = nullptr;
+		e->next = head_;
+		if (head_)
+			head_->prev = e;
+		head_ = e;
+	}
+
+	void remove(entry *e)
+	{
+		if (e->prev)
+			e->prev->next = e->next;
+		else if (head_ == e)
+			head_ = e->next;
+		else
+			return;
+		if (e->next)
+			e->next->prev = e->prev;
+		e->prev = e->next = nullptr;
+	}
+
+private:
+	entry *head_ = nullptr;
+	bool cancelled_ = false;
+};
+
+template <typename T = void>
+class task;
+
+namespace detail {
+
+struct promise_base {
+	std::coroutine_handle<> continuation;
+	loop *spawned = nullptr;       /* Set for top-level tasks, which free themselves */
+	waiter start;
+
+	static void *operator new(std::size_t n) { return frame_alloc(n); }
+	static void operator delete(void *p, std::size_t n) { frame_free(p, n); }
+
+	std::suspend_always initial_suspend() noexcept { return {}; }
+
+	struct final_awaiter {
+		bool await_ready() noexcept { return false; }
+
+		template <typename P>
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept;
+
+		void await_resume() noexcept {}
+	};
+
+	final_awaiter final_suspend() noexcept { return {}; }
+
+	void unhandled_exception() noexcept { std::terminate(); }
+};
+
+template <typename T>
+struct promise : promise_base {
+	T value{};
+
+	task<T> get_return_object() noexcept;
+	void return_value(T v) noexcept { value = std::move(v); }
+};
+
+template <>
+struct promise<void> : promise_base {
+	task<void> get_return_object() noexcept;
+	void return_void() noexcept {}
+};
+
+} /* namespace detail */
+
+/**
+ * class task - A lazily started coroutine returning T
+ *
+ * A task starts when it is awaited, or when it is handed to loop::spawn().
+ */
+template <typename T>
+class task {
+public:
+	using promise_type = detail::promise<T>;
+
+	task() = default;
+	explicit task(std::coroutine_handle<promise_type> h) : h_(h) {}
+	task(task &&o) noexcept : h_(std::exchange(o.h_, {})) {}
+	task &operator=(task &&o) noexcept
+	{
+		if (this != &o) {
+			if (h_)
+				h_.destroy();
+			h_ = std::exchange(o.h_, {});
+		}
+		return *this;
+	}
+	task(const task &) = delete;
+	task &operator=(const task &) = delete;
+	~task()
+	{
+		if (h_)
+			h_.destroy();
+	}
+
+	bool await_ready() const noexcept { return false; }
+
+	std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept
+	{
+		h_.promise().continuation = caller;
+		return h_;
+	}
+
+	T await_resume() noexcept
+	{
+		if constexpr (!std::is_void_v<T>)
+			return std::move(h_.promise().value);
+	}
+
+	std::coroutine_handle<promise_type> release() noexcept { return std::exchange(h_, {}); }
+
+private:
+	std::coroutine_handle<promise_type> h_;
+};
+
+namespace detail {
+
+template <typename T>
+inline task<T> promise<T>::get_return_object() noexcept
+{
+	return task<T>(std::coroutine_handle<promise<T>>::from_promise(*this));
+}
+
+inline task<void> promise<void>::get_return_object() noexcept
+{
+	return task<void>(std::coroutine_handle<promise<void>>::from_promise(*this));
+}
+
+} /* namespace detail */
+
+/**
+ * class loop - Single-threaded event loop over a set of uC transports
+ */
+class loop {
+public:
+	static constexpr unsigned int max_xports = 64;
+	static constexpr long poll_us = 200;   /* Wait per transport when several are busy */
+
+	loop() = default;
+	loop(const loop &) = delete;
+	loop &operator=(const loop &) = delete;
+
+	/* Register a transport. Returns 0, or -ENOSPC. */
+	int add(struct cuc_xport *x)
+	{
+		if (nxports_ == max_xports)
+			return -ENOSPC;
+		xports_[nxports_++] = x;
+		return 0;
+	}
+
+	/* Start a top-level task; it is freed when it completes */
+	void spawn(task<void> t)
+	{
+		auto h = t.release();
+
+		h.promise().spawned = this;
+		h.promise().start.h = h;
+		live_++;
+		ready(&h.promise().start);
+	}
+
+	/* Queue a suspended coroutine for resumption */
+	void ready(waiter *w)
+	{
+		w->next = nullptr;
+		if (ready_tail_)
+			ready_tail_->next = w;
+		else
+			ready_head_ = w;
+		ready_tail_ = w;
+	}
+
+	void task_done() { live_--; }
+
+	unsigned int live() const { return live_; }
+
+	/**
+	 * run() - Drive the spawned tasks until all of them have completed
+	 *
+	 * Return: 0, the first transport failure reported by cuc_xport_progress(), or
+	 * -EDEADLK if tasks remain that nothing can wake
+	 */
+	int run()
+	{
+		int err = 0;
+
+		while (live_) {
+			unsigned int busy = 0, nrx = 0, i;
+			struct cuc_xport *first = nullptr;
+			u64 now, wait;
+			int rc;
+
+			while (waiter *w = ready_head_) {
+				ready_head_ = w->next;
+				if (!ready_head_)
+					ready_tail_ = nullptr;
+				w->h.resume();
+			}
+			if (!live_)
+				break;
+
+			now = cuc_xport_now_us();
+			fire_timers(now);
+			if (ready_head_)
+				continue;
+
+			for (i = 0; i < nxports_; i++) {
+				struct cuc_xport *x = xports_[(next_xport_ + i) % nxports_];
+
+				if (cuc_xport_idle(x))
+					continue;
+				if (!first)
+					first = x;
+				busy++;
+				rc = cuc_xport_progress(x, 0);
+				if (rc < 0 && !err)
+					err = rc;
+				if (rc > 0)
+					nrx += (unsigned int)rc;
+			}
+			next_xport_ = nxports_ ? (next_xport_ + 1) % nxports_ : 0;
+			if (nrx || ready_head_)
+				continue;
+
+			wait = timers_ ? (timers_->deadline > now ? timers_->deadline - now : 0) : (u64)-1;
+			if (busy) {
+				u64 cap = busy == 1 ? first->default_timeout_us : (u64)poll_us;
+
+				rc = cuc_xport_progress(first, (long)(wait < cap ? wait : cap));
+				if (rc < 0 && !err)
+					err = rc;
+			} else if (timers_) {
+				if (wait)
+					usleep((useconds_t)wait);
+			} else {
+				return err ? err : -EDEADLK;
+			}
+		}
+		return err;
+	}
+
+	/* Whether the transport still holds a request, so it may not be resubmitted */
+	static bool busy(const struct cuc_xport_req *r)
+	{
+		return r->state == CUC_XPORT_REQ_PENDING || r->state == CUC_XPORT_REQ_INFLIGHT;
+	}
+
+	/* Awaitable completion of one request; see exec() */
+	struct exec_awaiter {
+		loop *l;
+		struct cuc_xport *x;
+		struct cuc_xport_req *r;
+		cancel_token *ct;
+		int err = 0;
+		bool on_wire = false;      /* Cancelled after it was sent */
+		waiter w;
+		cancel_token::entry ce;
+
+		bool await_ready() const noexcept { return false; }
+
+		bool await_suspend(std::coroutine_handle<> h) noexcept
+		{
+			struct cuc_xport_req *one = r;
+
+			if (busy(r)) {
+				err = -EBUSY;
+				return false;
+			}
+			if (ct && ct->cancelled()) {
+				r->status = -ECANCELED;
+				return false;
+			}
+			w.h = h;
+			r->done = on_done;
+			r->priv = this;
+			/* Registered first: a failed send completes the request inside submit */
+			if (ct) {
+				ce.fn = on_cancel;
+				ct->add(&ce);
+			}
+			/* Cannot fail: the request is not held by the transport */
+			cuc_xport_submit(x, &one, 1);
+			return true;
+		}
+
+		int await_resume() const noexcept { return err ? err : r->status; }
+
+		static void on_done(struct cuc_xport_req *r)
+		{
+			exec_awaiter *a = static_cast<exec_awaiter *>(r->priv);
+
+			r->state = CUC_XPORT_REQ_IDLE;
+			if (a->ct)
+				a->ct->remove(&a->ce);
+			a->l->ready(&a->w);
+		}
+
+		static void on_cancel(cancel_token::entry *e)
+		{
+			exec_awaiter *a = reinterpret_cast<exec_awaiter *>(reinterpret_cast<char *>(e) -
+									    offsetof(exec_awaiter, ce));
+
+			a->on_wire = a->r->state == CUC_XPORT_REQ_INFLIGHT;
+			cuc_xport_cancel(a->x, a->r);
+		}
+	};
+
+	/**
+	 * exec() - Submit a request and resume when it completes
+	 *
+	 * The request's 'done' and 'priv' fields are used by the loop.
+	 * co_await yields the request status, or -EBUSY without touching a request the
+	 * transport still holds; the response is in r.rsp.
+	 */
+	exec_awaiter exec(struct cuc_xport *x, struct cuc_xport_req &r, cancel_token *ct = nullptr)
+	{
+		return exec_awaiter{ this, x, &r, ct, 0, false, {}, {} };
+	}
+
+	/* Awaitable completion of a window of requests; see exec_all() */
+	struct exec_all_awaiter {
+		loop *l;
+		struct cuc_xport *x;
+		struct cuc_xport_req *reqs;
+		unsigned int n;
+		cancel_token *ct;
+		unsigned int left = 0;
+		int err = 0;
+		bool submitting = false;   /* Completions inside submit must not queue the task */
+		waiter w;
+		cancel_token::entry ce;
+
+		bool await_ready() const noexcept { return !n; }
+
+		bool await_suspend(std::coroutine_handle<> h) noexcept
+		{
+			struct cuc_xport_req *one;
+			unsigned int i;
+
+			for (i = 0; i < n; i++) {
+				if (busy(&reqs[i])) {
+					err = -EBUSY;
+					return false;
+				}
+			}
+			if (ct && ct->cancelled()) {
+				for (i = 0; i < n; i++)
+					reqs[i].status = -ECANCELED;
+				return false;
+			}
+			w.h = h;
+			left = n;
+			submitting = true;
+			if (ct) {
+				ce.fn = on_cancel;
+				ct->add(&ce);
+			}
+			for (i = 0; i < n; i++) {
+				one = &reqs[i];
+				one->done = on_done;
+				one->priv = this;
+				/* Cannot fail: none of the requests is held by the transport */
+				cuc_xport_submit(x, &one, 1);
+			}
+			submitting = false;
+			/* Everything may already have completed, e.g. on failed sends */
+			return left != 0;
+		}
+
+		int await_resume() const noexcept
+		{
+			if (err)
+				return err;
+			for (unsigned int i = 0; i < n; i++)
+				if (reqs[i].status)
+					return reqs[i].status;
+			return 0;
+		}
+
+		static void on_done(struct cuc_xport_req *r)
+		{
+			exec_all_awaiter *a = static_cast<exec_all_awaiter *>(r->priv);
+
+			r->state = CUC_XPORT_REQ_IDLE;
+			if (--a->left)
+				return;
+			if (a->ct)
+				a->ct->remove(&a->ce);
+			if (!a->submitting)
+				a->l->ready(&a->w);
+		}
+
+		static void on_cancel(cancel_token::entry *e)
+		{
+			exec_all_awaiter *a = reinterpret_cast<exec_all_awaiter *>(reinterpret_cast<char *>(e) -
+										   offsetof(exec_all_awaiter, ce));
+
+			/* Unsent requests complete right here; the last one can resume the task */
+			for (unsigned int i = 0; i < a->n; i++)
+				if (busy(&a->reqs[i]))
+					cuc_xport_cancel(a->x, &a->reqs[i]);
+		}
+	};
+
+	/**
+	 * exec_all() - Submit n requests together and resume when all have completed
+	 *
+	 * co_await yields -EBUSY if the transport still holds one of the requests, in
+	 * which case none is submitted. Otherwise it yields the first non-zero status in
+	 * array order, or 0.
+	 */
+	exec_all_awaiter exec_all(struct cuc_xport *x, struct cuc_xport_req *reqs, unsigned int n,
+				  cancel_token *ct = nullptr)
+	{
+		return exec_all_awaiter{ this, x, reqs, n, ct, 0, 0, false, {}, {} };
+	}
+
+	/* Awaitable timer; see sleep_for() */
+	struct sleep_awaiter {
+		loop *l;
+		u64 deadline;
+		cancel_token *ct;
+		int status = 0;
+		waiter w;
+		sleep_awaiter *next = nullptr;
+		cancel_token::entry ce;
+
+		bool await_ready() noexcept
+		{
+			if (ct && ct->cancelled()) {
+				status = -ECANCELED;
+				return true;
+			}
+			return false;
+		}
+
+		void await_suspend(std::coroutine_handle<> h) noexcept
+		{
+			w.h = h;
+			l->add_timer(this);
+			if (ct) {
+				ce.fn = on_cancel;
+				ct->add(&ce);
+			}
+		}
+
+		int await_resume() const noexcept { return status; }
+
+		static void on_cancel(cancel_token::entry *e)
+		{
+			sleep_awaiter *a = reinterpret_cast<sleep_awaiter *>(reinterpret_cast<char *>(e) -
+									     offsetof(sleep_awaiter, ce));
+
+			a->l->remove_timer(a);
+			a->status = -ECANCELED;
+			a->l->ready(&a->w);
+		}
+	};
+
+	/* Resume after 'us' microseconds. co_await yields 0, or -ECANCELED. */
+	sleep_awaiter sleep_for(u64 us, cancel_token *ct = nullptr)
+	{
+		return sleep_awaiter{ this, cuc_xport_now_us() + us, ct, 0, {}, nullptr, {} };
+	}
+
+	void add_timer(sleep_awaiter *a)
+	{
+		sleep_awaiter **p = &timers_;
+
+		while (*p && (*p)->deadline <= a->deadline)
+			p = &(*p)->next;
+		a->next = *p;
+		*p = a;
+	}
+
+	void remove_timer(sleep_awaiter *a)
+	{
+		for (sleep_awaiter **p = &timers_; *p; p = &(*p)->next) {
+			if (*p == a) {
+				*p = a->next;
+				return;
+			}
+		}
+	}
+
+private:
+	void fire_timers(u64 now)
+	{
+		while (timers_ && timers_->deadline <= now) {
+			sleep_awaiter *a = timers_;
+
+			timers_ = a->next;
+			if (a->ct)
+				a->ct->remove(&a->ce);
+			ready(&a->w);
+		}
+	}
+
+	struct cuc_xport *xports_[max_xports] = {};
+	unsigned int nxports_ = 0;
+	unsigned int next_xport_ = 0;
+	waiter *ready_head_ = nullptr;
+	waiter *ready_tail_ = nullptr;
+	sleep_awaiter *timers_ = nullptr;
+	unsigned int live_ = 0;
+};
+
+namespace detail {
+
+template <typename P>
+inline std::coroutine_handle<> promise_base::final_awaiter::await_suspend(std::coroutine_handle<P> h) noexcept
+{
+	promise_base &p = h.promise();
+
+	if (p.continuation)
+		return p.continuation;
+	if (loop *l = p.spawned) {
+		h.destroy();
+		l->task_done();
+	}
+	return std::noop_coroutine();
+}
+
+} /* namespace detail */
+
+/**
+ * struct endpoint - A uC transport and the requester that allocates its PLDM instance IDs
+ *
+ * The requester may be shared with the PDR cache and the sensor poller of the same
+ * transport, so the tasks of the loop and those users never hold the same ID.
+ */
+struct endpoint {
+	struct cuc_xport *x;
+	struct pldm_requester *rq;
+	waiter *iid_head = nullptr;    /* Tasks waiting for an instance ID */
+	waiter *iid_tail = nullptr;
+	unsigned int held = 0;         /* IDs taken by tasks and not yet given back */
+
+	explicit endpoint(struct pldm_requester *r) : x(r->x), rq(r) {}
+
+	/*
+	 * Give back an ID. The first waiting task gets an ID right here, so a task that
+	 * asks before it runs cannot take it. If none is free the waiters stay queued
+	 * while other tasks hold IDs, and are all woken to fail otherwise.
+	 */
+	void put_iid(loop &l, unsigned int id, int status)
+	{
+		pldm_rq_put_iid(rq, (u8)id, status);
+		held--;
+		while (waiter *w = iid_head) {
+			iid_awaiter *a = reinterpret_cast<iid_awaiter *>(reinterpret_cast<char *>(w) -
+								       offsetof(iid_awaiter, w));
+
+			a->id = pldm_rq_get_iid(rq);
+			if (a->id < 0 && held)
+				return;
+			iid_head = w->next;
+			if (!iid_head)
+				iid_tail = nullptr;
+			l.ready(w);
+			if (a->id >= 0) {
+				held++;
+				return;
+			}
+		}
+	}
+
+	struct iid_awaiter {
+		endpoint *ep;
+		loop *l;
+		int id = -EAGAIN;
+		waiter w;
+
+		bool await_ready() noexcept
+		{
+			/* Queued tasks are served first */
+			if (ep->iid_head)
+				return false;
+			id = pldm_rq_get_iid(ep->rq);
+			if (id < 0)
+				return false;
+			ep->held++;
+			return true;
+		}
+
+		bool await_suspend(std::coroutine_handle<> h) noexcept
+		{
+			/* Only a task giving back its ID wakes us; with none holding one, fail now */
+			if (!ep->held && !ep->iid_head)
+				return false;
+			w.h = h;
+			w.next = nullptr;
+			if (ep->iid_tail)
+				ep->iid_tail->next = &w;
+			else
+				ep->iid_head = &w;
+			ep->iid_tail = &w;
+			return true;
+		}
+
+		int await_resume() noexcept
+		{
+			if (id < 0) {
+				id = pldm_rq_get_iid(ep->rq);
+				if (id >= 0)
+					ep->held++;
+			}
+			return id;
+		}
+	};
+
+	/* co_await yields an instance ID, or -EAGAIN if every ID is quarantined */
+	iid_awaiter acquire(loop &l) { return iid_awaiter{ this, &l, -EAGAIN, {} }; }
+};
+
+/**
+ * pldm_exec() - Run one PLDM transaction on an endpoint
+ * @l: Loop
+ * @ep: Endpoint
+ * @r: CUC_CMD_PLDM request; the instance ID it was built with is replaced
+ * @ct: Optional cancellation
+ *
+ * Return: The request status, -EAGAIN if every instance ID is quarantined. The
+ * completion code is left in the response.
+ */
+inline task<int> pldm_exec(loop &l, endpoint &ep, struct cuc_xport_req &r, cancel_token *ct = nullptr)
+{
+	auto a = l.exec(ep.x, r, ct);
+	int iid, rc;
+
+	iid = co_await ep.acquire(l);
+	if (iid < 0)
+		co_return iid;
+	r.req.data[0] = (u8)((r.req.data[0] & ~0x1F) | iid);
+	rc = co_await a;
+	/* The uC may still answer a request cancelled on the wire, as after a timeout */
+	ep.put_iid(l, (unsigned int)iid, rc == -ECANCELED && a.on_wire ? -ETIMEDOUT : rc);
+	co_return rc;
+}
+
+/* Completion code of a PLDM response, or -1 if there is none */
+inline int pldm_cc(const struct cuc_xport_req &r)
+{
+	if (r.rsp.type != CUC_TYPE_RSP_PLDM || cuc_xport_rsp_len(&r) <= sizeof(struct pldm_hdr))
+		return -1;
+	return r.rsp.data[sizeof(struct pldm_hdr)];
+}
+
+/**
+ * pldm_retry() - Run a PLDM transaction, retrying PLDM_ERROR_NOT_READY with backoff
+ *
+ * Return: As pldm_exec()
+ */
+inline task<int> pldm_retry(loop &l, endpoint &ep, struct cuc_xport_req &r, cancel_token *ct = nullptr)
+{
+	u64 backoff = 1000;
+	int rc;
+
+	for (int retries = 0;; retries++) {
+		rc = co_await pldm_exec(l, ep, r, ct);
+		if (rc || pldm_cc(r) != PLDM_ERROR_NOT_READY || retries == 8)
+			co_return rc;
+		rc = co_await l.sleep_for(backoff, ct);
+		if (rc)
+			co_return rc;
+		if (backoff < 64 * 1000)
+			backoff *= 2;
+	}
+}
+
+/**
+ * get_sensor_reading() - GetSensorReading for one sensor
+ * @rsp: Receives the response; valid up to the size of the reading
+ *
+ * Return: 0, -EAGAIN if the uC stayed not ready, -EIO for another completion code,
+ * -EPROTO for a short response, or a transport error
+ */
+inline task<int> get_sensor_reading(loop &l, endpoint &ep, u16 sensor_id, struct get_sensor_reading_rsp &rsp,
+				    cancel_token *ct = nullptr)
+{
+	struct cuc_xport_req r;
+	unsigned int len;
+	int rc, cc;
+
+	pldm_poll_sensor_req_init(&r, 0, sensor_id);
+	rc = co_await pldm_retry(l, ep, r, ct);
+	if (rc)
+		co_return rc;
+	cc = pldm_cc(r);
+	if (cc == PLDM_ERROR_NOT_READY)
+		co_return -EAGAIN;
+	if (cc != PLDM_SUCCESS)
+		co_return cc < 0 ? -EPROTO : -EIO;
+	len = cuc_xport_rsp_len(&r);
+	if (len < offsetof(struct get_sensor_reading_rsp, present_reading))
+		co_return -EPROTO;
+	std::memset(&rsp, 0, sizeof(rsp));
+	std::memcpy(&rsp, r.rsp.data, len < sizeof(rsp) ? len : sizeof(rsp));
+	co_return 0;
+}
+
+/**
+ * get_pdr_record() - Fetch one complete PDR with a multipart GetPDR walk
+ * @out: Buffer the record is appended to
+ * @next_record_handle: Set to the handle of the following record (0 at the end)
+ *
+ * Return: 0 or a negative errno, as pldm_pdr_fetch_record()
+ */
+inline task<int> get_pdr_record(loop &l, endpoint &ep, u32 record_handle, struct pldm_pdr_buf &out,
+				u32 &next_record_handle, cancel_token *ct = nullptr)
+{
+	struct cuc_xport_req r;
+	const struct get_pdr_rsp *rsp;
+	std::size_t start = out.len;
+	u32 xfer = 0;
+	u16 rcn = 0;
+	u8 op = PLDM_XFER_OP_GET_FIRST_PART;
+	int rc;
+
+	for (;;) {
+		pldm_get_pdr_req_init(&r, 0, record_handle, xfer, op, PLDM_PDR_XFER_MAX, rcn);
+		rc = co_await pldm_retry(l, ep, r, ct);
+		if (rc)
+			break;
+		rsp = pldm_get_pdr_rsp(&r, &rc);
+		if (rc)
+			break;
+		rc = pldm_pdr_buf_append(&out, rsp->record_data, rsp->response_count);
+		if (rc)
+			break;
+
+		if (op == PLDM_XFER_OP_GET_FIRST_PART) {
+			if (rsp->response_count < sizeof(struct pdr_hdr)) {
+				rc = -EPROTO;
+				break;
+			}
+			rcn = reinterpret_cast<const struct pdr_hdr *>(out.p + start)->record_change_number;
+		}
+		if (rsp->transfer_flag == PLDM_XFER_FLAG_END || rsp->transfer_flag == PLDM_XFER_FLAG_START_AND_END) {
+			if (out.len - start != sizeof(struct pdr_hdr) +
+			    reinterpret_cast<const struct pdr_hdr *>(out.p + start)->data_length) {
+				rc = -EPROTO;
+				break;
+			}
+			next_record_handle = rsp->next_record_handle;
+			co_return 0;
+		}
+		if (!rsp->next_data_transfer_handle || !rsp->response_count) {
+			rc = -EPROTO;
+			break;
+		}
+		xfer = rsp->next_data_transfer_handle;
+		op = PLDM_XFER_OP_GET_NEXT_PART;
+	}
+	out.len = start;
+	co_return rc;
+}
+
+/**
+ * qsfp_read() - Read QSFP module memory of one NIC
+ * @page: Upper page select
+ * @addr: Start address; the read may span the lower/upper boundary
+ *
+ * Both halves are requested together when the read spans the boundary.
+ *
+ * Return: 0 or a negative errno
+ */
+inline task<int> qsfp_read(loop &l, struct cuc_xport *x, u8 nic, u8 page, u8 addr, void *buf, unsigned int count,
+			   cancel_token *ct = nullptr)
+{
+	constexpr unsigned int half = CUC_QSFP_PAGE_SIZE;
+	struct cuc_xport_req r[2];
+	unsigned int n = 0, off, len;
+	int rc;
+
+	if (!count || addr + count > 2 * half)
+		co_return -EINVAL;
+	for (off = 0; off < count; off += len) {
+		unsigned int a = addr + off;
+
+		len = count - off;
+		if (a < half && len > half - a)
+			len = half - a;
+		cuc_qsfp_read_req_init(&r[n++], nic, page, (u8)a, (u8)len);
+	}
+	rc = co_await l.exec_all(x, r, n, ct);
+	if (rc)
+		co_return rc;
+	for (unsigned int i = 0, o = 0; i < n; i++) {
+		len = r[i].req.data[3];
+		if (cuc_xport_rsp_len(&r[i]) < len)
+			co_return -EPROTO;
+		std::memcpy(static_cast<u8 *>(buf) + o, r[i].rsp.data, len);
+		o += len;
+	}
+	co_return 0;
+}
+
+/**
+ * firmware_update() - Start, download and wait for a firmware update
+ * @image: Image to send, CUC_DATA_BYTES per FIRMWARE_UPDATE_DOWNLOAD
+ * @fwu_status: Receives the last FWU_STATUS_* reported
+ * @timeout_us: Overall limit for verification and flashing
+ *
+ * Downloads are pipelined in windows of 'window' chunks. The status is polled with a
+ * backoff from CUC_FWU_POLL_MIN_US up to CUC_FWU_POLL_MAX_US, reset whenever the
+ * status changes. Unlike struct cuc_fwu, there is no checkpoint or version check.
+ *
+ * Return: 0 when the uC reports FWU_STATUS_SUCCESS, -EIO when it reports a failed or
+ * idle state, -ETIMEDOUT, -ECANCELED, or a transport error
+ */
+inline task<int> firmware_update(loop &l, struct cuc_xport *x, u8 nic, u8 slot, const u8 *image, u32 size,
+				 u8 &fwu_status, u64 timeout_us, cancel_token *ct = nullptr)
+{
+	constexpr unsigned int window = 8;
+	struct cuc_firmware_update_start_req rq;
+	struct cuc_firmware_update_status_rsp st;
+	struct cuc_xport_req r[window];
+	u64 poll_us = CUC_FWU_POLL_MIN_US, end;
+	u32 sent = 0;
+	int rc;
+
+	fwu_status = FWU_STATUS_IDLE;
+	rq.nic = nic;
+	rq.size = size;
+	rq.slot = slot;
+	cuc_xport_req_init(&r[0], CUC_CMD_FIRMWARE_UPDATE_START, &rq, sizeof(rq));
+	rc = co_await l.exec(x, r[0], ct);
+	if (rc)
+		co_return rc;
+	fwu_status = FWU_STATUS_STARTED;
+
+	while (sent < size) {
+		unsigned int n;
+
+		for (n = 0; n < window && sent < size; n++) {
+			u32 len = size - sent < CUC_DATA_BYTES ? size - sent : CUC_DATA_BYTES;
+
+			cuc_xport_req_init(&r[n], CUC_CMD_FIRMWARE_UPDATE_DOWNLOAD, image + sent, len);
+			sent += len;
+		}
+		rc = co_await l.exec_all(x, r, n, ct);
+		if (rc)
+			co_return rc;
+	}
+	fwu_status = FWU_STATUS_DOWNLOADING;
+
+	end = cuc_xport_now_us() + timeout_us;
+	for (;;) {
+		rc = co_await l.sleep_for(poll_us, ct);
+		if (rc)
+			co_return rc;
+		cuc_xport_req_init(&r[0], CUC_CMD_FIRMWARE_UPDATE_STATUS, nullptr, 0);
+		rc = co_await l.exec(x, r[0], ct);
+		if (rc)
+			co_return rc;
+		if (cuc_xport_rsp_len(&r[0]) < sizeof(st))
+			co_return -EPROTO;
+		std::memcpy(&st, r[0].rsp.data, sizeof(st));
+
+		if (st.status == FWU_STATUS_SUCCESS) {
+			fwu_status = st.status;
+			co_return 0;
+		}
+		if (st.status >= FWU_STATUS_IDLE) {
+			/* IDLE here means the uC lost the update, e.g. it was reset */
+			fwu_status = st.status;
+			co_return -EIO;
+		}
+		if (st.status != fwu_status)
+			poll_us = CUC_FWU_POLL_MIN_US;
+		else if (poll_us < CUC_FWU_POLL_MAX_US)
+			poll_us = poll_us * 2 < CUC_FWU_POLL_MAX_US ? poll_us * 2 : CUC_FWU_POLL_MAX_US;
+		fwu_status = st.status;
+		if (cuc_xport_now_us() >= end)
+			co_return -ETIMEDOUT;
+	}
+}
+
+} /* namespace co */
+} /* namespace cuc */
+
+#endif /* CUC_CO_HPP */
@@ -0,0 +1,364 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* This file implements a cached inventory of uC firmware component versions.
+ *
+ * For each NIC, the inventory holds the running version and the versions stored
+ * in FW_SLOT_0 and FW_SLOT_1 of every firmware component in the board's blob.
+ * Components are listed by CAS1_BLOB_FW_TARGETS or CAS2_BLOB_FW_TARGETS, chosen by
+ * the board type reported by CUC_CMD_BOARD_INFO. Targets the board cannot have
+ * are never queried. A target that the uC reports as absent (ENOENT) is cached
+ * like a version, so only real failures are queried again.
+ *
+ * Queries go out through the pipelined transport. Each inventory keeps up to
+ * CUC_FW_INV_DEPTH CUC_CMD_FIRMWARE_VERSION requests in flight and issues the next
+ * one as each completes. cuc_fw_inv_refresh_all() runs many cards at once. Once
+ * an inventory is complete, a refresh costs no uC traffic until something
+ * invalidates it:
+ *
+ *  - ATT1_UC_RESET, reported through cuc_fw_inv_intr(), drops everything;
+ *  - cuc_fw_inv_uc_reset() sends CUC_CMD_RESET and drops everything;
+ *  - cuc_fw_inv_invalidate_slot() drops one slot after a firmware update of it;
+ *    a cuc_fwu_job whose 'inv' is set does this when it finishes.
+ *
+ * Each (NIC, copy) has a generation that every invalidation of it bumps, and each
+ * query records the generation it was issued under. A response that comes back
+ * after its entry was invalidated describes the old contents, so it is dropped and
+ * the refresh reports -EAGAIN.
+ */
+
+#ifndef CUC_FW_INVENTORY_H
+#define CUC_FW_INVENTORY_H
+
+#include <errno.h>
+#include <string.h>
+
+#include "cuc_cxi.h"
+#include "cuc_xport.h"
+
+#define CUC_FW_INV_MAX_NICS     2
+#define CUC_FW_INV_VERSION_LEN  32
+#define CUC_FW_INV_DEPTH        16
+
+/* Which copy of a component an entry describes */
+enum {
+	CUC_FW_INV_RUNNING,
+	CUC_FW_INV_SLOT0,
+	CUC_FW_INV_SLOT1,
+	CUC_FW_INV_COPIES
+};
+
+#define CUC_FW_INV_ALL_COPIES  ((1u << CUC_FW_INV_COPIES) - 1)
+
+enum cuc_fw_inv_state {
+	CUC_FW_INV_UNKNOWN,     /* Not queried since the last invalidation */
+	CUC_FW_INV_VALID,       /* 'version' holds the reported version */
+	CUC_FW_INV_ABSENT,      /* The uC has no such component */
+	CUC_FW_INV_ERROR,       /* The query failed; retried on the next refresh */
+};
+
+static const u8 cuc_fw_inv_cas1_targets[] = { CAS1_BLOB_FW_TARGETS };
+static const u8 cuc_fw_inv_cas2_targets[] = { CAS2_BLOB_FW_TARGETS };
+
+struct cuc_fw_inv_entry {
+	u8 state;
+	int err;                                   /* Status of the last failed query */
+	char version[CUC_FW_INV_VERSION_LEN];      /* NUL terminated */
+};
+
+/**
+ * struct cuc_fw_inv - Firmware inventory of the NICs behind one uC
+ */
+struct cuc_fw_inv {
+	struct cuc_xport *x;
+	u8 num_nics;
+	u8 copies;                  /* CUC_FW_INV_* bits to collect */
+	int board_type;             /* CUC_BOARD_TYPE_*, UNKNOWN until read */
+	const u8 *targets;
+	unsigned int ntargets;
+
+	struct cuc_fw_inv_entry entry[CUC_FW_INV_MAX_NICS][CUC_FW_INV_COPIES][FW_NUM_ENTRIES];
+
+	/* Refresh state */
+	unsigned int cursor;        /* Next (nic, copy, target) index to consider */
+	unsigned int inflight;
+	int err;                    /* First failure of the current refresh */
+	struct cuc_xport_req reqs[CUC_FW_INV_DEPTH];
+	u32 req_gen[CUC_FW_INV_DEPTH];  /* Generation of each request's entry when issued */
+	u32 free_mask;
+	u32 gen[CUC_FW_INV_MAX_NICS][CUC_FW_INV_COPIES];
+
+	/* Counters */
+	unsigned long queries;
+	unsigned long cached;       /* Entries served without a query */
+	unsigned long invalidations;
+	unsigned long dropped;      /* Responses that arrived after an invalidation */
+};
+
+static inline void cuc_fw_inv_init(struct cuc_fw_inv *inv, struct cuc_xport *x, u8 num_nics)
+{
+	memset(inv, 0, sizeof(*inv));
+	inv->x = x;
+	inv->num_nics = num_nics > CUC_FW_INV_MAX_NICS ? CUC_FW_INV_MAX_NICS : num_nics;
+	inv->copies = CUC_FW_INV_ALL_COPIES;
+	inv->board_type = CUC_BOARD_TYPE_UNKNOWN;
+	inv->free_mask = (1u << CUC_FW_INV_DEPTH) - 1;
+}
+
+/* Use a board type already known to the caller, which saves the CUC_CMD_BOARD_INFO */
+static inline int cuc_fw_inv_set_board_type(struct cuc_fw_inv *inv, int board_type)
+{
+	if (is_cas1_board_type(board_type)) {
+		inv->targets = cuc_fw_inv_cas1_targets;
+		inv->ntargets = sizeof(cuc_fw_inv_cas1_targets);
+	} else if (is_cas2_board_type(board_type)) {
+		inv->targets = cuc_fw_inv_cas2_targets;
+		inv->ntargets = sizeof(cuc_fw_inv_cas2_targets);
+	} else {
+		return -EINVAL;
+	}
+	inv->board_type = board_type;
+	return 0;
+}
+
+/* Forget every cached entry */
+static inline void cuc_fw_inv_invalidate(struct cuc_fw_inv *inv)
+{
+	unsigned int nic, copy;
+
+	memset(inv->entry, 0, sizeof(inv->entry));
+	for (nic = 0; nic < CUC_FW_INV_MAX_NICS; nic++)
+		for (copy = 0; copy < CUC_FW_INV_COPIES; copy++)
+			inv->gen[nic][copy]++;
+	inv->invalidations++;
+}
+
+/* Forget the stored versions of one slot, e.g. after cuc_fwu rewrote it */
+static inline void cuc_fw_inv_invalidate_slot(struct cuc_fw_inv *inv, u8 nic, u8 slot)
+{
+	if (nic >= CUC_FW_INV_MAX_NICS || slot >= FW_SLOT_MAX)
+		return;
+	memset(inv->entry[nic][CUC_FW_INV_SLOT0 + slot], 0, sizeof(inv->entry[nic][0]));
+	inv->gen[nic][CUC_FW_INV_SLOT0 + slot]++;
+	inv->invalidations++;
+}
+
+/* For a cuc_intr handler: a uC reset may have changed every running version */
+static inline void cuc_fw_inv_intr(struct cuc_fw_inv *inv, u8 nic, u32 isr)
+{
+	(void)nic;
+	if (isr & ATT1_UC_RESET)
+		cuc_fw_inv_invalidate(inv);
+}
+
+/**
+ * cuc_fw_inv_uc_reset() - Reset the uC and drop the inventory
+ *
+ * Return: 0 on success or a negative errno
+ */
+static inline int cuc_fw_inv_uc_reset(struct cuc_fw_inv *inv)
+{
+	struct cuc_xport_req r;
+	int rc;
+
+	cuc_xport_req_init(&r, CUC_CMD_RESET, NULL, 0);
+	rc = cuc_xport_exec(inv->x, &r);
+	/* Even a failed reset may have taken effect */
+	cuc_fw_inv_invalidate(inv);
+	return rc;
+}
+
+/**
+ * cuc_fw_inv_get() - Look up a cached entry
+ * @inv: Inventory
+ * @target: enum casuc_fw_target
+ * @nic: NIC
+ * @copy: CUC_FW_INV_RUNNING, CUC_FW_INV_SLOT0 or CUC_FW_INV_SLOT1
+ *
+ * Return: The entry, or NULL if the arguments are out of range
+ */
+static inline const struct cuc_fw_inv_entry *cuc_fw_inv_get(const struct cuc_fw_inv *inv, unsigned int target,
+							     unsigned int nic, unsigned int copy)
+{
+	if (target >= FW_NUM_ENTRIES || nic >= inv->num_nics || copy >= CUC_FW_INV_COPIES)
+		return NULL;
+	return &inv->entry[nic][copy][target];
+}
+
+static inline void cuc_fw_inv_req_done(struct cuc_xport_req *r);
+
+/* Issue queries for entries that are not cached, up to the in-flight limit */
+static inline void cuc_fw_inv_fill(struct cuc_fw_inv *inv)
+{
+	unsigned int total = inv->num_nics * CUC_FW_INV_COPIES * inv->ntargets;
+
+	while (inv->free_mask && inv->cursor < total) {
+		unsigned int idx = inv->cursor++;
+		unsigned int t = inv->targets[idx % inv->ntargets];
+		unsigned int copy = (idx / inv->ntargets) % CUC_FW_INV_COPIES;
+		unsigned int nic = idx / (inv->ntargets * CUC_FW_INV_COPIES);
+		struct cuc_fw_inv_entry *e = &inv->entry[nic][copy][t];
+		struct cuc_get_firmware_version_req rq;
+		struct cuc_xport_req *r;
+
+		if (!(inv->copies & (1u << copy)))
+			continue;
+		if (e->state == CUC_FW_INV_VALID || e->state == CUC_FW_INV_ABSENT) {
+			inv->cached++;
+			continue;
+		}
+
+		r = &inv->reqs[__builtin_ctz(inv->free_mask)];
+		rq.fw_target = (u8)t;
+		rq.nic = (u8)nic;
+		rq.from_flash = copy != CUC_FW_INV_RUNNING;
+		rq.slot = copy == CUC_FW_INV_RUNNING ? 0 : (u8)(copy - CUC_FW_INV_SLOT0);
+		cuc_xport_req_init(r, CUC_CMD_FIRMWARE_VERSION, &rq, sizeof(rq));
+		r->done = cuc_fw_inv_req_done;
+		r->priv = inv;
+		inv->req_gen[r - inv->reqs] = inv->gen[nic][copy];
+		inv->free_mask &= ~(1u << (unsigned int)(r - inv->reqs));
+		inv->inflight++;
+		inv->queries++;
+		if (cuc_xport_submit(inv->x, &r, 1) < 0) {
+			inv->free_mask |= 1u << (unsigned int)(r - inv->reqs);
+			inv->inflight--;
+			inv->err = inv->err ? inv->err : -EBUSY;
+			break;
+		}
+	}
+}
+
+/* Store a version response and keep the pipeline full */
+static inline void cuc_fw_inv_req_done(struct cuc_xport_req *r)
+{
+	struct cuc_fw_inv *inv = (struct cuc_fw_inv *)r->priv;
+	struct cuc_get_firmware_version_req rq;
+	struct cuc_fw_inv_entry *e;
+	unsigned int len, copy;
+
+	memcpy(&rq, r->req.data, sizeof(rq));
+	copy = rq.from_flash ? CUC_FW_INV_SLOT0 + rq.slot : CUC_FW_INV_RUNNING;
+	e = &inv->entry[rq.nic][copy][rq.fw_target];
+	inv->free_mask |= 1u << (unsigned int)(r - inv->reqs);
+	inv->inflight--;
+
+	if (inv->req_gen[r - inv->reqs] != inv->gen[rq.nic][copy]) {
+		/* The entry was invalidated while this query was out; it stays unknown */
+		inv->dropped++;
+		if (!inv->err)
+			inv->err = -EAGAIN;
+	} else if (r->status == -ENOENT) {
+		e->state = CUC_FW_INV_ABSENT;
+		e->version[0] = 0;
+	} else if (r->status < 0) {
+		e->state = CUC_FW_INV_ERROR;
+		e->err = r->status;
+		if (!inv->err)
+			inv->err = r->status;
+	} else {
+		len = cuc_xport_rsp_len(r);
+		if (len >= CUC_FW_INV_VERSION_LEN)
+			len = CUC_FW_INV_VERSION_LEN - 1;
+		memcpy(e->version, r->rsp.data, len);
+		e->version[len] = 0;
+		e->state = CUC_FW_INV_VALID;
+	}
+	cuc_fw_inv_fill(inv);
+}
+
+/* Begin a refresh; the board type must be known */
+static inline void cuc_fw_inv_start(struct cuc_fw_inv *inv)
+{
+	inv->cursor = 0;
+	inv->err = 0;
+	cuc_fw_inv_fill(inv);
+}
+
+/* Board type from a completed CUC_CMD_BOARD_INFO */
+static inline int cuc_fw_inv_board_info(struct cuc_fw_inv *inv, const struct cuc_xport_req *r)
+{
+	struct cuc_board_info_rsp bi;
+
+	if (r->status < 0)
+		return r->status;
+	if (cuc_xport_rsp_len(r) < sizeof(bi))
+		return -EPROTO;
+	memcpy(&bi, r->rsp.data, sizeof(bi));
+	return cuc_fw_inv_set_board_type(inv, (s8)bi.board_type);
+}
+
+/**
+ * cuc_fw_inv_refresh_all() - Bring many inventories up to date at once
+ * @invs: Inventories, each on its own transport
+ * @n: Number of inventories
+ *
+ * Board types are read first where unknown (one pipelined round), then every
+ * inventory queries its missing entries concurrently. Up to date inventories send
+ * nothing.
+ *
+ * Return: 0 if every entry is known, otherwise the first error seen (entries that
+ *         failed are in state CUC_FW_INV_ERROR), -EAGAIN if entries were
+ *         invalidated while being queried
+ */
+static inline int cuc_fw_inv_refresh_all(struct cuc_fw_inv **invs, unsigned int n)
+{
+	unsigned int i, busy;
+	int err = 0, rc;
+
+	for (i = 0; i < n; i++) {
+		struct cuc_xport_req *r = &invs[i]->reqs[0];
+
+		if (invs[i]->targets)
+			continue;
+		cuc_xport_req_init(r, CUC_CMD_BOARD_INFO, NULL, 0);
+		rc = cuc_xport_submit(invs[i]->x, &r, 1);
+		if (rc < 0)
+			r->status = rc;
+	}
+	for (i = 0; i < n; i++) {
+		if (invs[i]->targets)
+			continue;
+		cuc_xport_wait(invs[i]->x, &invs[i]->reqs[0]);
+		rc = cuc_fw_inv_board_info(invs[i], &invs[i]->reqs[0]);
+		if (rc < 0 && !err)
+			err = rc;
+	}
+
+	for (i = 0; i < n; i++)
+		if (invs[i]->targets)
+			cuc_fw_inv_start(invs[i]);
+
+	do {
+		busy = 0;
+		for (i = 0; i < n; i++) {
+			if (!invs[i]->inflight)
+				continue;
+			rc = cuc_xport_progress(invs[i]->x, n == 1 ? CUC_XPORT_DEFAULT_TIMEOUT_US : 100);
+			if (rc < 0) {
+				/* The transport failed: issue nothing more, let the rest expire */
+				invs[i]->cursor = ~0u;
+				if (!invs[i]->err)
+					invs[i]->err = rc;
+			}
+			busy |= invs[i]->inflight != 0;
+		}
+	} while (busy);
+
+	for (i = 0; i < n; i++)
+		if (invs[i]->err && !err)
+			err = invs[i]->err;
+	return err;
+}
+
+/**
+ * cuc_fw_inv_refresh() - Bring one inventory up to date
+ *
+ * Return: 0 if every entry is known, otherwise the first error seen
+ */
+static inline int cuc_fw_inv_refresh(struct cuc_fw_inv *inv)
+{
+	return cuc_fw_inv_refresh_all(&inv, 1);
+}
+
+#endif /* CUC_FW_INVENTORY_H */
@@ -0,0 +1,935 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* This file implements a host-side firmware update engine for the Cassini uC.
+ *
+ * An update is CUC_CMD_FIRMWARE_UPDATE_START, the image in CUC_DATA_BYTES chunks
+ * through CUC_CMD_FIRMWARE_UPDATE_DOWNLOAD, then CUC_CMD_FIRMWARE_UPDATE_STATUS until
+ * the FWU_STATUS_* state machine reaches SUCCESS or one of the FAILED states.
+ *
+ * The image is mmap()ed rather than read into a buffer, and each chunk is written
+ * straight from the mapping into its request packet. Downloads are pipelined through
+ * cuc_xport.h, so the transport window stays full instead of waiting a round trip
+ * per chunk. Any number of jobs (one per NIC and FW_SLOT_*) can be queued across any
+ * number of uC interfaces; at most 'max_active' run at once, and at most one per
+ * interface, since each uC has a single update state machine. While the uC is
+ * verifying or flashing, the status poll interval backs off exponentially as long as
+ * the state does not change, and snaps back to the minimum when it does.
+ *
+ * A job can carry a manifest of the component versions in its image. Before anything
+ * is transferred, the engine reads the stored version of each listed casuc_fw_target
+ * from the target slot (cuc_get_firmware_version_req with from_flash=1) and skips the
+ * job if they all match. A job can also name a checkpoint file, which records how
+ * much of the image the uC has acknowledged. Chunks go out in segments of
+ * CUC_FWU_CKPT_CHUNKS: before each segment the window is drained and the record,
+ * naming both the acknowledged offset and the end of the segment about to be sent,
+ * is written and synced. A record is only resumable when the two are equal, which is
+ * the case when a job stopped with every chunk it sent acknowledged; after a crash
+ * mid-segment the uC may hold any prefix up to the segment end, so the download
+ * starts over. If a download can resume and the uC is still in
+ * FWU_STATUS_DOWNLOADING when the job is run again, it continues from the checkpoint
+ * instead of byte zero. A resumed update that then fails is retried once from the
+ * start, since the uC cannot report how many bytes it holds. The uC refuses a new
+ * FIRMWARE_UPDATE_START with EBUSY while an abandoned update is still in progress, so
+ * a job that follows an earlier attempt on the same NIC and slot resets the uC first.
+ * A job given a cuc_fw_inv drops the inventory's entries for its slot when it
+ * finishes, unless it never sent any of the image.
+ *
+ * Like cuc_xport.h, the engine does not allocate and takes no locks; jobs are owned by
+ * the caller and everything runs from cuc_fwu_run() on one thread.
+ */
+
+#ifndef CUC_FWU_H
+#define CUC_FWU_H
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cuc_cxi.h"
+#include "cuc_fw_inventory.h"
+#include "cuc_xport.h"
+
+/* Download chunks kept in flight per job (the interface window may be smaller) */
+#define CUC_FWU_DEPTH                 CUC_XPORT_MAX_INFLIGHT
+
+#define CUC_FWU_POLL_MIN_US           (2 * 1000)
+#define CUC_FWU_POLL_MAX_US           (500 * 1000)
+#define CUC_FWU_DEFAULT_TIMEOUT_US    (15ULL * 60 * 1000 * 1000)
+
+#define CUC_FWU_VERSION_LEN           32
+
+#define CUC_FWU_FNV_BASIS             0xCBF29CE484222325ULL
+
+#define CUC_FWU_CKPT_MAGIC            0x43555746  /* "FWUC" */
+#define CUC_FWU_CKPT_VERSION          3
+#define CUC_FWU_CKPT_CHUNKS           256         /* Download chunks per checkpoint */
+
+/**
+ * struct cuc_fwu_image - A firmware image mapped from a file
+ */
+struct cuc_fwu_image {
+	const u8 *data;
+	size_t size;
+};
+
+/**
+ * struct cuc_fwu_manifest - Component versions contained in an image
+ *
+ * Indexed by enum casuc_fw_target; targets with an empty string are not checked.
+ */
+struct cuc_fwu_manifest {
+	char version[FW_NUM_ENTRIES][CUC_FWU_VERSION_LEN];
+};
+
+/**
+ * struct cuc_fwu_ckpt - Download checkpoint file contents
+ */
+struct cuc_fwu_ckpt {
+	u32 magic;
+	u16 version;
+	u8 nic;
+	u8 slot;
+	u32 image_size;
+	u32 acked;        /* Image bytes the uC has acknowledged */
+	u32 sent;         /* Image bytes possibly sent; resumable only if equal to acked */
+	u64 acked_sum;    /* FNV-1a of the first 'acked' image bytes */
+} __packed;
+
+/**
+ * cuc_fwu_image_open() - Map a firmware image
+ *
+ * Return: 0 on success, -EFBIG if the image does not fit the u32 size of
+ *         struct cuc_firmware_update_start_req, or another negative errno
+ */
+static inline int cuc_fwu_image_open(struct cuc_fwu_image *img, const char *path)
+{
+	struct stat st;
+	void *map;
+	int fd;
+
+	memset(img, 0, sizeof(*img));
+
+	fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return -errno;
+	if (fstat(fd, &st) < 0) {
+		close(fd);
+		return -errno;
+	}
+	if (st.st_size == 0 || (u64)st.st_size > 0xFFFFFFFFULL) {
+		close(fd);
+		return st.st_size ? -EFBIG : -EINVAL;
+	}
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+		return -errno;
+
+	/* Every job reads the image front to back */
+	madvise(map, st.st_size, MADV_SEQUENTIAL | MADV_WILLNEED);
+	img->data = (const u8 *)map;
+	img->size = st.st_size;
+	return 0;
+}
+
+/* FNV-1a of 'len' more bytes. Checkpoints identify the image by the hash of the part
+ * the uC holds, which is computed as chunks are sent rather than over the whole
+ * mapping up front.
+ */
+static inline u64 cuc_fwu_fnv(u64 sum, const u8 *p, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++)
+		sum = (sum ^ p[i]) * 0x100000001B3ULL;
+	return sum;
+}
+
+static inline void cuc_fwu_image_close(struct cuc_fwu_image *img)
+{
+	if (img->data)
+		munmap((void *)img->data, img->size);
+	memset(img, 0, sizeof(*img));
+}
+
+/**
+ * cuc_fwu_manifest_set() - Record the version of one component of an image
+ *
+ * Return: 0 on success, -EINVAL for an unknown target or an over-long version
+ */
+static inline int cuc_fwu_manifest_set(struct cuc_fwu_manifest *m, unsigned int target, const char *version)
+{
+	size_t len = strlen(version);
+
+	if (target >= FW_NUM_ENTRIES || len >= CUC_FWU_VERSION_LEN)
+		return -EINVAL;
+	memset(m->version[target], 0, CUC_FWU_VERSION_LEN);
+	memcpy(m->version[target], version, len);
+	return 0;
+}
+
+enum {
+	CUC_FWU_JOB_QUEUED,       /* Waiting for a free slot */
+	CUC_FWU_JOB_CHECKING,     /* Comparing stored versions against the manifest */
+	CUC_FWU_JOB_PROBING,      /* Checking whether a checkpointed download can resume */
+	CUC_FWU_JOB_RESETTING,    /* CUC_CMD_RESET outstanding to abandon an earlier update */
+	CUC_FWU_JOB_STARTING,     /* FIRMWARE_UPDATE_START outstanding */
+	CUC_FWU_JOB_DOWNLOADING,  /* Streaming chunks */
+	CUC_FWU_JOB_POLLING,      /* Waiting for the uC to verify and flash */
+	CUC_FWU_JOB_DONE,
+};
+
+struct cuc_fwu_job;
+
+typedef void (*cuc_fwu_done_fn)(struct cuc_fwu_job *job);
+
+/**
+ * struct cuc_fwu_job - One image to one NIC and slot
+ *
+ * On completion 'status' is 0 on success (including a skipped job), -EIO if the uC
+ * reported a FWU_STATUS_FAILED_* state (kept in 'fwu_status'), or the negative errno
+ * of the request that failed.
+ */
+struct cuc_fwu_job {
+	struct cuc_xport *x;             /* Interface of the uC that owns the NIC */
+	const struct cuc_fwu_image *img;
+	u8 nic;
+	u8 slot;                         /* FW_SLOT_* */
+	u64 timeout_us;                  /* Whole-update timeout, 0 for the default */
+	const struct cuc_fwu_manifest *manifest;  /* Optional, enables skipping */
+	const char *ckpt_path;           /* Optional, enables resuming */
+	struct cuc_fw_inv *inv;          /* Optional, its slot entries are dropped when done */
+	cuc_fwu_done_fn done;            /* Optional completion callback */
+	void *priv;
+
+	/* Results */
+	int status;
+	u8 fwu_status;                   /* Last FWU_STATUS_* seen */
+	u8 skipped;                      /* The slot already held the manifest versions */
+	u8 resumed;                      /* The download continued from the checkpoint */
+	u32 resume_offset;
+	u64 start_us;
+	u64 end_us;
+	unsigned long polls;
+
+	/* Engine private */
+	struct cuc_fwu *fwu;
+	struct cuc_fwu_job *next;
+	u8 state;                        /* CUC_FWU_JOB_* */
+	u32 sent;                        /* Image bytes queued for download */
+	u32 acked;                       /* Image bytes the uC has accepted */
+	u64 sent_sum;                    /* FNV-1a of the first 'sent' image bytes */
+	unsigned int inflight;           /* Requests of this job on the interface */
+	u32 poll_us;                     /* Current status poll interval */
+	u64 next_poll_us;
+	u32 free_mask;                   /* Idle entries of reqs[] */
+	u8 mismatch;                     /* A stored version differs from the manifest */
+	u8 restarted;                    /* A failed resume has been retried from zero */
+	u8 stale;                        /* The checkpoint names an earlier download to the slot */
+	u8 reset;                        /* The uC has been reset by this attempt */
+	u32 ckpt_end;                    /* Image offset at which the next checkpoint is due */
+	int ckpt_fd;
+	struct cuc_fwu_ckpt ckpt;
+	struct cuc_xport_req reqs[CUC_FWU_DEPTH];
+};
+
+/**
+ * struct cuc_fwu - Update engine
+ */
+struct cuc_fwu {
+	unsigned int max_active;         /* Jobs allowed to run at once */
+	u32 poll_min_us;
+	u32 poll_max_us;
+
+	struct cuc_fwu_job *queued;      /* In cuc_fwu_add() order */
+	struct cuc_fwu_job *active;
+	unsigned int nqueued;
+	unsigned int nactive;
+
+	/* Counters */
+	unsigned long completed;
+	unsigned long failed;
+	unsigned long chunks;
+	unsigned long polls;
+	unsigned long skipped;
+	unsigned long resumed;
+	u64 bytes_saved;                 /* Image bytes not transferred thanks to skip/resume */
+};
+
+static inline void cuc_fwu_init(struct cuc_fwu *f, unsigned int max_active)
+{
+	memset(f, 0, sizeof(*f));
+	f->max_active = max_active ? max_active : 1;
+	f->poll_min_us = CUC_FWU_POLL_MIN_US;
+	f->poll_max_us = CUC_FWU_POLL_MAX_US;
+}
+
+/**
+ * cuc_fwu_job_init() - Describe one update
+ * @job: Job
+ * @x: Interface of the uC the NIC is attached to
+ * @img: Image, which must stay mapped until the job is done
+ * @nic: NIC to update
+ * @slot: FW_SLOT_* to write
+ */
+static inline void cuc_fwu_job_init(struct cuc_fwu_job *job, struct cuc_xport *x,
+				    const struct cuc_fwu_image *img, u8 nic, u8 slot)
+{
+	memset(job, 0, sizeof(*job));
+	job->x = x;
+	job->img = img;
+	job->nic = nic;
+	job->slot = slot;
+	job->fwu_status = FWU_STATUS_IDLE;
+	job->ckpt_fd = -1;
+}
+
+/**
+ * cuc_fwu_ckpt_path() - Build the conventional checkpoint path of a card, NIC and slot
+ * @buf: Output buffer
+ * @len: Size of @buf
+ * @dir: Checkpoint directory
+ * @card: Stable card identifier, e.g. its serial number or bus address
+ * @nic: NIC
+ * @slot: FW_SLOT_*
+ *
+ * Return: 0 on success, -ENAMETOOLONG if @buf is too small
+ */
+static inline int cuc_fwu_ckpt_path(char *buf, size_t len, const char *dir, const char *card,
+				    unsigned int nic, unsigned int slot)
+{
+	int n = snprintf(buf, len, "%s/%s-nic%u-slot%u.fwu", dir, card, nic, slot);
+
+	return n < 0 || (size_t)n >= len ? -ENAMETOOLONG : 0;
+}
+
+/**
+ * cuc_fwu_add() - Queue a job
+ *
+ * Return: 0 on success, -EINVAL for an image the uC cannot take, -EBUSY if the job
+ *         is already queued or running
+ */
+static inline int cuc_fwu_add(struct cuc_fwu *f, struct cuc_fwu_job *job)
+{
+	struct cuc_fwu_job **p;
+
+	if (!job->img || !job->img->size || job->img->size > 0xFFFFFFFFULL || job->slot >= FW_SLOT_MAX)
+		return -EINVAL;
+	if (job->fwu == f && job->state != CUC_FWU_JOB_DONE)
+		return -EBUSY;
+
+	job->fwu = f;
+	job->state = CUC_FWU_JOB_QUEUED;
+	job->status = 0;
+	job->restarted = 0;
+	job->next = NULL;
+	for (p = &f->queued; *p; p = &(*p)->next)
+		;
+	*p = job;
+	f->nqueued++;
+	return 0;
+}
+
+static inline struct cuc_xport_req *cuc_fwu_req_get(struct cuc_fwu_job *job)
+{
+	unsigned int i;
+
+	if (!job->free_mask)
+		return NULL;
+	i = __builtin_ctz(job->free_mask);
+	job->free_mask &= ~(1u << i);
+	return &job->reqs[i];
+}
+
+static inline void cuc_fwu_req_put(struct cuc_fwu_job *job, struct cuc_xport_req *r)
+{
+	job->free_mask |= 1u << (unsigned int)(r - job->reqs);
+}
+
+/* Write and sync the record. Checkpointing is best effort: on an error the job
+ * carries on without one.
+ */
+static inline void cuc_fwu_ckpt_write(struct cuc_fwu_job *job, u32 sent)
+{
+	/* Only written with the window drained, where the hash of 'sent' covers 'acked' */
+	job->ckpt.acked = job->acked;
+	job->ckpt.sent = sent;
+	job->ckpt.acked_sum = job->sent_sum;
+	if (pwrite(job->ckpt_fd, &job->ckpt, sizeof(job->ckpt), 0) != (ssize_t)sizeof(job->ckpt) ||
+	    fdatasync(job->ckpt_fd) < 0) {
+		close(job->ckpt_fd);
+		job->ckpt_fd = -1;
+	}
+}
+
+/* Begin a checkpoint segment. The window is drained (acked == sent) and the record
+ * names the end of the segment before any of it is sent.
+ */
+static inline void cuc_fwu_ckpt_save(struct cuc_fwu_job *job)
+{
+	u32 size = (u32)job->img->size;
+	u32 end = job->acked + CUC_FWU_CKPT_CHUNKS * CUC_DATA_BYTES;
+
+	job->ckpt_end = end > size || end < job->acked ? size : end;
+	if (job->ckpt_fd < 0) {
+		job->ckpt_end = size;
+		return;
+	}
+	cuc_fwu_ckpt_write(job, job->ckpt_end);
+	if (job->ckpt_fd < 0)
+		job->ckpt_end = size;
+}
+
+/* Open the checkpoint file. Returns the offset the previous run reached with this
+ * image, NIC and slot, or 0 if there is nothing to resume.
+ */
+static inline u32 cuc_fwu_ckpt_open(struct cuc_fwu_job *job)
+{
+	struct cuc_fwu_ckpt old;
+	int same, valid;
+
+	job->stale = 0;
+	if (!job->ckpt_path)
+		return 0;
+	job->ckpt_fd = open(job->ckpt_path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+	if (job->ckpt_fd < 0)
+		return 0;
+
+	job->ckpt.magic = CUC_FWU_CKPT_MAGIC;
+	job->ckpt.version = CUC_FWU_CKPT_VERSION;
+	job->ckpt.nic = job->nic;
+	job->ckpt.slot = job->slot;
+	job->ckpt.image_size = (u32)job->img->size;
+	job->ckpt.acked = 0;
+	job->ckpt.sent = 0;
+	job->ckpt.acked_sum = 0;
+
+	/* An earlier download into this NIC and slot, with this image or not */
+	same = pread(job->ckpt_fd, &old, sizeof(old), 0) == (ssize_t)sizeof(old) &&
+	       old.magic == job->ckpt.magic && old.version == job->ckpt.version &&
+	       old.nic == job->ckpt.nic && old.slot == job->ckpt.slot;
+	valid = same && old.image_size == job->ckpt.image_size &&
+		old.acked == old.sent && old.acked && old.acked < old.image_size;
+	job->stale = same;
+	if (!valid)
+		return 0;
+
+	/* The uC must hold the same bytes as the start of this image */
+	job->sent_sum = cuc_fwu_fnv(CUC_FWU_FNV_BASIS, job->img->data, old.acked);
+	return job->sent_sum == old.acked_sum ? old.acked : 0;
+}
+
+/* Keep the checkpoint of a job that failed once its requests are all back. If every
+ * chunk sent was acknowledged, the uC holds exactly 'acked' bytes and the record is
+ * made resumable.
+ */
+static inline void cuc_fwu_ckpt_stop(struct cuc_fwu_job *job)
+{
+	if (job->ckpt_fd < 0)
+		return;
+	if (job->acked && job->acked == job->sent && job->acked < job->img->size)
+		cuc_fwu_ckpt_write(job, job->acked);
+	if (job->ckpt_fd >= 0) {
+		close(job->ckpt_fd);
+		job->ckpt_fd = -1;
+	}
+}
+
+static inline void cuc_fwu_ckpt_close(struct cuc_fwu_job *job, int remove)
+{
+	if (job->ckpt_fd < 0)
+		return;
+	close(job->ckpt_fd);
+	job->ckpt_fd = -1;
+	if (remove)
+		unlink(job->ckpt_path);
+}
+
+static inline void cuc_fwu_finish(struct cuc_fwu_job *job, int status)
+{
+	if (job->state == CUC_FWU_JOB_DONE)
+		return;
+	/* The first error sticks; later completions of the same job are ignored */
+	job->status = status;
+	job->state = CUC_FWU_JOB_DONE;
+	job->end_us = cuc_xport_now_us();
+	/* A failed job keeps its checkpoint, see cuc_fwu_ckpt_stop() */
+	if (!status)
+		cuc_fwu_ckpt_close(job, 1);
+}
+
+static inline void cuc_fwu_req_done(struct cuc_xport_req *r);
+
+static inline int cuc_fwu_submit(struct cuc_fwu_job *job, struct cuc_xport_req *r)
+{
+	int rc;
+
+	r->done = cuc_fwu_req_done;
+	r->priv = job;
+	job->inflight++;
+	rc = cuc_xport_submit(job->x, &r, 1);
+	if (rc < 0) {
+		job->inflight--;
+		cuc_fwu_req_put(job, r);
+		cuc_fwu_finish(job, rc);
+	}
+	return rc;
+}
+
+/* Send one request of the job. The job fails with -EBUSY if all of its requests are
+ * in use, which the state machine should never allow.
+ */
+static inline int cuc_fwu_send(struct cuc_fwu_job *job, u8 cmd, const void *data, unsigned int len)
+{
+	struct cuc_xport_req *r = cuc_fwu_req_get(job);
+
+	if (!r) {
+		cuc_fwu_finish(job, -EBUSY);
+		return -EBUSY;
+	}
+	cuc_xport_req_init(r, cmd, data, len);
+	return cuc_fwu_submit(job, r);
+}
+
+/* Queue download chunks until the job's requests are all in use or the image is sent */
+static inline void cuc_fwu_fill(struct cuc_fwu_job *job)
+{
+	struct cuc_xport_req *r;
+	u32 n;
+
+	while (job->state == CUC_FWU_JOB_DOWNLOADING && job->sent < job->img->size) {
+		if (job->sent == job->ckpt_end) {
+			/* Wait for the segment to be acknowledged before checkpointing */
+			if (job->acked != job->sent)
+				return;
+			cuc_fwu_ckpt_save(job);
+		}
+		r = cuc_fwu_req_get(job);
+		if (!r)
+			return;
+		n = job->ckpt_end - job->sent;
+		if (n > CUC_DATA_BYTES)
+			n = CUC_DATA_BYTES;
+		/* The only copy of the image: mapping to request packet */
+		cuc_xport_req_init(r, CUC_CMD_FIRMWARE_UPDATE_DOWNLOAD, job->img->data + job->sent, n);
+		job->sent_sum = cuc_fwu_fnv(job->sent_sum, job->img->data + job->sent, n);
+		job->sent += n;
+		job->fwu->chunks++;
+		if (cuc_fwu_submit(job, r) < 0)
+			return;
+	}
+}
+
+static inline int cuc_fwu_send_status(struct cuc_fwu_job *job)
+{
+	job->polls++;
+	job->fwu->polls++;
+	return cuc_fwu_send(job, CUC_CMD_FIRMWARE_UPDATE_STATUS, NULL, 0);
+}
+
+static inline void cuc_fwu_poll(struct cuc_fwu_job *job, u64 now)
+{
+	if (job->state != CUC_FWU_JOB_POLLING || job->inflight || now < job->next_poll_us)
+		return;
+	cuc_fwu_send_status(job);
+}
+
+static inline int cuc_fwu_send_start(struct cuc_fwu_job *job)
+{
+	struct cuc_firmware_update_start_req rq;
+
+	job->state = CUC_FWU_JOB_STARTING;
+	job->sent = 0;
+	job->acked = 0;
+	job->sent_sum = CUC_FWU_FNV_BASIS;
+	job->ckpt_end = 0;
+	job->resumed = 0;
+
+	rq.nic = job->nic;
+	rq.size = (u32)job->img->size;
+	rq.slot = job->slot;
+	return cuc_fwu_send(job, CUC_CMD_FIRMWARE_UPDATE_START, &rq, sizeof(rq));
+}
+
+/* Abandon an update the uC is still running from an earlier attempt; a reset is the
+ * only way to take its update state machine out of FWU_STATUS_DOWNLOADING.
+ */
+static inline int cuc_fwu_send_reset(struct cuc_fwu_job *job)
+{
+	job->state = CUC_FWU_JOB_RESETTING;
+	job->reset = 1;
+	return cuc_fwu_send(job, CUC_CMD_RESET, NULL, 0);
+}
+
+/* Resume from the checkpoint if there is one, otherwise start the update */
+static inline void cuc_fwu_prepare(struct cuc_fwu_job *job)
+{
+	u32 off = cuc_fwu_ckpt_open(job);
+
+	if (off && !job->restarted) {
+		job->resume_offset = off;
+		job->state = CUC_FWU_JOB_PROBING;
+		cuc_fwu_send_status(job);
+		return;
+	}
+	cuc_fwu_send_start(job);
+}
+
+/* Read the stored version of every component listed in the manifest from the target slot */
+static inline void cuc_fwu_check_versions(struct cuc_fwu_job *job)
+{
+	struct cuc_get_firmware_version_req rq;
+	struct cuc_xport_req *reqs[FW_NUM_ENTRIES];
+	unsigned int t, n = 0;
+	int rc;
+
+	for (t = 0; t < FW_NUM_ENTRIES; t++) {
+		if (!job->manifest->version[t][0])
+			continue;
+		rq.fw_target = (u8)t;
+		rq.nic = job->nic;
+		rq.from_flash = 1;
+		rq.slot = job->slot;
+		reqs[n] = cuc_fwu_req_get(job);
+		if (!reqs[n]) {
+			while (n)
+				cuc_fwu_req_put(job, reqs[--n]);
+			cuc_fwu_finish(job, -EBUSY);
+			return;
+		}
+		cuc_xport_req_init(reqs[n], CUC_CMD_FIRMWARE_VERSION, &rq, sizeof(rq));
+		reqs[n]->done = cuc_fwu_req_done;
+		reqs[n]->priv = job;
+		n++;
+	}
+	if (!n) {
+		cuc_fwu_prepare(job);
+		return;
+	}
+
+	job->state = CUC_FWU_JOB_CHECKING;
+	job->inflight += n;
+	rc = cuc_xport_submit(job->x, reqs, n);
+	if (rc < 0) {
+		for (t = 0; t < n; t++)
+			cuc_fwu_req_put(job, reqs[t]);
+		job->inflight -= n;
+		cuc_fwu_finish(job, rc);
+	}
+}
+
+static inline void cuc_fwu_version_rsp(struct cuc_fwu_job *job, struct cuc_xport_req *r)
+{
+	const char *want = job->manifest->version[r->req.data[0]];
+	size_t len = r->status < 0 ? 0 : strnlen((const char *)r->rsp.data, cuc_xport_rsp_len(r));
+
+	/* A missing version (ENOENT) or a failed read counts as a mismatch */
+	if (!len || len != strlen(want) || memcmp(r->rsp.data, want, len) != 0)
+		job->mismatch = 1;
+
+	if (job->inflight)
+		return;
+	if (!job->mismatch) {
+		job->skipped = 1;
+		cuc_fwu_finish(job, 0);
+		return;
+	}
+	cuc_fwu_prepare(job);
+}
+
+static inline void cuc_fwu_probe_rsp(struct cuc_fwu_job *job, struct cuc_xport_req *r)
+{
+	struct cuc_firmware_update_status_rsp st;
+
+	if (r->status < 0 || cuc_xport_rsp_len(r) < sizeof(st)) {
+		cuc_fwu_send_start(job);
+		return;
+	}
+	memcpy(&st, r->rsp.data, sizeof(st));
+	if (st.status != FWU_STATUS_DOWNLOADING) {
+		cuc_fwu_send_start(job);
+		return;
+	}
+
+	job->resumed = 1;
+	job->sent = job->resume_offset;
+	job->acked = job->resume_offset;
+	job->ckpt_end = job->resume_offset;
+	job->fwu_status = st.status;
+	job->state = CUC_FWU_JOB_DOWNLOADING;
+	cuc_fwu_fill(job);
+}
+
+static inline void cuc_fwu_status_rsp(struct cuc_fwu_job *job, struct cuc_xport_req *r)
+{
+	struct cuc_fwu *f = job->fwu;
+	struct cuc_firmware_update_status_rsp st;
+	u64 now = cuc_xport_now_us();
+
+	if (cuc_xport_rsp_len(r) < sizeof(st)) {
+		cuc_fwu_finish(job, -EPROTO);
+		return;
+	}
+	memcpy(&st, r->rsp.data, sizeof(st));
+
+	if (st.status == FWU_STATUS_SUCCESS) {
+		job->fwu_status = st.status;
+		cuc_fwu_finish(job, 0);
+		return;
+	}
+	if (st.status >= FWU_STATUS_IDLE) {
+		/* IDLE here means the uC lost the update, e.g. it was reset */
+		job->fwu_status = st.status;
+		cuc_fwu_finish(job, -EIO);
+		return;
+	}
+
+	if (st.status != job->fwu_status)
+		job->poll_us = f->poll_min_us;
+	else if (job->poll_us < f->poll_max_us)
+		job->poll_us = job->poll_us * 2 < f->poll_max_us ? job->poll_us * 2 : f->poll_max_us;
+	job->fwu_status = st.status;
+	job->next_poll_us = now + job->poll_us;
+}
+
+/* struct cuc_xport_req done() for every request issued by the engine */
+static inline void cuc_fwu_req_done(struct cuc_xport_req *r)
+{
+	struct cuc_fwu_job *job = (struct cuc_fwu_job *)r->priv;
+
+	job->inflight--;
+	cuc_fwu_req_put(job, r);
+	if (job->state == CUC_FWU_JOB_DONE) {
+		/* Chunks still count after a failure, for cuc_fwu_ckpt_stop() */
+		if (r->req.cmd == CUC_CMD_FIRMWARE_UPDATE_DOWNLOAD && !r->status)
+			job->acked += r->req.count - 1;
+		return;
+	}
+
+	/* Version checks and the resume probe only decide how to proceed */
+	if (job->state == CUC_FWU_JOB_CHECKING) {
+		cuc_fwu_version_rsp(job, r);
+		return;
+	}
+	if (job->state == CUC_FWU_JOB_PROBING) {
+		cuc_fwu_probe_rsp(job, r);
+		return;
+	}
+	/* The uC is still busy with an update this NIC and slot were given earlier */
+	if (r->req.cmd == CUC_CMD_FIRMWARE_UPDATE_START && r->status == -EBUSY &&
+	    (job->stale || job->restarted) && !job->reset) {
+		cuc_fwu_send_reset(job);
+		return;
+	}
+	if (r->status < 0) {
+		cuc_fwu_finish(job, r->status);
+		return;
+	}
+
+	switch (r->req.cmd) {
+	case CUC_CMD_RESET:
+		cuc_fwu_send_start(job);
+		break;
+	case CUC_CMD_FIRMWARE_UPDATE_START:
+		job->state = CUC_FWU_JOB_DOWNLOADING;
+		job->fwu_status = FWU_STATUS_STARTED;
+		cuc_fwu_fill(job);
+		break;
+	case CUC_CMD_FIRMWARE_UPDATE_DOWNLOAD:
+		job->acked += r->req.count - 1;
+		if (job->acked == job->img->size) {
+			job->state = CUC_FWU_JOB_POLLING;
+			job->fwu_status = FWU_STATUS_DOWNLOADING;
+			job->poll_us = job->fwu->poll_min_us;
+			job->next_poll_us = cuc_xport_now_us() + job->poll_us;
+		} else {
+			cuc_fwu_fill(job);
+		}
+		break;
+	case CUC_CMD_FIRMWARE_UPDATE_STATUS:
+		cuc_fwu_status_rsp(job, r);
+		break;
+	}
+}
+
+static inline void cuc_fwu_start(struct cuc_fwu_job *job)
+{
+	if (!job->restarted)
+		job->start_us = cuc_xport_now_us();
+	job->end_us = 0;
+	job->sent = 0;
+	job->acked = 0;
+	job->inflight = 0;
+	job->polls = 0;
+	job->mismatch = 0;
+	job->skipped = 0;
+	job->resumed = 0;
+	job->resume_offset = 0;
+	job->reset = 0;
+	job->ckpt_end = 0;
+	job->fwu_status = FWU_STATUS_IDLE;
+	job->free_mask = CUC_FWU_DEPTH >= 32 ? 0xFFFFFFFFu : (1u << CUC_FWU_DEPTH) - 1;
+
+	if (job->manifest && !job->restarted)
+		cuc_fwu_check_versions(job);
+	else
+		cuc_fwu_prepare(job);
+}
+
+/* True if another running job already owns the job's uC */
+static inline int cuc_fwu_xport_busy(const struct cuc_fwu *f, const struct cuc_fwu_job *job)
+{
+	const struct cuc_fwu_job *a;
+
+	for (a = f->active; a; a = a->next)
+		if (a->x == job->x)
+			return 1;
+	return 0;
+}
+
+/* Move queued jobs to the active list while there is room */
+static inline void cuc_fwu_admit(struct cuc_fwu *f)
+{
+	struct cuc_fwu_job **p = &f->queued;
+	struct cuc_fwu_job *job;
+
+	while (f->nactive < f->max_active && (job = *p) != NULL) {
+		if (cuc_fwu_xport_busy(f, job)) {
+			p = &job->next;
+			continue;
+		}
+		*p = job->next;
+		f->nqueued--;
+		job->next = f->active;
+		f->active = job;
+		f->nactive++;
+		cuc_fwu_start(job);
+	}
+}
+
+/* Retire finished jobs whose requests have all come back */
+static inline void cuc_fwu_reap(struct cuc_fwu *f)
+{
+	struct cuc_fwu_job **p = &f->active;
+	struct cuc_fwu_job *job;
+
+	while ((job = *p) != NULL) {
+		if (job->state != CUC_FWU_JOB_DONE || job->inflight) {
+			p = &job->next;
+			continue;
+		}
+		cuc_fwu_ckpt_stop(job);
+		/* An image the uC rejects after a resume is sent again in full, once */
+		if (job->status && job->resumed && !job->restarted) {
+			job->restarted = 1;
+			cuc_fwu_start(job);
+			p = &job->next;
+			continue;
+		}
+		*p = job->next;
+		job->next = NULL;
+		f->nactive--;
+		if (job->status) {
+			f->failed++;
+		} else {
+			f->completed++;
+			if (job->skipped) {
+				f->skipped++;
+				f->bytes_saved += job->img->size;
+			} else if (job->resumed) {
+				f->resumed++;
+				f->bytes_saved += job->resume_offset;
+			}
+		}
+		/* Even a failed download may have changed what the slot holds */
+		if (job->inv && job->sent)
+			cuc_fw_inv_invalidate_slot(job->inv, job->nic, job->slot);
+		if (job->done)
+			job->done(job);
+	}
+}
+
+/**
+ * cuc_fwu_step() - Make progress on every running job
+ * @f: Engine
+ * @timeout_us: Maximum time to block waiting for the uCs
+ *
+ * Return: Number of jobs not yet done
+ */
+static inline unsigned int cuc_fwu_step(struct cuc_fwu *f, long timeout_us)
+{
+	struct cuc_xport *wait_x = NULL;
+	struct cuc_fwu_job *job;
+	unsigned int nbusy = 0;
+	int progressed = 0;
+	u64 now, wake;
+
+	cuc_fwu_admit(f);
+	now = cuc_xport_now_us();
+	wake = now + (timeout_us > 0 ? (u64)timeout_us : 0);
+
+	for (job = f->active; job; job = job->next) {
+		u64 limit = job->timeout_us ? job->timeout_us : CUC_FWU_DEFAULT_TIMEOUT_US;
+
+		if (job->state != CUC_FWU_JOB_DONE && now > job->start_us + limit)
+			cuc_fwu_finish(job, -ETIMEDOUT);
+		cuc_fwu_poll(job, now);
+		if (job->state == CUC_FWU_JOB_POLLING && !job->inflight && job->next_poll_us < wake)
+			wake = job->next_poll_us;
+	}
+
+	/* Collect whatever has already arrived on every interface */
+	for (job = f->active; job; job = job->next) {
+		if (!job->inflight)
+			continue;
+		if (cuc_xport_progress(job->x, 0) > 0)
+			progressed = 1;
+		if (job->inflight) {
+			nbusy++;
+			wait_x = job->x;
+		}
+	}
+
+	/* Nothing ready: block on the single busy interface, or sleep briefly */
+	now = cuc_xport_now_us();
+	if (!progressed && wake > now) {
+		long wait = (long)(wake - now);
+
+		if (nbusy == 1) {
+			cuc_xport_progress(wait_x, wait);
+		} else {
+			struct timespec ts = { 0, 0 };
+
+			if (nbusy && wait > 100)
+				wait = 100;
+			ts.tv_sec = wait / 1000000;
+			ts.tv_nsec = (wait % 1000000) * 1000;
+			nanosleep(&ts, NULL);
+		}
+	}
+
+	cuc_fwu_reap(f);
+	cuc_fwu_admit(f);
+	return f->nqueued + f->nactive;
+}
+
+/**
+ * cuc_fwu_run() - Run every queued job to completion
+ *
+ * Return: Number of jobs that failed
+ */
+static inline unsigned long cuc_fwu_run(struct cuc_fwu *f)
+{
+	unsigned long failed = f->failed;
+
+	while (cuc_fwu_step(f, f->poll_max_us))
+		;
+	return f->failed - failed;
+}
+
+#endif /* CUC_FWU_H */
@@ -0,0 +1,488 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* This file implements a bulk I2C engine on top of CUC_CMD_I2C_READ and
+ * CUC_CMD_I2C_WRITE.
+ *
+ * A caller describes what it wants as a scatter-gather list of (bus, addr, offset,
+ * len, buf) segments in any order. Segments of the same device that overlap or touch
+ * are merged into runs, and each run is cut into the largest transactions a packet
+ * can carry, so a full EEPROM image or a register map scattered over many small
+ * reads costs as few uC round trips as possible. All transactions are pipelined
+ * through cuc_xport.h.
+ *
+ * The first read of a run sets the device address pointer with a random-address
+ * read; the following ones are current-address reads that continue where the
+ * previous one stopped, which saves the address phase on the bus. This relies on the
+ * uC servicing one interface in order and on nothing else addressing the device
+ * while the batch runs.
+ *
+ * Traffic to QSFP_I2C_BUS_REDIRECT goes to the module of the NIC behind the uC,
+ * which the uC itself also polls. Such transfers always use 8-bit random-address
+ * reads and never span the lower/upper (128-byte) half boundary, as with
+ * CUC_CMD_QSFP_READ.
+ */
+
+#ifndef CUC_I2C_BULK_H
+#define CUC_I2C_BULK_H
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cuc_cxi.h"
+#include "cuc_xport.h"
+
+#define CUC_I2C_BULK_MAX_SEGS   1024
+#define CUC_I2C_BULK_MAX_DEVS   16
+#define CUC_I2C_BULK_WAVE       64     /* Transactions queued on the transport at once */
+
+/* Largest read; the count field is one byte and the data must fit in one response */
+#define CUC_I2C_READ_MAX        (CUC_DATA_BYTES < 255 ? CUC_DATA_BYTES : 255)
+
+/* Largest write payload after the request header and 'abytes' offset bytes */
+#define CUC_I2C_WRITE_MAX(abytes)  (CUC_DATA_BYTES - sizeof(struct cuc_i2c_write_req) - (abytes))
+
+#define CUC_I2C_REDIRECT_HALF   128
+
+/**
+ * struct cuc_i2c_seg - One element of a scatter-gather list
+ */
+struct cuc_i2c_seg {
+	u8 bus;                    /* I2C bus, or QSFP_I2C_BUS_REDIRECT */
+	u8 addr;                   /* 7-bit slave address */
+	u32 offset;                /* Register offset in the device */
+	u32 len;
+	void *buf;                 /* Read into, or written from */
+	int status;                /* Set on completion */
+};
+
+/**
+ * struct cuc_i2c_dev_cfg - Addressing properties of one device
+ */
+struct cuc_i2c_dev_cfg {
+	u8 bus;
+	u8 addr;
+	u8 addr16;                 /* 16-bit register offsets */
+	u16 write_page;            /* Writes may not cross a multiple of this, 0 for no limit */
+};
+
+struct cuc_i2c_run {
+	u8 bus;
+	u8 addr;
+	u16 first;                 /* Range of the run's segments in 'ord' */
+	u16 last;
+	u32 start;
+	u32 end;
+	int status;
+};
+
+/**
+ * struct cuc_i2c_bulk - Bulk I2C engine for one uC transport
+ */
+struct cuc_i2c_bulk {
+	struct cuc_xport *x;
+	u32 gap_max;               /* Read runs are also merged across gaps up to this size */
+	struct cuc_i2c_dev_cfg dev[CUC_I2C_BULK_MAX_DEVS];
+	unsigned int ndevs;
+
+	/* Scratch for one call */
+	u64 key[CUC_I2C_BULK_MAX_SEGS];
+	u16 ord[CUC_I2C_BULK_MAX_SEGS];
+	struct cuc_i2c_run run[CUC_I2C_BULK_MAX_SEGS];
+	struct cuc_xport_req req[CUC_I2C_BULK_WAVE];
+	u16 xrun[CUC_I2C_BULK_WAVE];
+	u32 xoff[CUC_I2C_BULK_WAVE];
+
+	/* Counters */
+	unsigned long segs;
+	unsigned long runs;
+	unsigned long reads;       /* Transactions */
+	unsigned long writes;
+	unsigned long bytes;
+};
+
+static inline void cuc_i2c_bulk_init(struct cuc_i2c_bulk *b, struct cuc_xport *x)
+{
+	memset(b, 0, sizeof(*b));
+	b->x = x;
+}
+
+/**
+ * cuc_i2c_bulk_set_dev() - Describe a device
+ * @b: Engine
+ * @bus: I2C bus
+ * @addr: 7-bit slave address
+ * @addr16: Non-zero if the device takes 16-bit register offsets
+ * @write_page: Write page size of an EEPROM, 0 for no limit
+ *
+ * Devices that are not described use 8-bit offsets and no write page limit.
+ *
+ * Return: 0 on success, -EINVAL for 16-bit offsets on QSFP_I2C_BUS_REDIRECT, -ENOSPC
+ * when the table is full
+ */
+static inline int cuc_i2c_bulk_set_dev(struct cuc_i2c_bulk *b, u8 bus, u8 addr, int addr16, u16 write_page)
+{
+	struct cuc_i2c_dev_cfg *d;
+	unsigned int i;
+
+	if (bus == QSFP_I2C_BUS_REDIRECT && addr16)
+		return -EINVAL;
+	for (i = 0; i < b->ndevs; i++)
+		if (b->dev[i].bus == bus && b->dev[i].addr == addr)
+			break;
+	if (i == b->ndevs) {
+		if (i == CUC_I2C_BULK_MAX_DEVS)
+			return -ENOSPC;
+		b->ndevs++;
+	}
+	d = &b->dev[i];
+	d->bus = bus;
+	d->addr = addr;
+	d->addr16 = addr16 ? 1 : 0;
+	d->write_page = write_page;
+	return 0;
+}
+
+static inline struct cuc_i2c_dev_cfg cuc_i2c_bulk_dev(const struct cuc_i2c_bulk *b, u8 bus, u8 addr)
+{
+	struct cuc_i2c_dev_cfg d = { bus, addr, 0, 0 };
+	unsigned int i;
+
+	for (i = 0; i < b->ndevs; i++)
+		if (b->dev[i].bus == bus && b->dev[i].addr == addr)
+			return b->dev[i];
+	return d;
+}
+
+/* Whether a transaction slot may be rebuilt: the transport no longer holds it */
+static inline int cuc_i2c_bulk_req_free(const struct cuc_xport_req *r)
+{
+	return r->state != CUC_XPORT_REQ_PENDING && r->state != CUC_XPORT_REQ_INFLIGHT;
+}
+
+static inline int cuc_i2c_bulk_cmp_u64(const void *a, const void *b)
+{
+	u64 x = *(const u64 *)a, y = *(const u64 *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+static inline int cuc_i2c_bulk_cmp_u16(const void *a, const void *b)
+{
+	return (int)*(const u16 *)a - (int)*(const u16 *)b;
+}
+
+/*
+ * Validate the segments, sort them by (bus, addr, offset) and merge them into runs.
+ * Segments closer than 'gap' join a run. Returns the number of runs or a negative errno.
+ */
+static inline int cuc_i2c_bulk_plan(struct cuc_i2c_bulk *b, struct cuc_i2c_seg *segs, unsigned int n, u32 gap)
+{
+	unsigned int i, nruns = 0;
+	struct cuc_i2c_run *run = NULL;
+
+	if (n > CUC_I2C_BULK_MAX_SEGS)
+		return -E2BIG;
+	/* Transactions of an earlier call are still owned by the transport */
+	for (i = 0; i < CUC_I2C_BULK_WAVE; i++)
+		if (!cuc_i2c_bulk_req_free(&b->req[i]))
+			return -EBUSY;
+	for (i = 0; i < n; i++) {
+		struct cuc_i2c_seg *s = &segs[i];
+		struct cuc_i2c_dev_cfg d = cuc_i2c_bulk_dev(b, s->bus, s->addr);
+		u32 limit = d.addr16 ? 0x10000u : 0x100u;
+
+		if (!s->len || s->offset >= limit || s->len > limit - s->offset)
+			return -EINVAL;
+		s->status = 0;
+		b->key[i] = (u64)s->bus << 56 | (u64)s->addr << 48 | (u64)s->offset << 16 | i;
+	}
+	qsort(b->key, n, sizeof(b->key[0]), cuc_i2c_bulk_cmp_u64);
+
+	for (i = 0; i < n; i++) {
+		const struct cuc_i2c_seg *s = &segs[b->key[i] & 0xFFFF];
+
+		b->ord[i] = (u16)(b->key[i] & 0xFFFF);
+		if (run && run->bus == s->bus && run->addr == s->addr && s->offset <= run->end + gap) {
+			if (s->offset + s->len > run->end)
+				run->end = s->offset + s->len;
+			run->last = (u16)i;
+			continue;
+		}
+		run = &b->run[nruns++];
+		run->bus = s->bus;
+		run->addr = s->addr;
+		run->first = (u16)i;
+		run->last = (u16)i;
+		run->start = s->offset;
+		run->end = s->offset + s->len;
+		run->status = 0;
+	}
+	b->segs += n;
+	b->runs += nruns;
+	return (int)nruns;
+}
+
+/*
+ * Submit the queued transactions and wait for each one; its status is the result of
+ * the wait. Returns 0, or the submit error, in which case nothing was sent.
+ */
+static inline int cuc_i2c_bulk_exec(struct cuc_i2c_bulk *b, unsigned int n)
+{
+	struct cuc_xport_req *reqs[CUC_I2C_BULK_WAVE];
+	unsigned int i;
+	int rc;
+
+	for (i = 0; i < n; i++)
+		reqs[i] = &b->req[i];
+	rc = cuc_xport_submit(b->x, reqs, n);
+	if (rc < 0)
+		return rc;
+	for (i = 0; i < n; i++)
+		b->req[i].status = cuc_xport_wait(b->x, reqs[i]);
+	return 0;
+}
+
+/* Fail every run without a result yet, after a wave could not be submitted */
+static inline void cuc_i2c_bulk_fail(struct cuc_i2c_bulk *b, unsigned int nruns, int err)
+{
+	unsigned int r;
+
+	for (r = 0; r < nruns; r++)
+		if (!b->run[r].status)
+			b->run[r].status = err;
+}
+
+/* Copy the data of a completed read to the segments of its run that overlap it */
+static inline void cuc_i2c_bulk_scatter(struct cuc_i2c_bulk *b, struct cuc_i2c_seg *segs, unsigned int x)
+{
+	struct cuc_i2c_run *run = &b->run[b->xrun[x]];
+	const struct cuc_xport_req *r = &b->req[x];
+	u32 lo = b->xoff[x], hi = lo + r->req.data[3];
+	unsigned int i;
+
+	if (run->status)
+		return;
+	if (r->status) {
+		run->status = r->status;
+		return;
+	}
+	if (cuc_xport_rsp_len(r) < r->req.data[3]) {
+		run->status = -EPROTO;
+		return;
+	}
+
+	for (i = run->first; i <= run->last; i++) {
+		struct cuc_i2c_seg *s = &segs[b->ord[i]];
+		u32 a = s->offset > lo ? s->offset : lo;
+		u32 e = s->offset + s->len < hi ? s->offset + s->len : hi;
+
+		if (s->offset >= hi)
+			break;
+		if (a < e)
+			memcpy((u8 *)s->buf + (a - s->offset), r->rsp.data + (a - lo), e - a);
+	}
+}
+
+/* Record each run's status in its segments. Returns the first error in list order. */
+static inline int cuc_i2c_bulk_status(struct cuc_i2c_bulk *b, struct cuc_i2c_seg *segs, unsigned int n,
+				      unsigned int nruns)
+{
+	unsigned int r, i;
+
+	for (r = 0; r < nruns; r++)
+		for (i = b->run[r].first; i <= b->run[r].last; i++)
+			segs[b->ord[i]].status = b->run[r].status;
+	for (i = 0; i < n; i++)
+		if (segs[i].status)
+			return segs[i].status;
+	return 0;
+}
+
+/* Run a wave of reads and copy out what they returned. Returns 0 or the submit error. */
+static inline int cuc_i2c_bulk_read_wave(struct cuc_i2c_bulk *b, struct cuc_i2c_seg *segs, unsigned int n)
+{
+	unsigned int i;
+	int rc;
+
+	rc = cuc_i2c_bulk_exec(b, n);
+	if (rc)
+		return rc;
+	for (i = 0; i < n; i++)
+		cuc_i2c_bulk_scatter(b, segs, i);
+	b->reads += n;
+	return 0;
+}
+
+/* Run a wave of writes and record their errors in their runs. Returns 0 or the submit error. */
+static inline int cuc_i2c_bulk_write_wave(struct cuc_i2c_bulk *b, unsigned int n)
+{
+	unsigned int i;
+	int rc;
+
+	rc = cuc_i2c_bulk_exec(b, n);
+	if (rc)
+		return rc;
+	for (i = 0; i < n; i++)
+		if (b->req[i].status && !b->run[b->xrun[i]].status)
+			b->run[b->xrun[i]].status = b->req[i].status;
+	b->writes += n;
+	return 0;
+}
+
+/**
+ * cuc_i2c_bulk_read() - Read a scatter-gather list
+ * @b: Engine
+ * @segs: Segments, in any order; may overlap
+ * @n: Number of segments
+ *
+ * If a wave cannot be submitted, no further transaction is issued and every segment
+ * not read yet fails with the submit error.
+ *
+ * Return: 0 if every segment was read, otherwise the error of the first failed
+ * segment; each segment's own result is in its status field. -EBUSY if transactions
+ * of an earlier call are still outstanding.
+ */
+static inline int cuc_i2c_bulk_read(struct cuc_i2c_bulk *b, struct cuc_i2c_seg *segs, unsigned int n)
+{
+	unsigned int nx = 0, r;
+	int nruns, rc = 0;
+
+	nruns = cuc_i2c_bulk_plan(b, segs, n, b->gap_max);
+	if (nruns < 0)
+		return nruns;
+
+	for (r = 0; r < (unsigned int)nruns && !rc; r++) {
+		struct cuc_i2c_run *run = &b->run[r];
+		struct cuc_i2c_dev_cfg d = cuc_i2c_bulk_dev(b, run->bus, run->addr);
+		int redirect = run->bus == QSFP_I2C_BUS_REDIRECT;
+		u32 pos, len;
+
+		for (pos = run->start; pos < run->end && !rc; pos += len) {
+			struct cuc_i2c_read_req rq;
+
+			len = run->end - pos;
+			if (len > CUC_I2C_READ_MAX)
+				len = CUC_I2C_READ_MAX;
+			if (redirect && len > CUC_I2C_REDIRECT_HALF - pos % CUC_I2C_REDIRECT_HALF)
+				len = CUC_I2C_REDIRECT_HALF - pos % CUC_I2C_REDIRECT_HALF;
+
+			rq.bus = run->bus;
+			rq.addr = run->addr;
+			rq.count = (u8)len;
+			rq.offset = (u16)pos;
+			if (pos != run->start && !redirect)
+				rq.type = I2C_CURRENT_ADDR_READ;
+			else
+				rq.type = d.addr16 ? I2C_RANDOM_ADDR16_READ : I2C_RANDOM_ADDR8_READ;
+
+			cuc_xport_req_init(&b->req[nx], CUC_CMD_I2C_READ, &rq, sizeof(rq));
+			b->xrun[nx] = (u16)r;
+			b->xoff[nx] = pos;
+			b->bytes += len;
+			if (++nx == CUC_I2C_BULK_WAVE) {
+				rc = cuc_i2c_bulk_read_wave(b, segs, nx);
+				nx = 0;
+			}
+		}
+	}
+	if (!rc)
+		rc = cuc_i2c_bulk_read_wave(b, segs, nx);
+	if (rc)
+		cuc_i2c_bulk_fail(b, (unsigned int)nruns, rc);
+
+	return cuc_i2c_bulk_status(b, segs, n, (unsigned int)nruns);
+}
+
+/**
+ * cuc_i2c_bulk_write() - Write a scatter-gather list
+ * @b: Engine
+ * @segs: Segments, in any order; where they overlap, the later one in the list wins
+ * @n: Number of segments
+ *
+ * Writes are cut at the device's write page boundaries.
+ *
+ * Return: As cuc_i2c_bulk_read()
+ */
+static inline int cuc_i2c_bulk_write(struct cuc_i2c_bulk *b, struct cuc_i2c_seg *segs, unsigned int n)
+{
+	u8 pkt[CUC_DATA_BYTES];
+	struct cuc_i2c_write_req *wq = (struct cuc_i2c_write_req *)pkt;
+	unsigned int nx = 0, r, i;
+	int nruns, rc = 0;
+
+	nruns = cuc_i2c_bulk_plan(b, segs, n, 0);
+	if (nruns < 0)
+		return nruns;
+
+	for (r = 0; r < (unsigned int)nruns && !rc; r++) {
+		struct cuc_i2c_run *run = &b->run[r];
+		struct cuc_i2c_dev_cfg d = cuc_i2c_bulk_dev(b, run->bus, run->addr);
+		unsigned int abytes = d.addr16 ? 2 : 1;
+		u32 pos, len;
+
+		/* Offset order is no longer needed; apply overlapping segments in list order */
+		qsort(&b->ord[run->first], run->last - run->first + 1u, sizeof(b->ord[0]), cuc_i2c_bulk_cmp_u16);
+
+		for (pos = run->start; pos < run->end && !rc; pos += len) {
+			u8 *data = wq->buf + abytes;
+
+			len = run->end - pos;
+			if (len > CUC_I2C_WRITE_MAX(abytes))
+				len = CUC_I2C_WRITE_MAX(abytes);
+			if (d.write_page && len > d.write_page - pos % d.write_page)
+				len = d.write_page - pos % d.write_page;
+			if (run->bus == QSFP_I2C_BUS_REDIRECT &&
+			    len > CUC_I2C_REDIRECT_HALF - pos % CUC_I2C_REDIRECT_HALF)
+				len = CUC_I2C_REDIRECT_HALF - pos % CUC_I2C_REDIRECT_HALF;
+
+			wq->bus = run->bus;
+			wq->addr = run->addr;
+			wq->count = (u8)(abytes + len);
+			if (d.addr16) {
+				wq->buf[0] = (u8)(pos >> 8);
+				wq->buf[1] = (u8)pos;
+			} else {
+				wq->buf[0] = (u8)pos;
+			}
+			for (i = run->first; i <= run->last; i++) {
+				const struct cuc_i2c_seg *s = &segs[b->ord[i]];
+				u32 a = s->offset > pos ? s->offset : pos;
+				u32 e = s->offset + s->len < pos + len ? s->offset + s->len : pos + len;
+
+				if (a < e)
+					memcpy(data + (a - pos), (const u8 *)s->buf + (a - s->offset), e - a);
+			}
+
+			cuc_xport_req_init(&b->req[nx], CUC_CMD_I2C_WRITE, pkt, sizeof(*wq) + abytes + len);
+			b->xrun[nx] = (u16)r;
+			b->bytes += len;
+			if (++nx == CUC_I2C_BULK_WAVE) {
+				rc = cuc_i2c_bulk_write_wave(b, nx);
+				nx = 0;
+			}
+		}
+	}
+	if (!rc)
+		rc = cuc_i2c_bulk_write_wave(b, nx);
+	if (rc)
+		cuc_i2c_bulk_fail(b, (unsigned int)nruns, rc);
+
+	return cuc_i2c_bulk_status(b, segs, n, (unsigned int)nruns);
+}
+
+/**
+ * cuc_i2c_bulk_read_image() - Read a contiguous range of one device
+ *
+ * Return: 0 on success or a negative errno
+ */
+static inline int cuc_i2c_bulk_read_image(struct cuc_i2c_bulk *b, u8 bus, u8 addr, u32 offset,
+					  void *buf, u32 len)
+{
+	struct cuc_i2c_seg s = { bus, addr, offset, len, buf, 0 };
+
+	return cuc_i2c_bulk_read(b, &s, 1);
+}
+
+#endif /* CUC_I2C_BULK_H */
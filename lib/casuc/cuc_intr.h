@@ -0,0 +1,340 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* This file implements a host-side dispatcher for the uC ATT1 interrupts.
+ *
+ * The uC raises UC_ATTENTION[1] in C_PI_ERR_FLG when an enabled ATT1_* status bit is
+ * set for a NIC. Instead of polling CUC_CMD_GET_INTR on a timer, the host reports
+ * that attention with cuc_intr_attention() and then calls cuc_intr_service(). For
+ * each NIC that needs it, the dispatcher issues one GET_INTR (pipelined across NICs)
+ * and one CLEAR_ISR for the host-cleared bits it saw
+ * (HOST_CLEARED_ATT1_INTERRUPTS, never the self-clearing ATT1_QSFP_INT). It then
+ * calls the handlers registered for the bits that were set. Status is cleared before
+ * the handlers run, so an event that recurs while they run latches again and is not
+ * lost. An event that recurs between the GET_INTR and the CLEAR_ISR is cleared with
+ * the first one: the handlers run once, after both. A status bit says that something
+ * happened, not how often, so handlers should read the state they act on rather than
+ * count calls.
+ *
+ * With no attention pending, no requests are sent, except for an optional slow
+ * sweep of every NIC. The sweep bounds the latency of events that cannot raise
+ * attention, such as ATT1_ASIC_PWR_FAIL while the ASIC is off.
+ *
+ * Interrupt enables are kept in step with the registered handlers by
+ * cuc_intr_sync_ier(), so that bits nobody handles do not raise attention.
+ */
+
+#ifndef CUC_INTR_H
+#define CUC_INTR_H
+
+#include <errno.h>
+#include <string.h>
+
+#include "cuc_cxi.h"
+#include "cuc_xport.h"
+
+#define CUC_INTR_MAX_NICS      2
+#define CUC_INTR_MAX_HANDLERS  16
+
+#define CUC_INTR_DEFAULT_SWEEP_US  (5 * 1000 * 1000)
+
+struct cuc_intr;
+
+/* Called with the bits of 'mask' that were set in the NIC's ISR */
+typedef void (*cuc_intr_fn)(struct cuc_intr *d, u8 nic, u32 bits, void *priv);
+
+struct cuc_intr_handler {
+	u32 mask;          /* ATT1_* bits handled */
+	u32 nics;          /* Bit per NIC, 0 for all NICs */
+	cuc_intr_fn fn;
+	void *priv;
+};
+
+struct cuc_intr_nic {
+	u32 ier;           /* Enables last reported by the uC */
+	u32 isr;           /* Status read by the last GET_INTR */
+	u8 attention;      /* Service on the next cuc_intr_service() */
+	u8 ier_known;
+	u64 last_us;       /* Time of the last GET_INTR */
+};
+
+/**
+ * struct cuc_intr - ATT1 interrupt dispatcher for the NICs behind one uC
+ */
+struct cuc_intr {
+	struct cuc_xport *x;
+	u8 num_nics;
+	u64 sweep_us;                   /* Poll every NIC at least this often, 0 to disable */
+	struct cuc_intr_nic nic[CUC_INTR_MAX_NICS];
+	struct cuc_intr_handler handlers[CUC_INTR_MAX_HANDLERS];
+	unsigned int nhandlers;
+	struct cuc_xport_req reqs[CUC_INTR_MAX_NICS];
+
+	/* Counters */
+	unsigned long get_intr;
+	unsigned long clear_isr;
+	unsigned long update_ier;
+	unsigned long dispatched;
+	unsigned long events[32];       /* Times each ATT1 bit was seen set */
+};
+
+static inline void cuc_intr_init(struct cuc_intr *d, struct cuc_xport *x, u8 num_nics)
+{
+	unsigned int n;
+
+	memset(d, 0, sizeof(*d));
+	d->x = x;
+	d->num_nics = num_nics > CUC_INTR_MAX_NICS ? CUC_INTR_MAX_NICS : num_nics;
+	d->sweep_us = CUC_INTR_DEFAULT_SWEEP_US;
+	/* Status latched before we started (e.g. ATT1_UC_RESET) is picked up right away */
+	for (n = 0; n < d->num_nics; n++)
+		d->nic[n].attention = 1;
+}
+
+/**
+ * cuc_intr_register() - Add a handler
+ * @d: Dispatcher
+ * @mask: ATT1_* bits to handle
+ * @nics: Bit per NIC to handle, 0 for every NIC
+ * @fn: Handler
+ * @priv: Handler cookie
+ *
+ * Several handlers may cover the same bit; they are called in registration order.
+ *
+ * Return: 0 on success, -ENOSPC if the table is full
+ */
+static inline int cuc_intr_register(struct cuc_intr *d, u32 mask, u32 nics, cuc_intr_fn fn, void *priv)
+{
+	struct cuc_intr_handler *h;
+
+	if (d->nhandlers == CUC_INTR_MAX_HANDLERS)
+		return -ENOSPC;
+	h = &d->handlers[d->nhandlers++];
+	h->mask = mask;
+	h->nics = nics;
+	h->fn = fn;
+	h->priv = priv;
+	return 0;
+}
+
+/* Note that UC_ATTENTION[1] was seen for the NICs in 'nics' (bit per NIC) */
+static inline void cuc_intr_attention(struct cuc_intr *d, u32 nics)
+{
+	unsigned int n;
+
+	for (n = 0; n < d->num_nics; n++)
+		if (nics & (1u << n))
+			d->nic[n].attention = 1;
+}
+
+/* Union of the handler masks for one NIC */
+static inline u32 cuc_intr_wanted(const struct cuc_intr *d, u8 nic)
+{
+	u32 want = 0;
+	unsigned int i;
+
+	for (i = 0; i < d->nhandlers; i++)
+		if (!d->handlers[i].nics || (d->handlers[i].nics & (1u << nic)))
+			want |= d->handlers[i].mask;
+	return want;
+}
+
+/* Run reqs[0..n) as one pipelined batch. Returns the first error; every request
+ * holds its own status, including the submit error if nothing was sent.
+ */
+static inline int cuc_intr_exec(struct cuc_intr *d, unsigned int n)
+{
+	struct cuc_xport_req *reqs[CUC_INTR_MAX_NICS];
+	unsigned int i;
+	int rc, err = 0;
+
+	if (!n)
+		return 0;
+	for (i = 0; i < n; i++)
+		reqs[i] = &d->reqs[i];
+	rc = cuc_xport_submit(d->x, reqs, n);
+	if (rc < 0) {
+		for (i = 0; i < n; i++)
+			reqs[i]->status = rc;
+		return rc;
+	}
+	for (i = 0; i < n; i++) {
+		rc = cuc_xport_wait(d->x, reqs[i]);
+		if (rc < 0 && !err)
+			err = rc;
+	}
+	return err;
+}
+
+/**
+ * cuc_intr_update_ier() - Set and clear interrupt enables of one NIC
+ *
+ * Return: 0 on success or a negative errno
+ */
+static inline int cuc_intr_update_ier(struct cuc_intr *d, u8 nic, u32 set, u32 clear)
+{
+	struct cuc_update_ier_req_data rq;
+	int rc;
+
+	if (nic >= d->num_nics)
+		return -EINVAL;
+	rq.nic = nic;
+	rq.ier_set_bits = set;
+	rq.ier_clear_bits = clear;
+	cuc_xport_req_init(&d->reqs[0], CUC_CMD_UPDATE_IER, &rq, sizeof(rq));
+	d->update_ier++;
+	rc = cuc_intr_exec(d, 1);
+	if (rc == 0) {
+		d->nic[nic].ier = (d->nic[nic].ier | set) & ~clear;
+		/* Newly enabled bits may already be latched */
+		if (set)
+			d->nic[nic].attention = 1;
+	}
+	return rc;
+}
+
+/**
+ * cuc_intr_sync_ier() - Enable exactly the bits that have handlers
+ *
+ * Uses the enables read by the last GET_INTR, so call it after cuc_intr_service().
+ * ATT1_UC_RESET stays enabled regardless, so a uC restart is always noticed.
+ *
+ * Return: 0 on success or the first error
+ */
+static inline int cuc_intr_sync_ier(struct cuc_intr *d)
+{
+	unsigned int n;
+	int rc, err = 0;
+
+	for (n = 0; n < d->num_nics; n++) {
+		struct cuc_intr_nic *in = &d->nic[n];
+		u32 want = cuc_intr_wanted(d, (u8)n) | ATT1_UC_RESET;
+
+		if (in->ier_known && in->ier == want)
+			continue;
+		rc = cuc_intr_update_ier(d, (u8)n, want, in->ier_known ? in->ier & ~want : ~want);
+		if (rc < 0 && !err)
+			err = rc;
+		in->ier_known = rc == 0;
+	}
+	return err;
+}
+
+/**
+ * cuc_intr_next() - Time of the next sweep, for the caller's wait
+ *
+ * Return: Absolute time in microseconds, or 0 if a NIC needs service now
+ */
+static inline u64 cuc_intr_next(const struct cuc_intr *d)
+{
+	u64 next = (u64)-1;
+	unsigned int n;
+
+	for (n = 0; n < d->num_nics; n++) {
+		if (d->nic[n].attention)
+			return 0;
+		if (d->sweep_us && d->nic[n].last_us + d->sweep_us < next)
+			next = d->nic[n].last_us + d->sweep_us;
+	}
+	return next;
+}
+
+/**
+ * cuc_intr_service() - Read, clear and dispatch the interrupts of every NIC that needs it
+ * @d: Dispatcher
+ * @now: Current time from cuc_xport_now_us()
+ *
+ * A NIC whose GET_INTR fails is not dispatched. A NIC whose CLEAR_ISR fails is
+ * dispatched, since its status was read, and stays marked for service; the bits
+ * still latched are then dispatched again by the next call.
+ *
+ * Return: Number of handler calls made, or the first error of a GET_INTR or
+ *         CLEAR_ISR (the NIC stays marked for service)
+ */
+static inline int cuc_intr_service(struct cuc_intr *d, u64 now)
+{
+	u8 nics[CUC_INTR_MAX_NICS], cleared[CUC_INTR_MAX_NICS];
+	u32 isr[CUC_INTR_MAX_NICS];
+	unsigned int n, i, count = 0, nclear = 0;
+	int calls = 0, err, rc;
+
+	/* One GET_INTR per NIC that raised attention or is due for a sweep */
+	for (n = 0; n < d->num_nics; n++) {
+		struct cuc_intr_nic *in = &d->nic[n];
+		struct cuc_get_intr_req_data rq;
+
+		if (!in->attention && !(d->sweep_us && now >= in->last_us + d->sweep_us))
+			continue;
+		rq.nic = (u8)n;
+		cuc_xport_req_init(&d->reqs[count], CUC_CMD_GET_INTR, &rq, sizeof(rq));
+		nics[count++] = (u8)n;
+	}
+	if (!count)
+		return 0;
+	d->get_intr += count;
+	err = cuc_intr_exec(d, count);
+
+	for (i = 0; i < count; i++) {
+		struct cuc_xport_req *r = &d->reqs[i];
+		struct cuc_intr_nic *in = &d->nic[nics[i]];
+		struct cuc_get_intr_rsp_data ir;
+
+		isr[i] = 0;
+		if (r->status < 0)
+			continue;
+		if (cuc_xport_rsp_len(r) < sizeof(ir)) {
+			if (!err)
+				err = -EPROTO;
+			continue;
+		}
+		memcpy(&ir, r->rsp.data, sizeof(ir));
+		in->attention = 0;
+		in->last_us = now;
+		in->ier = ir.ier;
+		in->ier_known = 1;
+		in->isr = ir.isr;
+		isr[i] = ir.isr;
+	}
+
+	/* Acknowledge before dispatching, so a repeat of an event is latched again */
+	for (i = 0; i < count; i++) {
+		struct cuc_clear_isr_req_data rq;
+
+		if (!(isr[i] & HOST_CLEARED_ATT1_INTERRUPTS))
+			continue;
+		rq.nic = nics[i];
+		rq.isr_clear_bits = isr[i] & HOST_CLEARED_ATT1_INTERRUPTS;
+		cleared[nclear] = nics[i];
+		cuc_xport_req_init(&d->reqs[nclear++], CUC_CMD_CLEAR_ISR, &rq, sizeof(rq));
+	}
+	d->clear_isr += nclear;
+	rc = cuc_intr_exec(d, nclear);
+	if (rc < 0 && !err)
+		err = rc;
+	for (i = 0; i < nclear; i++)
+		if (d->reqs[i].status < 0)
+			d->nic[cleared[i]].attention = 1;
+
+	for (i = 0; i < count; i++) {
+		u32 bits = isr[i];
+
+		while (bits) {
+			d->events[__builtin_ctz(bits)]++;
+			bits &= bits - 1;
+		}
+		if (!isr[i])
+			continue;
+		for (n = 0; n < d->nhandlers; n++) {
+			struct cuc_intr_handler *h = &d->handlers[n];
+
+			if (!(h->mask & isr[i]) || (h->nics && !(h->nics & (1u << nics[i]))))
+				continue;
+			h->fn(d, nics[i], h->mask & isr[i], h->priv);
+			calls++;
+		}
+	}
+	d->dispatched += calls;
+	return err ? err : calls;
+}
+
+#endif /* CUC_INTR_H */
@@ -0,0 +1,463 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* This file implements a host-side collector for uC log messages.
+ *
+ * CUC_CMD_GET_LOG returns one message per request, or no data once the uC's queue is
+ * empty, and the uC drops its oldest message when that queue overflows. The
+ * collector keeps GET_LOG requests pipelined on each uC interface while messages keep
+ * coming. The number in flight doubles up to 'max_depth' during a burst and falls
+ * back to a single probe every 'idle_us' once the uC reports empty. New requests are
+ * only queued when the interface has nothing else pending, and one slot of the
+ * transport window is always left free, so a command from another user of the
+ * transport is sent at once. On a transport whose window is a single request, such
+ * a command can wait for one GET_LOG.
+ *
+ * Each message is stamped with the host time at which it arrived. It is appended
+ * to a compact spill file and published to an in-memory ring. The spill file keeps
+ * every message, stamped with the wall-clock time so that it can be read after a
+ * reboot. Records are buffered and written out at every cuc_log_poll(), so a crash
+ * loses at most the messages received since the previous poll. The ring has one
+ * producer (the thread driving the transports) and any number of consumers.
+ * Consumers tail it through their own cursor without locks and never block the
+ * producer. A consumer that falls more than a ring's worth behind is told how many
+ * entries it missed, and can recover them from the spill file.
+ */
+
+#ifndef CUC_LOG_H
+#define CUC_LOG_H
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "cuc_cxi.h"
+#include "cuc_xport.h"
+
+#define CUC_LOG_MAX_SOURCES      16
+#define CUC_LOG_MAX_DEPTH        8
+#define CUC_LOG_DEFAULT_IDLE_US  (100 * 1000)
+#define CUC_LOG_SPILL_BUF        (64 * 1024)
+
+#define CUC_LOG_SPILL_MAGIC      0x474F4C43  /* "CLOG" */
+#define CUC_LOG_SPILL_VERSION    2
+
+/**
+ * struct cuc_log_entry - One uC log message
+ */
+struct cuc_log_entry {
+	u64 host_us;               /* Host time the message was received */
+	u64 seq;                   /* Position in the collector's stream */
+	u8 source;                 /* Index of the uC it came from */
+	u8 len;
+	char msg[CUC_DATA_BYTES + 1];  /* NUL terminated */
+};
+
+struct cuc_log_slot {
+	u64 seq;                   /* 2 * (position + 1) when complete, odd while written */
+	struct cuc_log_entry e;
+};
+
+/**
+ * struct cuc_log_ring - Single-producer, multi-consumer broadcast ring
+ */
+struct cuc_log_ring {
+	u64 head;                  /* Next position to write */
+	u64 mask;
+	struct cuc_log_slot *slots;
+};
+
+/**
+ * struct cuc_log_reader - A consumer's cursor
+ */
+struct cuc_log_reader {
+	u64 pos;                   /* Next position to read */
+	u64 lost;                  /* Entries overwritten before they were read */
+};
+
+/* Spill file layout: a header, then records of a struct cuc_log_spill_rec and 'len' message bytes */
+struct cuc_log_spill_hdr {
+	u32 magic;
+	u32 version;
+} __packed;
+
+struct cuc_log_spill_rec {
+	u64 real_us;               /* CLOCK_REALTIME, in microseconds */
+	u8 source;
+	u8 len;
+} __packed;
+
+struct cuc_log_source {
+	struct cuc_xport *x;
+	unsigned int depth;        /* Requests allowed in flight */
+	unsigned int inflight;
+	u8 empty;                  /* The last response carried no message */
+	u64 next_us;               /* Next probe while idle */
+	unsigned long messages;
+	struct cuc_log *log;
+	struct cuc_xport_req reqs[CUC_LOG_MAX_DEPTH];
+	u32 free_mask;
+};
+
+/**
+ * struct cuc_log - Log collector for a set of uCs
+ */
+struct cuc_log {
+	struct cuc_log_ring ring;
+	struct cuc_log_source src[CUC_LOG_MAX_SOURCES];
+	unsigned int nsrc;
+	unsigned int max_depth;
+	u64 idle_us;
+
+	int spill_fd;              /* -1 when not spilling */
+	size_t spill_len;
+	u8 *spill_buf;
+
+	/* Counters */
+	unsigned long requests;
+	unsigned long messages;
+	unsigned long spill_errors;
+};
+
+/**
+ * cuc_log_init() - Set up a collector
+ * @l: Collector
+ * @ring_entries: Ring size, rounded up to a power of two
+ * @spill_path: Append-only spill file, or NULL for none
+ *
+ * Return: 0 on success or a negative errno
+ */
+static inline int cuc_log_init(struct cuc_log *l, unsigned int ring_entries, const char *spill_path)
+{
+	u64 n = 1;
+
+	memset(l, 0, sizeof(*l));
+	l->spill_fd = -1;
+	l->max_depth = CUC_LOG_MAX_DEPTH;
+	l->idle_us = CUC_LOG_DEFAULT_IDLE_US;
+
+	while (n < ring_entries)
+		n <<= 1;
+	l->ring.slots = (struct cuc_log_slot *)calloc(n, sizeof(*l->ring.slots));
+	if (!l->ring.slots)
+		return -ENOMEM;
+	l->ring.mask = n - 1;
+
+	if (spill_path) {
+		struct cuc_log_spill_hdr hdr = { CUC_LOG_SPILL_MAGIC, CUC_LOG_SPILL_VERSION };
+
+		l->spill_buf = (u8 *)malloc(CUC_LOG_SPILL_BUF);
+		l->spill_fd = open(spill_path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+		if (!l->spill_buf || l->spill_fd < 0) {
+			int rc = l->spill_fd < 0 ? -errno : -ENOMEM;
+
+			if (l->spill_fd >= 0)
+				close(l->spill_fd);
+			free(l->spill_buf);
+			free(l->ring.slots);
+			memset(l, 0, sizeof(*l));
+			l->spill_fd = -1;
+			return rc;
+		}
+		/* A new file starts with a header; appending to an existing one does not */
+		if (lseek(l->spill_fd, 0, SEEK_END) == 0) {
+			memcpy(l->spill_buf, &hdr, sizeof(hdr));
+			l->spill_len = sizeof(hdr);
+		}
+	}
+	return 0;
+}
+
+/**
+ * cuc_log_flush() - Write buffered spill records to the file
+ *
+ * Return: 0 on success or a negative errno
+ */
+static inline int cuc_log_flush(struct cuc_log *l)
+{
+	size_t off = 0;
+	ssize_t n;
+
+	while (l->spill_fd >= 0 && off < l->spill_len) {
+		n = write(l->spill_fd, l->spill_buf + off, l->spill_len - off);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+			l->spill_errors++;
+			memmove(l->spill_buf, l->spill_buf + off, l->spill_len - off);
+			l->spill_len -= off;
+			return -errno;
+		}
+		off += n;
+	}
+	l->spill_len = 0;
+	return 0;
+}
+
+/* The collector must be idle: every source's interface drained of log requests */
+static inline void cuc_log_fini(struct cuc_log *l)
+{
+	cuc_log_flush(l);
+	if (l->spill_fd >= 0)
+		close(l->spill_fd);
+	free(l->spill_buf);
+	free(l->ring.slots);
+	memset(l, 0, sizeof(*l));
+	l->spill_fd = -1;
+}
+
+/**
+ * cuc_log_add_source() - Drain a uC through an interface
+ *
+ * Return: Source index, or -ENOSPC
+ */
+static inline int cuc_log_add_source(struct cuc_log *l, struct cuc_xport *x)
+{
+	struct cuc_log_source *s;
+
+	if (l->nsrc == CUC_LOG_MAX_SOURCES)
+		return -ENOSPC;
+	s = &l->src[l->nsrc];
+	memset(s, 0, sizeof(*s));
+	s->x = x;
+	s->log = l;
+	s->depth = 1;
+	s->free_mask = (1u << CUC_LOG_MAX_DEPTH) - 1;
+	return (int)l->nsrc++;
+}
+
+/* Drain a source now instead of at its next idle probe, e.g. on a FWU or power event */
+static inline void cuc_log_kick(struct cuc_log *l, unsigned int source)
+{
+	if (source < l->nsrc) {
+		l->src[source].empty = 0;
+		l->src[source].next_us = 0;
+	}
+}
+
+/* Publish one entry: mark the slot busy, fill it, then mark it complete */
+static inline void cuc_log_ring_push(struct cuc_log_ring *r, u64 host_us, u8 source, const u8 *msg,
+				     unsigned int len)
+{
+	u64 pos = r->head;
+	struct cuc_log_slot *s = &r->slots[pos & r->mask];
+
+	__atomic_store_n(&s->seq, 2 * pos + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	s->e.host_us = host_us;
+	s->e.seq = pos;
+	s->e.source = source;
+	s->e.len = (u8)len;
+	memcpy(s->e.msg, msg, len);
+	s->e.msg[len] = 0;
+	__atomic_store_n(&s->seq, 2 * pos + 2, __ATOMIC_RELEASE);
+	__atomic_store_n(&r->head, pos + 1, __ATOMIC_RELEASE);
+}
+
+/* Start a consumer at the oldest entry still in the ring, or at the next new one */
+static inline void cuc_log_reader_init(const struct cuc_log_ring *r, struct cuc_log_reader *rd, int oldest)
+{
+	u64 head = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+
+	rd->lost = 0;
+	rd->pos = oldest && head > r->mask + 1 ? head - (r->mask + 1) : (oldest ? 0 : head);
+}
+
+/**
+ * cuc_log_read() - Read the next entry without blocking
+ * @r: Ring
+ * @rd: Consumer cursor
+ * @e: Output
+ *
+ * Return: 1 if an entry was stored, 0 if the consumer is caught up
+ */
+static inline int cuc_log_read(const struct cuc_log_ring *r, struct cuc_log_reader *rd, struct cuc_log_entry *e)
+{
+	for (;;) {
+		u64 head = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+		const struct cuc_log_slot *s;
+		u64 s1, s2;
+
+		if (rd->pos >= head)
+			return 0;
+		/* Overrun: skip to the oldest entry that can still be intact */
+		if (head - rd->pos > r->mask + 1) {
+			rd->lost += head - (r->mask + 1) - rd->pos;
+			rd->pos = head - (r->mask + 1);
+		}
+
+		s = &r->slots[rd->pos & r->mask];
+		s1 = __atomic_load_n(&s->seq, __ATOMIC_ACQUIRE);
+		if (s1 == 2 * rd->pos + 2) {
+			memcpy(e, &s->e, sizeof(*e));
+			__atomic_thread_fence(__ATOMIC_ACQUIRE);
+			s2 = __atomic_load_n(&s->seq, __ATOMIC_RELAXED);
+			if (s2 == s1) {
+				rd->pos++;
+				return 1;
+			}
+		}
+		/* The producer lapped us while we copied; the entry is gone */
+		rd->lost++;
+		rd->pos++;
+	}
+}
+
+static inline void cuc_log_spill(struct cuc_log *l, u8 source, const u8 *msg, unsigned int len)
+{
+	struct cuc_log_spill_rec rec;
+	struct timespec ts;
+
+	if (l->spill_fd < 0)
+		return;
+	if (l->spill_len + sizeof(rec) + len > CUC_LOG_SPILL_BUF)
+		cuc_log_flush(l);
+	if (l->spill_len + sizeof(rec) + len > CUC_LOG_SPILL_BUF) {
+		l->spill_errors++;
+		return;
+	}
+	clock_gettime(CLOCK_REALTIME, &ts);
+	rec.real_us = (u64)ts.tv_sec * 1000000 + (u64)ts.tv_nsec / 1000;
+	rec.source = source;
+	rec.len = (u8)len;
+	memcpy(l->spill_buf + l->spill_len, &rec, sizeof(rec));
+	memcpy(l->spill_buf + l->spill_len + sizeof(rec), msg, len);
+	l->spill_len += sizeof(rec) + len;
+}
+
+/* Room for one more GET_LOG: nothing queued, and a slot of the window left for other commands */
+static inline int cuc_log_has_room(const struct cuc_xport *x)
+{
+	return cuc_xport_has_room(x) && (x->window == 1 || x->ninflight + 1 < x->window);
+}
+
+/* struct cuc_xport_req done() for GET_LOG requests */
+static inline void cuc_log_req_done(struct cuc_xport_req *req)
+{
+	struct cuc_log_source *s = (struct cuc_log_source *)req->priv;
+	struct cuc_log *l = s->log;
+	unsigned int len = req->status < 0 ? 0 : cuc_xport_rsp_len(req);
+	u64 now = cuc_xport_now_us();
+
+	s->inflight--;
+	s->free_mask |= 1u << (unsigned int)(req - s->reqs);
+
+	if (!len) {
+		/* Empty (or failed): stop streaming until the next probe */
+		s->empty = 1;
+		s->depth = 1;
+		s->next_us = now + l->idle_us;
+		return;
+	}
+
+	/* The uC may pad with NULs; keep the text only */
+	len = (unsigned int)strnlen((const char *)req->rsp.data, len);
+	cuc_log_ring_push(&l->ring, now, (u8)(s - l->src), req->rsp.data, len);
+	cuc_log_spill(l, (u8)(s - l->src), req->rsp.data, len);
+	s->messages++;
+	l->messages++;
+	s->empty = 0;
+	if (s->depth < l->max_depth)
+		s->depth *= 2;
+}
+
+/**
+ * cuc_log_poll() - Queue GET_LOG requests where they are due
+ * @l: Collector
+ * @now: Current time from cuc_xport_now_us()
+ *
+ * Responses are processed by the transports' own cuc_xport_progress(), which the
+ * caller drives. Spill records buffered since the last call are written out first.
+ *
+ * Return: Time of the next idle probe
+ */
+static inline u64 cuc_log_poll(struct cuc_log *l, u64 now)
+{
+	u64 next = (u64)-1;
+	unsigned int i;
+
+	if (l->spill_len)
+		cuc_log_flush(l);
+
+	for (i = 0; i < l->nsrc; i++) {
+		struct cuc_log_source *s = &l->src[i];
+
+		if (s->empty && now < s->next_us) {
+			if (s->next_us < next)
+				next = s->next_us;
+			continue;
+		}
+		if (s->empty && s->inflight)
+			continue;
+		s->empty = 0;
+
+		/* Never queue behind, or ahead of, other users of the interface. A failed
+		 * send completes at once and marks the source empty.
+		 */
+		while (s->inflight < s->depth && s->free_mask && !s->empty && cuc_log_has_room(s->x)) {
+			struct cuc_xport_req *r = &s->reqs[__builtin_ctz(s->free_mask)];
+
+			cuc_xport_req_init(r, CUC_CMD_GET_LOG, NULL, 0);
+			r->done = cuc_log_req_done;
+			r->priv = s;
+			s->free_mask &= ~(1u << (unsigned int)(r - s->reqs));
+			s->inflight++;
+			l->requests++;
+			if (cuc_xport_submit(s->x, &r, 1) < 0) {
+				s->free_mask |= 1u << (unsigned int)(r - s->reqs);
+				s->inflight--;
+				break;
+			}
+		}
+		next = now;
+	}
+	return next;
+}
+
+/**
+ * cuc_log_run() - Drive the collector's own transports for up to 'timeout_us'
+ *
+ * For a process whose only traffic on these interfaces is log collection. Spill
+ * records are flushed on return.
+ *
+ * Return: Number of messages collected
+ */
+static inline unsigned long cuc_log_run(struct cuc_log *l, long timeout_us)
+{
+	unsigned long before = l->messages;
+	u64 end = cuc_xport_now_us() + (timeout_us > 0 ? (u64)timeout_us : 0);
+	u64 now, next;
+	unsigned int i;
+
+	do {
+		unsigned int busy = 0;
+		u64 until;
+
+		now = cuc_xport_now_us();
+		next = cuc_log_poll(l, now);
+		until = next > now && next < end ? next : end;
+		for (i = 0; i < l->nsrc; i++) {
+			/* Wait for our responses, or for others' to make room in a full window */
+			if (cuc_xport_idle(l->src[i].x))
+				continue;
+			/* A single interface can block; several are serviced in turn */
+			cuc_xport_progress(l->src[i].x, l->nsrc == 1 && until > now ? (long)(until - now) : 100);
+			busy = 1;
+		}
+		now = cuc_xport_now_us();
+		if (!busy && next > now && now < end) {
+			u64 wait = (next < end ? next : end) - now;
+			struct timespec ts = { (time_t)(wait / 1000000), (long)(wait % 1000000) * 1000 };
+
+			nanosleep(&ts, NULL);
+		}
+	} while (cuc_xport_now_us() < end);
+
+	cuc_log_flush(l);
+	return l->messages - before;
+}
+
+#endif /* CUC_LOG_H */
@@ -0,0 +1,360 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* This file implements a host-side cache of QSFP/CMIS module EEPROM pages.
+ *
+ * Every CUC_CMD_QSFP_READ is an I2C transaction performed by the uC, yet most of what
+ * link management reads (identifier, vendor name and part number, advertised
+ * capabilities, alarm thresholds) never changes while a module stays plugged in. The
+ * cache keeps those upper pages per NIC. A page is loaded whole, with one read of the
+ * largest count the uC accepts, the first time any byte of it is needed, and later
+ * reads are served from memory. The lower page and pages not marked static (DOM
+ * monitors, flags, lane status, control bytes) always go to the bus.
+ *
+ * By default upper pages 00h-03h are static. That covers the SFF-8636 vendor,
+ * threshold and user EEPROM pages and the CMIS advertising and threshold pages;
+ * cuc_qsfp_cache_set_static() changes this per page.
+ *
+ * A NIC's cache is dropped whenever ATT1_QSFP_INSERT, ATT1_QSFP_REMOVE or
+ * ATT1_QSFP_BAD_CABLE is reported for it, either by the cuc_intr.h dispatcher the
+ * cache is attached to with cuc_qsfp_cache_attach() or by the caller through
+ * cuc_qsfp_cache_intr(), and when the module is reset through
+ * cuc_qsfp_cache_reset(). Writes made through cuc_qsfp_cache_write() update the
+ * cached copy once the uC has accepted them.
+ */
+
+#ifndef CUC_QSFP_CACHE_H
+#define CUC_QSFP_CACHE_H
+
+#include <errno.h>
+#include <string.h>
+
+#include "cuc_cxi.h"
+#include "cuc_intr.h"
+#include "cuc_xport.h"
+
+#define CUC_QSFP_PAGE_SIZE          128
+#define CUC_QSFP_CACHE_PAGES        32    /* Upper pages 00h-1Fh can be cached */
+#define CUC_QSFP_CACHE_NICS         2
+
+/* Largest count of one QSFP read or write; accesses may not span the lower/upper boundary */
+#define CUC_QSFP_XFER_MAX  \
+	(CUC_QSFP_PAGE_SIZE < CUC_DATA_BYTES - sizeof(struct cuc_qsfp_write_req_data) ? \
+	 CUC_QSFP_PAGE_SIZE : CUC_DATA_BYTES - sizeof(struct cuc_qsfp_write_req_data))
+
+/* Interrupts after which a NIC's module contents can no longer be trusted */
+#define CUC_QSFP_CACHE_INVALIDATE_INTR  (ATT1_QSFP_INSERT | ATT1_QSFP_REMOVE | ATT1_QSFP_BAD_CABLE)
+
+struct cuc_qsfp_cache_nic {
+	u32 valid;                      /* Bit per cached upper page */
+	u8 upper[CUC_QSFP_CACHE_PAGES][CUC_QSFP_PAGE_SIZE];
+};
+
+/**
+ * struct cuc_qsfp_cache - Module EEPROM cache for the NICs behind one uC
+ */
+struct cuc_qsfp_cache {
+	struct cuc_xport *x;
+	u32 static_pages;               /* Bit per upper page that may be cached */
+	struct cuc_qsfp_cache_nic nic[CUC_QSFP_CACHE_NICS];
+	struct cuc_xport_req reqs[CUC_QSFP_CACHE_PAGES];
+
+	/* Counters */
+	unsigned long hits;             /* Reads served entirely from memory */
+	unsigned long misses;           /* Reads that needed the bus */
+	unsigned long page_loads;
+	unsigned long bus_reads;
+	unsigned long bus_writes;
+	unsigned long invalidations;
+};
+
+static inline void cuc_qsfp_cache_init(struct cuc_qsfp_cache *c, struct cuc_xport *x)
+{
+	memset(c, 0, sizeof(*c));
+	c->x = x;
+	c->static_pages = 0xF;
+}
+
+/* Mark an upper page as static (cacheable) or volatile */
+static inline int cuc_qsfp_cache_set_static(struct cuc_qsfp_cache *c, u8 page, int is_static)
+{
+	unsigned int n;
+
+	if (page >= CUC_QSFP_CACHE_PAGES)
+		return is_static ? -EINVAL : 0;
+	if (is_static) {
+		c->static_pages |= 1u << page;
+		return 0;
+	}
+	c->static_pages &= ~(1u << page);
+	for (n = 0; n < CUC_QSFP_CACHE_NICS; n++)
+		c->nic[n].valid &= ~(1u << page);
+	return 0;
+}
+
+/* Drop everything cached for a NIC */
+static inline void cuc_qsfp_cache_invalidate(struct cuc_qsfp_cache *c, u8 nic)
+{
+	if (nic >= CUC_QSFP_CACHE_NICS)
+		return;
+	if (c->nic[nic].valid)
+		c->invalidations++;
+	c->nic[nic].valid = 0;
+}
+
+/**
+ * cuc_qsfp_cache_intr() - Account for interrupt status bits of a NIC
+ * @c: Cache
+ * @nic: NIC the bits belong to
+ * @isr: Interrupt status, e.g. from struct cuc_get_intr_rsp_data
+ *
+ * Unless the cache is attached to a dispatcher, must be called with every ISR value
+ * read for the NIC, so that a module swap is never missed.
+ */
+static inline void cuc_qsfp_cache_intr(struct cuc_qsfp_cache *c, u8 nic, u32 isr)
+{
+	if (isr & CUC_QSFP_CACHE_INVALIDATE_INTR)
+		cuc_qsfp_cache_invalidate(c, nic);
+}
+
+static inline void cuc_qsfp_cache_intr_fn(struct cuc_intr *d, u8 nic, u32 bits, void *priv)
+{
+	(void)d;
+	cuc_qsfp_cache_intr((struct cuc_qsfp_cache *)priv, nic, bits);
+}
+
+/**
+ * cuc_qsfp_cache_attach() - Have a dispatcher invalidate the cache
+ * @c: Cache
+ * @d: Dispatcher of the same uC
+ *
+ * Registers for CUC_QSFP_CACHE_INVALIDATE_INTR on every NIC; the bits are enabled by
+ * the next cuc_intr_sync_ier(). Without this, the caller must pass every ISR value it
+ * reads to cuc_qsfp_cache_intr().
+ *
+ * Return: 0 on success, -ENOSPC if the dispatcher's handler table is full
+ */
+static inline int cuc_qsfp_cache_attach(struct cuc_qsfp_cache *c, struct cuc_intr *d)
+{
+	return cuc_intr_register(d, CUC_QSFP_CACHE_INVALIDATE_INTR, 0, cuc_qsfp_cache_intr_fn, c);
+}
+
+static inline int cuc_qsfp_cache_cacheable(const struct cuc_qsfp_cache *c, u8 nic, u8 page, u8 addr)
+{
+	return nic < CUC_QSFP_CACHE_NICS && addr >= CUC_QSFP_PAGE_SIZE && page < CUC_QSFP_CACHE_PAGES &&
+	       (c->static_pages & (1u << page));
+}
+
+static inline void cuc_qsfp_read_req_init(struct cuc_xport_req *r, u8 nic, u8 page, u8 addr, u8 count)
+{
+	struct cuc_qsfp_read_req_data rq = { nic, page, addr, count };
+
+	cuc_xport_req_init(r, CUC_CMD_QSFP_READ, &rq, sizeof(rq));
+}
+
+/* Run a batch of requests as one pipelined burst. Returns the first error. */
+static inline int cuc_qsfp_cache_exec(struct cuc_qsfp_cache *c, unsigned int n)
+{
+	struct cuc_xport_req *reqs[CUC_QSFP_CACHE_PAGES];
+	unsigned int i;
+	int rc, err = 0;
+
+	for (i = 0; i < n; i++)
+		reqs[i] = &c->reqs[i];
+	rc = cuc_xport_submit(c->x, reqs, n);
+	if (rc < 0)
+		return rc;
+	for (i = 0; i < n; i++) {
+		rc = cuc_xport_wait(c->x, reqs[i]);
+		if (rc < 0 && !err)
+			err = rc;
+	}
+	return err;
+}
+
+/* Store the responses to the page loads queued in reqs[0..n). A page short of
+ * CUC_QSFP_PAGE_SIZE is not cached and fails the load with -EPROTO.
+ */
+static inline int cuc_qsfp_cache_fill(struct cuc_qsfp_cache *c, u8 nic, unsigned int n)
+{
+	unsigned int i;
+	int rc;
+
+	c->page_loads += n;
+	c->bus_reads += n;
+	rc = cuc_qsfp_cache_exec(c, n);
+	for (i = 0; i < n; i++) {
+		struct cuc_xport_req *r = &c->reqs[i];
+		u8 page = r->req.data[1];
+
+		if (r->status < 0)
+			continue;
+		if (cuc_xport_rsp_len(r) < CUC_QSFP_PAGE_SIZE) {
+			if (!rc)
+				rc = -EPROTO;
+			continue;
+		}
+		memcpy(c->nic[nic].upper[page], r->rsp.data, CUC_QSFP_PAGE_SIZE);
+		c->nic[nic].valid |= 1u << page;
+	}
+	return rc;
+}
+
+/**
+ * cuc_qsfp_cache_prefetch() - Load every static page of a NIC that is not cached
+ *
+ * All page loads are pipelined. Useful right after a module is inserted.
+ *
+ * Return: 0 on success, the first error reported by the uC, or -EPROTO if a page
+ *         came back short
+ */
+static inline int cuc_qsfp_cache_prefetch(struct cuc_qsfp_cache *c, u8 nic)
+{
+	unsigned int n = 0, page;
+	u32 want;
+
+	if (nic >= CUC_QSFP_CACHE_NICS)
+		return -EINVAL;
+	want = c->static_pages & ~c->nic[nic].valid;
+	for (page = 0; page < CUC_QSFP_CACHE_PAGES; page++)
+		if (want & (1u << page))
+			cuc_qsfp_read_req_init(&c->reqs[n++], nic, (u8)page, CUC_QSFP_PAGE_SIZE, CUC_QSFP_PAGE_SIZE);
+	return n ? cuc_qsfp_cache_fill(c, nic, n) : 0;
+}
+
+/**
+ * cuc_qsfp_cache_read() - Read module memory
+ * @c: Cache
+ * @nic: NIC whose module is read
+ * @page: Upper page select
+ * @addr: Start address, 0-127 for the lower page and 128-255 for the upper page
+ * @buf: Output
+ * @count: Bytes to read; may span the lower/upper boundary
+ *
+ * Return: 0 on success or a negative errno (-ENODEV if no module is present)
+ */
+static inline int cuc_qsfp_cache_read(struct cuc_qsfp_cache *c, u8 nic, u8 page, u8 addr, void *buf,
+				      unsigned int count)
+{
+	u8 *out = (u8 *)buf;
+	unsigned int n = 0, i, off, len;
+	int rc;
+
+	if (!count || addr + count > 2 * CUC_QSFP_PAGE_SIZE)
+		return -EINVAL;
+
+	if (cuc_qsfp_cache_cacheable(c, nic, page, addr)) {
+		struct cuc_qsfp_cache_nic *cn = &c->nic[nic];
+
+		if (cn->valid & (1u << page)) {
+			c->hits++;
+		} else {
+			c->misses++;
+			cuc_qsfp_read_req_init(&c->reqs[0], nic, page, CUC_QSFP_PAGE_SIZE, CUC_QSFP_PAGE_SIZE);
+			rc = cuc_qsfp_cache_fill(c, nic, 1);
+			if (rc < 0)
+				return rc;
+			if (!(cn->valid & (1u << page)))
+				return -EPROTO;
+		}
+		memcpy(out, &cn->upper[page][addr - CUC_QSFP_PAGE_SIZE], count);
+		return 0;
+	}
+
+	/* Uncached: split at the lower/upper boundary and at the transfer limit */
+	c->misses++;
+	for (off = 0; off < count; off += len) {
+		unsigned int a = addr + off;
+		unsigned int end = a < CUC_QSFP_PAGE_SIZE ? CUC_QSFP_PAGE_SIZE : 2 * CUC_QSFP_PAGE_SIZE;
+
+		len = count - off;
+		if (len > end - a)
+			len = end - a;
+		if (len > CUC_QSFP_XFER_MAX)
+			len = CUC_QSFP_XFER_MAX;
+		cuc_qsfp_read_req_init(&c->reqs[n++], nic, page, (u8)a, (u8)len);
+	}
+	c->bus_reads += n;
+	rc = cuc_qsfp_cache_exec(c, n);
+	if (rc < 0)
+		return rc;
+
+	for (i = 0, off = 0; i < n; i++) {
+		len = c->reqs[i].req.data[3];
+		if (cuc_xport_rsp_len(&c->reqs[i]) < len)
+			return -EPROTO;
+		memcpy(out + off, c->reqs[i].rsp.data, len);
+		off += len;
+	}
+	return 0;
+}
+
+/**
+ * cuc_qsfp_cache_write() - Write module memory and keep the cache coherent
+ *
+ * Arguments as for cuc_qsfp_cache_read(). Cached bytes are updated only after the uC
+ * has accepted the write; a failed write drops the affected page, since the module
+ * may hold part of it.
+ *
+ * Return: 0 on success or a negative errno
+ */
+static inline int cuc_qsfp_cache_write(struct cuc_qsfp_cache *c, u8 nic, u8 page, u8 addr,
+				       const void *buf, unsigned int count)
+{
+	u8 pkt[sizeof(struct cuc_qsfp_write_req_data) + CUC_QSFP_XFER_MAX];
+	struct cuc_qsfp_write_req_data *wq = (struct cuc_qsfp_write_req_data *)pkt;
+	const u8 *in = (const u8 *)buf;
+	unsigned int n = 0, off, len;
+	int rc;
+
+	if (!count || addr + count > 2 * CUC_QSFP_PAGE_SIZE)
+		return -EINVAL;
+
+	for (off = 0; off < count; off += len) {
+		unsigned int a = addr + off;
+		unsigned int end = a < CUC_QSFP_PAGE_SIZE ? CUC_QSFP_PAGE_SIZE : 2 * CUC_QSFP_PAGE_SIZE;
+
+		len = count - off;
+		if (len > end - a)
+			len = end - a;
+		if (len > CUC_QSFP_XFER_MAX)
+			len = CUC_QSFP_XFER_MAX;
+		wq->nic = nic;
+		wq->page = page;
+		wq->addr = (u8)a;
+		wq->count = (u8)len;
+		memcpy(wq->data, in + off, len);
+		cuc_xport_req_init(&c->reqs[n++], CUC_CMD_QSFP_WRITE, pkt, sizeof(*wq) + len);
+	}
+	c->bus_writes += n;
+	rc = cuc_qsfp_cache_exec(c, n);
+
+	/* Only the part of the write that falls in the upper page can be cached */
+	off = addr < CUC_QSFP_PAGE_SIZE ? CUC_QSFP_PAGE_SIZE - addr : 0;
+	if (off < count && cuc_qsfp_cache_cacheable(c, nic, page, (u8)(addr + off)) &&
+	    (c->nic[nic].valid & (1u << page))) {
+		if (rc < 0)
+			c->nic[nic].valid &= ~(1u << page);
+		else
+			memcpy(&c->nic[nic].upper[page][addr + off - CUC_QSFP_PAGE_SIZE], in + off, count - off);
+	}
+	return rc;
+}
+
+/**
+ * cuc_qsfp_cache_reset() - Reset a NIC's module and drop its cached pages
+ *
+ * Return: 0 on success or a negative errno
+ */
+static inline int cuc_qsfp_cache_reset(struct cuc_qsfp_cache *c, u8 nic)
+{
+	struct cuc_qsfp_reset_req_data rq = { nic };
+	int rc;
+
+	cuc_xport_req_init(&c->reqs[0], CUC_CMD_QSFP_RESET, &rq, sizeof(rq));
+	rc = cuc_xport_exec(c->x, &c->reqs[0]);
+	cuc_qsfp_cache_invalidate(c, nic);
+	return rc;
+}
+
+#endif /* CUC_QSFP_CACHE_H */
@@ -0,0 +1,391 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* This file implements a thread pool that runs uC command work for all the Cassini
+ * cards of a node.
+ *
+ * Work is submitted as tasks, each bound to one uC and, optionally, to one of its two
+ * NICs. Every uC has its own submission queues, one per priority class and NIC, and is
+ * driven by at most one worker at a time, since a struct cuc_xport is single-threaded.
+ * Each uC has a home worker, but any idle worker takes over a uC that has work and is
+ * not being served. A worker stuck behind a slow uC (e.g. one that is busy with
+ * FWU_STATUS_FLASHING) therefore only holds up that uC; its other uCs are picked up
+ * by its peers.
+ *
+ * Workers pick the uC whose most urgent waiting task has the highest priority class,
+ * and re-check after each task, so interrupt handling and link management never wait
+ * for more than one task of bulk work. Within a class the NICs of a uC are served
+ * round-robin. A lower class that has been passed over CUC_SCHED_STARVE_LIMIT times
+ * in a row gets one task through, so bulk work is slowed down but never stopped.
+ *
+ * Tasks are owned by the caller and linked into the queues intrusively. The task
+ * function runs without any scheduler lock held and may submit further tasks.
+ */
+
+#ifndef CUC_SCHED_H
+#define CUC_SCHED_H
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cuc_cxi.h"
+#include "cuc_xport.h"
+
+#define CUC_SCHED_MAX_UCS       16
+#define CUC_SCHED_MAX_WORKERS   32
+#define CUC_SCHED_NIC_QUEUES    3     /* NIC 0, NIC 1, and work for the uC as a whole */
+#define CUC_SCHED_STARVE_LIMIT  16
+
+/* Priority classes, most urgent first */
+enum cuc_sched_prio {
+	CUC_SCHED_PRIO_INTR,      /* Interrupt handling */
+	CUC_SCHED_PRIO_LINK,      /* Link management, QSFP */
+	CUC_SCHED_PRIO_BULK,      /* Inventory, log draining, firmware update */
+	CUC_SCHED_NUM_PRIO
+};
+
+struct cuc_sched_task;
+
+/* Runs with exclusive use of the task's uC transport */
+typedef void (*cuc_sched_fn)(struct cuc_sched_task *t, struct cuc_xport *x);
+
+/**
+ * struct cuc_sched_task - One unit of uC work
+ */
+struct cuc_sched_task {
+	cuc_sched_fn fn;
+	void *priv;                /* Caller cookie */
+	u8 uc;                     /* Index returned by cuc_sched_add_uc() */
+	u8 nic;                    /* NIC the work is for; CUC_MAC_THIS_NIC or any value > 1 for the uC */
+	u8 prio;                   /* enum cuc_sched_prio */
+
+	/* Scheduler private */
+	struct cuc_sched_task *next;
+};
+
+struct cuc_sched_queue {
+	struct cuc_sched_task *head;
+	struct cuc_sched_task *tail;
+};
+
+/**
+ * struct cuc_sched_uc - Submission queues of one uC
+ */
+struct cuc_sched_uc {
+	struct cuc_xport *x;
+	struct cuc_sched_queue q[CUC_SCHED_NUM_PRIO][CUC_SCHED_NIC_QUEUES];
+	unsigned int pending[CUC_SCHED_NUM_PRIO];
+	u8 rr[CUC_SCHED_NUM_PRIO];     /* Next NIC queue to serve per class */
+	u8 passed[CUC_SCHED_NUM_PRIO]; /* Times a waiting class was passed over */
+	u8 busy;                       /* Being served by a worker */
+	u8 home;                       /* Worker that normally serves this uC */
+
+	/* Counters */
+	unsigned long executed;
+	unsigned long stolen;          /* Tasks run by a worker other than the home one */
+};
+
+/**
+ * struct cuc_sched - Scheduler for all uCs of a node
+ */
+struct cuc_sched {
+	pthread_mutex_t lock;
+	pthread_cond_t work;           /* Signalled when a uC becomes runnable */
+	pthread_cond_t idle;           /* Signalled when the last task completes */
+	struct cuc_sched_uc uc[CUC_SCHED_MAX_UCS];
+	unsigned int num_ucs;
+	pthread_t worker[CUC_SCHED_MAX_WORKERS];
+	unsigned int num_workers;
+	unsigned int queued;           /* Tasks waiting or running */
+	unsigned int next_uc;          /* Where the next search for work starts */
+	int stop;
+};
+
+struct cuc_sched_worker_arg {
+	struct cuc_sched *s;
+	unsigned int id;
+};
+
+static inline int cuc_sched_init(struct cuc_sched *s)
+{
+	int rc;
+
+	memset(s, 0, sizeof(*s));
+	rc = pthread_mutex_init(&s->lock, NULL);
+	if (rc)
+		return -rc;
+	rc = pthread_cond_init(&s->work, NULL);
+	if (rc)
+		goto err_work;
+	rc = pthread_cond_init(&s->idle, NULL);
+	if (rc)
+		goto err_idle;
+	return 0;
+
+err_idle:
+	pthread_cond_destroy(&s->work);
+err_work:
+	pthread_mutex_destroy(&s->lock);
+	return -rc;
+}
+
+/**
+ * cuc_sched_add_uc() - Register a uC transport
+ *
+ * Must be called before cuc_sched_start().
+ *
+ * Return: The uC index used in cuc_sched_task.uc, or -ENOSPC
+ */
+static inline int cuc_sched_add_uc(struct cuc_sched *s, struct cuc_xport *x)
+{
+	if (s->num_ucs == CUC_SCHED_MAX_UCS)
+		return -ENOSPC;
+	s->uc[s->num_ucs].x = x;
+	return (int)s->num_ucs++;
+}
+
+/* Most urgent class with waiting tasks, or CUC_SCHED_NUM_PRIO */
+static inline unsigned int cuc_sched_top(const struct cuc_sched_uc *u)
+{
+	unsigned int p;
+
+	for (p = 0; p < CUC_SCHED_NUM_PRIO; p++)
+		if (u->pending[p])
+			return p;
+	return CUC_SCHED_NUM_PRIO;
+}
+
+/* Choose the uC to serve next. Called with the lock held. */
+static inline struct cuc_sched_uc *cuc_sched_pick(struct cuc_sched *s, unsigned int self)
+{
+	struct cuc_sched_uc *best = NULL;
+	unsigned int best_prio = CUC_SCHED_NUM_PRIO;
+	unsigned int i;
+
+	for (i = 0; i < s->num_ucs; i++) {
+		struct cuc_sched_uc *u = &s->uc[(s->next_uc + i) % s->num_ucs];
+		unsigned int p;
+
+		if (u->busy)
+			continue;
+		p = cuc_sched_top(u);
+		/* Home uCs win ties; others are stolen only if they are more urgent or nothing else is runnable */
+		if (p < best_prio || (p == best_prio && p < CUC_SCHED_NUM_PRIO && u->home == self && best->home != self)) {
+			best = u;
+			best_prio = p;
+		}
+	}
+	if (best)
+		s->next_uc = (unsigned int)(best - s->uc + 1) % s->num_ucs;
+	return best;
+}
+
+/* True if a uC nobody is serving has work more urgent than class 'prio'. Called with the lock held. */
+static inline int cuc_sched_preempt(const struct cuc_sched *s, unsigned int prio)
+{
+	unsigned int i;
+
+	for (i = 0; i < s->num_ucs; i++)
+		if (!s->uc[i].busy && cuc_sched_top(&s->uc[i]) < prio)
+			return 1;
+	return 0;
+}
+
+/* Take the next task of a uC: the most urgent class, NICs in turn. Called with the lock held. */
+static inline struct cuc_sched_task *cuc_sched_dequeue(struct cuc_sched_uc *u)
+{
+	struct cuc_sched_task *t;
+	unsigned int top = cuc_sched_top(u), p, lo, n;
+
+	if (top == CUC_SCHED_NUM_PRIO)
+		return NULL;
+
+	/* Every waiting class below the top one is passed over; the most urgent of them
+	 * that has been passed over too often gets this turn instead.
+	 */
+	p = top;
+	for (lo = CUC_SCHED_NUM_PRIO - 1; lo > top; lo--) {
+		if (!u->pending[lo])
+			continue;
+		if (++u->passed[lo] >= CUC_SCHED_STARVE_LIMIT)
+			p = lo;
+	}
+	u->passed[p] = 0;
+
+	for (n = 0; n < CUC_SCHED_NIC_QUEUES; n++) {
+		struct cuc_sched_queue *q = &u->q[p][(u->rr[p] + n) % CUC_SCHED_NIC_QUEUES];
+
+		t = q->head;
+		if (!t)
+			continue;
+		q->head = t->next;
+		if (!q->head)
+			q->tail = NULL;
+		t->next = NULL;
+		u->rr[p] = (u8)((u->rr[p] + n + 1) % CUC_SCHED_NIC_QUEUES);
+		u->pending[p]--;
+		return t;
+	}
+	return NULL;
+}
+
+static inline void *cuc_sched_worker(void *arg)
+{
+	struct cuc_sched_worker_arg *wa = (struct cuc_sched_worker_arg *)arg;
+	struct cuc_sched *s = wa->s;
+	unsigned int self = wa->id;
+	struct cuc_sched_uc *u;
+	struct cuc_sched_task *t;
+
+	pthread_mutex_lock(&s->lock);
+	for (;;) {
+		u = cuc_sched_pick(s, self);
+		if (!u) {
+			if (s->stop)
+				break;
+			pthread_cond_wait(&s->work, &s->lock);
+			continue;
+		}
+
+		u->busy = 1;
+		/* Keep the uC while its work is the most urgent runnable work */
+		while ((t = cuc_sched_dequeue(u)) != NULL) {
+			pthread_mutex_unlock(&s->lock);
+			t->fn(t, u->x);
+			pthread_mutex_lock(&s->lock);
+
+			u->executed++;
+			if (u->home != self)
+				u->stolen++;
+			if (!--s->queued)
+				pthread_cond_broadcast(&s->idle);
+
+			if (cuc_sched_top(u) == CUC_SCHED_NUM_PRIO)
+				break;
+			if (cuc_sched_preempt(s, cuc_sched_top(u))) {
+				/* Go serve the more urgent uC; another worker may take this one */
+				pthread_cond_signal(&s->work);
+				break;
+			}
+		}
+		u->busy = 0;
+	}
+	pthread_mutex_unlock(&s->lock);
+	free(wa);
+	return NULL;
+}
+
+/**
+ * cuc_sched_start() - Start the workers
+ * @s: Scheduler with its uCs registered
+ * @num_workers: Number of threads; uC i is homed on worker i % num_workers
+ *
+ * Return: 0 on success or a negative errno. On failure the workers already started
+ * are stopped.
+ */
+static inline int cuc_sched_start(struct cuc_sched *s, unsigned int num_workers)
+{
+	struct cuc_sched_worker_arg *wa;
+	unsigned int i;
+	int rc;
+
+	if (!num_workers || num_workers > CUC_SCHED_MAX_WORKERS)
+		return -EINVAL;
+	for (i = 0; i < s->num_ucs; i++)
+		s->uc[i].home = (u8)(i % num_workers);
+
+	for (i = 0; i < num_workers; i++) {
+		wa = (struct cuc_sched_worker_arg *)malloc(sizeof(*wa));
+		if (!wa) {
+			rc = ENOMEM;
+			goto err;
+		}
+		wa->s = s;
+		wa->id = i;
+		rc = pthread_create(&s->worker[i], NULL, cuc_sched_worker, wa);
+		if (rc) {
+			free(wa);
+			goto err;
+		}
+		s->num_workers++;
+	}
+	return 0;
+
+err:
+	pthread_mutex_lock(&s->lock);
+	s->stop = 1;
+	pthread_cond_broadcast(&s->work);
+	pthread_mutex_unlock(&s->lock);
+	for (i = 0; i < s->num_workers; i++)
+		pthread_join(s->worker[i], NULL);
+	s->num_workers = 0;
+	s->stop = 0;
+	return -rc;
+}
+
+/**
+ * cuc_sched_submit() - Queue a task
+ *
+ * Return: 0 on success, -EINVAL for an unknown uC or priority class
+ */
+static inline int cuc_sched_submit(struct cuc_sched *s, struct cuc_sched_task *t)
+{
+	struct cuc_sched_queue *q;
+	struct cuc_sched_uc *u;
+
+	if (t->uc >= s->num_ucs || t->prio >= CUC_SCHED_NUM_PRIO)
+		return -EINVAL;
+
+	pthread_mutex_lock(&s->lock);
+	u = &s->uc[t->uc];
+	q = &u->q[t->prio][t->nic < CUC_SCHED_NIC_QUEUES - 1 ? t->nic : CUC_SCHED_NIC_QUEUES - 1];
+	t->next = NULL;
+	if (q->tail)
+		q->tail->next = t;
+	else
+		q->head = t;
+	q->tail = t;
+	u->pending[t->prio]++;
+	s->queued++;
+	if (!u->busy)
+		pthread_cond_signal(&s->work);
+	pthread_mutex_unlock(&s->lock);
+	return 0;
+}
+
+/* Wait until every submitted task has run */
+static inline void cuc_sched_wait_idle(struct cuc_sched *s)
+{
+	pthread_mutex_lock(&s->lock);
+	while (s->queued)
+		pthread_cond_wait(&s->idle, &s->lock);
+	pthread_mutex_unlock(&s->lock);
+}
+
+/**
+ * cuc_sched_stop() - Run the remaining tasks and stop the workers
+ */
+static inline void cuc_sched_stop(struct cuc_sched *s)
+{
+	unsigned int i;
+
+	pthread_mutex_lock(&s->lock);
+	s->stop = 1;
+	pthread_cond_broadcast(&s->work);
+	pthread_mutex_unlock(&s->lock);
+	for (i = 0; i < s->num_workers; i++)
+		pthread_join(s->worker[i], NULL);
+	s->num_workers = 0;
+}
+
+static inline void cuc_sched_fini(struct cuc_sched *s)
+{
+	cuc_sched_stop(s);
+	pthread_cond_destroy(&s->idle);
+	pthread_cond_destroy(&s->work);
+	pthread_mutex_destroy(&s->lock);
+}
+
+#endif /* CUC_SCHED_H */
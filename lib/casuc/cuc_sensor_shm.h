@@ -0,0 +1,615 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* This file implements a shared memory snapshot of uC sensor readings, so that any
+ * number of local consumers can read them without sending anything to a uC.
+ *
+ * One collector process owns the uC transports. It reads numeric sensors with
+ * GetSensorReading (typically through pldm_poll, with cuc_sensor_shm_poll_fn() as
+ * the completion callback), and the fan and the ATT1 interrupt registers of every
+ * NIC with CUC_CMD_GET_FAN_RPM and CUC_CMD_GET_INTR (cuc_sensor_shm_collect_uc()).
+ * Results are decoded into a private staging copy: readings are converted to the
+ * base unit of the sensor's PDR and stored with their unit and operational state.
+ * cuc_sensor_shm_publish() then copies the staging copy into the region as one
+ * update.
+ *
+ * The region is protected by a sequence lock. The counter is odd while the
+ * collector copies, and a reader copies what it needs and retries if the counter
+ * was odd or changed meanwhile. Reading takes no lock and makes no system call, and
+ * readers never delay the collector. The collector only holds the counter odd for
+ * one memcpy() of the used part of the region, so a reader rarely retries.
+ *
+ * Sensors are kept in sensor_id order so a reader can look one up by binary search.
+ */
+
+#ifndef CUC_SENSOR_SHM_H
+#define CUC_SENSOR_SHM_H
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cuc_cxi.h"
+#include "cuc_xport.h"
+#include "pldm_cxi.h"
+#include "pldm_sensor_conv.h"
+#include "pldm_sensor_poll.h"
+
+#define CUC_SENSOR_SHM_MAGIC        0x53534355  /* "UCSS" */
+#define CUC_SENSOR_SHM_VERSION      1
+#define CUC_SENSOR_SHM_MAX_UCS      16
+#define CUC_SENSOR_SHM_MAX_NICS     2
+#define CUC_SENSOR_SHM_MAX_SENSORS  1024        /* Default capacity */
+#define CUC_SENSOR_SHM_STALL_SPINS  (1u << 26)  /* Reader spins on one odd count before giving up */
+
+/**
+ * struct cuc_sensor_shm_sensor - Latest reading of one numeric sensor
+ *
+ * 'value' is NaN unless the last read succeeded with the sensor enabled and the
+ * sensor is linear. The other fields are those of the last response received.
+ */
+struct cuc_sensor_shm_sensor {
+	u16 sensor_id;
+	u8 base_unit;              /* enum of DSP0248 Table 74; see pldm_sensor_unit_name() */
+	u8 rate_unit;
+	u8 opstate;                /* enum pldm_sensor_opstate */
+	u8 present_state;
+	u8 event_state;
+	u8 pad;
+	s32 status;                /* 0, or negative errno of the last read */
+	u32 reads;                 /* Successful reads */
+	double value;              /* In base_unit; unit_modifier is already applied */
+	u64 read_us;               /* Collector time of the last successful read */
+};
+
+/**
+ * struct cuc_sensor_shm_nic - ATT1 interrupt registers of one NIC
+ */
+struct cuc_sensor_shm_nic {
+	u32 isr;
+	u32 ier;
+	s32 status;                /* 0, or negative errno of the last CUC_CMD_GET_INTR */
+	u32 pad;
+	u64 read_us;
+};
+
+/**
+ * struct cuc_sensor_shm_uc - Fan and interrupt state reported by one uC
+ */
+struct cuc_sensor_shm_uc {
+	u32 fan_rpm;
+	u8 fan_percent;
+	u8 fan_auto;               /* Non-zero if the uC controls the fan speed */
+	u8 num_nics;
+	u8 pad;
+	s32 fan_status;            /* 0, or negative errno of the last CUC_CMD_GET_FAN_RPM */
+	u32 pad2;
+	u64 fan_read_us;
+	struct cuc_sensor_shm_nic nic[CUC_SENSOR_SHM_MAX_NICS];
+};
+
+/**
+ * struct cuc_sensor_shm_data - Contents of the region covered by the sequence lock
+ */
+struct cuc_sensor_shm_data {
+	u64 update_us;             /* Collector time of the publish */
+	u64 generation;            /* Number of publishes */
+	u32 num_sensors;
+	u32 num_ucs;
+	struct cuc_sensor_shm_uc uc[CUC_SENSOR_SHM_MAX_UCS];
+	struct cuc_sensor_shm_sensor sensor[];
+};
+
+/**
+ * struct cuc_sensor_shm_hdr - Layout of the shared memory region
+ *
+ * The layout fields let a reader built against a different version of this
+ * header refuse the region instead of misreading it. struct cuc_sensor_shm_data
+ * follows on the next cache line.
+ */
+struct cuc_sensor_shm_hdr {
+	u32 magic;                 /* Written last by the creator */
+	u32 version;
+	u32 max_sensors;
+	u32 max_ucs;
+	u32 max_nics;
+	u32 sensor_size;
+	u32 uc_size;
+	u32 pad32;
+	u64 seq;                   /* Odd while the collector publishes */
+	u64 pad[3];
+};
+
+struct cuc_sensor_shm {
+	struct cuc_sensor_shm_hdr *shm;
+	struct cuc_sensor_shm_data *data;
+	size_t size;
+	int fd;
+
+	/* Collector only */
+	struct cuc_sensor_shm_data *stage;
+	const struct numeric_sensor_pdr **pdr;  /* Parallel to stage->sensor */
+	struct cuc_xport_req req[1 + CUC_SENSOR_SHM_MAX_NICS];
+};
+
+static inline size_t cuc_sensor_shm_data_size(unsigned int max_sensors)
+{
+	return sizeof(struct cuc_sensor_shm_data) + (size_t)max_sensors * sizeof(struct cuc_sensor_shm_sensor);
+}
+
+static inline size_t cuc_sensor_shm_size(unsigned int max_sensors)
+{
+	return sizeof(struct cuc_sensor_shm_hdr) + cuc_sensor_shm_data_size(max_sensors);
+}
+
+/* Unmap the region. The creator's name stays until shm_unlink(). */
+static inline void cuc_sensor_shm_close(struct cuc_sensor_shm *s)
+{
+	if (s->shm)
+		munmap(s->shm, s->size);
+	if (s->fd >= 0)
+		close(s->fd);
+	free(s->stage);
+	free(s->pdr);
+	s->shm = NULL;
+	s->data = NULL;
+	s->stage = NULL;
+	s->pdr = NULL;
+	s->fd = -1;
+}
+
+/**
+ * cuc_sensor_shm_create() - Create the region, for the collector
+ * @s: Handle
+ * @name: shm_open() name such as "/cuc_sensors", or NULL for a private mapping
+ * @max_sensors: Capacity, 0 for CUC_SENSOR_SHM_MAX_SENSORS
+ *
+ * An existing region of the same name is replaced. Nothing is visible to readers
+ * until the first cuc_sensor_shm_publish().
+ *
+ * Return: 0 on success, negative errno on failure
+ */
+static inline int cuc_sensor_shm_create(struct cuc_sensor_shm *s, const char *name, unsigned int max_sensors)
+{
+	void *p;
+
+	memset(s, 0, sizeof(*s));
+	s->fd = -1;
+	if (!max_sensors)
+		max_sensors = CUC_SENSOR_SHM_MAX_SENSORS;
+	s->size = cuc_sensor_shm_size(max_sensors);
+
+	s->stage = (struct cuc_sensor_shm_data *)calloc(1, cuc_sensor_shm_data_size(max_sensors));
+	s->pdr = (const struct numeric_sensor_pdr **)calloc(max_sensors, sizeof(*s->pdr));
+	if (!s->stage || !s->pdr) {
+		cuc_sensor_shm_close(s);
+		return -ENOMEM;
+	}
+
+	if (name) {
+		shm_unlink(name);
+		s->fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0644);
+		if (s->fd < 0) {
+			int rc = -errno;
+
+			cuc_sensor_shm_close(s);
+			return rc;
+		}
+		if (ftruncate(s->fd, (off_t)s->size) < 0) {
+			int rc = -errno;
+
+			cuc_sensor_shm_close(s);
+			shm_unlink(name);
+			return rc;
+		}
+		p = mmap(NULL, s->size, PROT_READ | PROT_WRITE, MAP_SHARED, s->fd, 0);
+	} else {
+		p = mmap(NULL, s->size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	}
+	if (p == MAP_FAILED) {
+		int rc = -errno;
+
+		cuc_sensor_shm_close(s);
+		if (name)
+			shm_unlink(name);
+		return rc;
+	}
+
+	s->shm = (struct cuc_sensor_shm_hdr *)p;
+	s->data = (struct cuc_sensor_shm_data *)(s->shm + 1);
+	s->shm->version = CUC_SENSOR_SHM_VERSION;
+	s->shm->max_sensors = max_sensors;
+	s->shm->max_ucs = CUC_SENSOR_SHM_MAX_UCS;
+	s->shm->max_nics = CUC_SENSOR_SHM_MAX_NICS;
+	s->shm->sensor_size = sizeof(struct cuc_sensor_shm_sensor);
+	s->shm->uc_size = sizeof(struct cuc_sensor_shm_uc);
+	__atomic_store_n(&s->shm->magic, CUC_SENSOR_SHM_MAGIC, __ATOMIC_RELEASE);
+	return 0;
+}
+
+/**
+ * cuc_sensor_shm_open() - Map an existing region read-only, for a reader
+ *
+ * Return: 0 on success, -EPROTO if the region has a different layout, other
+ * negative errno on failure
+ */
+static inline int cuc_sensor_shm_open(struct cuc_sensor_shm *s, const char *name)
+{
+	const struct cuc_sensor_shm_hdr *h;
+	struct stat st;
+	void *p;
+
+	memset(s, 0, sizeof(*s));
+	s->fd = shm_open(name, O_RDONLY, 0);
+	if (s->fd < 0)
+		return -errno;
+	if (fstat(s->fd, &st) < 0 || (size_t)st.st_size < sizeof(*h))
+		goto err_proto;
+	p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, s->fd, 0);
+	if (p == MAP_FAILED) {
+		int rc = -errno;
+
+		close(s->fd);
+		return rc;
+	}
+	s->shm = (struct cuc_sensor_shm_hdr *)p;
+	s->data = (struct cuc_sensor_shm_data *)(s->shm + 1);
+	s->size = (size_t)st.st_size;
+
+	h = s->shm;
+	if (__atomic_load_n(&h->magic, __ATOMIC_ACQUIRE) != CUC_SENSOR_SHM_MAGIC ||
+	    h->version != CUC_SENSOR_SHM_VERSION || h->max_ucs != CUC_SENSOR_SHM_MAX_UCS ||
+	    h->max_nics != CUC_SENSOR_SHM_MAX_NICS || h->sensor_size != sizeof(struct cuc_sensor_shm_sensor) ||
+	    h->uc_size != sizeof(struct cuc_sensor_shm_uc) || cuc_sensor_shm_size(h->max_sensors) > s->size) {
+		munmap(p, s->size);
+		goto err_proto;
+	}
+	return 0;
+
+err_proto:
+	close(s->fd);
+	s->shm = NULL;
+	s->data = NULL;
+	return -EPROTO;
+}
+
+/* Find sensor_id among the first 'n' sensors of 'd'. Returns its index or -1. */
+static inline long cuc_sensor_shm_find(const struct cuc_sensor_shm_data *d, unsigned int n, u16 sensor_id)
+{
+	unsigned int lo = 0, hi = n;
+
+	while (lo < hi) {
+		unsigned int mid = lo + (hi - lo) / 2;
+		u16 id = d->sensor[mid].sensor_id;
+
+		if (id == sensor_id)
+			return (long)mid;
+		if (id < sensor_id)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return -1;
+}
+
+/**
+ * cuc_sensor_shm_add_sensor() - Register a numeric sensor with the collector
+ * @s: Handle from cuc_sensor_shm_create()
+ * @pdr: The sensor's PDR; must stay valid while the sensor is collected
+ *
+ * Return: 0 on success, -EEXIST if the sensor is already registered, -ENOSPC if
+ * the region is full
+ */
+static inline int cuc_sensor_shm_add_sensor(struct cuc_sensor_shm *s, const struct numeric_sensor_pdr *pdr)
+{
+	struct cuc_sensor_shm_data *d = s->stage;
+	struct cuc_sensor_shm_sensor *e;
+	unsigned int i = d->num_sensors;
+
+	if (cuc_sensor_shm_find(d, d->num_sensors, pdr->sensor_id) >= 0)
+		return -EEXIST;
+	if (d->num_sensors >= s->shm->max_sensors)
+		return -ENOSPC;
+
+	/* Insertion keeps sensor_id order; sensors are registered once at startup */
+	while (i > 0 && d->sensor[i - 1].sensor_id > pdr->sensor_id) {
+		d->sensor[i] = d->sensor[i - 1];
+		s->pdr[i] = s->pdr[i - 1];
+		i--;
+	}
+	e = &d->sensor[i];
+	memset(e, 0, sizeof(*e));
+	e->sensor_id = pdr->sensor_id;
+	e->base_unit = pdr->base_unit;
+	e->rate_unit = pdr->rate_unit;
+	e->opstate = PLDM_OPSTATE_STATUS_UNKNOWN;
+	e->status = -ENODATA;
+	e->value = NAN;
+	s->pdr[i] = pdr;
+	d->num_sensors++;
+	return 0;
+}
+
+/**
+ * cuc_sensor_shm_update_sensor() - Stage the result of one GetSensorReading
+ * @s: Handle from cuc_sensor_shm_create()
+ * @sensor_id: Sensor that was read
+ * @rsp: The response, or NULL if status is non-zero
+ * @status: 0, or the negative errno of the read
+ * @now: Time of the read from cuc_xport_now_us()
+ *
+ * The arguments are those of a pldm_poll_fn: a response whose completion code is
+ * not PLDM_SUCCESS arrives with a non-zero status and no response.
+ *
+ * Return: 0, or -ENOENT if the sensor was not registered
+ */
+static inline int cuc_sensor_shm_update_sensor(struct cuc_sensor_shm *s, u16 sensor_id,
+					       const struct get_sensor_reading_rsp *rsp, int status, u64 now)
+{
+	struct cuc_sensor_shm_data *d = s->stage;
+	struct cuc_sensor_shm_sensor *e;
+	long i = cuc_sensor_shm_find(d, d->num_sensors, sensor_id);
+
+	if (i < 0)
+		return -ENOENT;
+	e = &d->sensor[i];
+	e->status = status;
+	if (status || !rsp) {
+		e->value = NAN;
+		return 0;
+	}
+
+	e->opstate = rsp->sensor_operational_state;
+	e->present_state = rsp->present_state;
+	e->event_state = rsp->event_state;
+	e->read_us = now;
+	e->reads++;
+	if (rsp->sensor_operational_state == PLDM_OPSTATE_ENABLED &&
+	    rsp->sensor_data_size == s->pdr[i]->sensor_data_size)
+		e->value = pldm_sensor_convert(s->pdr[i], rsp->present_reading);
+	else
+		e->value = NAN;
+	return 0;
+}
+
+/**
+ * cuc_sensor_shm_poll_fn() - pldm_poll_fn that stages each reading
+ *
+ * For a pldm_poll initialized with the collector's struct cuc_sensor_shm as 'priv'.
+ */
+static inline void cuc_sensor_shm_poll_fn(struct pldm_poll *p, struct pldm_poll_sensor *ps,
+					  const struct get_sensor_reading_rsp *rsp, int status)
+{
+	cuc_sensor_shm_update_sensor((struct cuc_sensor_shm *)p->priv, ps->sensor_id, rsp, status,
+				     cuc_xport_now_us());
+}
+
+/**
+ * cuc_sensor_shm_collect_uc() - Read the fan and the interrupt registers of one uC
+ * @s: Handle from cuc_sensor_shm_create()
+ * @uc: Index of the uC, below CUC_SENSOR_SHM_MAX_UCS
+ * @x: Transport to the uC
+ * @num_nics: NICs served by the uC
+ *
+ * One CUC_CMD_GET_FAN_RPM and one CUC_CMD_GET_INTR per NIC are sent together and
+ * the results are staged. Interrupt status bits are only read, not cleared.
+ *
+ * Return: 0 if every command succeeded, otherwise the first negative errno
+ */
+static inline int cuc_sensor_shm_collect_uc(struct cuc_sensor_shm *s, unsigned int uc, struct cuc_xport *x,
+					    unsigned int num_nics)
+{
+	struct cuc_xport_req *reqs[1 + CUC_SENSOR_SHM_MAX_NICS];
+	struct cuc_sensor_shm_uc *u;
+	unsigned int i, n = 0;
+	int err = 0;
+	u64 now;
+	int rc;
+
+	if (uc >= CUC_SENSOR_SHM_MAX_UCS)
+		return -EINVAL;
+	if (num_nics > CUC_SENSOR_SHM_MAX_NICS)
+		num_nics = CUC_SENSOR_SHM_MAX_NICS;
+	u = &s->stage->uc[uc];
+	u->num_nics = (u8)num_nics;
+	if (uc >= s->stage->num_ucs)
+		s->stage->num_ucs = uc + 1;
+
+	cuc_xport_req_init(&s->req[n], CUC_CMD_GET_FAN_RPM, NULL, 0);
+	reqs[n] = &s->req[n];
+	n++;
+	for (i = 0; i < num_nics; i++) {
+		struct cuc_get_intr_req_data rq;
+
+		rq.nic = (u8)i;
+		cuc_xport_req_init(&s->req[n], CUC_CMD_GET_INTR, &rq, sizeof(rq));
+		reqs[n] = &s->req[n];
+		n++;
+	}
+
+	rc = cuc_xport_submit(x, reqs, n);
+	if (rc < 0)
+		return rc;
+	for (i = 0; i < n; i++)
+		cuc_xport_wait(x, reqs[i]);
+	now = cuc_xport_now_us();
+
+	rc = s->req[0].status;
+	if (!rc && cuc_xport_rsp_len(&s->req[0]) < sizeof(struct cuc_get_fan_rpm_rsp_data))
+		rc = -EPROTO;
+	u->fan_status = rc;
+	if (!rc) {
+		struct cuc_get_fan_rpm_rsp_data fr;
+
+		memcpy(&fr, s->req[0].rsp.data, sizeof(fr));
+		u->fan_rpm = fr.rpm;
+		u->fan_percent = fr.percent;
+		u->fan_auto = fr.is_auto;
+		u->fan_read_us = now;
+	}
+	err = rc;
+
+	for (i = 0; i < num_nics; i++) {
+		struct cuc_xport_req *r = &s->req[1 + i];
+		struct cuc_sensor_shm_nic *sn = &u->nic[i];
+
+		rc = r->status;
+		if (!rc && cuc_xport_rsp_len(r) < sizeof(struct cuc_get_intr_rsp_data))
+			rc = -EPROTO;
+		sn->status = rc;
+		if (!rc) {
+			struct cuc_get_intr_rsp_data ir;
+
+			memcpy(&ir, r->rsp.data, sizeof(ir));
+			sn->isr = ir.isr;
+			sn->ier = ir.ier;
+			sn->read_us = now;
+		} else if (!err) {
+			err = rc;
+		}
+	}
+	return err;
+}
+
+/**
+ * cuc_sensor_shm_publish() - Make the staged readings visible to readers
+ * @s: Handle from cuc_sensor_shm_create()
+ * @now: Time from cuc_xport_now_us()
+ */
+static inline void cuc_sensor_shm_publish(struct cuc_sensor_shm *s, u64 now)
+{
+	u64 seq = __atomic_load_n(&s->shm->seq, __ATOMIC_RELAXED);
+
+	s->stage->update_us = now;
+	s->stage->generation++;
+
+	__atomic_store_n(&s->shm->seq, seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	memcpy(s->data, s->stage, cuc_sensor_shm_data_size(s->stage->num_sensors));
+	__atomic_store_n(&s->shm->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+/*
+ * Wait for the counter to be even and return it in *seq. A publish in progress is
+ * waited for; only a count that stays odd, i.e. a collector that stopped in the
+ * middle of a publish, makes the reader give up.
+ */
+static inline int cuc_sensor_shm_read_begin(const struct cuc_sensor_shm *s, u64 *seq)
+{
+	unsigned int spins = 0;
+	u64 last = 0;
+
+	for (;;) {
+		u64 v = __atomic_load_n(&s->shm->seq, __ATOMIC_ACQUIRE);
+
+		if (!v)
+			return -ENODATA;
+		if (!(v & 1)) {
+			*seq = v;
+			return 0;
+		}
+		if (v != last) {
+			last = v;
+			spins = 0;
+		} else if (++spins >= CUC_SENSOR_SHM_STALL_SPINS) {
+			return -EAGAIN;
+		}
+	}
+}
+
+/* Returns non-zero if what was copied since cuc_sensor_shm_read_begin() may be torn */
+static inline int cuc_sensor_shm_read_retry(const struct cuc_sensor_shm *s, u64 seq)
+{
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	return __atomic_load_n(&s->shm->seq, __ATOMIC_RELAXED) != seq;
+}
+
+/* Number of sensors to copy, bounded by the capacity in case the count is torn */
+static inline unsigned int cuc_sensor_shm_num_sensors(const struct cuc_sensor_shm *s)
+{
+	u32 n = __atomic_load_n(&s->data->num_sensors, __ATOMIC_RELAXED);
+
+	return n > s->shm->max_sensors ? s->shm->max_sensors : n;
+}
+
+/**
+ * cuc_sensor_shm_snapshot() - Copy a consistent snapshot of the whole region
+ * @s: Handle from cuc_sensor_shm_open() or cuc_sensor_shm_create()
+ * @out: Buffer of cuc_sensor_shm_data_size(s->shm->max_sensors) bytes
+ *
+ * Return: 0 on success, -ENODATA if nothing was published yet, -EAGAIN if the
+ * collector stayed in the middle of a publish (e.g. it died there)
+ */
+static inline int cuc_sensor_shm_snapshot(const struct cuc_sensor_shm *s, struct cuc_sensor_shm_data *out)
+{
+	u64 seq;
+	int rc;
+
+	do {
+		rc = cuc_sensor_shm_read_begin(s, &seq);
+		if (rc)
+			return rc;
+		memcpy(out, s->data, cuc_sensor_shm_data_size(cuc_sensor_shm_num_sensors(s)));
+	} while (cuc_sensor_shm_read_retry(s, seq));
+	return 0;
+}
+
+/**
+ * cuc_sensor_shm_read_sensor() - Copy the latest reading of one sensor
+ * @s: Handle from cuc_sensor_shm_open() or cuc_sensor_shm_create()
+ * @sensor_id: Sensor to look up
+ * @out: Output
+ *
+ * Return: 0 on success, -ENOENT if the sensor is not collected, other errors as
+ * cuc_sensor_shm_snapshot()
+ */
+static inline int cuc_sensor_shm_read_sensor(const struct cuc_sensor_shm *s, u16 sensor_id,
+					     struct cuc_sensor_shm_sensor *out)
+{
+	u64 seq;
+	long i;
+	int rc;
+
+	do {
+		rc = cuc_sensor_shm_read_begin(s, &seq);
+		if (rc)
+			return rc;
+		/* A torn search can only pick the wrong in-bounds entry, which the recheck rejects */
+		i = cuc_sensor_shm_find(s->data, cuc_sensor_shm_num_sensors(s), sensor_id);
+		if (i >= 0)
+			memcpy(out, &s->data->sensor[i], sizeof(*out));
+	} while (cuc_sensor_shm_read_retry(s, seq));
+	return i >= 0 ? 0 : -ENOENT;
+}
+
+/**
+ * cuc_sensor_shm_read_uc() - Copy the latest fan and interrupt state of one uC
+ *
+ * Return: 0 on success, -ENOENT if the uC is not collected, other errors as
+ * cuc_sensor_shm_snapshot()
+ */
+static inline int cuc_sensor_shm_read_uc(const struct cuc_sensor_shm *s, unsigned int uc,
+					 struct cuc_sensor_shm_uc *out)
+{
+	u32 num_ucs;
+	u64 seq;
+	int rc;
+
+	if (uc >= CUC_SENSOR_SHM_MAX_UCS)
+		return -ENOENT;
+	do {
+		rc = cuc_sensor_shm_read_begin(s, &seq);
+		if (rc)
+			return rc;
+		num_ucs = __atomic_load_n(&s->data->num_ucs, __ATOMIC_RELAXED);
+		memcpy(out, &s->data->uc[uc], sizeof(*out));
+	} while (cuc_sensor_shm_read_retry(s, seq));
+	return uc < num_ucs ? 0 : -ENOENT;
+}
+
+#endif /* CUC_SENSOR_SHM_H */
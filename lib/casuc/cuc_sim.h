@@ -0,0 +1,1131 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* This file implements a software Cassini uC that speaks struct cuc_pkt and plugs
+ * into the transport engine in cuc_xport.h as a local backend.
+ *
+ * The simulator implements every CUC_CMD_* in cuc_cxi.h, including page addressable
+ * QSFP and I2C EEPROM images, the ATT1 interrupt registers, the FWU_STATUS_* firmware
+ * update state machine and a PLDM responder serving GetPDR and GetSensorReading from a
+ * caller supplied PDR repository. Each command can be given a latency, jitter, error
+ * rate and drop rate, and the link can be limited to a fixed bandwidth, so host tooling
+ * can be exercised and benchmarked without hardware.
+ *
+ * The simulator does not allocate. Memory for EEPROM images, the PDR repository and the
+ * sensor table is owned by the caller and must outlive the simulator.
+ */
+
+#ifndef CUC_SIM_H
+#define CUC_SIM_H
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "cuc_cxi.h"
+#include "cuc_xport.h"
+#include "pldm_cxi.h"
+
+#define CUC_SIM_NUM_CMDS        64    /* All CUC_CMD_* values are below this */
+#define CUC_SIM_MAX_NICS        2
+#define CUC_SIM_QSFP_PAGES      32    /* Upper pages 0x00 through 0x1F */
+#define CUC_SIM_QSFP_PAGE_SIZE  128
+#define CUC_SIM_MAX_I2C_DEVS    8
+#define CUC_SIM_LOG_DEPTH       64
+#define CUC_SIM_MAX_PDRS        256
+#define CUC_SIM_RSP_DEPTH       (2 * CUC_XPORT_MAX_INFLIGHT)
+#define CUC_SIM_FW_VERSION_LEN  32
+
+/* Largest record_data chunk that fits in a GetPDR response packet */
+#define CUC_SIM_GET_PDR_RSP_MAX  (CUC_DATA_BYTES - sizeof(struct get_pdr_rsp))
+
+/* Versions are kept for the running image and each flash slot */
+enum {
+	CUC_SIM_FW_RUNNING,
+	CUC_SIM_FW_FLASH_SLOT0,
+	CUC_SIM_FW_FLASH_SLOT1,
+	CUC_SIM_FW_COPIES
+};
+
+/**
+ * struct cuc_sim_cmd_cfg - Fault and timing injection for one CUC_CMD_*
+ */
+struct cuc_sim_cmd_cfg {
+	u32 latency_us;  /* Round-trip link latency, overlaps between requests in flight */
+	u32 service_us;  /* uC processing time, requests are serviced one at a time */
+	u32 jitter_us;   /* Uniformly distributed extra processing time */
+	u32 error_ppm;   /* Probability (per million) of a CUC_TYPE_RSP_ERROR/EIO response */
+	u32 drop_ppm;    /* Probability (per million) that no response is sent */
+};
+
+/**
+ * struct cuc_sim_i2c_dev - EEPROM-like device on a uC I2C bus
+ */
+struct cuc_sim_i2c_dev {
+	u8 bus;         /* I2C bus number */
+	u8 addr;        /* 7-bit slave address */
+	u8 addr16;      /* Non-zero for devices using 16-bit register offsets */
+	u8 *image;      /* Device contents */
+	u32 size;       /* Size of 'image' */
+	u32 pointer;    /* Current address pointer */
+};
+
+/**
+ * struct cuc_sim_sensor - Value reported by GetSensorReading for one sensor
+ */
+struct cuc_sim_sensor {
+	u16 sensor_id;
+	u8 data_size;              /* enum pldm_data_size */
+	u8 operational_state;      /* enum pldm_sensor_opstate */
+	u8 present_state;
+	u8 previous_state;
+	u8 event_state;
+	union sensor_value value;
+};
+
+struct cuc_sim_nic {
+	u32 isr;
+	u32 ier;
+	u8 mac[6];
+	u8 led[3];
+	u8 qsfp_present;
+	u8 qsfp_lower[CUC_SIM_QSFP_PAGE_SIZE];
+	u8 qsfp_upper[CUC_SIM_QSFP_PAGES][CUC_SIM_QSFP_PAGE_SIZE];
+	char fw_version[CUC_SIM_FW_COPIES][FW_NUM_ENTRIES][CUC_SIM_FW_VERSION_LEN];
+};
+
+struct cuc_sim_pdr {
+	const struct pdr_hdr *hdr;
+	u32 len;                   /* Header plus data_length */
+};
+
+struct cuc_sim_rsp {
+	struct cuc_pkt pkt;
+	u64 due_us;
+};
+
+/**
+ * struct cuc_sim - Simulated Cassini uC
+ */
+struct cuc_sim {
+	/* Configuration */
+	s8 board_type;             /* CUC_BOARD_TYPE_* */
+	u8 board_rev;
+	u8 num_nics;
+	u8 this_nic;               /* NIC reported by CUC_CMD_GET_NIC_ID */
+	u8 uc_mac[6];
+	unsigned int max_inflight; /* Depth advertised to the transport engine */
+	u32 bus_bytes_per_sec;     /* 0 for unlimited */
+	u32 fwu_phase_us;          /* Duration of each post-download FWU_STATUS_* phase */
+	u8 fwu_fail_status;        /* FWU_STATUS_FAILED_* to end updates with, 0 for success */
+	u32 pldm_not_ready_ppm;    /* Probability of PLDM_ERROR_NOT_READY */
+	struct cuc_sim_cmd_cfg cmd[CUC_SIM_NUM_CMDS];
+
+	/* Device state */
+	struct cuc_sim_nic nic[CUC_SIM_MAX_NICS];
+	struct cuc_sim_i2c_dev i2c[CUC_SIM_MAX_I2C_DEVS];
+	unsigned int num_i2c;
+	u8 fan_percent;
+	u8 fan_auto;
+	u32 fan_max_rpm;
+	u64 timings_us[TIMING_NUM_ENTRIES];
+	u64 boot_us;
+	const u8 *fru;
+	unsigned int fru_len;
+
+	/* Log messages, oldest first */
+	char log[CUC_SIM_LOG_DEPTH][CUC_DATA_BYTES];
+	u8 log_len[CUC_SIM_LOG_DEPTH];
+	unsigned int log_head;
+	unsigned int log_count;
+
+	/* Firmware update state machine */
+	char fwu_image[FW_NUM_ENTRIES][CUC_SIM_FW_VERSION_LEN];  /* Versions in the image being flashed */
+	u8 fwu_status;
+	u8 fwu_nic;
+	u8 fwu_slot;
+	u32 fwu_size;
+	u32 fwu_received;
+	u64 fwu_phase_start_us;
+
+	/* PLDM */
+	struct cuc_sim_pdr pdr[CUC_SIM_MAX_PDRS];
+	unsigned int num_pdrs;
+	struct cuc_sim_sensor *sensors;
+	unsigned int num_sensors;
+
+	/* Responses waiting for their service time to elapse */
+	struct cuc_sim_rsp rsp[CUC_SIM_RSP_DEPTH];
+	unsigned int rsp_head;
+	unsigned int rsp_count;
+	u64 last_due_us;
+	u64 bus_free_us;
+	u64 uc_free_us;
+	u64 rng;
+
+	/* Counters */
+	unsigned long requests[CUC_SIM_NUM_CMDS];
+	unsigned long injected_errors;
+	unsigned long dropped;
+};
+
+static inline u32 cuc_sim_rand(struct cuc_sim *sim)
+{
+	/* xorshift64* */
+	sim->rng ^= sim->rng >> 12;
+	sim->rng ^= sim->rng << 25;
+	sim->rng ^= sim->rng >> 27;
+	return (u32)((sim->rng * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+static inline int cuc_sim_chance(struct cuc_sim *sim, u32 ppm)
+{
+	return ppm && (cuc_sim_rand(sim) % 1000000) < ppm;
+}
+
+/**
+ * cuc_sim_init() - Initialize a simulated uC
+ * @sim: Simulator
+ * @board_type: CUC_BOARD_TYPE_* to report
+ * @board_rev: Board revision to report
+ * @num_nics: Number of NICs served by this uC (1 or 2)
+ *
+ * All commands start with zero latency and no faults. Firmware versions are empty,
+ * which makes CUC_CMD_FIRMWARE_VERSION fail with ENOENT for that target.
+ */
+static inline void cuc_sim_init(struct cuc_sim *sim, int board_type, u8 board_rev, u8 num_nics)
+{
+	unsigned int n, i;
+
+	memset(sim, 0, sizeof(*sim));
+	sim->board_type = (s8)board_type;
+	sim->board_rev = board_rev;
+	sim->num_nics = num_nics > CUC_SIM_MAX_NICS ? CUC_SIM_MAX_NICS : num_nics;
+	sim->max_inflight = CUC_XPORT_MAX_INFLIGHT;
+	sim->fwu_status = FWU_STATUS_IDLE;
+	sim->fwu_phase_us = 1000;
+	sim->fan_auto = 1;
+	sim->fan_percent = 40;
+	sim->fan_max_rpm = 12000;
+	sim->rng = 0x9E3779B97F4A7C15ULL;
+	sim->boot_us = cuc_xport_now_us();
+
+	for (i = 0; i < 6; i++)
+		sim->uc_mac[i] = (u8)(0x02 + i);
+	for (n = 0; n < CUC_SIM_MAX_NICS; n++) {
+		struct cuc_sim_nic *nic = &sim->nic[n];
+
+		nic->ier = ATT1_ALL_INTERRUPTS;
+		nic->isr = ATT1_UC_RESET;
+		nic->qsfp_present = 1;
+		for (i = 0; i < 6; i++)
+			nic->mac[i] = (u8)(0x10 * (n + 1) + i);
+	}
+	for (i = 0; i < TIMING_NUM_ENTRIES; i++)
+		sim->timings_us[i] = (u64)(i + 1) * 10000;
+}
+
+/* Set the latency, jitter and fault rates of one command, or of all commands if cmd < 0 */
+static inline void cuc_sim_set_cmd_cfg(struct cuc_sim *sim, int cmd, const struct cuc_sim_cmd_cfg *cfg)
+{
+	int i;
+
+	for (i = 0; i < CUC_SIM_NUM_CMDS; i++)
+		if (cmd < 0 || cmd == i)
+			sim->cmd[i] = *cfg;
+}
+
+/**
+ * cuc_sim_add_i2c_dev() - Attach an EEPROM image to an I2C bus
+ *
+ * Return: 0 on success, -EINVAL for an empty image, -ENOSPC when the device table
+ * is full
+ */
+static inline int cuc_sim_add_i2c_dev(struct cuc_sim *sim, u8 bus, u8 addr, int addr16,
+				      u8 *image, u32 size)
+{
+	struct cuc_sim_i2c_dev *dev;
+
+	if (!size)
+		return -EINVAL;
+	if (sim->num_i2c >= CUC_SIM_MAX_I2C_DEVS)
+		return -ENOSPC;
+	dev = &sim->i2c[sim->num_i2c++];
+	dev->bus = bus;
+	dev->addr = addr;
+	dev->addr16 = addr16 ? 1 : 0;
+	dev->image = image;
+	dev->size = size;
+	dev->pointer = 0;
+	return 0;
+}
+
+/**
+ * cuc_sim_set_pdr_repo() - Serve a PDR repository
+ * @sim: Simulator
+ * @repo: Concatenated PDRs, each a struct pdr_hdr followed by data_length bytes
+ * @len: Size of @repo
+ *
+ * The repository is indexed, not copied. Records may be changed in place afterwards
+ * as long as their size does not change; bump record_change_number when doing so.
+ *
+ * Return: Number of records, or -EINVAL on a malformed repository
+ */
+static inline int cuc_sim_set_pdr_repo(struct cuc_sim *sim, const void *repo, size_t len)
+{
+	const u8 *p = (const u8 *)repo;
+	size_t off = 0;
+
+	sim->num_pdrs = 0;
+	while (off < len) {
+		const struct pdr_hdr *hdr = (const struct pdr_hdr *)(p + off);
+		size_t rec;
+
+		if (len - off < sizeof(*hdr) || sim->num_pdrs >= CUC_SIM_MAX_PDRS)
+			return -EINVAL;
+		rec = sizeof(*hdr) + hdr->data_length;
+		if (rec > len - off)
+			return -EINVAL;
+		sim->pdr[sim->num_pdrs].hdr = hdr;
+		sim->pdr[sim->num_pdrs].len = (u32)rec;
+		sim->num_pdrs++;
+		off += rec;
+	}
+	return (int)sim->num_pdrs;
+}
+
+/* Serve GetSensorReading values from a caller owned table */
+static inline void cuc_sim_set_sensors(struct cuc_sim *sim, struct cuc_sim_sensor *sensors, unsigned int n)
+{
+	sim->sensors = sensors;
+	sim->num_sensors = n;
+}
+
+static inline struct cuc_sim_sensor *cuc_sim_find_sensor(struct cuc_sim *sim, u16 sensor_id)
+{
+	unsigned int i;
+
+	for (i = 0; i < sim->num_sensors; i++)
+		if (sim->sensors[i].sensor_id == sensor_id)
+			return &sim->sensors[i];
+	return NULL;
+}
+
+/**
+ * cuc_sim_set_fw_version() - Set the version reported for a firmware component
+ * @copy: CUC_SIM_FW_RUNNING or CUC_SIM_FW_FLASH_SLOT0/1
+ */
+static inline void cuc_sim_set_fw_version(struct cuc_sim *sim, unsigned int target, unsigned int nic,
+					  unsigned int copy, const char *version)
+{
+	if (target >= FW_NUM_ENTRIES || nic >= CUC_SIM_MAX_NICS || copy >= CUC_SIM_FW_COPIES)
+		return;
+	snprintf(sim->nic[nic].fw_version[copy][target], CUC_SIM_FW_VERSION_LEN, "%s", version);
+}
+
+/* Set the version of a component contained in the image accepted by the next firmware update */
+static inline void cuc_sim_set_fwu_image_version(struct cuc_sim *sim, unsigned int target, const char *version)
+{
+	if (target >= FW_NUM_ENTRIES)
+		return;
+	snprintf(sim->fwu_image[target], CUC_SIM_FW_VERSION_LEN, "%s", version);
+}
+
+/* Latch interrupt status bits, as the uC does when an event occurs */
+static inline void cuc_sim_raise(struct cuc_sim *sim, unsigned int nic, u32 bits)
+{
+	if (nic >= CUC_SIM_MAX_NICS)
+		return;
+	sim->nic[nic].isr |= bits;
+	if (bits & ATT1_QSFP_INSERT)
+		sim->nic[nic].qsfp_present = 1;
+	if (bits & ATT1_QSFP_REMOVE)
+		sim->nic[nic].qsfp_present = 0;
+}
+
+/* State of UC_ATTENTION[1] for a NIC: any enabled interrupt is pending */
+static inline int cuc_sim_attention(const struct cuc_sim *sim, unsigned int nic)
+{
+	if (nic >= CUC_SIM_MAX_NICS)
+		return 0;
+	return (sim->nic[nic].isr & sim->nic[nic].ier) != 0;
+}
+
+/* Queue a uC log message for CUC_CMD_GET_LOG. The oldest message is lost when full. */
+static inline void cuc_sim_log(struct cuc_sim *sim, const char *fmt, ...)
+{
+	unsigned int slot;
+	va_list ap;
+	int len;
+
+	if (sim->log_count == CUC_SIM_LOG_DEPTH) {
+		sim->log_head = (sim->log_head + 1) % CUC_SIM_LOG_DEPTH;
+		sim->log_count--;
+	}
+	slot = (sim->log_head + sim->log_count) % CUC_SIM_LOG_DEPTH;
+
+	va_start(ap, fmt);
+	len = vsnprintf(sim->log[slot], CUC_DATA_BYTES, fmt, ap);
+	va_end(ap);
+	if (len < 0)
+		len = 0;
+	if (len > CUC_DATA_BYTES - 1)
+		len = CUC_DATA_BYTES - 1;
+	sim->log_len[slot] = (u8)len;
+	sim->log_count++;
+}
+
+/* Advance the post-download phases of a firmware update based on elapsed time */
+static inline void cuc_sim_fwu_advance(struct cuc_sim *sim, u64 now)
+{
+	struct cuc_sim_nic *nic;
+	unsigned int t;
+
+	while (sim->fwu_status >= FWU_STATUS_VERIFYING_SIGNATURE &&
+	       sim->fwu_status <= FWU_STATUS_VERIFYING_FLASH &&
+	       now - sim->fwu_phase_start_us >= sim->fwu_phase_us) {
+		sim->fwu_phase_start_us += sim->fwu_phase_us;
+
+		if (sim->fwu_fail_status &&
+		    ((sim->fwu_fail_status == FWU_STATUS_FAILED_BAD_SIGN &&
+		      sim->fwu_status == FWU_STATUS_VERIFYING_SIGNATURE) ||
+		     (sim->fwu_fail_status == FWU_STATUS_FAILED_VALIDATION &&
+		      sim->fwu_status == FWU_STATUS_VALIDATING_IMAGE) ||
+		     (sim->fwu_fail_status == FWU_STATUS_FAILED_FLASH &&
+		      sim->fwu_status == FWU_STATUS_FLASHING) ||
+		     (sim->fwu_fail_status == FWU_STATUS_FAILED_VERIFICATION &&
+		      sim->fwu_status == FWU_STATUS_VERIFYING_FLASH) ||
+		     (sim->fwu_fail_status == FWU_STATUS_FAILED &&
+		      sim->fwu_status == FWU_STATUS_VERIFYING_FLASH))) {
+			sim->fwu_status = sim->fwu_fail_status;
+			cuc_sim_log(sim, "fwu: nic %u slot %u failed (0x%x)", sim->fwu_nic, sim->fwu_slot,
+				    sim->fwu_status);
+			return;
+		}
+
+		if (sim->fwu_status == FWU_STATUS_VERIFYING_FLASH) {
+			/* The components in the new blob become the stored versions of the slot */
+			nic = &sim->nic[sim->fwu_nic];
+			for (t = 0; t < FW_NUM_ENTRIES; t++)
+				if (sim->fwu_image[t][0])
+					memcpy(nic->fw_version[CUC_SIM_FW_FLASH_SLOT0 + sim->fwu_slot][t],
+					       sim->fwu_image[t], CUC_SIM_FW_VERSION_LEN);
+			sim->fwu_status = FWU_STATUS_SUCCESS;
+			cuc_sim_log(sim, "fwu: nic %u slot %u updated", sim->fwu_nic, sim->fwu_slot);
+			return;
+		}
+		sim->fwu_status++;
+	}
+}
+
+static inline struct cuc_sim_i2c_dev *cuc_sim_find_i2c(struct cuc_sim *sim, u8 bus, u8 addr)
+{
+	unsigned int i;
+
+	for (i = 0; i < sim->num_i2c; i++)
+		if (sim->i2c[i].bus == bus && sim->i2c[i].addr == addr)
+			return &sim->i2c[i];
+	return NULL;
+}
+
+/* Locate 'count' bytes of QSFP memory at page/addr. Accesses may not span the lower/upper boundary. */
+static inline u8 *cuc_sim_qsfp_mem(struct cuc_sim *sim, u8 nic, u8 page, u8 addr, u8 count)
+{
+	struct cuc_sim_nic *n;
+
+	if (nic == CUC_MAC_THIS_NIC)
+		nic = sim->this_nic;
+	if (nic >= sim->num_nics || count == 0)
+		return NULL;
+	n = &sim->nic[nic];
+	if (!n->qsfp_present)
+		return NULL;
+	if (addr < CUC_SIM_QSFP_PAGE_SIZE) {
+		if (addr + count > CUC_SIM_QSFP_PAGE_SIZE)
+			return NULL;
+		return &n->qsfp_lower[addr];
+	}
+	if (page >= CUC_SIM_QSFP_PAGES || addr + count > 2 * CUC_SIM_QSFP_PAGE_SIZE)
+		return NULL;
+	return &n->qsfp_upper[page][addr - CUC_SIM_QSFP_PAGE_SIZE];
+}
+
+static inline int cuc_sim_pldm_get_pdr(struct cuc_sim *sim, const u8 *msg, unsigned int len, u8 *out)
+{
+	struct get_pdr_req req;
+	struct get_pdr_rsp *rsp = (struct get_pdr_rsp *)out;
+	const struct cuc_sim_pdr *pdr = NULL;
+	unsigned int i, idx = 0;
+	u32 off, n, max;
+
+	if (len < sizeof(req)) {
+		rsp->completion_code = PLDM_ERROR_INVALID_LENGTH;
+		return offsetof(struct get_pdr_rsp, next_record_handle);
+	}
+	memcpy(&req, msg, sizeof(req));
+
+	for (i = 0; i < sim->num_pdrs; i++) {
+		if (req.record_handle == 0 || sim->pdr[i].hdr->record_handle == req.record_handle) {
+			pdr = &sim->pdr[i];
+			idx = i;
+			break;
+		}
+	}
+	if (!pdr) {
+		rsp->completion_code = PLDM_GET_PDR_INVALID_RECORD_HANDLE;
+		return offsetof(struct get_pdr_rsp, next_record_handle);
+	}
+
+	if (req.transfer_operation_flag == PLDM_XFER_OP_GET_FIRST_PART) {
+		off = 0;
+	} else if (req.transfer_operation_flag == PLDM_XFER_OP_GET_NEXT_PART) {
+		if (req.record_change_number != pdr->hdr->record_change_number) {
+			rsp->completion_code = PLDM_GET_PDR_INVALID_RECORD_CHANGE_NUMBER;
+			return offsetof(struct get_pdr_rsp, next_record_handle);
+		}
+		off = req.data_transfer_handle;
+		if (off == 0 || off >= pdr->len) {
+			rsp->completion_code = PLDM_GET_PDR_INVALID_DATA_TRANSFER_HANDLE;
+			return offsetof(struct get_pdr_rsp, next_record_handle);
+		}
+	} else {
+		rsp->completion_code = PLDM_GET_PDR_INVALID_TRANSFER_OPERATION_FLAG;
+		return offsetof(struct get_pdr_rsp, next_record_handle);
+	}
+
+	max = CUC_SIM_GET_PDR_RSP_MAX;
+	n = pdr->len - off;
+	if (n > req.request_count)
+		n = req.request_count;
+	if (n > max)
+		n = max;
+
+	rsp->completion_code = PLDM_SUCCESS;
+	rsp->next_record_handle = idx + 1 < sim->num_pdrs ? sim->pdr[idx + 1].hdr->record_handle : 0;
+	rsp->next_data_transfer_handle = off + n < pdr->len ? off + n : 0;
+	if (off == 0)
+		rsp->transfer_flag = off + n < pdr->len ? PLDM_XFER_FLAG_START : PLDM_XFER_FLAG_START_AND_END;
+	else
+		rsp->transfer_flag = off + n < pdr->len ? PLDM_XFER_FLAG_MIDDLE : PLDM_XFER_FLAG_END;
+	rsp->response_count = (u16)n;
+	memcpy(rsp->record_data, (const u8 *)pdr->hdr + off, n);
+	return (int)(sizeof(*rsp) + n);
+}
+
+static inline int cuc_sim_pldm_get_sensor_reading(struct cuc_sim *sim, const u8 *msg, unsigned int len,
+						  u8 *out)
+{
+	struct get_sensor_reading_req req;
+	struct get_sensor_reading_rsp *rsp = (struct get_sensor_reading_rsp *)out;
+	struct cuc_sim_sensor *s;
+	unsigned int size;
+
+	if (len < sizeof(req)) {
+		rsp->completion_code = PLDM_ERROR_INVALID_LENGTH;
+		return offsetof(struct get_sensor_reading_rsp, sensor_data_size);
+	}
+	memcpy(&req, msg, sizeof(req));
+
+	s = cuc_sim_find_sensor(sim, req.sensor_id);
+	if (!s) {
+		/* DSP0248 Table 30: INVALID_SENSOR_ID */
+		rsp->completion_code = PLDM_ERROR_COMMAND_SPECIFIC_START + 0x02;
+		return offsetof(struct get_sensor_reading_rsp, sensor_data_size);
+	}
+
+	rsp->completion_code = PLDM_SUCCESS;
+	rsp->sensor_data_size = s->data_size;
+	rsp->sensor_operational_state = s->operational_state;
+	rsp->sensor_event_message_enable = 0;
+	rsp->present_state = s->present_state;
+	rsp->previous_state = s->previous_state;
+	rsp->event_state = s->event_state;
+	rsp->present_reading = s->value;
+
+	switch (s->data_size) {
+	case PLDM_DATA_SIZE_UINT8:
+	case PLDM_DATA_SIZE_SINT8:
+		size = 1;
+		break;
+	case PLDM_DATA_SIZE_UINT16:
+	case PLDM_DATA_SIZE_SINT16:
+		size = 2;
+		break;
+	default:
+		size = 4;
+		break;
+	}
+	return (int)(offsetof(struct get_sensor_reading_rsp, present_reading) + size);
+}
+
+/* Service one PLDM request message. Returns the response message length. */
+static inline int cuc_sim_pldm(struct cuc_sim *sim, const u8 *msg, unsigned int len, u8 *out)
+{
+	const struct pldm_hdr *hdr = (const struct pldm_hdr *)msg;
+	struct pldm_hdr *rhdr = (struct pldm_hdr *)out;
+	u8 *cc = out + sizeof(*rhdr);
+
+	if (len < sizeof(*hdr))
+		return -EINVAL;
+
+	memcpy(rhdr, hdr, sizeof(*rhdr));
+	rhdr->rq = 0;
+	rhdr->d = 0;
+
+	if (cuc_sim_chance(sim, sim->pldm_not_ready_ppm)) {
+		*cc = PLDM_ERROR_NOT_READY;
+		return sizeof(*rhdr) + 1;
+	}
+	if (hdr->pldm_type != PLDM_TYPE_PLATFORM_MONITORING_AND_CONTROL) {
+		*cc = PLDM_ERROR_INVALID_PLDM_TYPE;
+		return sizeof(*rhdr) + 1;
+	}
+
+	switch (hdr->pldm_command_code) {
+	case PLDM_CMD_GET_PDR:
+		return cuc_sim_pldm_get_pdr(sim, msg, len, out);
+	case PLDM_CMD_GET_SENSOR_READING:
+		return cuc_sim_pldm_get_sensor_reading(sim, msg, len, out);
+	default:
+		*cc = PLDM_ERROR_UNSUPPORTED_CMD;
+		return sizeof(*rhdr) + 1;
+	}
+}
+
+/**
+ * cuc_sim_handle() - Execute one request packet
+ * @sim: Simulator
+ * @req: Request packet
+ * @rsp: Response packet
+ *
+ * This is the functional model only; timing and fault injection are applied by the
+ * transport backend. It can be called directly to test request encoders.
+ */
+static inline void cuc_sim_handle(struct cuc_sim *sim, const struct cuc_pkt *req, struct cuc_pkt *rsp)
+{
+	const u8 *d = req->data;
+	unsigned int len = req->count ? req->count - 1u : 0;
+	u8 *o = rsp->data;
+	int err = 0;
+	int olen = 0;
+	u64 now = cuc_xport_now_us();
+
+	if (len > CUC_DATA_BYTES)
+		len = CUC_DATA_BYTES;
+
+	memset(rsp, 0, sizeof(*rsp));
+	rsp->cmd = req->cmd;
+
+	if (req->type != CUC_TYPE_REQ) {
+		err = EPROTO;
+		goto out;
+	}
+
+	switch (req->cmd) {
+	case CUC_CMD_PING:
+		break;
+
+	case CUC_CMD_BOARD_INFO: {
+		struct cuc_board_info_rsp *bi = (struct cuc_board_info_rsp *)o;
+
+		bi->board_type = (u8)sim->board_type;
+		bi->board_rev = sim->board_rev;
+		olen = sizeof(*bi);
+		break;
+	}
+
+	case CUC_CMD_I2C_READ: {
+		struct cuc_i2c_read_req rq;
+		struct cuc_sim_i2c_dev *dev;
+
+		if (len < sizeof(rq)) {
+			err = EINVAL;
+			break;
+		}
+		memcpy(&rq, d, sizeof(rq));
+		dev = cuc_sim_find_i2c(sim, rq.bus, rq.addr);
+		if (!dev) {
+			err = ENXIO;
+			break;
+		}
+		if (rq.count > CUC_DATA_BYTES) {
+			err = EINVAL;
+			break;
+		}
+		if (rq.type == I2C_RANDOM_ADDR8_READ)
+			dev->pointer = rq.offset & 0xFF;
+		else if (rq.type == I2C_RANDOM_ADDR16_READ)
+			dev->pointer = rq.offset;
+		else if (rq.type != I2C_CURRENT_ADDR_READ) {
+			err = EINVAL;
+			break;
+		}
+		for (olen = 0; olen < rq.count; olen++) {
+			o[olen] = dev->image[dev->pointer % dev->size];
+			dev->pointer = (dev->pointer + 1) % dev->size;
+		}
+		break;
+	}
+
+	case CUC_CMD_I2C_WRITE: {
+		const struct cuc_i2c_write_req *wq = (const struct cuc_i2c_write_req *)d;
+		struct cuc_sim_i2c_dev *dev;
+		unsigned int hdr, i;
+
+		if (len < sizeof(*wq) || wq->count > len - sizeof(*wq)) {
+			err = EINVAL;
+			break;
+		}
+		dev = cuc_sim_find_i2c(sim, wq->bus, wq->addr);
+		if (!dev) {
+			err = ENXIO;
+			break;
+		}
+		/* The leading bytes set the address pointer, the rest are written */
+		hdr = dev->addr16 ? 2 : 1;
+		if (wq->count < hdr) {
+			err = EINVAL;
+			break;
+		}
+		dev->pointer = dev->addr16 ? ((u32)wq->buf[0] << 8 | wq->buf[1]) : wq->buf[0];
+		for (i = hdr; i < wq->count; i++) {
+			dev->image[dev->pointer % dev->size] = wq->buf[i];
+			dev->pointer = (dev->pointer + 1) % dev->size;
+		}
+		break;
+	}
+
+	case CUC_CMD_GET_LOG:
+		if (sim->log_count) {
+			olen = sim->log_len[sim->log_head];
+			memcpy(o, sim->log[sim->log_head], olen);
+			sim->log_head = (sim->log_head + 1) % CUC_SIM_LOG_DEPTH;
+			sim->log_count--;
+		}
+		break;
+
+	case CUC_CMD_GET_FRU:
+		olen = sim->fru_len > CUC_DATA_BYTES ? CUC_DATA_BYTES : sim->fru_len;
+		if (olen)
+			memcpy(o, sim->fru, olen);
+		break;
+
+	case CUC_CMD_SET_FAN_PWM: {
+		struct cuc_set_fan_pwm_req_data rq;
+
+		if (len < sizeof(rq)) {
+			err = EINVAL;
+			break;
+		}
+		memcpy(&rq, d, sizeof(rq));
+		if (rq.percent == 255) {
+			sim->fan_auto = 1;
+		} else if (rq.percent <= 100) {
+			sim->fan_auto = 0;
+			sim->fan_percent = rq.percent;
+		} else {
+			err = EINVAL;
+		}
+		break;
+	}
+
+	case CUC_CMD_GET_FAN_RPM: {
+		struct cuc_get_fan_rpm_rsp_data fr;
+
+		fr.rpm = sim->fan_max_rpm / 100 * sim->fan_percent;
+		fr.percent = sim->fan_percent;
+		fr.is_auto = sim->fan_auto;
+		memcpy(o, &fr, sizeof(fr));
+		olen = sizeof(fr);
+		break;
+	}
+
+	case CUC_CMD_GET_MAC: {
+		struct cuc_mac_rsp_data mr;
+		u8 nic = len ? d[0] : CUC_MAC_THIS_NIC;
+
+		if (nic == CUC_MAC_THIS_NIC)
+			nic = sim->this_nic;
+		if (nic >= sim->num_nics) {
+			err = EINVAL;
+			break;
+		}
+		mr.nic = nic;
+		memcpy(mr.nic_mac, sim->nic[nic].mac, 6);
+		memcpy(mr.uc_mac, sim->uc_mac, 6);
+		memcpy(o, &mr, sizeof(mr));
+		olen = sizeof(mr);
+		break;
+	}
+
+	case CUC_CMD_QSFP_READ: {
+		struct cuc_qsfp_read_req_data rq;
+		u8 *mem;
+
+		if (len < sizeof(rq)) {
+			err = EINVAL;
+			break;
+		}
+		memcpy(&rq, d, sizeof(rq));
+		if (rq.count > CUC_DATA_BYTES) {
+			err = EINVAL;
+			break;
+		}
+		mem = cuc_sim_qsfp_mem(sim, rq.nic, rq.page, rq.addr, rq.count);
+		if (!mem) {
+			err = rq.nic < sim->num_nics && !sim->nic[rq.nic].qsfp_present ? ENODEV : EINVAL;
+			break;
+		}
+		memcpy(o, mem, rq.count);
+		olen = rq.count;
+		break;
+	}
+
+	case CUC_CMD_QSFP_WRITE: {
+		const struct cuc_qsfp_write_req_data *wq = (const struct cuc_qsfp_write_req_data *)d;
+		u8 *mem;
+
+		if (len < sizeof(*wq) || wq->count > len - sizeof(*wq)) {
+			err = EINVAL;
+			break;
+		}
+		mem = cuc_sim_qsfp_mem(sim, wq->nic, wq->page, wq->addr, wq->count);
+		if (!mem) {
+			err = EINVAL;
+			break;
+		}
+		memcpy(mem, wq->data, wq->count);
+		break;
+	}
+
+	case CUC_CMD_QSFP_RESET:
+		if (!len || (d[0] >= sim->num_nics && d[0] != CUC_MAC_THIS_NIC))
+			err = EINVAL;
+		break;
+
+	case CUC_CMD_GET_INTR: {
+		struct cuc_get_intr_rsp_data ir;
+
+		if (!len || d[0] >= sim->num_nics) {
+			err = EINVAL;
+			break;
+		}
+		ir.isr = sim->nic[d[0]].isr;
+		ir.ier = sim->nic[d[0]].ier;
+		memcpy(o, &ir, sizeof(ir));
+		olen = sizeof(ir);
+		break;
+	}
+
+	case CUC_CMD_CLEAR_ISR: {
+		struct cuc_clear_isr_req_data rq;
+
+		if (len < sizeof(rq)) {
+			err = EINVAL;
+			break;
+		}
+		memcpy(&rq, d, sizeof(rq));
+		if (rq.nic >= sim->num_nics) {
+			err = EINVAL;
+			break;
+		}
+		sim->nic[rq.nic].isr &= ~(rq.isr_clear_bits & HOST_CLEARED_ATT1_INTERRUPTS);
+		break;
+	}
+
+	case CUC_CMD_UPDATE_IER: {
+		struct cuc_update_ier_req_data rq;
+
+		if (len < sizeof(rq)) {
+			err = EINVAL;
+			break;
+		}
+		memcpy(&rq, d, sizeof(rq));
+		if (rq.nic >= sim->num_nics) {
+			err = EINVAL;
+			break;
+		}
+		sim->nic[rq.nic].ier |= rq.ier_set_bits;
+		sim->nic[rq.nic].ier &= ~rq.ier_clear_bits;
+		break;
+	}
+
+	case CUC_CMD_PLDM:
+		olen = cuc_sim_pldm(sim, d, len, o);
+		if (olen < 0) {
+			err = -olen;
+			olen = 0;
+			break;
+		}
+		rsp->type = CUC_TYPE_RSP_PLDM;
+		break;
+
+	case CUC_CMD_FIRMWARE_UPDATE_START: {
+		struct cuc_firmware_update_start_req rq;
+
+		if (len < sizeof(rq)) {
+			err = EINVAL;
+			break;
+		}
+		cuc_sim_fwu_advance(sim, now);
+		if (sim->fwu_status < FWU_STATUS_IDLE) {
+			err = EBUSY;
+			break;
+		}
+		memcpy(&rq, d, sizeof(rq));
+		if (rq.nic >= sim->num_nics || rq.size == 0) {
+			err = EINVAL;
+			break;
+		}
+		if (rq.slot >= FW_SLOT_MAX) {
+			sim->fwu_status = FWU_STATUS_FAILED_INVALID_SLOT;
+			err = EINVAL;
+			break;
+		}
+		sim->fwu_nic = rq.nic;
+		sim->fwu_slot = rq.slot;
+		sim->fwu_size = rq.size;
+		sim->fwu_received = 0;
+		sim->fwu_status = FWU_STATUS_STARTED;
+		cuc_sim_log(sim, "fwu: nic %u slot %u size %u started", rq.nic, rq.slot, rq.size);
+		break;
+	}
+
+	case CUC_CMD_FIRMWARE_UPDATE_DOWNLOAD:
+		if (sim->fwu_status != FWU_STATUS_STARTED && sim->fwu_status != FWU_STATUS_DOWNLOADING) {
+			err = EINVAL;
+			break;
+		}
+		if (len > sim->fwu_size - sim->fwu_received) {
+			sim->fwu_status = FWU_STATUS_FAILED_DOWNLOAD;
+			err = EFBIG;
+			break;
+		}
+		sim->fwu_received += len;
+		sim->fwu_status = FWU_STATUS_DOWNLOADING;
+		if (sim->fwu_received == sim->fwu_size) {
+			sim->fwu_status = FWU_STATUS_VERIFYING_SIGNATURE;
+			sim->fwu_phase_start_us = now;
+		}
+		break;
+
+	case CUC_CMD_FIRMWARE_UPDATE_STATUS: {
+		struct cuc_firmware_update_status_rsp st;
+
+		cuc_sim_fwu_advance(sim, now);
+		st.status = sim->fwu_status;
+		memcpy(o, &st, sizeof(st));
+		olen = sizeof(st);
+		break;
+	}
+
+	case CUC_CMD_FIRMWARE_VERSION: {
+		struct cuc_get_firmware_version_req rq;
+		const char *v;
+		unsigned int copy;
+
+		if (len < sizeof(rq)) {
+			err = EINVAL;
+			break;
+		}
+		memcpy(&rq, d, sizeof(rq));
+		if (rq.fw_target >= FW_NUM_ENTRIES || rq.nic >= sim->num_nics ||
+		    (rq.from_flash && rq.slot >= FW_SLOT_MAX)) {
+			err = EINVAL;
+			break;
+		}
+		copy = rq.from_flash ? CUC_SIM_FW_FLASH_SLOT0 + rq.slot : CUC_SIM_FW_RUNNING;
+		v = sim->nic[rq.nic].fw_version[copy][rq.fw_target];
+		if (!v[0]) {
+			err = ENOENT;
+			break;
+		}
+		olen = (int)strnlen(v, CUC_SIM_FW_VERSION_LEN);
+		memcpy(o, v, olen);
+		break;
+	}
+
+	case CUC_CMD_RESET: {
+		unsigned int n;
+
+		for (n = 0; n < sim->num_nics; n++)
+			sim->nic[n].isr |= ATT1_UC_RESET;
+		if (sim->fwu_status < FWU_STATUS_IDLE)
+			sim->fwu_status = FWU_STATUS_FAILED;
+		sim->boot_us = now;
+		cuc_sim_log(sim, "uc reset");
+		break;
+	}
+
+	case CUC_CMD_SET_LED: {
+		struct cuc_set_led_req rq;
+
+		if (len < sizeof(rq)) {
+			err = EINVAL;
+			break;
+		}
+		memcpy(&rq, d, sizeof(rq));
+		if (rq.nic >= sim->num_nics || rq.led > LED_OCP_ACTIVITY_STATUS ||
+		    rq.state > LED_FAST_GRN_YEL) {
+			err = EINVAL;
+			break;
+		}
+		sim->nic[rq.nic].led[rq.led] = rq.state;
+		break;
+	}
+
+	case CUC_CMD_GET_NIC_ID: {
+		struct cuc_get_nic_id_rsp nr = { .nic = sim->this_nic };
+
+		memcpy(o, &nr, sizeof(nr));
+		olen = sizeof(nr);
+		break;
+	}
+
+	case CUC_CMD_GET_TIMINGS: {
+		struct cuc_get_timings_rsp tr;
+
+		memcpy(tr.entries_us, sim->timings_us, sizeof(tr.entries_us));
+		tr.entries_us[TIMING_UPTIME] = now - sim->boot_us;
+		memcpy(o, &tr, sizeof(tr));
+		olen = sizeof(tr);
+		break;
+	}
+
+	default:
+		err = EOPNOTSUPP;
+		break;
+	}
+
+out:
+	if (err) {
+		struct cuc_error_rsp_data er = { .error = (u8)err };
+
+		rsp->type = CUC_TYPE_RSP_ERROR;
+		memcpy(rsp->data, &er, sizeof(er));
+		olen = sizeof(er);
+	} else if (rsp->type != CUC_TYPE_RSP_PLDM) {
+		rsp->type = CUC_TYPE_RSP_SUCCESS;
+	}
+	rsp->count = (u8)(olen + 1);
+}
+
+/* Time to move 'bytes' across the simulated link */
+static inline u64 cuc_sim_wire_us(const struct cuc_sim *sim, unsigned int bytes)
+{
+	if (!sim->bus_bytes_per_sec)
+		return 0;
+	return (u64)bytes * 1000000 / sim->bus_bytes_per_sec;
+}
+
+/* struct cuc_xport_ops send(): execute the request and schedule its response */
+static inline int cuc_sim_send(void *priv, const struct cuc_pkt *pkt)
+{
+	struct cuc_sim *sim = (struct cuc_sim *)priv;
+	const struct cuc_sim_cmd_cfg *cfg;
+	struct cuc_sim_rsp *r;
+	u64 now = cuc_xport_now_us();
+	u64 start, due;
+
+	if (sim->rsp_count >= CUC_SIM_RSP_DEPTH)
+		return -EAGAIN;
+
+	cfg = &sim->cmd[pkt->cmd % CUC_SIM_NUM_CMDS];
+	if (pkt->cmd < CUC_SIM_NUM_CMDS)
+		sim->requests[pkt->cmd]++;
+
+	/* The request occupies the link, then the uC services requests one at a time */
+	start = sim->bus_free_us > now ? sim->bus_free_us : now;
+	sim->bus_free_us = start + cuc_sim_wire_us(sim, 3 + pkt->count);
+	start = sim->bus_free_us > sim->uc_free_us ? sim->bus_free_us : sim->uc_free_us;
+	sim->uc_free_us = start + cfg->service_us;
+	if (cfg->jitter_us)
+		sim->uc_free_us += cuc_sim_rand(sim) % (cfg->jitter_us + 1);
+
+	if (cuc_sim_chance(sim, cfg->drop_ppm)) {
+		sim->dropped++;
+		return 0;
+	}
+
+	r = &sim->rsp[(sim->rsp_head + sim->rsp_count) % CUC_SIM_RSP_DEPTH];
+	if (cuc_sim_chance(sim, cfg->error_ppm)) {
+		memset(&r->pkt, 0, sizeof(r->pkt));
+		r->pkt.cmd = pkt->cmd;
+		r->pkt.type = CUC_TYPE_RSP_ERROR;
+		r->pkt.count = 2;
+		r->pkt.data[0] = EIO;
+		sim->injected_errors++;
+	} else {
+		cuc_sim_handle(sim, pkt, &r->pkt);
+	}
+
+	/* The response also has to cross the link */
+	start = sim->bus_free_us > sim->uc_free_us ? sim->bus_free_us : sim->uc_free_us;
+	sim->bus_free_us = start + cuc_sim_wire_us(sim, 2 + r->pkt.count);
+	due = sim->bus_free_us + cfg->latency_us;
+	if (due < sim->last_due_us)
+		due = sim->last_due_us;
+	r->due_us = due;
+	sim->last_due_us = due;
+	sim->rsp_count++;
+	return 0;
+}
+
+/* struct cuc_xport_ops recv(): deliver the oldest response once its service time has elapsed */
+static inline int cuc_sim_recv(void *priv, struct cuc_pkt *pkt, long timeout_us)
+{
+	struct cuc_sim *sim = (struct cuc_sim *)priv;
+	struct cuc_sim_rsp *r;
+	u64 now = cuc_xport_now_us();
+	u64 wait;
+
+	if (!sim->rsp_count) {
+		if (timeout_us > 0) {
+			struct timespec ts = { timeout_us / 1000000, (timeout_us % 1000000) * 1000 };
+
+			nanosleep(&ts, NULL);
+		}
+		return -EAGAIN;
+	}
+
+	r = &sim->rsp[sim->rsp_head];
+	if (r->due_us > now) {
+		wait = r->due_us - now;
+		if (timeout_us <= 0)
+			return -EAGAIN;
+		if (wait > (u64)timeout_us) {
+			struct timespec ts = { timeout_us / 1000000, (timeout_us % 1000000) * 1000 };
+
+			nanosleep(&ts, NULL);
+			return -EAGAIN;
+		} else {
+			struct timespec ts = { (time_t)(wait / 1000000), (long)(wait % 1000000) * 1000 };
+
+			nanosleep(&ts, NULL);
+		}
+	}
+
+	*pkt = r->pkt;
+	sim->rsp_head = (sim->rsp_head + 1) % CUC_SIM_RSP_DEPTH;
+	sim->rsp_count--;
+	return 0;
+}
+
+/**
+ * cuc_sim_xport_init() - Attach a transport engine to a simulator
+ *
+ * @ops must stay valid for the life of @x; it is filled in here so that the advertised
+ * depth follows sim->max_inflight.
+ */
+static inline void cuc_sim_xport_init(struct cuc_xport *x, struct cuc_xport_ops *ops, struct cuc_sim *sim)
+{
+	ops->kind = CUC_XPORT_SIM;
+	ops->max_inflight = sim->max_inflight;
+	ops->send = cuc_sim_send;
+	ops->recv = cuc_sim_recv;
+	cuc_xport_init(x, ops, sim);
+}
+
+#endif /* CUC_SIM_H */
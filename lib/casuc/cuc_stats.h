@@ -0,0 +1,511 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* This file implements per-command latency and error statistics for uC traffic.
+ *
+ * cuc_stats_attach() hooks a struct cuc_xport so that every completed request is
+ * recorded under its transport kind and command key. The keys are one per
+ * CUC_CMD_*; CUC_CMD_PLDM traffic is split further by pldm_platform_cmd. Each key
+ * keeps a count, an error count, the sum and maximum latency, a log-linear
+ * latency histogram and a counter per errno (the cuc_error_rsp_data.error of
+ * error responses, or the local -errno such as ETIMEDOUT). PLDM keys also count
+ * each completion_code.
+ *
+ * The counters live in a shared memory region so an exporter in another process
+ * can scrape them. The region holds one block per writer thread, claimed with
+ * cuc_stats_thread_register(). Each counter in a block has a single writer, so
+ * recording is a handful of relaxed loads and stores with no atomic
+ * read-modify-write and no shared cache lines between threads. A reader sums
+ * the blocks of every thread. Each counter only grows, but a reader can see a
+ * request in one counter and not yet in another (e.g. in 'count' but not yet in
+ * the histogram).
+ *
+ * Latency is measured from cuc_xport_submit() to completion, in microseconds.
+ * The histogram has CUC_STATS_SUB_BUCKETS buckets per power of two, so a
+ * percentile is accurate to 1/8 of its value.
+ */
+
+#ifndef CUC_STATS_H
+#define CUC_STATS_H
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cuc_cxi.h"
+#include "cuc_xport.h"
+#include "pldm_cxi.h"
+
+#define CUC_STATS_MAGIC          0x54534355  /* "UCST" */
+#define CUC_STATS_VERSION        1
+
+#define CUC_STATS_SUB_BITS       3
+#define CUC_STATS_SUB_BUCKETS    (1 << CUC_STATS_SUB_BITS)
+#define CUC_STATS_BUCKETS        192    /* Up to about 2^25 us; the last bucket takes the rest */
+#define CUC_STATS_ERRNOS         128    /* The last counter takes every larger errno */
+#define CUC_STATS_PLDM_CCS       256
+#define CUC_STATS_MAX_THREADS    64
+
+/* Statistics keys: one per CUC_CMD_*, with CUC_CMD_PLDM split by platform command */
+enum cuc_stats_key {
+	CUC_STATS_PING,
+	CUC_STATS_BOARD_INFO,
+	CUC_STATS_I2C_READ,
+	CUC_STATS_I2C_WRITE,
+	CUC_STATS_GET_LOG,
+	CUC_STATS_GET_FRU,
+	CUC_STATS_SET_FAN_PWM,
+	CUC_STATS_GET_FAN_RPM,
+	CUC_STATS_GET_MAC,
+	CUC_STATS_QSFP_READ,
+	CUC_STATS_QSFP_WRITE,
+	CUC_STATS_QSFP_RESET,
+	CUC_STATS_GET_INTR,
+	CUC_STATS_CLEAR_ISR,
+	CUC_STATS_UPDATE_IER,
+	CUC_STATS_FIRMWARE_UPDATE_START,
+	CUC_STATS_FIRMWARE_VERSION,
+	CUC_STATS_FIRMWARE_UPDATE_DOWNLOAD,
+	CUC_STATS_FIRMWARE_UPDATE_STATUS,
+	CUC_STATS_RESET,
+	CUC_STATS_SET_LED,
+	CUC_STATS_GET_NIC_ID,
+	CUC_STATS_GET_TIMINGS,
+	CUC_STATS_OTHER,                /* Command code with no key of its own */
+
+	/* CUC_CMD_PLDM; the keys from here on count completion codes */
+	CUC_STATS_PLDM_GET_SENSOR_READING,
+	CUC_STATS_PLDM_GET_PDR,
+	CUC_STATS_PLDM_OTHER,           /* Other types and commands */
+	CUC_STATS_NUM_KEYS
+};
+
+#define CUC_STATS_FIRST_PLDM     CUC_STATS_PLDM_GET_SENSOR_READING
+#define CUC_STATS_NUM_PLDM       (CUC_STATS_NUM_KEYS - CUC_STATS_FIRST_PLDM)
+
+static const char *const cuc_stats_key_names[CUC_STATS_NUM_KEYS] = {
+	"ping", "board_info", "i2c_read", "i2c_write", "get_log", "get_fru", "set_fan_pwm", "get_fan_rpm",
+	"get_mac", "qsfp_read", "qsfp_write", "qsfp_reset", "get_intr", "clear_isr", "update_ier",
+	"firmware_update_start", "firmware_version", "firmware_update_download", "firmware_update_status",
+	"reset", "set_led", "get_nic_id", "get_timings", "other",
+	"pldm_get_sensor_reading", "pldm_get_pdr", "pldm_other",
+};
+
+static const char *const cuc_stats_xport_names[CUC_XPORT_KIND_COUNT] = {
+	"usb", "smbus", "hsn", "sim",
+};
+
+/**
+ * struct cuc_stats_cmd - Counters of one key on one transport
+ */
+struct cuc_stats_cmd {
+	u64 count;
+	u64 errors;                     /* Completed with a negative status */
+	u64 sum_us;
+	u64 max_us;
+	u64 hist[CUC_STATS_BUCKETS];
+	u64 err[CUC_STATS_ERRNOS];      /* Indexed by errno */
+};
+
+/**
+ * struct cuc_stats_xport - Counters of one transport kind
+ */
+struct cuc_stats_xport {
+	struct cuc_stats_cmd cmd[CUC_STATS_NUM_KEYS];
+	u64 pldm_cc[CUC_STATS_NUM_PLDM][CUC_STATS_PLDM_CCS];
+};
+
+/**
+ * struct cuc_stats_thread - Counters written by one thread
+ */
+struct cuc_stats_thread {
+	u32 in_use;                     /* Claimed by a live thread */
+	u32 generation;                 /* Times claimed; 0 if never written */
+	u64 pad[7];
+	struct cuc_stats_xport xport[CUC_XPORT_KIND_COUNT];
+};
+
+/**
+ * struct cuc_stats_shm - Layout of the shared memory region
+ *
+ * The layout fields let a reader built against a different version of this
+ * header refuse the region instead of misreading it.
+ */
+struct cuc_stats_shm {
+	u32 magic;                      /* Written last by the creator */
+	u32 version;
+	u32 num_keys;
+	u32 num_buckets;
+	u32 num_errnos;
+	u32 num_xports;
+	u32 max_threads;
+	u32 sub_bits;
+	u64 pad[4];
+	struct cuc_stats_thread thread[];
+};
+
+struct cuc_stats {
+	struct cuc_stats_shm *shm;
+	size_t size;
+	int fd;
+};
+
+static inline size_t cuc_stats_size(unsigned int max_threads)
+{
+	return sizeof(struct cuc_stats_shm) + (size_t)max_threads * sizeof(struct cuc_stats_thread);
+}
+
+/* Map a command code, and for PLDM the request header, to its key */
+static inline unsigned int cuc_stats_key_of(const struct cuc_pkt *req)
+{
+	switch (req->cmd) {
+	case CUC_CMD_PING: return CUC_STATS_PING;
+	case CUC_CMD_BOARD_INFO: return CUC_STATS_BOARD_INFO;
+	case CUC_CMD_I2C_READ: return CUC_STATS_I2C_READ;
+	case CUC_CMD_I2C_WRITE: return CUC_STATS_I2C_WRITE;
+	case CUC_CMD_GET_LOG: return CUC_STATS_GET_LOG;
+	case CUC_CMD_GET_FRU: return CUC_STATS_GET_FRU;
+	case CUC_CMD_SET_FAN_PWM: return CUC_STATS_SET_FAN_PWM;
+	case CUC_CMD_GET_FAN_RPM: return CUC_STATS_GET_FAN_RPM;
+	case CUC_CMD_GET_MAC: return CUC_STATS_GET_MAC;
+	case CUC_CMD_QSFP_READ: return CUC_STATS_QSFP_READ;
+	case CUC_CMD_QSFP_WRITE: return CUC_STATS_QSFP_WRITE;
+	case CUC_CMD_QSFP_RESET: return CUC_STATS_QSFP_RESET;
+	case CUC_CMD_GET_INTR: return CUC_STATS_GET_INTR;
+	case CUC_CMD_CLEAR_ISR: return CUC_STATS_CLEAR_ISR;
+	case CUC_CMD_UPDATE_IER: return CUC_STATS_UPDATE_IER;
+	case CUC_CMD_FIRMWARE_UPDATE_START: return CUC_STATS_FIRMWARE_UPDATE_START;
+	case CUC_CMD_FIRMWARE_VERSION: return CUC_STATS_FIRMWARE_VERSION;
+	case CUC_CMD_FIRMWARE_UPDATE_DOWNLOAD: return CUC_STATS_FIRMWARE_UPDATE_DOWNLOAD;
+	case CUC_CMD_FIRMWARE_UPDATE_STATUS: return CUC_STATS_FIRMWARE_UPDATE_STATUS;
+	case CUC_CMD_RESET: return CUC_STATS_RESET;
+	case CUC_CMD_SET_LED: return CUC_STATS_SET_LED;
+	case CUC_CMD_GET_NIC_ID: return CUC_STATS_GET_NIC_ID;
+	case CUC_CMD_GET_TIMINGS: return CUC_STATS_GET_TIMINGS;
+	case CUC_CMD_PLDM:
+		/* data[1] is the PLDM type, data[2] the command */
+		if (req->count < 4 || (req->data[1] & 0x3F) != PLDM_TYPE_PLATFORM_MONITORING_AND_CONTROL)
+			return CUC_STATS_PLDM_OTHER;
+		switch (req->data[2]) {
+		case PLDM_CMD_GET_SENSOR_READING: return CUC_STATS_PLDM_GET_SENSOR_READING;
+		case PLDM_CMD_GET_PDR: return CUC_STATS_PLDM_GET_PDR;
+		default: return CUC_STATS_PLDM_OTHER;
+		}
+	default:
+		return CUC_STATS_OTHER;
+	}
+}
+
+/* Histogram bucket of a latency: exact below 8, then 8 buckets per power of two */
+static inline unsigned int cuc_stats_bucket(u64 us)
+{
+	unsigned int k, idx;
+
+	if (us < CUC_STATS_SUB_BUCKETS)
+		return (unsigned int)us;
+	k = 63 - (unsigned int)__builtin_clzll(us);
+	idx = (k - CUC_STATS_SUB_BITS + 1) * CUC_STATS_SUB_BUCKETS +
+	      (unsigned int)((us >> (k - CUC_STATS_SUB_BITS)) & (CUC_STATS_SUB_BUCKETS - 1));
+	return idx < CUC_STATS_BUCKETS ? idx : CUC_STATS_BUCKETS - 1;
+}
+
+/* Smallest latency that falls in a bucket */
+static inline u64 cuc_stats_bucket_lo(unsigned int idx)
+{
+	unsigned int k;
+
+	if (idx < CUC_STATS_SUB_BUCKETS)
+		return idx;
+	k = idx / CUC_STATS_SUB_BUCKETS + CUC_STATS_SUB_BITS - 1;
+	return (u64)(CUC_STATS_SUB_BUCKETS + idx % CUC_STATS_SUB_BUCKETS) << (k - CUC_STATS_SUB_BITS);
+}
+
+/* Single-writer increment: readers see either the old or the new value */
+static inline void cuc_stats_add(u64 *p, u64 v)
+{
+	__atomic_store_n(p, __atomic_load_n(p, __ATOMIC_RELAXED) + v, __ATOMIC_RELAXED);
+}
+
+/**
+ * cuc_stats_record() - Record one completed request
+ * @t: Counters of the calling thread for the request's transport
+ * @r: The completed request
+ * @lat_us: Latency of the request
+ */
+static inline void cuc_stats_record(struct cuc_stats_xport *t, const struct cuc_xport_req *r, u64 lat_us)
+{
+	unsigned int key = cuc_stats_key_of(&r->req);
+	struct cuc_stats_cmd *c = &t->cmd[key];
+
+	cuc_stats_add(&c->count, 1);
+	cuc_stats_add(&c->sum_us, lat_us);
+	cuc_stats_add(&c->hist[cuc_stats_bucket(lat_us)], 1);
+	if (lat_us > __atomic_load_n(&c->max_us, __ATOMIC_RELAXED))
+		__atomic_store_n(&c->max_us, lat_us, __ATOMIC_RELAXED);
+
+	if (r->status < 0) {
+		unsigned int e = (unsigned int)-r->status;
+
+		cuc_stats_add(&c->errors, 1);
+		cuc_stats_add(&c->err[e < CUC_STATS_ERRNOS ? e : CUC_STATS_ERRNOS - 1], 1);
+		return;
+	}
+	/* The completion code follows the 3-byte PLDM response header */
+	if (key >= CUC_STATS_FIRST_PLDM && r->rsp.type == CUC_TYPE_RSP_PLDM && cuc_xport_rsp_len(r) >= 4)
+		cuc_stats_add(&t->pldm_cc[key - CUC_STATS_FIRST_PLDM][r->rsp.data[3]], 1);
+}
+
+/* cuc_xport_observe_fn installed by cuc_stats_attach() */
+static inline void cuc_stats_observe(void *ctx, const struct cuc_xport_req *r)
+{
+	cuc_stats_record((struct cuc_stats_xport *)ctx, r, cuc_xport_now_us() - r->submit_us);
+}
+
+/**
+ * cuc_stats_create() - Create and map a statistics region for writing
+ * @s: Handle to initialize
+ * @name: shm_open() name such as "/cuc_stats", or NULL for a private mapping
+ * @max_threads: Writer threads, 0 for CUC_STATS_MAX_THREADS
+ *
+ * An existing region of the same name is replaced, so counters start from zero.
+ *
+ * Return: 0 on success, negative errno on failure
+ */
+static inline int cuc_stats_create(struct cuc_stats *s, const char *name, unsigned int max_threads)
+{
+	void *p;
+
+	memset(s, 0, sizeof(*s));
+	s->fd = -1;
+	if (!max_threads)
+		max_threads = CUC_STATS_MAX_THREADS;
+	s->size = cuc_stats_size(max_threads);
+
+	if (name) {
+		shm_unlink(name);
+		s->fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0644);
+		if (s->fd < 0)
+			return -errno;
+		/* The region is sparse: pages of unused threads and keys are never allocated */
+		if (ftruncate(s->fd, (off_t)s->size) < 0) {
+			int rc = -errno;
+
+			close(s->fd);
+			shm_unlink(name);
+			return rc;
+		}
+		p = mmap(NULL, s->size, PROT_READ | PROT_WRITE, MAP_SHARED, s->fd, 0);
+	} else {
+		p = mmap(NULL, s->size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	}
+	if (p == MAP_FAILED) {
+		int rc = -errno;
+
+		if (s->fd >= 0) {
+			close(s->fd);
+			shm_unlink(name);
+		}
+		return rc;
+	}
+
+	s->shm = (struct cuc_stats_shm *)p;
+	s->shm->version = CUC_STATS_VERSION;
+	s->shm->num_keys = CUC_STATS_NUM_KEYS;
+	s->shm->num_buckets = CUC_STATS_BUCKETS;
+	s->shm->num_errnos = CUC_STATS_ERRNOS;
+	s->shm->num_xports = CUC_XPORT_KIND_COUNT;
+	s->shm->max_threads = max_threads;
+	s->shm->sub_bits = CUC_STATS_SUB_BITS;
+	__atomic_store_n(&s->shm->magic, CUC_STATS_MAGIC, __ATOMIC_RELEASE);
+	return 0;
+}
+
+/**
+ * cuc_stats_open() - Map an existing statistics region read-only
+ *
+ * Return: 0 on success, -EPROTO if the region has a different layout, other
+ * negative errno on failure
+ */
+static inline int cuc_stats_open(struct cuc_stats *s, const char *name)
+{
+	const struct cuc_stats_shm *h;
+	struct stat st;
+	void *p;
+
+	memset(s, 0, sizeof(*s));
+	s->fd = shm_open(name, O_RDONLY, 0);
+	if (s->fd < 0)
+		return -errno;
+	if (fstat(s->fd, &st) < 0 || (size_t)st.st_size < sizeof(*h))
+		goto err_proto;
+	p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, s->fd, 0);
+	if (p == MAP_FAILED) {
+		int rc = -errno;
+
+		close(s->fd);
+		return rc;
+	}
+	s->shm = (struct cuc_stats_shm *)p;
+	s->size = (size_t)st.st_size;
+
+	h = s->shm;
+	if (__atomic_load_n(&h->magic, __ATOMIC_ACQUIRE) != CUC_STATS_MAGIC || h->version != CUC_STATS_VERSION ||
+	    h->num_keys != CUC_STATS_NUM_KEYS || h->num_buckets != CUC_STATS_BUCKETS ||
+	    h->num_errnos != CUC_STATS_ERRNOS || h->num_xports != CUC_XPORT_KIND_COUNT ||
+	    h->sub_bits != CUC_STATS_SUB_BITS || cuc_stats_size(h->max_threads) > s->size) {
+		munmap(p, s->size);
+		goto err_proto;
+	}
+	return 0;
+
+err_proto:
+	close(s->fd);
+	s->shm = NULL;
+	return -EPROTO;
+}
+
+/* Unmap the region. The creator's name stays until shm_unlink(). */
+static inline void cuc_stats_close(struct cuc_stats *s)
+{
+	if (s->shm)
+		munmap(s->shm, s->size);
+	if (s->fd >= 0)
+		close(s->fd);
+	s->shm = NULL;
+	s->fd = -1;
+}
+
+/**
+ * cuc_stats_thread_register() - Claim a block of counters for the calling thread
+ *
+ * A released block is reused with its counters intact, so totals never go back.
+ *
+ * Return: The block, or NULL if all are claimed
+ */
+static inline struct cuc_stats_thread *cuc_stats_thread_register(struct cuc_stats *s)
+{
+	unsigned int i;
+
+	for (i = 0; i < s->shm->max_threads; i++) {
+		struct cuc_stats_thread *t = &s->shm->thread[i];
+		u32 zero = 0;
+
+		if (__atomic_compare_exchange_n(&t->in_use, &zero, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+			__atomic_store_n(&t->generation, t->generation + 1, __ATOMIC_RELEASE);
+			return t;
+		}
+	}
+	return NULL;
+}
+
+static inline void cuc_stats_thread_release(struct cuc_stats_thread *t)
+{
+	__atomic_store_n(&t->in_use, 0, __ATOMIC_RELEASE);
+}
+
+/**
+ * cuc_stats_attach() - Record every request completed on x into t
+ *
+ * x must only be driven by the thread that registered t. A transport has a single
+ * observer, and one installed by someone else is left in place.
+ *
+ * Return: 0 on success (including when t is already attached to x), -EBUSY if x
+ * has another observer
+ */
+static inline int cuc_stats_attach(struct cuc_stats_thread *t, struct cuc_xport *x)
+{
+	unsigned int kind = x->ops->kind < CUC_XPORT_KIND_COUNT ? x->ops->kind : CUC_XPORT_SIM;
+
+	if (x->observe && (x->observe != cuc_stats_observe || x->observe_ctx != &t->xport[kind]))
+		return -EBUSY;
+	x->observe_ctx = &t->xport[kind];
+	x->observe = cuc_stats_observe;
+	return 0;
+}
+
+/* Stop recording x, if cuc_stats_attach() is what observes it */
+static inline void cuc_stats_detach(struct cuc_xport *x)
+{
+	if (x->observe != cuc_stats_observe)
+		return;
+	x->observe = NULL;
+	x->observe_ctx = NULL;
+}
+
+/**
+ * cuc_stats_sum() - Sum the counters of every thread for one transport kind
+ * @s: Mapped region
+ * @kind: enum cuc_xport_kind
+ * @out: Totals; max_us is the maximum over threads
+ */
+static inline void cuc_stats_sum(const struct cuc_stats *s, unsigned int kind, struct cuc_stats_xport *out)
+{
+	unsigned int i, k, b;
+
+	memset(out, 0, sizeof(*out));
+	for (i = 0; i < s->shm->max_threads; i++) {
+		const struct cuc_stats_xport *t = &s->shm->thread[i].xport[kind];
+
+		if (!__atomic_load_n(&s->shm->thread[i].generation, __ATOMIC_ACQUIRE))
+			continue;
+		for (k = 0; k < CUC_STATS_NUM_KEYS; k++) {
+			const struct cuc_stats_cmd *c = &t->cmd[k];
+			struct cuc_stats_cmd *o = &out->cmd[k];
+			u64 max;
+
+			/* Skip keys this thread never used without reading their histograms */
+			if (!__atomic_load_n(&c->count, __ATOMIC_RELAXED))
+				continue;
+			o->count += __atomic_load_n(&c->count, __ATOMIC_RELAXED);
+			o->errors += __atomic_load_n(&c->errors, __ATOMIC_RELAXED);
+			o->sum_us += __atomic_load_n(&c->sum_us, __ATOMIC_RELAXED);
+			max = __atomic_load_n(&c->max_us, __ATOMIC_RELAXED);
+			if (max > o->max_us)
+				o->max_us = max;
+			for (b = 0; b < CUC_STATS_BUCKETS; b++)
+				o->hist[b] += __atomic_load_n(&c->hist[b], __ATOMIC_RELAXED);
+			for (b = 0; b < CUC_STATS_ERRNOS; b++)
+				o->err[b] += __atomic_load_n(&c->err[b], __ATOMIC_RELAXED);
+			if (k >= CUC_STATS_FIRST_PLDM)
+				for (b = 0; b < CUC_STATS_PLDM_CCS; b++)
+					out->pldm_cc[k - CUC_STATS_FIRST_PLDM][b] +=
+						__atomic_load_n(&t->pldm_cc[k - CUC_STATS_FIRST_PLDM][b],
+								__ATOMIC_RELAXED);
+		}
+	}
+}
+
+/**
+ * cuc_stats_percentile() - Latency at or below which a fraction of requests completed
+ * @c: Counters, e.g. from cuc_stats_sum()
+ * @q: Fraction from 0 to 1
+ *
+ * Return: The upper bound of the bucket holding the q'th request, capped at max_us,
+ * or 0 if there are none
+ */
+static inline u64 cuc_stats_percentile(const struct cuc_stats_cmd *c, double q)
+{
+	u64 total = 0, seen = 0, rank;
+	unsigned int b;
+
+	for (b = 0; b < CUC_STATS_BUCKETS; b++)
+		total += c->hist[b];
+	if (!total)
+		return 0;
+	rank = (u64)(q * (double)total + 0.5);
+	if (rank < 1)
+		rank = 1;
+	for (b = 0; b < CUC_STATS_BUCKETS - 1; b++) {
+		seen += c->hist[b];
+		if (seen >= rank)
+			break;
+	}
+	if (b == CUC_STATS_BUCKETS - 1)
+		return c->max_us;
+	return cuc_stats_bucket_lo(b + 1) - 1 < c->max_us ? cuc_stats_bucket_lo(b + 1) - 1 : c->max_us;
+}
+
+#endif /* CUC_STATS_H */
@@ -0,0 +1,583 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* This file implements collection and analysis of uC boot timings across many cards.
+ *
+ * cuc_timings_collect() issues CUC_CMD_BOARD_INFO and CUC_CMD_GET_TIMINGS on every
+ * interface at once, then waits for them, so a fleet is sampled in roughly one
+ * round trip. Each sample becomes a row of a struct cuc_timings_archive. The archive
+ * is stored by column: the card id, the board type, then one column per
+ * enum cuc_timing_entries. On disk each column is a run of LEB128 varints, and each
+ * timestamp column is written as zigzag deltas from the column before it, so a
+ * phase that takes milliseconds is stored in two or three bytes.
+ *
+ * The uC only reports when each event happened, not what it waited for, so the
+ * analysis makes no assumption about dependencies between events. The timeline of
+ * a card is its events up to its last PCIe link up, in the order they happened, and
+ * each event is charged the time since the event before it. The per-phase
+ * distributions (count, mean, p50/p90/p99, min and max) can be taken over any pair
+ * of events, for one CUC_BOARD_TYPE_* or for every board type.
+ *
+ * A timestamp of 0 means the event did not happen, for example the NIC 1 events of
+ * a single NIC board. The one exception is TIMING_UC_APPLICATION_STARTED, which may
+ * legitimately be 0.
+ */
+
+#ifndef CUC_TIMINGS_H
+#define CUC_TIMINGS_H
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "cuc_cxi.h"
+#include "cuc_xport.h"
+
+#define CUC_TIMINGS_MAGIC    0x4D495443  /* "CTIM" */
+#define CUC_TIMINGS_VERSION  2
+
+/* Smallest encoding of a row: one byte per column */
+#define CUC_TIMINGS_MIN_ROW_BYTES  (2 + TIMING_NUM_ENTRIES)
+#define CUC_TIMINGS_NUM_BOARD_TYPES  (CUC_BOARD_TYPE_SOUHEGAN + 1)
+
+static const char *const cuc_timing_names[TIMING_NUM_ENTRIES] = {
+	"uc_application_started",
+	"uc_pin_init_complete",
+	"uc_fw_init_complete",
+	"en_clks_uc_asserted",
+	"12v_pg",
+	"pg_cassini_asserted",
+	"rst_pon_nic_n_deasserted",
+	"vid_stable_asserted",
+	"perst_nic_0_n_deasserted",
+	"perst_nic_1_n_deasserted",
+	"jtag_trst_n_deasserted",
+	"uc_cassini_rdy_nic_0",
+	"uc_cassini_rdy_nic_1",
+	"pcie_link_up_nic_0",
+	"pcie_link_up_nic_1",
+	"uptime",
+};
+
+/**
+ * struct cuc_timings_phase - A named interval between two events
+ */
+struct cuc_timings_phase {
+	const char *name;
+	u8 from;
+	u8 to;
+};
+
+/* The phases reported by cuc_timings_report() */
+static const struct cuc_timings_phase cuc_timings_phases[] = {
+	{ "uc_init", TIMING_UC_APPLICATION_STARTED, TIMING_UC_FW_INIT_COMPLETE },
+	{ "uc_to_12v_pg", TIMING_UC_FW_INIT_COMPLETE, TIMING_12V_PG },
+	{ "12v_pg_to_pg_cassini", TIMING_12V_PG, TIMING_PG_CASSINI_ASSERTED },
+	{ "pg_cassini_to_vid_stable", TIMING_PG_CASSINI_ASSERTED, TIMING_VID_STABLE_ASSERTED },
+	{ "vid_stable_to_perst_0", TIMING_VID_STABLE_ASSERTED, TIMING_PERST_NIC_0_N_DEASSERTED },
+	{ "perst_0_to_cassini_rdy_0", TIMING_PERST_NIC_0_N_DEASSERTED, TIMING_UC_CASSINI_RDY_NIC_0 },
+	{ "perst_0_to_link_up_0", TIMING_PERST_NIC_0_N_DEASSERTED, TIMING_PCIE_LINK_UP_NIC_0 },
+	{ "perst_1_to_link_up_1", TIMING_PERST_NIC_1_N_DEASSERTED, TIMING_PCIE_LINK_UP_NIC_1 },
+	{ "total_link_up_0", TIMING_UC_APPLICATION_STARTED, TIMING_PCIE_LINK_UP_NIC_0 },
+};
+
+#define CUC_TIMINGS_NUM_PHASES  (sizeof(cuc_timings_phases) / sizeof(cuc_timings_phases[0]))
+
+/**
+ * struct cuc_timings_archive - Timing samples stored by column
+ */
+struct cuc_timings_archive {
+	u32 n;
+	u32 cap;
+	u32 *card;                        /* Caller's card id */
+	s8 *board_type;                   /* CUC_BOARD_TYPE_* */
+	u64 *col[TIMING_NUM_ENTRIES];     /* entries_us, one column per event */
+};
+
+/**
+ * struct cuc_timings_stats - Distribution of one phase
+ */
+struct cuc_timings_stats {
+	u32 count;
+	u64 min_us;
+	u64 p50_us;
+	u64 p90_us;
+	u64 p99_us;
+	u64 max_us;
+	double mean_us;
+};
+
+static inline int cuc_timing_valid(unsigned int entry, u64 us)
+{
+	return us || entry == TIMING_UC_APPLICATION_STARTED;
+}
+
+static inline void cuc_timings_archive_init(struct cuc_timings_archive *a)
+{
+	memset(a, 0, sizeof(*a));
+}
+
+static inline void cuc_timings_archive_fini(struct cuc_timings_archive *a)
+{
+	unsigned int i;
+
+	free(a->card);
+	free(a->board_type);
+	for (i = 0; i < TIMING_NUM_ENTRIES; i++)
+		free(a->col[i]);
+	memset(a, 0, sizeof(*a));
+}
+
+static inline int cuc_timings_archive_reserve(struct cuc_timings_archive *a, u32 n)
+{
+	unsigned int i;
+	u32 cap;
+	void *p;
+
+	if (n <= a->cap)
+		return 0;
+	cap = a->cap ? a->cap : 64;
+	while (cap < n)
+		cap = cap > UINT32_MAX / 2 ? n : cap * 2;
+
+	p = realloc(a->card, (size_t)cap * sizeof(*a->card));
+	if (!p)
+		return -ENOMEM;
+	a->card = (u32 *)p;
+	p = realloc(a->board_type, (size_t)cap * sizeof(*a->board_type));
+	if (!p)
+		return -ENOMEM;
+	a->board_type = (s8 *)p;
+	for (i = 0; i < TIMING_NUM_ENTRIES; i++) {
+		p = realloc(a->col[i], (size_t)cap * sizeof(*a->col[i]));
+		if (!p)
+			return -ENOMEM;
+		a->col[i] = (u64 *)p;
+	}
+	a->cap = cap;
+	return 0;
+}
+
+/**
+ * cuc_timings_archive_add() - Append one card's sample
+ *
+ * Return: 0 on success or -ENOMEM
+ */
+static inline int cuc_timings_archive_add(struct cuc_timings_archive *a, u32 card, s8 board_type,
+					  const struct cuc_get_timings_rsp *t)
+{
+	unsigned int i;
+	int rc;
+
+	rc = cuc_timings_archive_reserve(a, a->n + 1);
+	if (rc)
+		return rc;
+	a->card[a->n] = card;
+	a->board_type[a->n] = board_type;
+	for (i = 0; i < TIMING_NUM_ENTRIES; i++)
+		memcpy(&a->col[i][a->n], &t->entries_us[i], sizeof(u64));
+	a->n++;
+	return 0;
+}
+
+/**
+ * cuc_timings_collect() - Sample every card at once
+ * @a: Archive to append to
+ * @xs: One interface per card
+ * @cards: Card id to record for each interface
+ * @n: Number of cards
+ * @reqs: Scratch, 2 * n requests
+ *
+ * Cards that fail either command, including a failed submit or send, are left out
+ * of the archive.
+ *
+ * Return: Number of cards added, or -ENOMEM
+ */
+static inline int cuc_timings_collect(struct cuc_timings_archive *a, struct cuc_xport **xs, const u32 *cards,
+				      unsigned int n, struct cuc_xport_req *reqs)
+{
+	unsigned int i;
+	int added = 0, rc;
+
+	rc = cuc_timings_archive_reserve(a, a->n + n);
+	if (rc)
+		return rc;
+
+	for (i = 0; i < n; i++) {
+		struct cuc_xport_req *pair[2] = { &reqs[2 * i], &reqs[2 * i + 1] };
+
+		cuc_xport_req_init(pair[0], CUC_CMD_BOARD_INFO, NULL, 0);
+		cuc_xport_req_init(pair[1], CUC_CMD_GET_TIMINGS, NULL, 0);
+		rc = cuc_xport_submit(xs[i], pair, 2);
+		if (rc < 0)
+			pair[0]->status = pair[1]->status = rc;
+	}
+
+	for (i = 0; i < n; i++) {
+		struct cuc_board_info_rsp bi;
+		struct cuc_get_timings_rsp t;
+		struct cuc_xport_req *b = &reqs[2 * i], *tr = &reqs[2 * i + 1];
+
+		/* Wait for both so neither is left on the interface */
+		rc = cuc_xport_wait(xs[i], b);
+		if (cuc_xport_wait(xs[i], tr) < 0 || rc < 0 || cuc_xport_rsp_len(b) < sizeof(bi) ||
+		    cuc_xport_rsp_len(tr) < sizeof(t))
+			continue;
+		memcpy(&bi, b->rsp.data, sizeof(bi));
+		memcpy(&t, tr->rsp.data, sizeof(t));
+		rc = cuc_timings_archive_add(a, cards[i], (s8)bi.board_type, &t);
+		if (rc)
+			return rc;
+		added++;
+	}
+	return added;
+}
+
+static inline size_t cuc_timings_put_varint(u8 *p, u64 v)
+{
+	size_t n = 0;
+
+	while (v >= 0x80) {
+		p[n++] = (u8)(v | 0x80);
+		v >>= 7;
+	}
+	p[n++] = (u8)v;
+	return n;
+}
+
+static inline int cuc_timings_get_varint(const u8 *p, size_t len, size_t *off, u64 *v)
+{
+	unsigned int shift = 0;
+
+	*v = 0;
+	while (*off < len && shift < 64) {
+		u8 b = p[(*off)++];
+
+		*v |= (u64)(b & 0x7f) << shift;
+		if (!(b & 0x80))
+			return 0;
+		shift += 7;
+	}
+	return -EPROTO;
+}
+
+/* Zigzag keeps small negative deltas (events out of enum order, or missing) small */
+static inline u64 cuc_timings_zigzag(s64 v)
+{
+	return ((u64)v << 1) ^ (u64)(v >> 63);
+}
+
+static inline s64 cuc_timings_unzigzag(u64 v)
+{
+	return (s64)(v >> 1) ^ -(s64)(v & 1);
+}
+
+/* Timestamp columns are stored relative to the column before them, the first to 0 */
+static inline u64 cuc_timings_base(const struct cuc_timings_archive *a, unsigned int entry, u32 row)
+{
+	return entry ? a->col[entry - 1][row] : 0;
+}
+
+/**
+ * cuc_timings_archive_save() - Write the archive to a file
+ *
+ * Layout: magic, version, column count and row count as u32, then the card id
+ * column, the board type column and the TIMING_NUM_ENTRIES timestamp columns, each
+ * as unsigned LEB128 varints.
+ *
+ * Return: 0 on success or a negative errno
+ */
+static inline int cuc_timings_archive_save(const struct cuc_timings_archive *a, const char *path)
+{
+	u32 hdr[4] = { CUC_TIMINGS_MAGIC, CUC_TIMINGS_VERSION, TIMING_NUM_ENTRIES, a->n };
+	size_t cap = sizeof(hdr) + (size_t)a->n * (2 + TIMING_NUM_ENTRIES) * 10;
+	size_t len = 0, off = 0;
+	unsigned int i;
+	u32 r;
+	u8 *buf;
+	int fd, rc = 0;
+
+	buf = (u8 *)malloc(cap);
+	if (!buf)
+		return -ENOMEM;
+	memcpy(buf, hdr, sizeof(hdr));
+	len = sizeof(hdr);
+	for (r = 0; r < a->n; r++)
+		len += cuc_timings_put_varint(buf + len, a->card[r]);
+	for (r = 0; r < a->n; r++)
+		len += cuc_timings_put_varint(buf + len, (u8)a->board_type[r]);
+	for (i = 0; i < TIMING_NUM_ENTRIES; i++)
+		for (r = 0; r < a->n; r++)
+			len += cuc_timings_put_varint(buf + len,
+				cuc_timings_zigzag((s64)(a->col[i][r] - cuc_timings_base(a, i, r))));
+
+	fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (fd < 0) {
+		free(buf);
+		return -errno;
+	}
+	while (off < len) {
+		ssize_t n = write(fd, buf + off, len - off);
+
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n < 0) {
+			rc = -errno;
+			break;
+		}
+		off += (size_t)n;
+	}
+	if (close(fd) < 0 && !rc)
+		rc = -errno;
+	free(buf);
+	return rc;
+}
+
+/**
+ * cuc_timings_archive_load() - Append the rows of a saved archive
+ *
+ * The row count in the header is checked against the file size before any memory
+ * is reserved for it.
+ *
+ * Return: Number of rows loaded, or a negative errno (-EPROTO if malformed)
+ */
+static inline int cuc_timings_archive_load(struct cuc_timings_archive *a, const char *path)
+{
+	u32 hdr[4];
+	size_t len = 0, off = sizeof(hdr);
+	unsigned int i;
+	u32 r, base;
+	u64 v;
+	u8 *buf;
+	FILE *f;
+	long sz;
+	int rc;
+
+	f = fopen(path, "rb");
+	if (!f)
+		return -errno;
+	if (fseek(f, 0, SEEK_END) || (sz = ftell(f)) < (long)sizeof(hdr) || fseek(f, 0, SEEK_SET)) {
+		fclose(f);
+		return -EPROTO;
+	}
+	buf = (u8 *)malloc((size_t)sz);
+	if (buf)
+		len = fread(buf, 1, (size_t)sz, f);
+	fclose(f);
+	if (!buf)
+		return -ENOMEM;
+
+	memcpy(hdr, buf, sizeof(hdr));
+	if (len != (size_t)sz || hdr[0] != CUC_TIMINGS_MAGIC || hdr[1] != CUC_TIMINGS_VERSION ||
+	    hdr[2] != TIMING_NUM_ENTRIES) {
+		free(buf);
+		return -EPROTO;
+	}
+
+	base = a->n;
+	if (hdr[3] > (len - sizeof(hdr)) / CUC_TIMINGS_MIN_ROW_BYTES || hdr[3] > UINT32_MAX - base ||
+	    hdr[3] > INT_MAX) {
+		free(buf);
+		return -EPROTO;
+	}
+	rc = cuc_timings_archive_reserve(a, base + hdr[3]);
+	if (rc) {
+		free(buf);
+		return rc;
+	}
+	rc = -EPROTO;
+	for (r = 0; r < hdr[3]; r++) {
+		if (cuc_timings_get_varint(buf, len, &off, &v))
+			goto out;
+		a->card[base + r] = (u32)v;
+	}
+	for (r = 0; r < hdr[3]; r++) {
+		if (cuc_timings_get_varint(buf, len, &off, &v))
+			goto out;
+		a->board_type[base + r] = (s8)(u8)v;
+	}
+	/* Columns are decoded in order, so each base is decoded before it is used */
+	for (i = 0; i < TIMING_NUM_ENTRIES; i++) {
+		for (r = 0; r < hdr[3]; r++) {
+			if (cuc_timings_get_varint(buf, len, &off, &v))
+				goto out;
+			a->col[i][base + r] = cuc_timings_base(a, i, base + r) + (u64)cuc_timings_unzigzag(v);
+		}
+	}
+	a->n = base + hdr[3];
+	rc = (int)hdr[3];
+out:
+	free(buf);
+	return rc;
+}
+
+/**
+ * cuc_timings_timeline() - Events up to one card's last link up, in time order
+ * @a: Archive
+ * @row: Card's row
+ * @path: Output, events in time order, ties in enum order
+ *
+ * Events that did not happen, happened after the last link up, and TIMING_UPTIME
+ * (a duration, not an event) are left out.
+ *
+ * Return: Number of events in 'path', 0 if no link came up
+ */
+static inline unsigned int cuc_timings_timeline(const struct cuc_timings_archive *a, u32 row,
+						u8 path[TIMING_NUM_ENTRIES])
+{
+	unsigned int n = 0, i, j;
+	u64 l0 = a->col[TIMING_PCIE_LINK_UP_NIC_0][row];
+	u64 l1 = a->col[TIMING_PCIE_LINK_UP_NIC_1][row];
+	u64 last = l1 > l0 ? l1 : l0;
+
+	if (!last)
+		return 0;
+	for (i = 0; i < TIMING_NUM_ENTRIES; i++) {
+		u64 t = a->col[i][row];
+
+		if (i == TIMING_UPTIME || !cuc_timing_valid(i, t) || t > last)
+			continue;
+		/* Insertion sort, stable so ties keep their enum order */
+		for (j = n; j && a->col[path[j - 1]][row] > t; j--)
+			path[j] = path[j - 1];
+		path[j] = (u8)i;
+		n++;
+	}
+	return n;
+}
+
+static inline int cuc_timings_cmp_u64(const void *pa, const void *pb)
+{
+	u64 x = *(const u64 *)pa, y = *(const u64 *)pb;
+
+	return (x > y) - (x < y);
+}
+
+/**
+ * cuc_timings_phase_stats() - Distribution of the time between two events
+ * @a: Archive
+ * @from: Starting event
+ * @to: Ending event
+ * @board_type: CUC_BOARD_TYPE_* to include, or CUC_BOARD_TYPE_UNKNOWN for all
+ * @st: Output
+ *
+ * Rows missing either event, or where 'to' precedes 'from', are skipped.
+ *
+ * Return: 0 on success or -ENOMEM
+ */
+static inline int cuc_timings_phase_stats(const struct cuc_timings_archive *a, unsigned int from, unsigned int to,
+					  int board_type, struct cuc_timings_stats *st)
+{
+	u64 *d;
+	double sum = 0;
+	u32 r, n = 0;
+
+	memset(st, 0, sizeof(*st));
+	if (!a->n)
+		return 0;
+	d = (u64 *)malloc(a->n * sizeof(*d));
+	if (!d)
+		return -ENOMEM;
+
+	for (r = 0; r < a->n; r++) {
+		u64 f = a->col[from][r], t = a->col[to][r];
+
+		if (board_type != CUC_BOARD_TYPE_UNKNOWN && a->board_type[r] != board_type)
+			continue;
+		if (!cuc_timing_valid(from, f) || !cuc_timing_valid(to, t) || t < f)
+			continue;
+		d[n++] = t - f;
+		sum += (double)(t - f);
+	}
+	if (n) {
+		qsort(d, n, sizeof(*d), cuc_timings_cmp_u64);
+		st->count = n;
+		st->min_us = d[0];
+		st->max_us = d[n - 1];
+		st->p50_us = d[(u64)(n - 1) * 50 / 100];
+		st->p90_us = d[(u64)(n - 1) * 90 / 100];
+		st->p99_us = d[(u64)(n - 1) * 99 / 100];
+		st->mean_us = sum / n;
+	}
+	free(d);
+	return 0;
+}
+
+/**
+ * cuc_timings_waits() - How often, and for how long, bring-up waited on each event
+ * @a: Archive
+ * @board_type: CUC_BOARD_TYPE_* to include, or CUC_BOARD_TYPE_UNKNOWN for all
+ * @hits: Output, times each event was on a timeline after its first event
+ * @total_us: Output, time from the previous event of the timeline to each event
+ */
+static inline void cuc_timings_waits(const struct cuc_timings_archive *a, int board_type,
+				     u32 hits[TIMING_NUM_ENTRIES], u64 total_us[TIMING_NUM_ENTRIES])
+{
+	u8 path[TIMING_NUM_ENTRIES];
+	unsigned int n, i;
+	u32 r;
+
+	memset(hits, 0, TIMING_NUM_ENTRIES * sizeof(*hits));
+	memset(total_us, 0, TIMING_NUM_ENTRIES * sizeof(*total_us));
+	for (r = 0; r < a->n; r++) {
+		if (board_type != CUC_BOARD_TYPE_UNKNOWN && a->board_type[r] != board_type)
+			continue;
+		n = cuc_timings_timeline(a, r, path);
+		for (i = 1; i < n; i++) {
+			s64 d = (s64)(a->col[path[i]][r] - a->col[path[i - 1]][r]);
+
+			/* The timeline is sorted, but never charge a negative wait */
+			if (d < 0)
+				continue;
+			hits[path[i]]++;
+			total_us[path[i]] += (u64)d;
+		}
+	}
+}
+
+/* Print the phase distributions and mean waits of each board type present */
+static inline void cuc_timings_report(const struct cuc_timings_archive *a, FILE *out)
+{
+	u32 hits[TIMING_NUM_ENTRIES];
+	u64 total[TIMING_NUM_ENTRIES];
+	u32 present[CUC_TIMINGS_NUM_BOARD_TYPES] = { 0 };
+	unsigned int p, i;
+	int bt;
+	u32 r;
+
+	for (r = 0; r < a->n; r++)
+		if (a->board_type[r] >= 0 && a->board_type[r] < CUC_TIMINGS_NUM_BOARD_TYPES)
+			present[(int)a->board_type[r]]++;
+
+	for (bt = 0; bt < CUC_TIMINGS_NUM_BOARD_TYPES; bt++) {
+		if (!present[bt])
+			continue;
+		fprintf(out, "board_type %d: %u cards\n", bt, present[bt]);
+		fprintf(out, "  %-26s %6s %10s %10s %10s %10s %10s\n", "phase (us)", "n", "min", "p50", "p90",
+			"p99", "max");
+		for (p = 0; p < CUC_TIMINGS_NUM_PHASES; p++) {
+			struct cuc_timings_stats st;
+
+			if (cuc_timings_phase_stats(a, cuc_timings_phases[p].from, cuc_timings_phases[p].to, bt,
+						    &st) || !st.count)
+				continue;
+			fprintf(out, "  %-26s %6u %10llu %10llu %10llu %10llu %10llu\n", cuc_timings_phases[p].name,
+				st.count, (unsigned long long)st.min_us, (unsigned long long)st.p50_us,
+				(unsigned long long)st.p90_us, (unsigned long long)st.p99_us,
+				(unsigned long long)st.max_us);
+		}
+		cuc_timings_waits(a, bt, hits, total);
+		fprintf(out, "  waits:         %-26s %6s %12s\n", "event", "cards", "mean wait us");
+		for (i = 0; i < TIMING_NUM_ENTRIES; i++)
+			if (hits[i] && total[i])
+				fprintf(out, "                 %-26s %6u %12llu\n", cuc_timing_names[i], hits[i],
+					(unsigned long long)(total[i] / hits[i]));
+	}
+}
+
+#endif /* CUC_TIMINGS_H */
@@ -0,0 +1,607 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* This file provides C++ typed views over cuc_pkt and PLDM payloads.
+ *
+ * A view wraps a pointer into a received packet and decodes fields in place: there is
+ * no memcpy into the __packed structs and no allocation. Multi-byte fields are read
+ * as little-endian, which is the wire byte order of the uC, so the same code is
+ * correct on big-endian hosts; on little-endian hosts each accessor is a plain load.
+ * Field offsets and types come from the C structs in cuc_cxi.h and pldm_cxi.h, and
+ * the struct sizes are checked at compile time so any change to the wire layout
+ * fails the build rather than decoding garbage.
+ *
+ * The size-dependent part of a numeric sensor PDR is resolved once per PDR:
+ * numeric_sensor_pdr_view::visit_ssd() switches on sensor_data_size and calls the
+ * visitor with an ssd_view whose threshold type is fixed at compile time.
+ *
+ * Accessors are constexpr, so a view over constant bytes decodes at compile time;
+ * floating-point fields additionally need C++20 for std::bit_cast.
+ *
+ * Like the C headers, this expects the u8..s64 types, BIT() and __packed to be
+ * provided by the includer. Requires C++17.
+ */
+
+#ifndef CUC_VIEW_HPP
+#define CUC_VIEW_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#if __cplusplus >= 202002L
+#include <bit>
+#endif
+
+#include "cuc_cxi.h"
+#include "pldm_cxi.h"
+
+/* Wire layout checks */
+static_assert(sizeof(struct cuc_pkt) == 3 + CUC_DATA_BYTES, "cuc_pkt layout");
+static_assert(sizeof(struct cuc_board_info_rsp) == 2, "cuc_board_info_rsp layout");
+static_assert(sizeof(struct cuc_i2c_read_req) == 6, "cuc_i2c_read_req layout");
+static_assert(sizeof(struct cuc_get_fan_rpm_rsp_data) == 6, "cuc_get_fan_rpm_rsp_data layout");
+static_assert(sizeof(struct cuc_mac_rsp_data) == 13, "cuc_mac_rsp_data layout");
+static_assert(sizeof(struct cuc_qsfp_read_req_data) == 4, "cuc_qsfp_read_req_data layout");
+static_assert(sizeof(struct cuc_get_intr_rsp_data) == 8, "cuc_get_intr_rsp_data layout");
+static_assert(sizeof(struct cuc_clear_isr_req_data) == 5, "cuc_clear_isr_req_data layout");
+static_assert(sizeof(struct cuc_update_ier_req_data) == 9, "cuc_update_ier_req_data layout");
+static_assert(sizeof(struct cuc_firmware_update_start_req) == 6, "cuc_firmware_update_start_req layout");
+static_assert(sizeof(struct cuc_get_firmware_version_req) == 4, "cuc_get_firmware_version_req layout");
+static_assert(sizeof(struct cuc_firmware_update_status_rsp) == 1, "cuc_firmware_update_status_rsp layout");
+static_assert(sizeof(struct cuc_set_led_req) == 3, "cuc_set_led_req layout");
+static_assert(sizeof(struct cuc_get_nic_id_rsp) == 1, "cuc_get_nic_id_rsp layout");
+static_assert(sizeof(struct cuc_get_timings_rsp) == 8 * TIMING_NUM_ENTRIES, "cuc_get_timings_rsp layout");
+static_assert(sizeof(struct cuc_get_timings_rsp) <= CUC_DATA_BYTES, "cuc_get_timings_rsp exceeds CUC_DATA_BYTES");
+
+static_assert(sizeof(struct pldm_hdr) == 3, "pldm_hdr layout");
+static_assert(sizeof(union sensor_value) == 4, "sensor_value layout");
+static_assert(sizeof(struct get_sensor_reading_req) == 6, "get_sensor_reading_req layout");
+static_assert(sizeof(struct get_sensor_reading_rsp) == 14, "get_sensor_reading_rsp layout");
+static_assert(sizeof(struct get_pdr_req) == 16, "get_pdr_req layout");
+static_assert(sizeof(struct get_pdr_rsp) == 15, "get_pdr_rsp layout");
+static_assert(sizeof(struct pdr_hdr) == 10, "pdr_hdr layout");
+static_assert(sizeof(struct numeric_sensor_ssd8) == 24, "numeric_sensor_ssd8 layout");
+static_assert(sizeof(struct numeric_sensor_ssd16) == 36, "numeric_sensor_ssd16 layout");
+static_assert(sizeof(struct numeric_sensor_ssd32) == 60, "numeric_sensor_ssd32 layout");
+static_assert(offsetof(struct numeric_sensor_pdr, ssd) == 45, "numeric_sensor_pdr layout");
+static_assert(sizeof(struct fru_record_set_pdr) == 20, "fru_record_set_pdr layout");
+static_assert(sizeof(struct get_pdr_rsp) + sizeof(struct numeric_sensor_pdr) <= CUC_DATA_BYTES,
+	      "a numeric sensor PDR must fit in a single GetPDR response");
+static_assert(sizeof(struct get_sensor_reading_rsp) <= CUC_DATA_BYTES, "get_sensor_reading_rsp exceeds CUC_DATA_BYTES");
+
+namespace cuc {
+
+namespace detail {
+
+/* Little-endian load of an integral or floating-point field */
+template <typename T>
+constexpr T load_le(const u8 *p)
+{
+	static_assert(std::is_trivially_copyable_v<T>, "view fields must be trivially copyable");
+	if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+		using B = typename std::conditional_t<std::is_enum_v<T>, std::underlying_type<T>,
+						      std::common_type<T>>::type;
+		using U = std::make_unsigned_t<B>;
+		U v = 0;
+
+		for (std::size_t i = 0; i < sizeof(U); i++)
+			v |= (U)((U)p[i] << (8 * i));
+		return (T)v;
+	} else {
+		static_assert(sizeof(T) == 4 || sizeof(T) == 8, "unsupported floating-point size");
+		using U = std::conditional_t<sizeof(T) == 4, u32, u64>;
+		U v = load_le<U>(p);
+#if __cpp_lib_bit_cast >= 201806L
+		return std::bit_cast<T>(v);
+#else
+		T f;
+
+		std::memcpy(&f, &v, sizeof(f));
+		return f;
+#endif
+	}
+}
+
+} /* namespace detail */
+
+/**
+ * class le_array - View of a fixed-size array of little-endian elements
+ */
+template <typename T, std::size_t N>
+class le_array {
+public:
+	constexpr explicit le_array(const u8 *p) : p_(p) {}
+	static constexpr std::size_t size() { return N; }
+	constexpr T operator[](std::size_t i) const { return detail::load_le<T>(p_ + i * sizeof(T)); }
+	constexpr const u8 *data() const { return p_; }
+
+private:
+	const u8 *p_;
+};
+
+/**
+ * class bytes - View of a run of raw bytes
+ */
+class bytes {
+public:
+	constexpr bytes() = default;
+	constexpr bytes(const u8 *p, std::size_t n) : p_(p), n_(n) {}
+	constexpr const u8 *data() const { return p_; }
+	constexpr std::size_t size() const { return n_; }
+	constexpr u8 operator[](std::size_t i) const { return p_[i]; }
+	constexpr const u8 *begin() const { return p_; }
+	constexpr const u8 *end() const { return p_ + n_; }
+
+private:
+	const u8 *p_ = nullptr;
+	std::size_t n_ = 0;
+};
+
+namespace detail {
+
+template <typename F>
+struct field_traits {
+	using type = F;
+};
+
+template <typename E, std::size_t N>
+struct field_traits<E[N]> {
+	using type = le_array<E, N>;
+};
+
+template <std::size_t N>
+struct field_traits<u8[N]> {
+	using type = bytes;
+};
+
+template <typename F>
+constexpr typename field_traits<F>::type load_field(const u8 *p)
+{
+	if constexpr (std::is_array_v<F>) {
+		if constexpr (std::is_same_v<typename field_traits<F>::type, bytes>)
+			return bytes(p, sizeof(F));
+		else
+			return typename field_traits<F>::type(p);
+	} else {
+		return load_le<F>(p);
+	}
+}
+
+} /* namespace detail */
+
+/**
+ * class view - Base of all typed views
+ *
+ * S is the C struct describing the layout. 'min_size' is the number of bytes a
+ * payload must hold to be viewed as S; it is sizeof(S) unless the struct ends in a
+ * variable-size part.
+ */
+template <typename S, std::size_t MinSize = sizeof(S)>
+class view {
+public:
+	using type = S;
+	static constexpr std::size_t min_size = MinSize;
+
+	constexpr explicit view(const u8 *p, std::size_t len = MinSize) : p_(p), len_(len) {}
+	constexpr const u8 *data() const { return p_; }
+	constexpr std::size_t size() const { return len_; }
+
+protected:
+	const u8 *p_;
+	std::size_t len_;
+};
+
+/* Define an accessor named after a member of the viewed struct */
+#define CUC_VIEW_FIELD(name)                                                              \
+	constexpr typename cuc::detail::field_traits<                                     \
+		std::remove_cv_t<decltype(type::name)>>::type                             \
+	name() const                                                                      \
+	{                                                                                 \
+		return cuc::detail::load_field<std::remove_cv_t<decltype(type::name)>>(   \
+			this->p_ + offsetof(type, name));                                 \
+	}
+
+/* Define a view class that only exposes plain struct members */
+#define CUC_SIMPLE_VIEW(vname, sname, ...)                                                \
+	class vname : public view<struct sname> {                                         \
+	public:                                                                           \
+		using view::view;                                                         \
+		__VA_ARGS__                                                               \
+	}
+
+/*
+ * uC command views
+ */
+
+CUC_SIMPLE_VIEW(error_rsp_view, cuc_error_rsp_data, CUC_VIEW_FIELD(error));
+CUC_SIMPLE_VIEW(board_info_rsp_view, cuc_board_info_rsp, CUC_VIEW_FIELD(board_type) CUC_VIEW_FIELD(board_rev));
+CUC_SIMPLE_VIEW(fan_rpm_rsp_view, cuc_get_fan_rpm_rsp_data,
+		CUC_VIEW_FIELD(rpm) CUC_VIEW_FIELD(percent) CUC_VIEW_FIELD(is_auto));
+CUC_SIMPLE_VIEW(mac_rsp_view, cuc_mac_rsp_data, CUC_VIEW_FIELD(nic) CUC_VIEW_FIELD(nic_mac) CUC_VIEW_FIELD(uc_mac));
+CUC_SIMPLE_VIEW(intr_rsp_view, cuc_get_intr_rsp_data, CUC_VIEW_FIELD(isr) CUC_VIEW_FIELD(ier));
+CUC_SIMPLE_VIEW(fwu_status_rsp_view, cuc_firmware_update_status_rsp, CUC_VIEW_FIELD(status));
+CUC_SIMPLE_VIEW(nic_id_rsp_view, cuc_get_nic_id_rsp, CUC_VIEW_FIELD(nic));
+CUC_SIMPLE_VIEW(timings_rsp_view, cuc_get_timings_rsp, CUC_VIEW_FIELD(entries_us));
+
+/*
+ * PLDM views
+ */
+
+/**
+ * class pldm_hdr_view - Generic PLDM message header
+ *
+ * The header is made of bit-fields, which have no offsets, so it is decoded by hand
+ * following DSP0240 Figure 1.
+ */
+class pldm_hdr_view : public view<struct pldm_hdr> {
+public:
+	using view::view;
+	constexpr u8 instance_id() const { return p_[0] & 0x1F; }
+	constexpr bool d() const { return p_[0] & BIT(6); }
+	constexpr bool rq() const { return p_[0] & BIT(7); }
+	constexpr u8 pldm_type() const { return p_[1] & 0x3F; }
+	constexpr u8 hdr_ver() const { return p_[1] >> 6; }
+	constexpr u8 pldm_command_code() const { return p_[2]; }
+};
+
+/* The six interpretations of a size-dependent value, indexed by enum pldm_data_size */
+template <int DataSize>
+struct data_size_traits;
+
+template <> struct data_size_traits<PLDM_DATA_SIZE_UINT8>  { using ssd = numeric_sensor_ssd8;  using value = u8; };
+template <> struct data_size_traits<PLDM_DATA_SIZE_SINT8>  { using ssd = numeric_sensor_ssd8;  using value = s8; };
+template <> struct data_size_traits<PLDM_DATA_SIZE_UINT16> { using ssd = numeric_sensor_ssd16; using value = u16; };
+template <> struct data_size_traits<PLDM_DATA_SIZE_SINT16> { using ssd = numeric_sensor_ssd16; using value = s16; };
+template <> struct data_size_traits<PLDM_DATA_SIZE_UINT32> { using ssd = numeric_sensor_ssd32; using value = u32; };
+template <> struct data_size_traits<PLDM_DATA_SIZE_SINT32> { using ssd = numeric_sensor_ssd32; using value = s32; };
+
+/**
+ * visit_data_size() - Call f(std::integral_constant<int, size>) for a runtime data size
+ *
+ * Return: What f returns, or std::nullopt for an unknown size
+ */
+template <typename F>
+constexpr auto visit_data_size(unsigned int size, F &&f)
+	-> std::optional<decltype(f(std::integral_constant<int, PLDM_DATA_SIZE_UINT8>()))>
+{
+	switch (size) {
+	case PLDM_DATA_SIZE_UINT8:
+		return f(std::integral_constant<int, PLDM_DATA_SIZE_UINT8>());
+	case PLDM_DATA_SIZE_SINT8:
+		return f(std::integral_constant<int, PLDM_DATA_SIZE_SINT8>());
+	case PLDM_DATA_SIZE_UINT16:
+		return f(std::integral_constant<int, PLDM_DATA_SIZE_UINT16>());
+	case PLDM_DATA_SIZE_SINT16:
+		return f(std::integral_constant<int, PLDM_DATA_SIZE_SINT16>());
+	case PLDM_DATA_SIZE_UINT32:
+		return f(std::integral_constant<int, PLDM_DATA_SIZE_UINT32>());
+	case PLDM_DATA_SIZE_SINT32:
+		return f(std::integral_constant<int, PLDM_DATA_SIZE_SINT32>());
+	default:
+		return std::nullopt;
+	}
+}
+
+/**
+ * class get_sensor_reading_rsp_view - GetSensorReading response
+ *
+ * present_reading is as wide as sensor_data_size says, so the response is shorter
+ * than the struct for 8 and 16-bit sensors.
+ */
+class get_sensor_reading_rsp_view
+	: public view<struct get_sensor_reading_rsp, offsetof(struct get_sensor_reading_rsp, present_reading)> {
+public:
+	using view::view;
+	constexpr pldm_hdr_view hdr() const { return pldm_hdr_view(p_); }
+	CUC_VIEW_FIELD(completion_code)
+	CUC_VIEW_FIELD(sensor_data_size)
+	CUC_VIEW_FIELD(sensor_operational_state)
+	CUC_VIEW_FIELD(sensor_event_message_enable)
+	CUC_VIEW_FIELD(present_state)
+	CUC_VIEW_FIELD(previous_state)
+	CUC_VIEW_FIELD(event_state)
+
+	/* The reading as the type selected by DataSize, which must match sensor_data_size() */
+	template <int DataSize>
+	constexpr typename data_size_traits<DataSize>::value reading() const
+	{
+		return detail::load_le<typename data_size_traits<DataSize>::value>(
+			p_ + offsetof(type, present_reading));
+	}
+
+	/* The reading widened to 64 bits, or std::nullopt for an unknown or truncated reading */
+	constexpr std::optional<s64> reading() const
+	{
+		auto r = visit_data_size(sensor_data_size(), [this](auto ds) -> std::optional<s64> {
+			using V = typename data_size_traits<decltype(ds)::value>::value;
+
+			if (len_ < min_size + sizeof(V))
+				return std::nullopt;
+			return (s64)reading<decltype(ds)::value>();
+		});
+
+		return r ? *r : std::nullopt;
+	}
+};
+
+/**
+ * class pdr_hdr_view - Common PDR header, with the record that follows it
+ */
+class pdr_hdr_view : public view<struct pdr_hdr> {
+public:
+	using view::view;
+	CUC_VIEW_FIELD(record_handle)
+	CUC_VIEW_FIELD(pdr_header_version)
+	CUC_VIEW_FIELD(pdr_type)
+	CUC_VIEW_FIELD(record_change_number)
+	CUC_VIEW_FIELD(data_length)
+
+	/* The whole record is available in the viewed bytes */
+	constexpr bool complete() const { return len_ >= sizeof(type) + data_length(); }
+
+	/* View the record as V if it has V's PDR type and enough bytes */
+	template <typename V>
+	constexpr std::optional<V> as() const
+	{
+		if (pdr_type() != V::pdr_type || len_ < V::min_size)
+			return std::nullopt;
+		return V(p_, len_);
+	}
+};
+
+/**
+ * class ssd_view - Size-dependent part of a numeric sensor PDR
+ *
+ * DataSize is the sensor's enum pldm_data_size; the threshold and range fields are
+ * returned as the matching signed or unsigned type.
+ */
+template <int DataSize>
+class ssd_view : public view<typename data_size_traits<DataSize>::ssd> {
+public:
+	using value_type = typename data_size_traits<DataSize>::value;
+	using type = typename data_size_traits<DataSize>::ssd;
+	using view<type>::view;
+	static constexpr int data_size = DataSize;
+
+	CUC_VIEW_FIELD(supported_thresholds)
+	CUC_VIEW_FIELD(threshold_and_hysteresis_volatility)
+	CUC_VIEW_FIELD(state_transition_interval)
+	CUC_VIEW_FIELD(update_interval)
+	CUC_VIEW_FIELD(range_field_format)
+	CUC_VIEW_FIELD(range_field_support)
+
+#define CUC_SSD_VALUE(name)                                                              \
+	constexpr value_type name() const                                                \
+	{                                                                                \
+		return detail::load_le<value_type>(this->p_ + offsetof(type, name));     \
+	}
+	/* Hysteresis is unsigned whatever the reading's signedness */
+	constexpr std::make_unsigned_t<value_type> hysteresis() const
+	{
+		return detail::load_le<std::make_unsigned_t<value_type>>(this->p_ + offsetof(type, hysteresis));
+	}
+	CUC_SSD_VALUE(max_readable)
+	CUC_SSD_VALUE(min_readable)
+	CUC_SSD_VALUE(nominal_value)
+	CUC_SSD_VALUE(normal_max)
+	CUC_SSD_VALUE(normal_min)
+	CUC_SSD_VALUE(warning_high)
+	CUC_SSD_VALUE(warning_low)
+	CUC_SSD_VALUE(critical_high)
+	CUC_SSD_VALUE(critical_low)
+	CUC_SSD_VALUE(fatal_high)
+	CUC_SSD_VALUE(fatal_low)
+#undef CUC_SSD_VALUE
+
+	/* Threshold by enum pldm_threshold */
+	constexpr value_type threshold(unsigned int which) const
+	{
+		switch (which) {
+		case PLDM_THRESHOLD_UPPER_WARNING:
+			return warning_high();
+		case PLDM_THRESHOLD_UPPER_CRITICAL:
+			return critical_high();
+		case PLDM_THRESHOLD_UPPER_FATAL:
+			return fatal_high();
+		case PLDM_THRESHOLD_LOWER_WARNING:
+			return warning_low();
+		case PLDM_THRESHOLD_LOWER_CRITICAL:
+			return critical_low();
+		default:
+			return fatal_low();
+		}
+	}
+};
+
+/**
+ * class numeric_sensor_pdr_view - Numeric sensor PDR
+ */
+class numeric_sensor_pdr_view : public view<struct numeric_sensor_pdr, offsetof(struct numeric_sensor_pdr, ssd)> {
+public:
+	static constexpr u8 pdr_type = PLDM_PDR_NUMERIC_SENSOR;
+	using view::view;
+
+	constexpr pdr_hdr_view hdr() const { return pdr_hdr_view(p_, len_); }
+	CUC_VIEW_FIELD(pldm_terminus_handle)
+	CUC_VIEW_FIELD(sensor_id)
+	CUC_VIEW_FIELD(entity_type)
+	constexpr u16 entity_id() const { return entity_type() & 0x7FFF; }
+	constexpr bool entity_logical() const { return entity_type() & 0x8000; }
+	CUC_VIEW_FIELD(entity_instance_number)
+	CUC_VIEW_FIELD(container_id)
+	CUC_VIEW_FIELD(sensor_init)
+	CUC_VIEW_FIELD(sensor_auxiliary_names_pdr)
+	CUC_VIEW_FIELD(base_unit)
+	CUC_VIEW_FIELD(unit_modifier)
+	CUC_VIEW_FIELD(rate_unit)
+	CUC_VIEW_FIELD(is_linear)
+	CUC_VIEW_FIELD(sensor_data_size)
+	CUC_VIEW_FIELD(resolution)
+	CUC_VIEW_FIELD(offset)
+	CUC_VIEW_FIELD(accuracy)
+	CUC_VIEW_FIELD(plus_tolerance)
+	CUC_VIEW_FIELD(minus_tolerance)
+
+	/**
+	 * visit_ssd() - Call f(ssd_view<DataSize>) for this sensor's data size
+	 *
+	 * Return: What f returns, or std::nullopt for an unknown data size or a record
+	 *         too short for its size-dependent part
+	 */
+	template <typename F>
+	constexpr auto visit_ssd(F &&f) const
+	{
+		return visit_data_size(sensor_data_size(), [&](auto ds) {
+			using V = ssd_view<decltype(ds)::value>;
+			using R = std::optional<decltype(f(std::declval<V>()))>;
+
+			if (len_ < min_size + V::min_size)
+				return R();
+			return R(f(V(p_ + min_size)));
+		}).value_or(std::nullopt);
+	}
+};
+
+/**
+ * class aux_name_pdr_view - Sensor auxiliary names PDR
+ *
+ * The name is UTF-16 and is read one code unit at a time.
+ */
+class aux_name_pdr_view : public view<struct aux_name_pdr, offsetof(struct aux_name_pdr, sensor_name)> {
+public:
+	static constexpr u8 pdr_type = PLDM_PDR_SENSOR_AUXILIARY_NAMES;
+	using view::view;
+
+	constexpr pdr_hdr_view hdr() const { return pdr_hdr_view(p_, len_); }
+	CUC_VIEW_FIELD(pldm_terminus_handle)
+	CUC_VIEW_FIELD(sensor_id)
+	CUC_VIEW_FIELD(sensor_count)
+	CUC_VIEW_FIELD(name_string_count)
+	std::string_view name_language_tag() const
+	{
+		const char *s = (const char *)p_ + offsetof(type, name_language_tag);
+
+		return std::string_view(s, strnlen(s, sizeof(type::name_language_tag)));
+	}
+
+	/* Number of UTF-16 code units before the terminator, bounded by the viewed bytes */
+	constexpr std::size_t name_length() const
+	{
+		std::size_t max = (len_ - min_size) / 2, i = 0;
+
+		if (max > AUX_NAME_MAX)
+			max = AUX_NAME_MAX;
+		for (; i < max && name_at(i); i++)
+			;
+		return i;
+	}
+	constexpr u16 name_at(std::size_t i) const { return detail::load_le<u16>(p_ + min_size + 2 * i); }
+};
+
+class fru_record_set_pdr_view : public view<struct fru_record_set_pdr> {
+public:
+	static constexpr u8 pdr_type = PLDM_PDR_FRU_RECORD_SET;
+	using view::view;
+
+	constexpr pdr_hdr_view hdr() const { return pdr_hdr_view(p_, len_); }
+	CUC_VIEW_FIELD(pldm_terminus_handle)
+	CUC_VIEW_FIELD(fru_record_set_identifier)
+	CUC_VIEW_FIELD(entity_type)
+	CUC_VIEW_FIELD(entity_instance_number)
+	CUC_VIEW_FIELD(container_id)
+};
+
+/**
+ * class get_pdr_rsp_view - GetPDR response
+ */
+class get_pdr_rsp_view : public view<struct get_pdr_rsp> {
+public:
+	using view::view;
+	constexpr pldm_hdr_view hdr() const { return pldm_hdr_view(p_); }
+	CUC_VIEW_FIELD(completion_code)
+	CUC_VIEW_FIELD(next_record_handle)
+	CUC_VIEW_FIELD(next_data_transfer_handle)
+	CUC_VIEW_FIELD(transfer_flag)
+	CUC_VIEW_FIELD(response_count)
+
+	/* The record data actually present, which may be less than response_count */
+	constexpr bytes record_data() const
+	{
+		std::size_t n = len_ - min_size;
+
+		return bytes(p_ + min_size, response_count() < n ? response_count() : n);
+	}
+
+	/* The record, when this response carries all of it */
+	constexpr std::optional<pdr_hdr_view> pdr() const
+	{
+		bytes d = record_data();
+
+		if (transfer_flag() != PLDM_XFER_FLAG_START_AND_END || d.size() < pdr_hdr_view::min_size)
+			return std::nullopt;
+		return pdr_hdr_view(d.data(), d.size());
+	}
+};
+
+/*
+ * Packets
+ */
+
+/**
+ * class pkt_view - View of a whole cuc_pkt
+ *
+ * 'count' includes the type byte, so the payload is count - 1 bytes, bounded by
+ * CUC_DATA_BYTES.
+ */
+class pkt_view {
+public:
+	constexpr explicit pkt_view(const struct cuc_pkt &pkt) : pkt_(&pkt) {}
+	constexpr u8 cmd() const { return pkt_->cmd; }
+	constexpr u8 type() const { return pkt_->type; }
+	constexpr const u8 *payload() const { return pkt_->data; }
+	constexpr std::size_t payload_len() const
+	{
+		std::size_t n = pkt_->count ? pkt_->count - 1u : 0;
+
+		return n < CUC_DATA_BYTES ? n : CUC_DATA_BYTES;
+	}
+	constexpr bytes payload_bytes() const { return bytes(payload(), payload_len()); }
+
+	/* View the payload as V if it is long enough */
+	template <typename V>
+	constexpr std::optional<V> as() const
+	{
+		static_assert(V::min_size <= CUC_DATA_BYTES, "view does not fit in a cuc_pkt");
+		if (payload_len() < V::min_size)
+			return std::nullopt;
+		return V(payload(), payload_len());
+	}
+
+	/* The errno of a CUC_TYPE_RSP_ERROR response, 0 otherwise */
+	constexpr int error() const
+	{
+		if (type() != CUC_TYPE_RSP_ERROR)
+			return 0;
+		return payload_len() ? payload()[0] : EIO;
+	}
+
+	/* The payload of a firmware version response, which is a string */
+	std::string_view string() const
+	{
+		const char *s = (const char *)payload();
+
+		return std::string_view(s, strnlen(s, payload_len()));
+	}
+
+private:
+	const struct cuc_pkt *pkt_;
+};
+
+} /* namespace cuc */
+
+#endif /* CUC_VIEW_HPP */
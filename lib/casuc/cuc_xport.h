@@ -0,0 +1,637 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* This file defines a host-side transport engine for exchanging struct cuc_pkt
+ * requests and responses with the Cassini uC.
+ *
+ * The uC services the requests arriving on one interface in order, so a response
+ * can be matched back to its request by command code (and by PLDM instance ID, type
+ * and command for CUC_CMD_PLDM) without adding a tag to the wire format. This lets
+ * a caller keep several requests in flight on an interface instead of paying one
+ * full round trip per command. USB, SMBus and HSN paths plug in through struct
+ * cuc_xport_ops and share the same queueing, matching and timeout logic.
+ *
+ * The engine performs no allocation and takes no locks. Requests are owned by the
+ * caller and are linked into the engine intrusively. A struct cuc_xport must only
+ * be driven by one thread at a time.
+ */
+
+#ifndef CUC_XPORT_H
+#define CUC_XPORT_H
+
+#include <errno.h>
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+
+#include "cuc_cxi.h"
+
+/* Upper bound on the number of requests outstanding on one interface */
+#define CUC_XPORT_MAX_INFLIGHT      32
+
+#define CUC_XPORT_DEFAULT_TIMEOUT_US  (2 * 1000 * 1000)
+
+/* Value of cuc_xport_req.match for requests that are matched by command code only */
+#define CUC_XPORT_MATCH_ANY         0xFF
+
+/* Physical interface used to reach the uC */
+enum cuc_xport_kind {
+	CUC_XPORT_USB,
+	CUC_XPORT_SMBUS,
+	CUC_XPORT_HSN,
+	CUC_XPORT_SIM,        /* In-process software uC, see cuc_sim.h */
+	CUC_XPORT_KIND_COUNT
+};
+
+/**
+ * struct cuc_xport_ops - Backend interface for a physical uC transport
+ *
+ * send() transmits one request packet. recv() waits up to timeout_us for one
+ * response packet and returns 0 when a packet was stored, -EAGAIN when none arrived
+ * in time, or another negative errno on a transport failure. Interfaces that cannot
+ * hold more than one request outstanding (e.g. SMBus block read/write) set
+ * max_inflight to 1 and still benefit from the shared queueing.
+ */
+struct cuc_xport_ops {
+	enum cuc_xport_kind kind;    /* Physical interface type */
+	unsigned int max_inflight;   /* Requests the interface can hold outstanding */
+	int (*send)(void *priv, const struct cuc_pkt *pkt);
+	int (*recv)(void *priv, struct cuc_pkt *pkt, long timeout_us);
+};
+
+enum {
+	CUC_XPORT_REQ_IDLE,       /* Not owned by the engine */
+	CUC_XPORT_REQ_PENDING,    /* Queued, not yet sent */
+	CUC_XPORT_REQ_INFLIGHT,   /* Sent, awaiting response */
+	CUC_XPORT_REQ_DONE,       /* Completed, on the done list */
+};
+
+struct cuc_xport_req;
+
+typedef void (*cuc_xport_done_fn)(struct cuc_xport_req *req);
+
+/* Called for every completed request, before its 'done' callback */
+typedef void (*cuc_xport_observe_fn)(void *ctx, const struct cuc_xport_req *req);
+
+/**
+ * struct cuc_xport_req - One request/response exchange
+ *
+ * The caller fills in 'req' (see cuc_xport_req_init()) and optionally 'timeout_us',
+ * 'done' and 'priv'. When the exchange completes, 'rsp' holds the response packet and
+ * 'status' is 0 for CUC_TYPE_RSP_SUCCESS/CUC_TYPE_RSP_PLDM, the negated errno from
+ * struct cuc_error_rsp_data for CUC_TYPE_RSP_ERROR, or a negative errno raised by the
+ * transport (-ETIMEDOUT, -ECANCELED, ...). If 'done' is set it is called on completion;
+ * otherwise the request is returned by cuc_xport_wait(), or by cuc_xport_complete()
+ * called with the same 'owner'.
+ *
+ * From cuc_xport_submit() until it completes, the request belongs to the engine and
+ * must not be reinitialized or freed.
+ */
+struct cuc_xport_req {
+	struct cuc_pkt req;         /* Request packet */
+	struct cuc_pkt rsp;         /* Response packet */
+	int status;                 /* Completion status */
+	u64 timeout_us;             /* Timeout measured from send, 0 for the engine default */
+	cuc_xport_done_fn done;     /* Optional completion callback */
+	void *priv;                 /* Caller cookie */
+	const void *owner;          /* Reaped only by cuc_xport_complete() for this owner */
+
+	/* Engine private */
+	struct cuc_xport_req *next;
+	u64 submit_us;              /* Time the request was queued */
+	u64 deadline_us;            /* Time the request times out */
+	u8 state;                   /* CUC_XPORT_REQ_* */
+	u8 match;                   /* PLDM instance ID, or CUC_XPORT_MATCH_ANY */
+	u8 cancelled;               /* Complete with -ECANCELED when the uC is done with it */
+};
+
+struct cuc_xport_queue {
+	struct cuc_xport_req *head;
+	struct cuc_xport_req *tail;
+};
+
+/**
+ * struct cuc_xport - Pipelined transport engine for one uC interface
+ */
+struct cuc_xport {
+	const struct cuc_xport_ops *ops;
+	void *priv;
+	unsigned int window;            /* Max requests in flight */
+	u64 default_timeout_us;
+	u8 resync;                      /* A request timed out; drain before sending more */
+
+	struct cuc_xport_queue pending; /* Queued, not yet sent */
+	struct cuc_xport_queue inflight;/* Sent, in transmit order */
+	struct cuc_xport_queue done;    /* Completed, not yet reaped */
+	unsigned int npending;
+	unsigned int ninflight;
+
+	/* Counters */
+	unsigned long sent;
+	unsigned long received;
+	unsigned long unmatched;        /* Responses with no matching request */
+	unsigned long timeouts;
+
+	/* Optional instrumentation, e.g. cuc_stats_attach() */
+	cuc_xport_observe_fn observe;
+	void *observe_ctx;
+};
+
+static inline u64 cuc_xport_now_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (u64)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static inline void cuc_xport_queue_push(struct cuc_xport_queue *q, struct cuc_xport_req *r)
+{
+	r->next = NULL;
+	if (q->tail)
+		q->tail->next = r;
+	else
+		q->head = r;
+	q->tail = r;
+}
+
+static inline struct cuc_xport_req *cuc_xport_queue_pop(struct cuc_xport_queue *q)
+{
+	struct cuc_xport_req *r = q->head;
+
+	if (r) {
+		q->head = r->next;
+		if (!q->head)
+			q->tail = NULL;
+		r->next = NULL;
+	}
+	return r;
+}
+
+/* Unlink 'r' given its predecessor 'prev' (NULL when r is the head) */
+static inline void cuc_xport_queue_unlink(struct cuc_xport_queue *q, struct cuc_xport_req *prev,
+					  struct cuc_xport_req *r)
+{
+	if (prev)
+		prev->next = r->next;
+	else
+		q->head = r->next;
+	if (q->tail == r)
+		q->tail = prev;
+	r->next = NULL;
+}
+
+/**
+ * cuc_xport_init() - Initialize a transport engine on top of a backend
+ * @x: Engine to initialize
+ * @ops: Backend operations
+ * @priv: Backend private data passed to every op
+ */
+static inline void cuc_xport_init(struct cuc_xport *x, const struct cuc_xport_ops *ops, void *priv)
+{
+	memset(x, 0, sizeof(*x));
+	x->ops = ops;
+	x->priv = priv;
+	x->window = ops->max_inflight;
+	if (x->window == 0)
+		x->window = 1;
+	if (x->window > CUC_XPORT_MAX_INFLIGHT)
+		x->window = CUC_XPORT_MAX_INFLIGHT;
+	x->default_timeout_us = CUC_XPORT_DEFAULT_TIMEOUT_US;
+}
+
+/**
+ * cuc_xport_req_init() - Build a request packet
+ * @r: Request to initialize
+ * @cmd: CUC_CMD_* command code
+ * @data: Request data, may be NULL when len is 0
+ * @len: Number of request data bytes
+ *
+ * Return: 0 on success, -EINVAL if the data does not fit in a packet
+ */
+static inline int cuc_xport_req_init(struct cuc_xport_req *r, u8 cmd, const void *data, size_t len)
+{
+	if (len > CUC_DATA_BYTES)
+		return -EINVAL;
+
+	r->req.cmd = cmd;
+	r->req.type = CUC_TYPE_REQ;
+	r->req.count = (u8)(len + 1);
+	if (len)
+		memmove(r->req.data, data, len);
+	r->status = 0;
+	r->timeout_us = 0;
+	r->done = NULL;
+	r->priv = NULL;
+	r->owner = NULL;
+	r->next = NULL;
+	r->state = CUC_XPORT_REQ_IDLE;
+	r->cancelled = 0;
+	return 0;
+}
+
+/* Number of data bytes in a response packet (count includes the 'type' byte) */
+static inline unsigned int cuc_xport_rsp_len(const struct cuc_xport_req *r)
+{
+	unsigned int count = r->rsp.count;
+
+	if (count == 0)
+		return 0;
+	count--;
+	return count > CUC_DATA_BYTES ? CUC_DATA_BYTES : count;
+}
+
+static inline void cuc_xport_finish(struct cuc_xport *x, struct cuc_xport_req *r, int status)
+{
+	r->status = r->cancelled ? -ECANCELED : status;
+	r->state = CUC_XPORT_REQ_DONE;
+	if (x->observe)
+		x->observe(x->observe_ctx, r);
+	if (r->done) {
+		r->done(r);
+		return;
+	}
+	cuc_xport_queue_push(&x->done, r);
+}
+
+/* PLDM responses carry the instance ID of the request in the first header byte */
+static inline u8 cuc_xport_match_key(const struct cuc_pkt *pkt)
+{
+	if (pkt->cmd != CUC_CMD_PLDM || pkt->count < 2)
+		return CUC_XPORT_MATCH_ANY;
+	if (pkt->type != CUC_TYPE_REQ && pkt->type != CUC_TYPE_RSP_PLDM)
+		return CUC_XPORT_MATCH_ANY;
+	return pkt->data[0] & 0x1F;
+}
+
+/* A PLDM response also echoes the PLDM type and command code of its request */
+static inline int cuc_xport_pldm_same_cmd(const struct cuc_pkt *req, const struct cuc_pkt *rsp)
+{
+	if (rsp->count < 4)
+		return 1;
+	return !((req->data[1] ^ rsp->data[1]) & 0x3F) && req->data[2] == rsp->data[2];
+}
+
+/* Send queued requests until the window is full */
+static inline int cuc_xport_kick(struct cuc_xport *x)
+{
+	struct cuc_xport_req *r;
+	u64 now;
+	int rc;
+
+	if (x->resync && x->ninflight)
+		return 0;
+	x->resync = 0;
+
+	now = cuc_xport_now_us();
+	while (x->ninflight < x->window && (r = x->pending.head) != NULL) {
+		cuc_xport_queue_pop(&x->pending);
+		x->npending--;
+
+		rc = x->ops->send(x->priv, &r->req);
+		if (rc < 0) {
+			cuc_xport_finish(x, r, rc);
+			return rc;
+		}
+		x->sent++;
+		r->state = CUC_XPORT_REQ_INFLIGHT;
+		r->deadline_us = now + (r->timeout_us ? r->timeout_us : x->default_timeout_us);
+		cuc_xport_queue_push(&x->inflight, r);
+		x->ninflight++;
+	}
+	return 0;
+}
+
+/**
+ * cuc_xport_submit() - Queue a batch of requests
+ * @x: Engine
+ * @reqs: Requests to queue, in transmit order
+ * @n: Number of requests
+ *
+ * Requests are sent as soon as the in-flight window allows; this call sends what it
+ * can without waiting for any response.
+ *
+ * Once queued, every request completes through the usual path. A request whose
+ * send fails completes with the send error, which can happen before this call
+ * returns: its 'done' callback may run from inside cuc_xport_submit().
+ *
+ * Return: @n, or -EBUSY if one of the requests is still owned by the engine, in
+ * which case none of them is queued
+ */
+static inline int cuc_xport_submit(struct cuc_xport *x, struct cuc_xport_req **reqs, unsigned int n)
+{
+	u64 now = cuc_xport_now_us();
+	unsigned int i;
+
+	for (i = 0; i < n; i++)
+		if (reqs[i]->state == CUC_XPORT_REQ_PENDING || reqs[i]->state == CUC_XPORT_REQ_INFLIGHT)
+			return -EBUSY;
+
+	for (i = 0; i < n; i++) {
+		struct cuc_xport_req *r = reqs[i];
+
+		r->state = CUC_XPORT_REQ_PENDING;
+		r->cancelled = 0;
+		r->status = 0;
+		r->submit_us = now;
+		r->match = cuc_xport_match_key(&r->req);
+		cuc_xport_queue_push(&x->pending, r);
+		x->npending++;
+	}
+
+	/* A send failure has already completed the request it concerns */
+	cuc_xport_kick(x);
+	return (int)n;
+}
+
+/* Pair a received packet with the oldest in-flight request it answers */
+static inline void cuc_xport_dispatch(struct cuc_xport *x, const struct cuc_pkt *pkt)
+{
+	struct cuc_xport_req *prev = NULL;
+	struct cuc_xport_req *r;
+	u8 key = cuc_xport_match_key(pkt);
+
+	for (r = x->inflight.head; r; prev = r, r = r->next) {
+		if (r->req.cmd != pkt->cmd)
+			continue;
+		if (key != CUC_XPORT_MATCH_ANY &&
+		    (r->match != key || !cuc_xport_pldm_same_cmd(&r->req, pkt)))
+			continue;
+		break;
+	}
+	if (!r) {
+		x->unmatched++;
+		return;
+	}
+
+	cuc_xport_queue_unlink(&x->inflight, prev, r);
+	x->ninflight--;
+	x->received++;
+	r->rsp = *pkt;
+
+	if (pkt->type == CUC_TYPE_RSP_ERROR)
+		cuc_xport_finish(x, r, pkt->count >= 2 && pkt->data[0] ? -(int)pkt->data[0] : -EIO);
+	else if (pkt->type == CUC_TYPE_RSP_SUCCESS || pkt->type == CUC_TYPE_RSP_PLDM)
+		cuc_xport_finish(x, r, 0);
+	else
+		cuc_xport_finish(x, r, -EPROTO);
+}
+
+/* Fail in-flight requests whose deadline has passed. Returns the earliest remaining deadline. */
+static inline u64 cuc_xport_expire(struct cuc_xport *x, u64 now)
+{
+	struct cuc_xport_req *prev = NULL;
+	struct cuc_xport_req *r = x->inflight.head;
+	u64 next = (u64)-1;
+
+	while (r) {
+		struct cuc_xport_req *n = r->next;
+
+		if (r->deadline_us <= now) {
+			cuc_xport_queue_unlink(&x->inflight, prev, r);
+			x->ninflight--;
+			x->timeouts++;
+			/* A late response could be paired with a newer request for the same
+			 * command. Stop sending until the interface has drained.
+			 */
+			x->resync = 1;
+			cuc_xport_finish(x, r, -ETIMEDOUT);
+		} else {
+			if (r->deadline_us < next)
+				next = r->deadline_us;
+			prev = r;
+		}
+		r = n;
+	}
+	return next;
+}
+
+/**
+ * cuc_xport_progress() - Send queued requests and collect responses
+ * @x: Engine
+ * @timeout_us: Maximum time to wait for the first response
+ *
+ * After the first response arrives, any further responses that are already available
+ * are collected without waiting.
+ *
+ * Return: Number of responses received, or a negative errno on transport failure
+ */
+static inline int cuc_xport_progress(struct cuc_xport *x, long timeout_us)
+{
+	struct cuc_pkt pkt;
+	unsigned int nrx = 0;
+	u64 now, next;
+	long wait;
+	int rc;
+
+	rc = cuc_xport_kick(x);
+	if (rc < 0)
+		return rc;
+
+	now = cuc_xport_now_us();
+	next = cuc_xport_expire(x, now);
+	if (!x->ninflight)
+		return (int)nrx;
+
+	wait = timeout_us < 0 ? 0 : timeout_us;
+	if (next != (u64)-1 && next - now < (u64)wait)
+		wait = (long)(next - now);
+
+	for (;;) {
+		rc = x->ops->recv(x->priv, &pkt, wait);
+		if (rc == -EAGAIN)
+			break;
+		if (rc < 0)
+			return rc;
+		cuc_xport_dispatch(x, &pkt);
+		nrx++;
+		if (!x->ninflight)
+			break;
+		wait = 0;
+	}
+
+	cuc_xport_expire(x, cuc_xport_now_us());
+	rc = cuc_xport_kick(x);
+	if (rc < 0)
+		return rc;
+	return (int)nrx;
+}
+
+/* True when nothing is queued or outstanding */
+static inline int cuc_xport_idle(const struct cuc_xport *x)
+{
+	return !x->npending && !x->ninflight;
+}
+
+/* True when a request submitted now would be sent at once, ahead of nobody */
+static inline int cuc_xport_has_room(const struct cuc_xport *x)
+{
+	return !x->npending && x->ninflight < x->window;
+}
+
+/* Take a request that has not been sent yet off the pending queue. Returns 1 if it was there. */
+static inline int cuc_xport_unqueue(struct cuc_xport *x, struct cuc_xport_req *r)
+{
+	struct cuc_xport_req *prev = NULL;
+	struct cuc_xport_req *it;
+
+	if (r->state != CUC_XPORT_REQ_PENDING)
+		return 0;
+	for (it = x->pending.head; it; prev = it, it = it->next) {
+		if (it == r) {
+			cuc_xport_queue_unlink(&x->pending, prev, r);
+			x->npending--;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/* Move completed requests of 'owner' from the done list to 'out' */
+static inline unsigned int cuc_xport_reap(struct cuc_xport *x, const void *owner, struct cuc_xport_req **out,
+					  unsigned int max)
+{
+	struct cuc_xport_req *prev = NULL;
+	struct cuc_xport_req *r = x->done.head;
+	unsigned int n = 0;
+
+	while (r && n < max) {
+		struct cuc_xport_req *next = r->next;
+
+		if (r->owner == owner) {
+			cuc_xport_queue_unlink(&x->done, prev, r);
+			r->state = CUC_XPORT_REQ_IDLE;
+			out[n++] = r;
+		} else {
+			prev = r;
+		}
+		r = next;
+	}
+	return n;
+}
+
+/* True if a completed request of 'owner' is waiting on the done list */
+static inline int cuc_xport_done_for(const struct cuc_xport *x, const void *owner)
+{
+	const struct cuc_xport_req *r;
+
+	for (r = x->done.head; r; r = r->next)
+		if (r->owner == owner)
+			return 1;
+	return 0;
+}
+
+/**
+ * cuc_xport_complete() - Reap completed requests of one owner
+ * @x: Engine
+ * @owner: Only requests whose 'owner' is this are returned
+ * @out: Array receiving completed requests
+ * @max: Size of @out
+ * @timeout_us: Maximum time to wait for at least one completion
+ *
+ * Several users can share an engine: the completions of other owners stay on the
+ * done list. Requests that have a 'done' callback are never returned here.
+ *
+ * Return: Number of requests stored in @out, or a negative errno on transport failure
+ */
+static inline int cuc_xport_complete(struct cuc_xport *x, const void *owner, struct cuc_xport_req **out,
+				     unsigned int max, long timeout_us)
+{
+	u64 end = cuc_xport_now_us() + (timeout_us > 0 ? (u64)timeout_us : 0);
+	unsigned int n;
+	u64 now;
+	int rc;
+
+	for (;;) {
+		n = cuc_xport_reap(x, owner, out, max);
+		if (n || cuc_xport_idle(x))
+			return (int)n;
+
+		now = cuc_xport_now_us();
+		rc = cuc_xport_progress(x, now < end ? (long)(end - now) : 0);
+		if (rc < 0)
+			return rc;
+		if (!cuc_xport_done_for(x, owner) && cuc_xport_now_us() >= end)
+			return 0;
+	}
+}
+
+/**
+ * cuc_xport_wait() - Wait for one specific request to complete
+ * @x: Engine
+ * @r: Request previously passed to cuc_xport_submit()
+ *
+ * Other requests that complete in the meantime stay on the done list.
+ *
+ * This only returns once the engine is done with @r, so the caller may then reuse
+ * or free it. If the transport fails while @r has not been sent yet, @r is taken off
+ * the queue and completes with that error. If @r is already on the wire it keeps
+ * its slot until the uC answers or it times out, as for cuc_xport_cancel().
+ *
+ * Return: The request status
+ */
+static inline int cuc_xport_wait(struct cuc_xport *x, struct cuc_xport_req *r)
+{
+	struct cuc_xport_req *prev = NULL;
+	struct cuc_xport_req *it;
+	int rc;
+
+	while (r->state == CUC_XPORT_REQ_PENDING || r->state == CUC_XPORT_REQ_INFLIGHT) {
+		rc = cuc_xport_progress(x, (long)x->default_timeout_us);
+		if (rc < 0 && cuc_xport_unqueue(x, r))
+			cuc_xport_finish(x, r, rc);
+	}
+
+	if (r->state == CUC_XPORT_REQ_DONE && !r->done) {
+		for (it = x->done.head; it; prev = it, it = it->next) {
+			if (it == r) {
+				cuc_xport_queue_unlink(&x->done, prev, r);
+				break;
+			}
+		}
+	}
+	r->state = CUC_XPORT_REQ_IDLE;
+	return r->status;
+}
+
+/**
+ * cuc_xport_exec() - Submit one request and wait for its response
+ * @x: Engine
+ * @r: Request
+ *
+ * Return: The request status
+ */
+static inline int cuc_xport_exec(struct cuc_xport *x, struct cuc_xport_req *r)
+{
+	int rc = cuc_xport_submit(x, &r, 1);
+
+	if (rc < 0)
+		return rc;
+	return cuc_xport_wait(x, r);
+}
+
+/**
+ * cuc_xport_cancel() - Cancel a submitted request
+ * @x: Engine
+ * @r: Request
+ *
+ * A request that has not been sent completes immediately with -ECANCELED. A request
+ * already on the wire keeps its slot until the uC answers (or it times out), so the
+ * in-order matching stays correct, and then completes with -ECANCELED.
+ *
+ * Return: 0 on success, -EALREADY if the request has already completed
+ */
+static inline int cuc_xport_cancel(struct cuc_xport *x, struct cuc_xport_req *r)
+{
+	if (r->state == CUC_XPORT_REQ_INFLIGHT) {
+		r->cancelled = 1;
+		return 0;
+	}
+	if (!cuc_xport_unqueue(x, r))
+		return -EALREADY;
+	r->cancelled = 1;
+	cuc_xport_finish(x, r, -ECANCELED);
+	return 0;
+}
+
+#endif /* CUC_XPORT_H */
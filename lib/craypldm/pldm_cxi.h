@@ -97,6 +97,21 @@ enum pldm_sensor_opstate {
     PLDM_OPSTATE_IN_TEST = 7
 };
 
+/* Numeric sensor presentState/previousState/eventState values (DSP0248 Table 30) */
+enum pldm_sensor_state {
+    PLDM_SENSOR_STATE_UNKNOWN = 0,
+    PLDM_SENSOR_STATE_NORMAL = 1,
+    PLDM_SENSOR_STATE_WARNING = 2,
+    PLDM_SENSOR_STATE_CRITICAL = 3,
+    PLDM_SENSOR_STATE_FATAL = 4,
+    PLDM_SENSOR_STATE_LOWER_WARNING = 5,
+    PLDM_SENSOR_STATE_LOWER_CRITICAL = 6,
+    PLDM_SENSOR_STATE_LOWER_FATAL = 7,
+    PLDM_SENSOR_STATE_UPPER_WARNING = 8,
+    PLDM_SENSOR_STATE_UPPER_CRITICAL = 9,
+    PLDM_SENSOR_STATE_UPPER_FATAL = 10
+};
+
 /* PLDM Sensor Units (Table 62 of DSP0248) */
 enum sensor_unit {
     PLDM_UNIT_NONE = 0,
@@ -173,6 +188,24 @@ enum pldm_transfer_op {
 	PLDM_XFER_OP_GET_FIRST_PART = 1
 };
 
+/* GetPDR transferFlag values (DSP0248 Table 68) */
+enum pldm_transfer_flag {
+	PLDM_XFER_FLAG_START = 0x00,
+	PLDM_XFER_FLAG_MIDDLE = 0x01,
+	PLDM_XFER_FLAG_END = 0x04,
+	PLDM_XFER_FLAG_START_AND_END = 0x05
+};
+
+/* GetPDR command-specific completion codes (DSP0248 Table 68) */
+enum pldm_get_pdr_completion_code {
+	PLDM_GET_PDR_INVALID_DATA_TRANSFER_HANDLE = 0x80,
+	PLDM_GET_PDR_INVALID_TRANSFER_OPERATION_FLAG = 0x81,
+	PLDM_GET_PDR_INVALID_RECORD_HANDLE = 0x82,
+	PLDM_GET_PDR_INVALID_RECORD_CHANGE_NUMBER = 0x83,
+	PLDM_GET_PDR_TRANSFER_TIMEOUT = 0x84,
+	PLDM_GET_PDR_REPOSITORY_UPDATE_IN_PROGRESS = 0x85
+};
+
 /* Common PDR Header Format (DSP0248 Table 75) */
 struct pdr_hdr {
 	u32 record_handle;
@@ -328,6 +361,38 @@ struct aux_name_pdr {
 	u16 sensor_name[AUX_NAME_MAX];
 } __packed;
 
+/* FRU Record Set PDR Format (DSP0248 Table 90) */
+struct fru_record_set_pdr {
+	struct pdr_hdr hdr;
+	u16 pldm_terminus_handle;
+	u16 fru_record_set_identifier;
+	u16 entity_type;
+	u16 entity_instance_number;
+	u16 container_id;
+} __packed;
+
+/* Entity identification as used in Entity Association PDRs */
+struct pldm_entity_id {
+	u16 entity_type;                /* Bit 15 set for a logical entity */
+	u16 entity_instance_number;
+	u16 container_id;
+} __packed;
+
+enum pldm_entity_association_type {
+	PLDM_ENTITY_ASSOCIATION_PHYSICAL = 0,
+	PLDM_ENTITY_ASSOCIATION_LOGICAL = 1
+};
+
+/* Entity Association PDR Format (DSP0248) */
+struct entity_association_pdr {
+	struct pdr_hdr hdr;
+	u16 container_id;               /* ID the container gives the entities it contains */
+	u8 association_type;
+	struct pldm_entity_id container;
+	u8 contained_entity_count;
+	struct pldm_entity_id contained[];
+} __packed;
+
 /* PLDM FRU Field TLV (DSP0257 Table 2) */
 struct pldm_fru_field {
 	u8 field_type;
@@ -0,0 +1,714 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* This file builds the PLDM entity hierarchy of a PDR repository.
+ *
+ * Physical Entity Association PDRs say which entities each container holds (board,
+ * then ASIC/NIC, QSFP cage, regulator, ...). Numeric sensor PDRs and FRU record
+ * set PDRs name the entity they belong to. pldm_entity_tree_build() joins them
+ * into one flat array of nodes in depth-first order, so every subtree is a
+ * contiguous range of nodes. The numeric sensors are stored in the same order
+ * (an entity's own sensors, then those of its children), so the sensors under
+ * any entity, such as every temperature sensor below one QSFP cage, are one
+ * contiguous slice as well.
+ *
+ * The tree keeps the record_handle and record_change_number of every record it
+ * used. pldm_entity_tree_update() compares them with a refreshed cache and
+ * rebuilds only the subtrees of the entities whose records changed, splicing the
+ * result into place. If records were added or removed, the set of top-level
+ * entities changed, or an entity moved to another container, it falls back to a
+ * full build.
+ *
+ * Logical associations are ignored. An entity that appears in several physical
+ * associations is placed under the first container in entity order. Entities
+ * that are not contained in anything are roots. Entities that are only contained
+ * in each other (a cycle with no root) cannot be placed, and fail the build with
+ * -ELOOP.
+ */
+
+#ifndef PLDM_ENTITY_H
+#define PLDM_ENTITY_H
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pldm_cxi.h"
+#include "pldm_pdr_cache.h"
+
+#define PLDM_ENTITY_NONE       0xFFFFFFFF
+#define PLDM_ENTITY_MAX_DEPTH  16
+
+/**
+ * struct pldm_entity_node - One entity; the node at index i owns [i, i + size)
+ */
+struct pldm_entity_node {
+	struct pldm_entity_id id;
+	u16 fru_record_set_id;     /* From a FRU record set PDR, 0 if none */
+	u32 parent;                /* Node index, PLDM_ENTITY_NONE for a root */
+	u32 size;                  /* Nodes in the subtree, including this one */
+	u32 sensor_begin;          /* Sensors of the subtree: [sensor_begin, sensor_end) */
+	u32 sensor_end;
+	u32 nown;                  /* Sensors of this entity itself, first in its range */
+	u32 depth;
+};
+
+/**
+ * struct pldm_entity_sensor - One numeric sensor in tree order
+ */
+struct pldm_entity_sensor {
+	u16 sensor_id;
+	u32 numeric_idx;           /* Index for pldm_pdr_cache_numeric_at() */
+};
+
+/* A record the tree was built from */
+struct pldm_entity_rec {
+	u32 handle;
+	u16 change;                /* record_change_number */
+	u8 pdr_type;
+	struct pldm_entity_id id;  /* The container, or the entity the record belongs to */
+};
+
+/**
+ * struct pldm_entity_tree - Entity hierarchy of one PDR repository
+ */
+struct pldm_entity_tree {
+	struct pldm_entity_node *node;
+	u32 nnodes;
+	u32 node_cap;
+	struct pldm_entity_sensor *sensor;
+	u32 nsensors;
+	u32 sensor_cap;
+	u32 *by_id;                /* Node indexes sorted by entity id */
+	struct pldm_entity_rec *rec;  /* Sorted by handle */
+	u32 nrecs;
+	u32 rebuilt;               /* Nodes rebuilt by the last build or update */
+};
+
+/* Records of a cache, indexed for building */
+struct pldm_entity_link {
+	struct pldm_entity_id parent;
+	struct pldm_entity_id child;
+};
+
+struct pldm_entity_sref {
+	struct pldm_entity_id id;
+	u16 sensor_id;
+	u32 numeric_idx;
+};
+
+struct pldm_entity_fref {
+	struct pldm_entity_id id;
+	u16 fru_record_set_id;
+};
+
+struct pldm_entity_maps {
+	struct pldm_entity_link *link;   /* Sorted by parent, then child */
+	u32 nlinks;
+	struct pldm_entity_sref *sens;   /* Sorted by entity, then sensor_id */
+	u32 nsens;
+	struct pldm_entity_fref *fru;    /* Sorted by entity */
+	u32 nfru;
+	struct pldm_entity_id *root;     /* Sorted */
+	u32 nroots;
+	struct pldm_entity_rec *rec;     /* Sorted by handle */
+	u32 nrecs;
+	u32 nentities;                   /* Distinct entities named by any record */
+};
+
+static inline int pldm_entity_id_cmp(const struct pldm_entity_id *a, const struct pldm_entity_id *b)
+{
+	if (a->entity_type != b->entity_type)
+		return a->entity_type < b->entity_type ? -1 : 1;
+	if (a->entity_instance_number != b->entity_instance_number)
+		return a->entity_instance_number < b->entity_instance_number ? -1 : 1;
+	return (a->container_id > b->container_id) - (a->container_id < b->container_id);
+}
+
+static inline int pldm_entity_cmp_id(const void *a, const void *b)
+{
+	return pldm_entity_id_cmp((const struct pldm_entity_id *)a, (const struct pldm_entity_id *)b);
+}
+
+static inline int pldm_entity_cmp_child(const void *a, const void *b)
+{
+	const struct pldm_entity_link *x = (const struct pldm_entity_link *)a;
+	const struct pldm_entity_link *y = (const struct pldm_entity_link *)b;
+	int c = pldm_entity_id_cmp(&x->child, &y->child);
+
+	return c ? c : pldm_entity_id_cmp(&x->parent, &y->parent);
+}
+
+static inline int pldm_entity_cmp_parent(const void *a, const void *b)
+{
+	const struct pldm_entity_link *x = (const struct pldm_entity_link *)a;
+	const struct pldm_entity_link *y = (const struct pldm_entity_link *)b;
+	int c = pldm_entity_id_cmp(&x->parent, &y->parent);
+
+	return c ? c : pldm_entity_id_cmp(&x->child, &y->child);
+}
+
+static inline int pldm_entity_cmp_sref(const void *a, const void *b)
+{
+	const struct pldm_entity_sref *x = (const struct pldm_entity_sref *)a;
+	const struct pldm_entity_sref *y = (const struct pldm_entity_sref *)b;
+	int c = pldm_entity_id_cmp(&x->id, &y->id);
+
+	return c ? c : (x->sensor_id > y->sensor_id) - (x->sensor_id < y->sensor_id);
+}
+
+static inline int pldm_entity_cmp_rec(const void *a, const void *b)
+{
+	u32 x = ((const struct pldm_entity_rec *)a)->handle;
+	u32 y = ((const struct pldm_entity_rec *)b)->handle;
+
+	return x < y ? -1 : x > y;
+}
+
+static __thread const struct pldm_entity_node *pldm_entity_sort_nodes;
+
+static inline int pldm_entity_cmp_node(const void *a, const void *b)
+{
+	return pldm_entity_id_cmp(&pldm_entity_sort_nodes[*(const u32 *)a].id,
+				  &pldm_entity_sort_nodes[*(const u32 *)b].id);
+}
+
+/*
+ * First index in a sorted array of n elements of 'size' bytes whose entity id,
+ * at offset 'off', is not less than id
+ */
+static inline u32 pldm_entity_lower(const void *base, u32 n, size_t size, size_t off,
+				    const struct pldm_entity_id *id)
+{
+	u32 lo = 0, hi = n, mid;
+
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (pldm_entity_id_cmp((const struct pldm_entity_id *)((const u8 *)base + mid * size + off), id) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+static inline void pldm_entity_maps_free(struct pldm_entity_maps *m)
+{
+	free(m->link);
+	free(m->sens);
+	free(m->fru);
+	free(m->root);
+	free(m->rec);
+	memset(m, 0, sizeof(*m));
+}
+
+/**
+ * pldm_entity_maps_build() - Collect the association, sensor and FRU set records of a cache
+ *
+ * The cache indexes numeric sensor and FRU record set PDRs only when they are long
+ * enough for their type (pldm_pdr_complete()), so only the association records,
+ * whose length depends on their contained entity count, are checked here.
+ *
+ * Return: 0 on success, -EINVAL if an association PDR is truncated, or -ENOMEM
+ */
+static inline int pldm_entity_maps_build(struct pldm_entity_maps *m, const struct pldm_pdr_cache *c)
+{
+	const struct pldm_pdr_cache_file *f = c->file;
+	struct pldm_entity_id *all = NULL;
+	u32 i, k, nlinks = 0, nall = 0;
+	int rc = -ENOMEM;
+
+	memset(m, 0, sizeof(*m));
+	if (!f)
+		return -EINVAL;
+
+	for (i = 0; i < f->num_records; i++) {
+		const struct entity_association_pdr *a;
+
+		if (c->entries[i].pdr_type != PLDM_PDR_ENTITY_ASSOCIATION)
+			continue;
+		a = (const struct entity_association_pdr *)pldm_pdr_cache_record(c, i);
+		if (c->entries[i].length < sizeof(*a) ||
+		    c->entries[i].length < sizeof(*a) + a->contained_entity_count * sizeof(a->contained[0]))
+			return -EINVAL;
+		if (a->association_type == PLDM_ENTITY_ASSOCIATION_PHYSICAL)
+			nlinks += a->contained_entity_count;
+	}
+
+	m->link = (struct pldm_entity_link *)malloc((nlinks + 1) * sizeof(*m->link));
+	m->sens = (struct pldm_entity_sref *)malloc((f->num_numeric + 1) * sizeof(*m->sens));
+	m->fru = (struct pldm_entity_fref *)malloc((f->num_fru_sets + 1) * sizeof(*m->fru));
+	m->rec = (struct pldm_entity_rec *)malloc((f->num_records + 1) * sizeof(*m->rec));
+	all = (struct pldm_entity_id *)malloc((2 * (size_t)nlinks + f->num_numeric + f->num_fru_sets + 1) *
+					      sizeof(*all));
+	if (!m->link || !m->sens || !m->fru || !m->rec || !all)
+		goto err;
+
+	for (i = 0; i < f->num_records; i++) {
+		const struct pldm_pdr_cache_entry *e = &c->entries[i];
+		const struct entity_association_pdr *a;
+		struct pldm_entity_rec *r;
+
+		if (e->pdr_type != PLDM_PDR_ENTITY_ASSOCIATION)
+			continue;
+		a = (const struct entity_association_pdr *)pldm_pdr_cache_record(c, i);
+		if (a->association_type != PLDM_ENTITY_ASSOCIATION_PHYSICAL)
+			continue;
+		r = &m->rec[m->nrecs++];
+		r->handle = e->record_handle;
+		r->change = e->record_change_number;
+		r->pdr_type = e->pdr_type;
+		r->id = a->container;
+		for (k = 0; k < a->contained_entity_count; k++) {
+			m->link[m->nlinks].parent = a->container;
+			m->link[m->nlinks++].child = a->contained[k];
+		}
+	}
+	for (i = 0; i < f->num_numeric; i++) {
+		const struct pldm_pdr_cache_entry *e = &c->entries[c->numeric[i]];
+		const struct numeric_sensor_pdr *p = pldm_pdr_cache_numeric_at(c, i);
+		struct pldm_entity_sref *s = &m->sens[m->nsens++];
+		struct pldm_entity_rec *r = &m->rec[m->nrecs++];
+
+		s->id.entity_type = p->entity_type;
+		s->id.entity_instance_number = p->entity_instance_number;
+		s->id.container_id = p->container_id;
+		s->sensor_id = p->sensor_id;
+		s->numeric_idx = i;
+		r->handle = e->record_handle;
+		r->change = e->record_change_number;
+		r->pdr_type = e->pdr_type;
+		r->id = s->id;
+		all[nall++] = s->id;
+	}
+	for (i = 0; i < f->num_fru_sets; i++) {
+		const struct pldm_pdr_cache_entry *e = &c->entries[c->fru_sets[i]];
+		const struct fru_record_set_pdr *p = pldm_pdr_cache_fru_set_at(c, i);
+		struct pldm_entity_fref *fr = &m->fru[m->nfru++];
+		struct pldm_entity_rec *r = &m->rec[m->nrecs++];
+
+		fr->id.entity_type = p->entity_type;
+		fr->id.entity_instance_number = p->entity_instance_number;
+		fr->id.container_id = p->container_id;
+		fr->fru_record_set_id = p->fru_record_set_identifier;
+		r->handle = e->record_handle;
+		r->change = e->record_change_number;
+		r->pdr_type = e->pdr_type;
+		r->id = fr->id;
+		all[nall++] = fr->id;
+	}
+
+	/* Keep one container per entity, then find the entities no container holds */
+	qsort(m->link, m->nlinks, sizeof(*m->link), pldm_entity_cmp_child);
+	for (i = 0, k = 0; i < m->nlinks; i++)
+		if (!k || pldm_entity_id_cmp(&m->link[i].child, &m->link[k - 1].child))
+			m->link[k++] = m->link[i];
+	m->nlinks = k;
+	for (i = 0; i < m->nlinks; i++) {
+		all[nall++] = m->link[i].parent;
+		all[nall++] = m->link[i].child;
+	}
+	qsort(all, nall, sizeof(*all), pldm_entity_cmp_id);
+	m->root = all;
+	for (i = 0; i < nall; i++) {
+		if (i && !pldm_entity_id_cmp(&all[i], &all[i - 1]))
+			continue;
+		m->nentities++;
+		k = pldm_entity_lower(m->link, m->nlinks, sizeof(*m->link), offsetof(struct pldm_entity_link, child),
+				      &all[i]);
+		if (k < m->nlinks && !pldm_entity_id_cmp(&m->link[k].child, &all[i]))
+			continue;
+		m->root[m->nroots++] = all[i];
+	}
+
+	qsort(m->link, m->nlinks, sizeof(*m->link), pldm_entity_cmp_parent);
+	qsort(m->sens, m->nsens, sizeof(*m->sens), pldm_entity_cmp_sref);
+	qsort(m->fru, m->nfru, sizeof(*m->fru), pldm_entity_cmp_id);
+	qsort(m->rec, m->nrecs, sizeof(*m->rec), pldm_entity_cmp_rec);
+	return 0;
+
+err:
+	free(all);
+	pldm_entity_maps_free(m);
+	return rc;
+}
+
+static inline int pldm_entity_grow(void **p, u32 *cap, u32 need, size_t size)
+{
+	u32 n = *cap ? *cap : 16;
+	void *q;
+
+	if (need <= *cap)
+		return 0;
+	while (n < need)
+		n *= 2;
+	q = realloc(*p, (size_t)n * size);
+	if (!q)
+		return -ENOMEM;
+	*p = q;
+	*cap = n;
+	return 0;
+}
+
+/*
+ * Append the subtree of 'id' to out->node and its sensors to out->sensor. Indexes
+ * are stored as if out->node[0] were node 'node_base' of the final tree and
+ * out->sensor[0] were sensor 'sensor_base'.
+ */
+static inline int pldm_entity_emit(const struct pldm_entity_maps *m, const struct pldm_entity_id *id, u32 parent,
+				   u32 depth, struct pldm_entity_tree *out, u32 node_base, u32 sensor_base)
+{
+	struct pldm_entity_node *n;
+	u32 idx = out->nnodes, i, s;
+	int rc;
+
+	if (depth >= PLDM_ENTITY_MAX_DEPTH)
+		return -ELOOP;
+	if (pldm_entity_grow((void **)&out->node, &out->node_cap, idx + 1, sizeof(*out->node)))
+		return -ENOMEM;
+	out->nnodes++;
+	n = &out->node[idx];
+	memset(n, 0, sizeof(*n));
+	n->id = *id;
+	n->parent = parent;
+	n->depth = depth;
+	n->sensor_begin = sensor_base + out->nsensors;
+	i = pldm_entity_lower(m->fru, m->nfru, sizeof(*m->fru), 0, id);
+	if (i < m->nfru && !pldm_entity_id_cmp(&m->fru[i].id, id))
+		n->fru_record_set_id = m->fru[i].fru_record_set_id;
+
+	for (s = pldm_entity_lower(m->sens, m->nsens, sizeof(*m->sens), 0, id);
+	     s < m->nsens && !pldm_entity_id_cmp(&m->sens[s].id, id); s++) {
+		if (pldm_entity_grow((void **)&out->sensor, &out->sensor_cap, out->nsensors + 1, sizeof(*out->sensor)))
+			return -ENOMEM;
+		out->sensor[out->nsensors].sensor_id = m->sens[s].sensor_id;
+		out->sensor[out->nsensors++].numeric_idx = m->sens[s].numeric_idx;
+		n->nown++;
+	}
+
+	for (i = pldm_entity_lower(m->link, m->nlinks, sizeof(*m->link), 0, id);
+	     i < m->nlinks && !pldm_entity_id_cmp(&m->link[i].parent, id); i++) {
+		rc = pldm_entity_emit(m, &m->link[i].child, node_base + idx, depth + 1, out, node_base, sensor_base);
+		if (rc)
+			return rc;
+	}
+
+	n = &out->node[idx];
+	n->size = out->nnodes - idx;
+	n->sensor_end = sensor_base + out->nsensors;
+	return 0;
+}
+
+static inline int pldm_entity_index(struct pldm_entity_tree *t)
+{
+	u32 i;
+
+	free(t->by_id);
+	t->by_id = (u32 *)malloc((t->nnodes + 1) * sizeof(*t->by_id));
+	if (!t->by_id)
+		return -ENOMEM;
+	for (i = 0; i < t->nnodes; i++)
+		t->by_id[i] = i;
+	pldm_entity_sort_nodes = t->node;
+	qsort(t->by_id, t->nnodes, sizeof(*t->by_id), pldm_entity_cmp_node);
+	pldm_entity_sort_nodes = NULL;
+	return 0;
+}
+
+static inline void pldm_entity_tree_fini(struct pldm_entity_tree *t)
+{
+	free(t->node);
+	free(t->sensor);
+	free(t->by_id);
+	free(t->rec);
+	memset(t, 0, sizeof(*t));
+}
+
+/* Rebuild the whole tree from m, taking over m's record list */
+static inline int pldm_entity_tree_from_maps(struct pldm_entity_tree *t, struct pldm_entity_maps *m)
+{
+	u32 i;
+	int rc;
+
+	t->nnodes = 0;
+	t->nsensors = 0;
+	for (i = 0; i < m->nroots; i++) {
+		rc = pldm_entity_emit(m, &m->root[i], PLDM_ENTITY_NONE, 0, t, 0, 0);
+		if (rc)
+			return rc;
+	}
+	/* Entities not reached from a root are contained in a cycle */
+	if (t->nnodes != m->nentities)
+		return -ELOOP;
+	free(t->rec);
+	t->rec = m->rec;
+	t->nrecs = m->nrecs;
+	m->rec = NULL;
+	t->rebuilt = t->nnodes;
+	return pldm_entity_index(t);
+}
+
+/**
+ * pldm_entity_tree_build() - Build the entity tree of a PDR cache
+ * @t: Tree to initialize; pldm_entity_tree_fini() releases it
+ * @c: Open PDR cache; the tree refers to its numeric sensor order
+ *
+ * Return: 0 on success, -ELOOP if the associations nest deeper than
+ * PLDM_ENTITY_MAX_DEPTH or contain a cycle, -EINVAL for a truncated record, or
+ * -ENOMEM
+ */
+static inline int pldm_entity_tree_build(struct pldm_entity_tree *t, const struct pldm_pdr_cache *c)
+{
+	struct pldm_entity_maps m;
+	int rc;
+
+	memset(t, 0, sizeof(*t));
+	rc = pldm_entity_maps_build(&m, c);
+	if (rc)
+		return rc;
+	rc = pldm_entity_tree_from_maps(t, &m);
+	pldm_entity_maps_free(&m);
+	if (rc)
+		pldm_entity_tree_fini(t);
+	return rc;
+}
+
+/**
+ * pldm_entity_find() - Node index of an entity
+ *
+ * Return: The index, or PLDM_ENTITY_NONE
+ */
+static inline u32 pldm_entity_find(const struct pldm_entity_tree *t, const struct pldm_entity_id *id)
+{
+	u32 lo = 0, hi = t->nnodes, mid;
+	int c;
+
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		c = pldm_entity_id_cmp(&t->node[t->by_id[mid]].id, id);
+		if (!c)
+			return t->by_id[mid];
+		if (c < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return PLDM_ENTITY_NONE;
+}
+
+/**
+ * pldm_entity_sensors() - Numeric sensors of an entity and everything below it
+ * @n: Set to the number of sensors
+ */
+static inline const struct pldm_entity_sensor *pldm_entity_sensors(const struct pldm_entity_tree *t, u32 node,
+								   u32 *n)
+{
+	const struct pldm_entity_node *e = &t->node[node];
+
+	*n = e->sensor_end - e->sensor_begin;
+	return t->sensor + e->sensor_begin;
+}
+
+/* Is node 'a' in the subtree of node 'root'? */
+static inline int pldm_entity_in_subtree(const struct pldm_entity_tree *t, u32 root, u32 a)
+{
+	return a >= root && a < root + t->node[root].size;
+}
+
+/* Replace the subtree at r with the one emitted into tmp, and fix up every index after it */
+static inline int pldm_entity_splice(struct pldm_entity_tree *t, u32 r, struct pldm_entity_tree *tmp)
+{
+	u32 old_n = t->node[r].size, sb = t->node[r].sensor_begin;
+	u32 old_s = t->node[r].sensor_end - sb, i, p;
+	s64 dn = (s64)tmp->nnodes - old_n, ds = (s64)tmp->nsensors - old_s;
+
+	if (pldm_entity_grow((void **)&t->node, &t->node_cap, (u32)(t->nnodes + dn), sizeof(*t->node)) ||
+	    pldm_entity_grow((void **)&t->sensor, &t->sensor_cap, (u32)(t->nsensors + ds) + 1, sizeof(*t->sensor)))
+		return -ENOMEM;
+
+	for (p = t->node[r].parent; p != PLDM_ENTITY_NONE; p = t->node[p].parent) {
+		t->node[p].size += (u32)dn;
+		t->node[p].sensor_end += (u32)ds;
+	}
+	memmove(&t->node[r + tmp->nnodes], &t->node[r + old_n], (t->nnodes - r - old_n) * sizeof(*t->node));
+	memcpy(&t->node[r], tmp->node, tmp->nnodes * sizeof(*t->node));
+	memmove(&t->sensor[sb + tmp->nsensors], &t->sensor[sb + old_s],
+		(t->nsensors - sb - old_s) * sizeof(*t->sensor));
+	if (tmp->nsensors)
+		memcpy(&t->sensor[sb], tmp->sensor, tmp->nsensors * sizeof(*t->sensor));
+	t->nnodes = (u32)(t->nnodes + dn);
+	t->nsensors = (u32)(t->nsensors + ds);
+
+	for (i = r + tmp->nnodes; i < t->nnodes; i++) {
+		struct pldm_entity_node *n = &t->node[i];
+
+		if (n->parent != PLDM_ENTITY_NONE && n->parent >= r + old_n)
+			n->parent = (u32)(n->parent + dn);
+		n->sensor_begin = (u32)(n->sensor_begin + ds);
+		n->sensor_end = (u32)(n->sensor_end + ds);
+	}
+	return 0;
+}
+
+/* The container of an entity in m, or NULL for a root */
+static inline const struct pldm_entity_id *pldm_entity_maps_parent(const struct pldm_entity_maps *m,
+								   const struct pldm_entity_id *id)
+{
+	u32 i;
+
+	for (i = 0; i < m->nlinks; i++)
+		if (!pldm_entity_id_cmp(&m->link[i].child, id))
+			return &m->link[i].parent;
+	return NULL;
+}
+
+/* Does m place 'child' in 'parent'? */
+static inline int pldm_entity_maps_has_link(const struct pldm_entity_maps *m, const struct pldm_entity_id *parent,
+					    const struct pldm_entity_id *child)
+{
+	struct pldm_entity_link key;
+
+	key.parent = *parent;
+	key.child = *child;
+	return bsearch(&key, m->link, m->nlinks, sizeof(*m->link), pldm_entity_cmp_parent) != NULL;
+}
+
+/*
+ * Mark the nodes whose records changed. Returns 1 if the change cannot be applied
+ * to the existing tree, e.g. a record was added or an entity is new.
+ */
+static inline int pldm_entity_mark(const struct pldm_entity_tree *t, const struct pldm_entity_maps *m, u8 *dirty)
+{
+	u32 i, k, n;
+
+	if (m->nrecs != t->nrecs)
+		return 1;
+	for (i = 0, n = 0; i < t->nnodes; i++)
+		if (t->node[i].parent == PLDM_ENTITY_NONE &&
+		    (n >= m->nroots || pldm_entity_id_cmp(&t->node[i].id, &m->root[n++])))
+			return 1;
+	if (n != m->nroots)
+		return 1;
+
+	for (i = 0; i < m->nrecs; i++) {
+		const struct pldm_entity_rec *o = &t->rec[i], *r = &m->rec[i];
+		const struct pldm_entity_id *ids[2] = { &o->id, &r->id };
+
+		if (o->handle != r->handle || o->pdr_type != r->pdr_type)
+			return 1;
+		if (o->change == r->change)
+			continue;
+		for (k = 0; k < 2; k++) {
+			u32 idx = pldm_entity_find(t, ids[k]);
+
+			if (idx == PLDM_ENTITY_NONE)
+				return 1;
+			dirty[idx] = 1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * pldm_entity_tree_update() - Bring a tree up to date with a refreshed cache
+ * @t: Tree from pldm_entity_tree_build()
+ * @c: The refreshed cache, e.g. from pldm_pdr_cache_refresh()
+ *
+ * Only the subtrees of entities with a changed record are rebuilt; t->rebuilt
+ * says how many nodes that was. On failure the tree is empty.
+ *
+ * Return: 0 on success or a negative errno
+ */
+static inline int pldm_entity_tree_update(struct pldm_entity_tree *t, const struct pldm_pdr_cache *c)
+{
+	struct pldm_entity_tree tmp;
+	struct pldm_entity_maps m;
+	u8 *dirty = NULL;
+	u32 *roots = NULL, nroots = 0, i, end = 0;
+	int rc;
+
+	rc = pldm_entity_maps_build(&m, c);
+	if (rc)
+		goto fail;
+	dirty = (u8 *)calloc(t->nnodes + 1, 1);
+	roots = (u32 *)malloc((t->nnodes + 1) * sizeof(*roots));
+	if (!dirty || !roots) {
+		rc = -ENOMEM;
+		goto fail;
+	}
+	if (pldm_entity_mark(t, &m, dirty))
+		goto full;
+
+	/* Outermost changed entities; each keeps its place and parent */
+	for (i = 0; i < t->nnodes; i++) {
+		const struct pldm_entity_id *p;
+		u32 op = t->node[i].parent, j;
+
+		if (!dirty[i] || i < end)
+			continue;
+		p = pldm_entity_maps_parent(&m, &t->node[i].id);
+		if ((op == PLDM_ENTITY_NONE) != !p || (p && pldm_entity_id_cmp(p, &t->node[op].id)))
+			goto full;
+		roots[nroots++] = i;
+		end = i + t->node[i].size;
+
+		/*
+		 * An entity below it that left its container must not have gone to one
+		 * outside the subtree, which is not rebuilt
+		 */
+		for (j = i + 1; j < end; j++)
+			if (!pldm_entity_maps_has_link(&m, &t->node[t->node[j].parent].id, &t->node[j].id) &&
+			    pldm_entity_maps_parent(&m, &t->node[j].id))
+				goto full;
+	}
+
+	/* Last first, so the indexes of the earlier ones stay valid */
+	memset(&tmp, 0, sizeof(tmp));
+	t->rebuilt = 0;
+	while (nroots--) {
+		const struct pldm_entity_node *n = &t->node[roots[nroots]];
+
+		tmp.nnodes = 0;
+		tmp.nsensors = 0;
+		rc = pldm_entity_emit(&m, &n->id, n->parent, n->depth, &tmp, roots[nroots], n->sensor_begin);
+		if (!rc)
+			rc = pldm_entity_splice(t, roots[nroots], &tmp);
+		if (rc) {
+			pldm_entity_tree_fini(&tmp);
+			goto fail;
+		}
+		t->rebuilt += tmp.nnodes;
+	}
+	pldm_entity_tree_fini(&tmp);
+	/* An entity that moved into a rebuilt subtree is now in the tree twice */
+	if (t->nnodes != m.nentities)
+		goto full;
+	free(t->rec);
+	t->rec = m.rec;
+	t->nrecs = m.nrecs;
+	m.rec = NULL;
+	rc = pldm_entity_index(t);
+	if (rc)
+		goto fail;
+	goto out;
+
+full:
+	rc = pldm_entity_tree_from_maps(t, &m);
+	if (rc)
+		goto fail;
+out:
+	free(dirty);
+	free(roots);
+	pldm_entity_maps_free(&m);
+	return 0;
+
+fail:
+	free(dirty);
+	free(roots);
+	pldm_entity_maps_free(&m);
+	pldm_entity_tree_fini(t);
+	return rc;
+}
+
+#endif /* PLDM_ENTITY_H */
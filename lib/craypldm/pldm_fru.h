@@ -0,0 +1,223 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* This file implements an indexed parser for PLDM FRU record tables (DSP0257).
+ *
+ * A FRU record table, as returned by CUC_CMD_GET_FRU, is a chain of
+ * pldm_fru_record headers, each followed by num_fields pldm_fru_field TLVs.
+ * Records of several FRU record sets (see fru_record_set_pdr) can share one
+ * table.
+ *
+ * pldm_fru_index_build() validates the whole table in one pass and records, for
+ * each record set, the offset of the first field of each type in its General and
+ * OEM records. Lookups are then a table load and return a view into the caller's
+ * buffer, which must outlive the index. Nothing is allocated or copied, and the
+ * values are not NUL terminated.
+ */
+
+#ifndef PLDM_FRU_H
+#define PLDM_FRU_H
+
+#include <errno.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "pldm_cxi.h"
+
+#define PLDM_FRU_MAX_SETS     8     /* Record sets per table */
+#define PLDM_FRU_INDEX_TYPES  16    /* Field types 1..15 are indexed; larger ones are only validated */
+#define PLDM_FRU_MAX_TABLE    0xFFFF
+
+/* Values of pldm_fru_record.field_encoding (DSP0257 Table 2) */
+enum pldm_fru_encoding {
+	PLDM_FRU_ENCODING_ASCII = 1,
+	PLDM_FRU_ENCODING_UTF8 = 2,
+	PLDM_FRU_ENCODING_UTF16 = 3,
+	PLDM_FRU_ENCODING_UTF16LE = 4,
+	PLDM_FRU_ENCODING_UTF16BE = 5,
+};
+
+/* Indexed record types */
+enum {
+	PLDM_FRU_IDX_GENERAL,
+	PLDM_FRU_IDX_OEM,
+	PLDM_FRU_IDX_COUNT
+};
+
+/**
+ * struct pldm_fru_str - View of one field value
+ */
+struct pldm_fru_str {
+	const char *s;     /* Into the table; NULL if the field is absent */
+	u8 len;
+	u8 encoding;       /* enum pldm_fru_encoding of the record */
+};
+
+/**
+ * struct pldm_fru_set - Index of one FRU record set
+ */
+struct pldm_fru_set {
+	u16 record_set_id;
+	u8 encoding[PLDM_FRU_IDX_COUNT];
+	u16 off[PLDM_FRU_IDX_COUNT][PLDM_FRU_INDEX_TYPES];  /* Field TLV offset, 0 if absent */
+};
+
+/**
+ * struct pldm_fru_index - Index of a FRU record table
+ */
+struct pldm_fru_index {
+	const u8 *table;
+	u16 len;
+	u16 nrecords;
+	u16 nfields;
+	u8 nsets;
+	struct pldm_fru_set set[PLDM_FRU_MAX_SETS];  /* In table order */
+};
+
+static inline int pldm_fru_record_idx(u8 record_type)
+{
+	switch (record_type) {
+	case PLDM_FRU_RECORD_GENERAL:
+		return PLDM_FRU_IDX_GENERAL;
+	case PLDM_FRU_RECORD_OEM:
+		return PLDM_FRU_IDX_OEM;
+	default:
+		return -1;
+	}
+}
+
+/**
+ * pldm_fru_index_build() - Validate a FRU record table and index its fields
+ * @ix: Index to fill
+ * @table: The table; must stay valid while the index is used
+ * @len: Length of the table; up to 3 trailing zero bytes of padding are allowed
+ *
+ * When a record set has several fields of the same type, the first one is indexed.
+ * Records of types other than General and OEM are validated but not indexed.
+ *
+ * Return: 0 on success, -EPROTO if a record or field runs past the end of the table,
+ * -ENOSPC if it has more than PLDM_FRU_MAX_SETS record sets, -EINVAL if it is
+ * larger than PLDM_FRU_MAX_TABLE
+ */
+static inline int pldm_fru_index_build(struct pldm_fru_index *ix, const void *table, size_t len)
+{
+	const u8 *p = (const u8 *)table;
+	size_t off = 0;
+
+	if (len > PLDM_FRU_MAX_TABLE)
+		return -EINVAL;
+	ix->table = p;
+	ix->len = (u16)len;
+	ix->nrecords = 0;
+	ix->nfields = 0;
+	ix->nsets = 0;
+
+	while (len - off >= sizeof(struct pldm_fru_record)) {
+		const struct pldm_fru_record *rec = (const struct pldm_fru_record *)(p + off);
+		struct pldm_fru_set *set = NULL;
+		unsigned int f, s;
+		int idx;
+
+		idx = pldm_fru_record_idx(rec->record_type);
+		if (idx >= 0) {
+			for (s = 0; s < ix->nsets; s++)
+				if (ix->set[s].record_set_id == rec->record_set_id)
+					break;
+			if (s == ix->nsets) {
+				if (s == PLDM_FRU_MAX_SETS)
+					return -ENOSPC;
+				memset(&ix->set[s], 0, sizeof(ix->set[s]));
+				ix->set[s].record_set_id = rec->record_set_id;
+				ix->nsets++;
+			}
+			set = &ix->set[s];
+			if (!set->encoding[idx])
+				set->encoding[idx] = rec->field_encoding;
+		}
+
+		off += sizeof(*rec);
+		for (f = 0; f < rec->num_fields; f++) {
+			const struct pldm_fru_field *fld = (const struct pldm_fru_field *)(p + off);
+
+			if (len - off < sizeof(*fld) || len - off - sizeof(*fld) < fld->length)
+				return -EPROTO;
+			if (set && fld->field_type < PLDM_FRU_INDEX_TYPES && !set->off[idx][fld->field_type])
+				set->off[idx][fld->field_type] = (u16)off;
+			off += sizeof(*fld) + fld->length;
+		}
+		ix->nrecords++;
+		ix->nfields += rec->num_fields;
+	}
+
+	/* Anything left, too short for a record header, must be padding */
+	for (; off < len; off++)
+		if (p[off] || len - off >= 4)
+			return -EPROTO;
+	return 0;
+}
+
+/* The index of a record set, or NULL */
+static inline const struct pldm_fru_set *pldm_fru_set_find(const struct pldm_fru_index *ix, u16 record_set_id)
+{
+	unsigned int s;
+
+	for (s = 0; s < ix->nsets; s++)
+		if (ix->set[s].record_set_id == record_set_id)
+			return &ix->set[s];
+	return NULL;
+}
+
+/**
+ * pldm_fru_lookup() - Value of one field of a record set
+ * @ix: Index
+ * @set: From pldm_fru_set_find(), or &ix->set[i]
+ * @record_type: PLDM_FRU_RECORD_GENERAL or PLDM_FRU_RECORD_OEM
+ * @field_type: enum pldm_fru_field_type, or an OEM field type
+ *
+ * Return: The value; .s is NULL if the field is absent or not indexed
+ */
+static inline struct pldm_fru_str pldm_fru_lookup(const struct pldm_fru_index *ix, const struct pldm_fru_set *set,
+						  u8 record_type, u8 field_type)
+{
+	struct pldm_fru_str v = { NULL, 0, 0 };
+	const struct pldm_fru_field *fld;
+	int idx = pldm_fru_record_idx(record_type);
+	u16 off;
+
+	if (!set || idx < 0 || field_type >= PLDM_FRU_INDEX_TYPES)
+		return v;
+	off = set->off[idx][field_type];
+	if (!off)
+		return v;
+	fld = (const struct pldm_fru_field *)(ix->table + off);
+	v.s = (const char *)fld->value;
+	v.len = fld->length;
+	v.encoding = set->encoding[idx];
+	return v;
+}
+
+/* A General record field of the table's first record set, e.g. PLDM_FRU_FIELD_SERIAL_NUMBER */
+static inline struct pldm_fru_str pldm_fru_general(const struct pldm_fru_index *ix, u8 field_type)
+{
+	return pldm_fru_lookup(ix, ix->nsets ? &ix->set[0] : NULL, PLDM_FRU_RECORD_GENERAL, field_type);
+}
+
+/**
+ * pldm_fru_str_copy() - Copy a value into a NUL-terminated buffer
+ *
+ * Return: The length of the value; the copy is truncated if that is >= size
+ */
+static inline unsigned int pldm_fru_str_copy(struct pldm_fru_str v, char *buf, size_t size)
+{
+	size_t n;
+
+	if (!size)
+		return v.len;
+	n = v.len < size ? v.len : size - 1;
+	if (n)
+		memcpy(buf, v.s, n);
+	buf[n] = '\0';
+	return v.len;
+}
+
+#endif /* PLDM_FRU_H */
@@ -0,0 +1,880 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* This file implements a persistent cache of the Cassini uC PDR repository.
+ *
+ * Walking the repository with GetPDR takes several multipart transfers per record.
+ * The cache stores every record in a file keyed by board type, board revision and uC
+ * firmware version. Opening a matching cache file is a single mmap(). Refreshing it
+ * revalidates each record by fetching only its struct pdr_hdr (pipelined through
+ * pldm_requester.h); records whose record_change_number and length are unchanged are kept,
+ * and only changed records are transferred in full.
+ *
+ * The file also holds sorted indexes, so numeric sensor PDRs and auxiliary name PDRs
+ * can be looked up by sensor_id, and any record by record_handle, straight from the
+ * mapping without parsing. A record is only indexed by type when it is long enough
+ * for the fields consumers read (see pldm_pdr_complete()), so the numeric sensor,
+ * auxiliary name and FRU record set lookups never return a truncated record.
+ */
+
+#ifndef PLDM_PDR_CACHE_H
+#define PLDM_PDR_CACHE_H
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cuc_cxi.h"
+#include "cuc_xport.h"
+#include "pldm_cxi.h"
+#include "pldm_requester.h"
+
+#define PLDM_PDR_CACHE_MAGIC        0x43524450  /* "PDRC" */
+#define PLDM_PDR_CACHE_VERSION      1
+#define PLDM_PDR_CACHE_FW_LEN       32
+#define PLDM_PDR_CACHE_MAX_RECORDS  4096
+
+/* Largest record_data chunk that fits in a GetPDR response packet */
+#define PLDM_PDR_XFER_MAX  (CUC_DATA_BYTES - sizeof(struct get_pdr_rsp))
+
+/**
+ * struct pldm_pdr_cache_key - Identity of a PDR repository
+ *
+ * The repository contents are a function of the board and the uC firmware, so a
+ * cache is only reused when all of these match.
+ */
+struct pldm_pdr_cache_key {
+	u8 board_type;                       /* CUC_BOARD_TYPE_* */
+	u8 board_rev;
+	u8 rsvd[2];
+	char fw_version[PLDM_PDR_CACHE_FW_LEN]; /* FW_UC_APPLICATION running version */
+};
+
+/* One record in the cache file */
+struct pldm_pdr_cache_entry {
+	u32 record_handle;
+	u32 offset;                /* Offset of the struct pdr_hdr in the data section */
+	u16 length;                /* Header plus data_length */
+	u16 record_change_number;
+	u16 sensor_id;             /* For numeric sensor and sensor auxiliary name PDRs */
+	u8 pdr_type;
+	u8 rsvd;
+};
+
+/**
+ * pldm_pdr_complete() - Check that a record holds every fixed field of its type
+ * @h: Record
+ * @length: Size of the record, header included
+ *
+ * A numeric sensor PDR must reach the end of the sensor-size dependent fields for
+ * its sensor_data_size, and an auxiliary names PDR the start of sensor_name (whose
+ * length varies; readers bound it by the record length). Other types need only
+ * the header.
+ *
+ * Return: Non-zero if the record can be indexed by its type
+ */
+static inline int pldm_pdr_complete(const struct pdr_hdr *h, size_t length)
+{
+	const struct numeric_sensor_pdr *ns = (const struct numeric_sensor_pdr *)h;
+	size_t need;
+
+	switch (h->pdr_type) {
+	case PLDM_PDR_NUMERIC_SENSOR:
+		if (length < offsetof(struct numeric_sensor_pdr, ssd))
+			return 0;
+		switch (ns->sensor_data_size) {
+		case PLDM_DATA_SIZE_UINT8:
+		case PLDM_DATA_SIZE_SINT8:
+			need = sizeof(struct numeric_sensor_ssd8);
+			break;
+		case PLDM_DATA_SIZE_UINT16:
+		case PLDM_DATA_SIZE_SINT16:
+			need = sizeof(struct numeric_sensor_ssd16);
+			break;
+		case PLDM_DATA_SIZE_UINT32:
+		case PLDM_DATA_SIZE_SINT32:
+			need = sizeof(struct numeric_sensor_ssd32);
+			break;
+		default:
+			return 0;
+		}
+		return length >= offsetof(struct numeric_sensor_pdr, ssd) + need;
+	case PLDM_PDR_SENSOR_AUXILIARY_NAMES:
+		return length >= offsetof(struct aux_name_pdr, sensor_name);
+	case PLDM_PDR_FRU_RECORD_SET:
+		return length >= sizeof(struct fru_record_set_pdr);
+	default:
+		return length >= sizeof(struct pdr_hdr);
+	}
+}
+
+/* Cache file header. All sections are 8-byte aligned offsets from the file start. */
+struct pldm_pdr_cache_file {
+	u32 magic;
+	u16 version;
+	u16 hdr_size;
+	struct pldm_pdr_cache_key key;
+	u32 num_records;
+	u32 num_numeric;
+	u32 num_aux_names;
+	u32 num_fru_sets;
+	u64 entries_off;           /* struct pldm_pdr_cache_entry[num_records], repository order */
+	u64 by_handle_off;         /* u32[num_records] entry indexes sorted by record_handle */
+	u64 numeric_off;           /* u32[num_numeric] entry indexes sorted by sensor_id */
+	u64 aux_names_off;         /* u32[num_aux_names] entry indexes sorted by sensor_id */
+	u64 fru_sets_off;          /* u32[num_fru_sets] entry indexes, repository order */
+	u64 data_off;
+	u64 data_size;
+	u64 file_size;
+};
+
+/**
+ * struct pldm_pdr_cache - Mapped PDR cache
+ */
+struct pldm_pdr_cache {
+	void *map;
+	size_t map_len;
+	const struct pldm_pdr_cache_file *file;
+	const struct pldm_pdr_cache_entry *entries;
+	const u32 *by_handle;
+	const u32 *numeric;
+	const u32 *aux_names;
+	const u32 *fru_sets;
+	const u8 *data;
+
+	/* Statistics from the last refresh */
+	unsigned int revalidated;  /* Records kept after a header-only check */
+	unsigned int fetched;      /* Records transferred in full */
+	unsigned int requests;     /* GetPDR requests issued */
+};
+
+static inline int pldm_pdr_cache_key_equal(const struct pldm_pdr_cache_key *a,
+					   const struct pldm_pdr_cache_key *b)
+{
+	return a->board_type == b->board_type && a->board_rev == b->board_rev &&
+	       !strncmp(a->fw_version, b->fw_version, PLDM_PDR_CACHE_FW_LEN);
+}
+
+static inline const struct pdr_hdr *pldm_pdr_cache_record(const struct pldm_pdr_cache *c, u32 idx)
+{
+	return (const struct pdr_hdr *)(c->data + c->entries[idx].offset);
+}
+
+static inline unsigned int pldm_pdr_cache_count(const struct pldm_pdr_cache *c)
+{
+	return c->file ? c->file->num_records : 0;
+}
+
+/**
+ * pldm_pdr_cache_close() - Unmap a cache
+ */
+static inline void pldm_pdr_cache_close(struct pldm_pdr_cache *c)
+{
+	if (c->map)
+		munmap(c->map, c->map_len);
+	memset(c, 0, sizeof(*c));
+}
+
+static inline int pldm_pdr_cache_section_ok(const struct pldm_pdr_cache_file *f, u64 off, u64 size)
+{
+	return off % 8 == 0 && off <= f->file_size && size <= f->file_size - off;
+}
+
+/* A typed index must only point at complete records of its type */
+static inline int pldm_pdr_cache_index_ok(const struct pldm_pdr_cache *c, u32 idx, u8 pdr_type)
+{
+	const struct pdr_hdr *h;
+
+	if (idx >= c->file->num_records)
+		return 0;
+	h = pldm_pdr_cache_record(c, idx);
+	return h->pdr_type == pdr_type && pldm_pdr_complete(h, c->entries[idx].length);
+}
+
+/**
+ * pldm_pdr_cache_open() - Map an existing cache file
+ * @c: Cache
+ * @path: Cache file
+ * @key: Expected repository identity, or NULL to accept any
+ *
+ * Return: 0 on success, -ENOENT if there is no file, -ESTALE if the key does not
+ *         match, -EINVAL if the file is corrupt, or another negative errno
+ */
+static inline int pldm_pdr_cache_open(struct pldm_pdr_cache *c, const char *path,
+				      const struct pldm_pdr_cache_key *key)
+{
+	const struct pldm_pdr_cache_file *f;
+	struct stat st;
+	void *map;
+	u32 i;
+	int fd;
+
+	memset(c, 0, sizeof(*c));
+
+	fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return -errno;
+	if (fstat(fd, &st) < 0) {
+		close(fd);
+		return -errno;
+	}
+	if ((size_t)st.st_size < sizeof(*f)) {
+		close(fd);
+		return -EINVAL;
+	}
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED)
+		return -errno;
+
+	c->map = map;
+	c->map_len = st.st_size;
+	f = (const struct pldm_pdr_cache_file *)map;
+
+	if (f->magic != PLDM_PDR_CACHE_MAGIC || f->version != PLDM_PDR_CACHE_VERSION ||
+	    f->hdr_size != sizeof(*f) || f->file_size != (u64)st.st_size ||
+	    f->num_records > PLDM_PDR_CACHE_MAX_RECORDS ||
+	    !pldm_pdr_cache_section_ok(f, f->entries_off, (u64)f->num_records * sizeof(*c->entries)) ||
+	    !pldm_pdr_cache_section_ok(f, f->by_handle_off, (u64)f->num_records * 4) ||
+	    !pldm_pdr_cache_section_ok(f, f->numeric_off, (u64)f->num_numeric * 4) ||
+	    !pldm_pdr_cache_section_ok(f, f->aux_names_off, (u64)f->num_aux_names * 4) ||
+	    !pldm_pdr_cache_section_ok(f, f->fru_sets_off, (u64)f->num_fru_sets * 4) ||
+	    !pldm_pdr_cache_section_ok(f, f->data_off, f->data_size) ||
+	    f->num_numeric > f->num_records || f->num_aux_names > f->num_records ||
+	    f->num_fru_sets > f->num_records)
+		goto corrupt;
+
+	c->file = f;
+	c->entries = (const struct pldm_pdr_cache_entry *)((const u8 *)map + f->entries_off);
+	c->by_handle = (const u32 *)((const u8 *)map + f->by_handle_off);
+	c->numeric = (const u32 *)((const u8 *)map + f->numeric_off);
+	c->aux_names = (const u32 *)((const u8 *)map + f->aux_names_off);
+	c->fru_sets = (const u32 *)((const u8 *)map + f->fru_sets_off);
+	c->data = (const u8 *)map + f->data_off;
+
+	for (i = 0; i < f->num_records; i++) {
+		const struct pldm_pdr_cache_entry *e = &c->entries[i];
+
+		if (e->length < sizeof(struct pdr_hdr) || e->offset > f->data_size ||
+		    e->length > f->data_size - e->offset ||
+		    pldm_pdr_cache_record(c, i)->data_length + sizeof(struct pdr_hdr) != e->length)
+			goto corrupt;
+	}
+	for (i = 0; i < f->num_records; i++)
+		if (c->by_handle[i] >= f->num_records)
+			goto corrupt;
+	for (i = 0; i < f->num_numeric; i++)
+		if (!pldm_pdr_cache_index_ok(c, c->numeric[i], PLDM_PDR_NUMERIC_SENSOR))
+			goto corrupt;
+	for (i = 0; i < f->num_aux_names; i++)
+		if (!pldm_pdr_cache_index_ok(c, c->aux_names[i], PLDM_PDR_SENSOR_AUXILIARY_NAMES))
+			goto corrupt;
+	for (i = 0; i < f->num_fru_sets; i++)
+		if (!pldm_pdr_cache_index_ok(c, c->fru_sets[i], PLDM_PDR_FRU_RECORD_SET))
+			goto corrupt;
+
+	if (key && !pldm_pdr_cache_key_equal(&f->key, key)) {
+		pldm_pdr_cache_close(c);
+		return -ESTALE;
+	}
+	return 0;
+
+corrupt:
+	pldm_pdr_cache_close(c);
+	return -EINVAL;
+}
+
+/* Binary search an index array ordered by record_handle (by_sensor == 0) or sensor_id */
+static inline const struct pldm_pdr_cache_entry *
+pldm_pdr_cache_bsearch(const struct pldm_pdr_cache *c, const u32 *idx, u32 n, u32 key, int by_sensor)
+{
+	const struct pldm_pdr_cache_entry *e;
+	u32 lo = 0, hi = n, mid;
+
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		e = &c->entries[idx[mid]];
+		if ((by_sensor ? e->sensor_id : e->record_handle) < key)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (lo == n)
+		return NULL;
+	e = &c->entries[idx[lo]];
+	return (by_sensor ? e->sensor_id : e->record_handle) == key ? e : NULL;
+}
+
+/**
+ * pldm_pdr_cache_find() - Look up a record by record_handle
+ *
+ * Return: The record, or NULL
+ */
+static inline const struct pdr_hdr *pldm_pdr_cache_find(const struct pldm_pdr_cache *c, u32 record_handle)
+{
+	const struct pldm_pdr_cache_entry *e;
+
+	if (!c->file)
+		return NULL;
+	e = pldm_pdr_cache_bsearch(c, c->by_handle, c->file->num_records, record_handle, 0);
+	return e ? (const struct pdr_hdr *)(c->data + e->offset) : NULL;
+}
+
+/**
+ * pldm_pdr_cache_numeric_sensor() - Look up a numeric sensor PDR by sensor_id
+ *
+ * Return: The PDR, or NULL
+ */
+static inline const struct numeric_sensor_pdr *
+pldm_pdr_cache_numeric_sensor(const struct pldm_pdr_cache *c, u16 sensor_id)
+{
+	const struct pldm_pdr_cache_entry *e;
+
+	if (!c->file)
+		return NULL;
+	e = pldm_pdr_cache_bsearch(c, c->numeric, c->file->num_numeric, sensor_id, 1);
+	return e ? (const struct numeric_sensor_pdr *)(c->data + e->offset) : NULL;
+}
+
+/**
+ * pldm_pdr_cache_aux_name() - Look up a sensor auxiliary name PDR by sensor_id
+ *
+ * Return: The PDR, or NULL
+ */
+static inline const struct aux_name_pdr *pldm_pdr_cache_aux_name(const struct pldm_pdr_cache *c, u16 sensor_id)
+{
+	const struct pldm_pdr_cache_entry *e;
+
+	if (!c->file)
+		return NULL;
+	e = pldm_pdr_cache_bsearch(c, c->aux_names, c->file->num_aux_names, sensor_id, 1);
+	return e ? (const struct aux_name_pdr *)(c->data + e->offset) : NULL;
+}
+
+/* The i-th numeric sensor PDR in sensor_id order */
+static inline const struct numeric_sensor_pdr *
+pldm_pdr_cache_numeric_at(const struct pldm_pdr_cache *c, u32 i)
+{
+	return (const struct numeric_sensor_pdr *)pldm_pdr_cache_record(c, c->numeric[i]);
+}
+
+/* The i-th FRU record set PDR in repository order */
+static inline const struct fru_record_set_pdr *pldm_pdr_cache_fru_set_at(const struct pldm_pdr_cache *c, u32 i)
+{
+	return (const struct fru_record_set_pdr *)pldm_pdr_cache_record(c, c->fru_sets[i]);
+}
+
+/* Growable byte buffer used while building a cache image */
+struct pldm_pdr_buf {
+	u8 *p;
+	size_t len;
+	size_t cap;
+};
+
+static inline int pldm_pdr_buf_reserve(struct pldm_pdr_buf *b, size_t n)
+{
+	size_t cap;
+	u8 *p;
+
+	if (b->len + n <= b->cap)
+		return 0;
+	cap = b->cap ? b->cap : 4096;
+	while (cap < b->len + n)
+		cap *= 2;
+	p = (u8 *)realloc(b->p, cap);
+	if (!p)
+		return -ENOMEM;
+	b->p = p;
+	b->cap = cap;
+	return 0;
+}
+
+static inline int pldm_pdr_buf_append(struct pldm_pdr_buf *b, const void *data, size_t n)
+{
+	int rc = pldm_pdr_buf_reserve(b, n);
+
+	if (rc)
+		return rc;
+	memcpy(b->p + b->len, data, n);
+	b->len += n;
+	return 0;
+}
+
+/**
+ * pldm_get_pdr_req_init() - Build a CUC_CMD_PLDM GetPDR request
+ */
+static inline void pldm_get_pdr_req_init(struct cuc_xport_req *r, u8 instance_id, u32 record_handle,
+					 u32 data_transfer_handle, u8 op, u16 request_count,
+					 u16 record_change_number)
+{
+	struct get_pdr_req req;
+
+	memset(&req, 0, sizeof(req));
+	req.hdr.instance_id = instance_id & 0x1F;
+	req.hdr.rq = 1;
+	req.hdr.pldm_type = PLDM_TYPE_PLATFORM_MONITORING_AND_CONTROL;
+	req.hdr.pldm_command_code = PLDM_CMD_GET_PDR;
+	req.record_handle = record_handle;
+	req.data_transfer_handle = data_transfer_handle;
+	req.transfer_operation_flag = op;
+	req.request_count = request_count;
+	req.record_change_number = record_change_number;
+	cuc_xport_req_init(r, CUC_CMD_PLDM, &req, sizeof(req));
+}
+
+/* Validate a completed GetPDR exchange. Returns the response, or NULL with *err set. */
+static inline const struct get_pdr_rsp *pldm_get_pdr_rsp(const struct cuc_xport_req *r, int *err)
+{
+	const struct get_pdr_rsp *rsp = (const struct get_pdr_rsp *)r->rsp.data;
+	unsigned int len = cuc_xport_rsp_len(r);
+
+	*err = r->status;
+	if (*err)
+		return NULL;
+	if (r->rsp.type != CUC_TYPE_RSP_PLDM || len < offsetof(struct get_pdr_rsp, next_record_handle)) {
+		*err = -EPROTO;
+		return NULL;
+	}
+	if (rsp->completion_code == PLDM_ERROR_NOT_READY) {
+		*err = -EAGAIN;
+		return NULL;
+	}
+	if (rsp->completion_code != PLDM_SUCCESS) {
+		*err = -EIO;
+		return NULL;
+	}
+	if (len < sizeof(*rsp) || rsp->response_count > len - sizeof(*rsp)) {
+		*err = -EPROTO;
+		return NULL;
+	}
+	return rsp;
+}
+
+/*
+ * Run one GetPDR exchange on an instance ID of 'rq', retrying with an exponential
+ * backoff while the uC answers PLDM_ERROR_NOT_READY. Returns the response, or NULL
+ * with *err set.
+ */
+static inline const struct get_pdr_rsp *pldm_get_pdr_exec(struct pldm_requester *rq, struct cuc_xport_req *r,
+							  unsigned int *requests, int *err)
+{
+	unsigned long sent = rq->requests;
+	const struct get_pdr_rsp *rsp;
+	int rc;
+
+	rc = pldm_rq_run(rq, r, 1);
+	*requests += (unsigned int)(rq->requests - sent);
+	rsp = pldm_get_pdr_rsp(r, err);
+	if (rc && !*err) {
+		*err = rc;
+		return NULL;
+	}
+	return rsp;
+}
+
+/**
+ * pldm_pdr_fetch_record() - Fetch one complete record with a multipart GetPDR walk
+ * @rq: Requester on the transport to the uC
+ * @record_handle: Record to fetch, 0 for the first record
+ * @out: Buffer the record is appended to
+ * @next_record_handle: Set to the handle of the following record (0 at the end)
+ * @requests: Incremented for every request issued
+ *
+ * Return: 0 on success or a negative errno
+ */
+static inline int pldm_pdr_fetch_record(struct pldm_requester *rq, u32 record_handle,
+					struct pldm_pdr_buf *out, u32 *next_record_handle,
+					unsigned int *requests)
+{
+	struct cuc_xport_req r;
+	const struct get_pdr_rsp *rsp;
+	size_t start = out->len;
+	u32 xfer = 0;
+	u16 rcn = 0;
+	u8 op = PLDM_XFER_OP_GET_FIRST_PART;
+	int rc;
+
+	for (;;) {
+		pldm_get_pdr_req_init(&r, 0, record_handle, xfer, op, PLDM_PDR_XFER_MAX, rcn);
+		rsp = pldm_get_pdr_exec(rq, &r, requests, &rc);
+		if (rc)
+			goto fail;
+
+		rc = pldm_pdr_buf_append(out, rsp->record_data, rsp->response_count);
+		if (rc)
+			goto fail;
+
+		if (op == PLDM_XFER_OP_GET_FIRST_PART) {
+			if (rsp->response_count < sizeof(struct pdr_hdr)) {
+				rc = -EPROTO;
+				goto fail;
+			}
+			rcn = ((const struct pdr_hdr *)(out->p + start))->record_change_number;
+		}
+
+		if (rsp->transfer_flag == PLDM_XFER_FLAG_END ||
+		    rsp->transfer_flag == PLDM_XFER_FLAG_START_AND_END)
+			break;
+		if (!rsp->next_data_transfer_handle || !rsp->response_count) {
+			rc = -EPROTO;
+			goto fail;
+		}
+		xfer = rsp->next_data_transfer_handle;
+		op = PLDM_XFER_OP_GET_NEXT_PART;
+	}
+
+	if (out->len - start != sizeof(struct pdr_hdr) +
+	    ((const struct pdr_hdr *)(out->p + start))->data_length) {
+		rc = -EPROTO;
+		goto fail;
+	}
+	*next_record_handle = rsp->next_record_handle;
+	return 0;
+
+fail:
+	out->len = start;
+	return rc;
+}
+
+/**
+ * pldm_rq_get_pdrs() - Fetch the first part of several PDRs
+ * @rq: Requester
+ * @reqs: One request per record; check each with pldm_get_pdr_rsp()
+ * @record_handles: Records to fetch
+ * @n: Number of records
+ *
+ * Records longer than PLDM_PDR_XFER_MAX come back with transfer flag
+ * PLDM_XFER_FLAG_START; the rest is fetched with pldm_pdr_fetch_record().
+ *
+ * Return: As pldm_rq_run()
+ */
+static inline int pldm_rq_get_pdrs(struct pldm_requester *rq, struct cuc_xport_req *reqs,
+				   const u32 *record_handles, unsigned int n)
+{
+	unsigned int i;
+
+	for (i = 0; i < n; i++)
+		pldm_get_pdr_req_init(&reqs[i], 0, record_handles[i], 0, PLDM_XFER_OP_GET_FIRST_PART,
+				      PLDM_PDR_XFER_MAX, 0);
+	return pldm_rq_run(rq, reqs, n);
+}
+
+
+/* Sort helpers; qsort() has no context argument so the entries are reached through a thread-local pointer */
+static __thread const struct pldm_pdr_cache_entry *pldm_pdr_sort_entries;
+
+static inline int pldm_pdr_cmp_handle(const void *a, const void *b)
+{
+	u32 x = pldm_pdr_sort_entries[*(const u32 *)a].record_handle;
+	u32 y = pldm_pdr_sort_entries[*(const u32 *)b].record_handle;
+
+	return x < y ? -1 : x > y;
+}
+
+static inline int pldm_pdr_cmp_sensor(const void *a, const void *b)
+{
+	u16 x = pldm_pdr_sort_entries[*(const u32 *)a].sensor_id;
+	u16 y = pldm_pdr_sort_entries[*(const u32 *)b].sensor_id;
+
+	return x < y ? -1 : x > y;
+}
+
+static inline size_t pldm_pdr_align8(size_t n)
+{
+	return (n + 7) & ~(size_t)7;
+}
+
+/**
+ * pldm_pdr_cache_write() - Write a cache file from concatenated records
+ * @path: Cache file, replaced atomically
+ * @key: Repository identity
+ * @records: Concatenated PDRs in repository order
+ * @len: Size of @records
+ *
+ * Return: 0 on success or a negative errno
+ */
+static inline int pldm_pdr_cache_write(const char *path, const struct pldm_pdr_cache_key *key,
+				       const u8 *records, size_t len)
+{
+	struct pldm_pdr_cache_file f;
+	struct pldm_pdr_cache_entry *e = NULL;
+	u32 *by_handle = NULL, *numeric = NULL, *aux = NULL, *fru = NULL;
+	char tmp[4096];
+	size_t off = 0;
+	u32 n = 0, i;
+	u8 *img = NULL;
+	int rc = 0, fd;
+	ssize_t w;
+
+	memset(&f, 0, sizeof(f));
+	while (off < len) {
+		const struct pdr_hdr *h = (const struct pdr_hdr *)(records + off);
+
+		if (len - off < sizeof(*h) || sizeof(*h) + h->data_length > len - off ||
+		    sizeof(*h) + h->data_length > 0xFFFF)
+			return -EINVAL;
+		off += sizeof(*h) + h->data_length;
+		n++;
+	}
+	if (n > PLDM_PDR_CACHE_MAX_RECORDS)
+		return -E2BIG;
+
+	e = (struct pldm_pdr_cache_entry *)calloc(n ? n : 1, sizeof(*e));
+	by_handle = (u32 *)calloc(n ? n : 1, 4);
+	numeric = (u32 *)calloc(n ? n : 1, 4);
+	aux = (u32 *)calloc(n ? n : 1, 4);
+	fru = (u32 *)calloc(n ? n : 1, 4);
+	if (!e || !by_handle || !numeric || !aux || !fru) {
+		rc = -ENOMEM;
+		goto out;
+	}
+
+	for (off = 0, i = 0; i < n; i++) {
+		const struct pdr_hdr *h = (const struct pdr_hdr *)(records + off);
+
+		e[i].record_handle = h->record_handle;
+		e[i].offset = (u32)off;
+		e[i].length = (u16)(sizeof(*h) + h->data_length);
+		e[i].record_change_number = h->record_change_number;
+		e[i].pdr_type = h->pdr_type;
+		by_handle[i] = i;
+		off += e[i].length;
+		/* Truncated records stay reachable by handle but are left out of the typed indexes */
+		if (!pldm_pdr_complete(h, e[i].length))
+			continue;
+		if (h->pdr_type == PLDM_PDR_NUMERIC_SENSOR) {
+			e[i].sensor_id = ((const struct numeric_sensor_pdr *)h)->sensor_id;
+			numeric[f.num_numeric++] = i;
+		} else if (h->pdr_type == PLDM_PDR_SENSOR_AUXILIARY_NAMES) {
+			e[i].sensor_id = ((const struct aux_name_pdr *)h)->sensor_id;
+			aux[f.num_aux_names++] = i;
+		} else if (h->pdr_type == PLDM_PDR_FRU_RECORD_SET) {
+			fru[f.num_fru_sets++] = i;
+		}
+	}
+
+	pldm_pdr_sort_entries = e;
+	qsort(by_handle, n, 4, pldm_pdr_cmp_handle);
+	qsort(numeric, f.num_numeric, 4, pldm_pdr_cmp_sensor);
+	qsort(aux, f.num_aux_names, 4, pldm_pdr_cmp_sensor);
+	pldm_pdr_sort_entries = NULL;
+
+	f.magic = PLDM_PDR_CACHE_MAGIC;
+	f.version = PLDM_PDR_CACHE_VERSION;
+	f.hdr_size = sizeof(f);
+	f.key = *key;
+	f.num_records = n;
+	f.entries_off = pldm_pdr_align8(sizeof(f));
+	f.by_handle_off = pldm_pdr_align8(f.entries_off + (u64)n * sizeof(*e));
+	f.numeric_off = pldm_pdr_align8(f.by_handle_off + (u64)n * 4);
+	f.aux_names_off = pldm_pdr_align8(f.numeric_off + (u64)f.num_numeric * 4);
+	f.fru_sets_off = pldm_pdr_align8(f.aux_names_off + (u64)f.num_aux_names * 4);
+	f.data_off = pldm_pdr_align8(f.fru_sets_off + (u64)f.num_fru_sets * 4);
+	f.data_size = len;
+	f.file_size = f.data_off + len;
+
+	img = (u8 *)calloc(1, f.file_size);
+	if (!img) {
+		rc = -ENOMEM;
+		goto out;
+	}
+	memcpy(img, &f, sizeof(f));
+	memcpy(img + f.entries_off, e, (size_t)n * sizeof(*e));
+	memcpy(img + f.by_handle_off, by_handle, (size_t)n * 4);
+	memcpy(img + f.numeric_off, numeric, (size_t)f.num_numeric * 4);
+	memcpy(img + f.aux_names_off, aux, (size_t)f.num_aux_names * 4);
+	memcpy(img + f.fru_sets_off, fru, (size_t)f.num_fru_sets * 4);
+	if (len)
+		memcpy(img + f.data_off, records, len);
+
+	snprintf(tmp, sizeof(tmp), "%s.%d.tmp", path, (int)getpid());
+	fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (fd < 0) {
+		rc = -errno;
+		goto out;
+	}
+	for (off = 0; off < f.file_size; off += (size_t)w) {
+		w = write(fd, img + off, f.file_size - off);
+		if (w < 0 && errno == EINTR) {
+			w = 0;
+			continue;
+		}
+		if (w <= 0) {
+			rc = w < 0 ? -errno : -EIO;
+			break;
+		}
+	}
+	if (!rc && fsync(fd) < 0)
+		rc = -errno;
+	close(fd);
+	if (!rc && rename(tmp, path) < 0)
+		rc = -errno;
+	if (rc)
+		unlink(tmp);
+
+out:
+	free(img);
+	free(e);
+	free(by_handle);
+	free(numeric);
+	free(aux);
+	free(fru);
+	return rc;
+}
+
+/* Walk the whole repository from the first record */
+static inline int pldm_pdr_walk(struct pldm_requester *rq, struct pldm_pdr_buf *out, struct pldm_pdr_cache *c)
+{
+	u32 handle = 0, next;
+	unsigned int n = 0;
+	int rc;
+
+	do {
+		if (n++ >= PLDM_PDR_CACHE_MAX_RECORDS)
+			return -E2BIG;
+		rc = pldm_pdr_fetch_record(rq, handle, out, &next, &c->requests);
+		if (rc)
+			return rc;
+		c->fetched++;
+		handle = next;
+	} while (handle);
+	return 0;
+}
+
+/*
+ * Revalidate every record of 'old' with pipelined header-only GetPDR requests.
+ * Unchanged records are copied from the mapping, changed ones are fetched again.
+ * Returns -ESTALE if the set of records itself changed.
+ */
+static inline int pldm_pdr_revalidate(struct pldm_requester *rq, const struct pldm_pdr_cache *old,
+				      struct pldm_pdr_buf *out, struct pldm_pdr_cache *c)
+{
+	u32 n = old->file->num_records;
+	struct cuc_xport_req *reqs;
+	unsigned long sent = rq->requests;
+	u32 i, next;
+	int rc = 0, err;
+
+	if (!n)
+		return -ESTALE;
+
+	reqs = (struct cuc_xport_req *)calloc(n, sizeof(*reqs));
+	if (!reqs)
+		return -ENOMEM;
+
+	for (i = 0; i < n; i++)
+		pldm_get_pdr_req_init(&reqs[i], 0, old->entries[i].record_handle, 0,
+				      PLDM_XFER_OP_GET_FIRST_PART, sizeof(struct pdr_hdr), 0);
+	rc = pldm_rq_run(rq, reqs, n);
+	c->requests += (unsigned int)(rq->requests - sent);
+	if (rc)
+		goto out;
+
+	for (i = 0; i < n; i++) {
+		const struct pldm_pdr_cache_entry *e = &old->entries[i];
+		const struct get_pdr_rsp *rsp = pldm_get_pdr_rsp(&reqs[i], &err);
+		const struct pdr_hdr *h;
+		u32 expect_next = i + 1 < n ? old->entries[i + 1].record_handle : 0;
+
+		if (!rsp) {
+			rc = err;
+			goto out;
+		}
+		if (rsp->response_count < sizeof(*h) || rsp->next_record_handle != expect_next) {
+			rc = -ESTALE;
+			goto out;
+		}
+		h = (const struct pdr_hdr *)rsp->record_data;
+		if (h->record_handle != e->record_handle) {
+			rc = -ESTALE;
+			goto out;
+		}
+
+		if (h->record_change_number == e->record_change_number &&
+		    sizeof(*h) + h->data_length == e->length) {
+			rc = pldm_pdr_buf_append(out, old->data + e->offset, e->length);
+			c->revalidated++;
+		} else {
+			rc = pldm_pdr_fetch_record(rq, e->record_handle, out, &next, &c->requests);
+			c->fetched++;
+		}
+		if (rc)
+			goto out;
+	}
+
+out:
+	free(reqs);
+	return rc;
+}
+
+/**
+ * pldm_pdr_cache_refresh() - Bring a cache file up to date with the uC and map it
+ * @c: Cache, mapped on success
+ * @path: Cache file
+ * @key: Identity of the repository behind @rq
+ * @rq: Requester on the transport to the uC
+ *
+ * A cache file with the same key is revalidated record by record; otherwise the whole
+ * repository is walked. The file is only rewritten when something changed.
+ *
+ * Return: 0 on success or a negative errno
+ */
+static inline int pldm_pdr_cache_refresh(struct pldm_pdr_cache *c, const char *path,
+					 const struct pldm_pdr_cache_key *key, struct pldm_requester *rq)
+{
+	struct pldm_pdr_cache old;
+	struct pldm_pdr_cache stats;
+	struct pldm_pdr_buf buf = { NULL, 0, 0 };
+	int rc;
+
+	memset(&stats, 0, sizeof(stats));
+	rc = pldm_pdr_cache_open(&old, path, key);
+	if (rc == 0) {
+		rc = pldm_pdr_revalidate(rq, &old, &buf, &stats);
+		if (rc == 0 && !stats.fetched) {
+			/* Nothing changed; keep the existing mapping */
+			free(buf.p);
+			*c = old;
+			goto out;
+		}
+		pldm_pdr_cache_close(&old);
+		if (rc == -ESTALE) {
+			/* Records were added or removed; start over */
+			buf.len = 0;
+			stats.revalidated = 0;
+			stats.fetched = 0;
+		} else if (rc) {
+			free(buf.p);
+			return rc;
+		}
+	}
+
+	if (!buf.len) {
+		rc = pldm_pdr_walk(rq, &buf, &stats);
+		if (rc) {
+			free(buf.p);
+			return rc;
+		}
+	}
+
+	rc = pldm_pdr_cache_write(path, key, buf.p, buf.len);
+	free(buf.p);
+	if (rc)
+		return rc;
+	rc = pldm_pdr_cache_open(c, path, key);
+	if (rc)
+		return rc;
+
+out:
+	c->revalidated = stats.revalidated;
+	c->fetched = stats.fetched;
+	c->requests = stats.requests;
+	return 0;
+}
+
+#endif /* PLDM_PDR_CACHE_H */
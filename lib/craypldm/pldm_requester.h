@@ -0,0 +1,332 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* This file implements a PLDM requester that pipelines CUC_CMD_PLDM transactions
+ * over one uC transport by managing the 5-bit PLDM instance ID space.
+ *
+ * Every outstanding request holds a distinct instance ID, so up to 32 requests can
+ * be in flight and each response is paired with its request by (instance ID, PLDM
+ * type, command code) in cuc_xport_dispatch(). IDs are handed out in ring order, so
+ * a released ID is the last one to be reused, which keeps a stale response as far as
+ * possible from a request that could be mistaken for it.
+ *
+ * A request that times out may still be answered later. Its ID is quarantined for
+ * one more timeout period before it is reused. A response with completion code
+ * PLDM_ERROR_NOT_READY is retried on a fresh ID after an exponential backoff.
+ *
+ * The requester is the one allocator of instance IDs on its transport. The PDR cache
+ * and the sensor poller take theirs from it too, through pldm_rq_run() or
+ * pldm_rq_get_iid(), so no two users of a uC can have the same ID outstanding.
+ *
+ * The requester performs no allocation. Like struct cuc_xport it must only be
+ * driven by one thread at a time.
+ */
+
+#ifndef PLDM_REQUESTER_H
+#define PLDM_REQUESTER_H
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "cuc_cxi.h"
+#include "cuc_xport.h"
+#include "pldm_cxi.h"
+
+#define PLDM_RQ_NUM_IDS         32
+#define PLDM_RQ_MAX_RETRIES     8              /* NOT_READY retries per request */
+#define PLDM_RQ_BACKOFF_US      1000           /* First NOT_READY backoff; doubles per retry */
+#define PLDM_RQ_BACKOFF_MAX_US  (64 * 1000)
+
+enum pldm_rq_slot_state {
+	PLDM_RQ_SLOT_FREE,
+	PLDM_RQ_SLOT_WAIT,       /* Waiting for an instance ID or for its backoff to end */
+	PLDM_RQ_SLOT_OUT,        /* Submitted to the transport */
+	PLDM_RQ_SLOT_RX,         /* Completed by the transport, not yet processed */
+};
+
+/**
+ * struct pldm_rq_slot - One request of the batch being run
+ */
+struct pldm_rq_slot {
+	struct cuc_xport_req *r;
+	cuc_xport_done_fn done;    /* Caller's callback and cookie, restored on completion */
+	void *priv;
+	u64 not_before_us;
+	u8 state;                  /* enum pldm_rq_slot_state */
+	u8 iid;
+	u8 retries;
+};
+
+/**
+ * struct pldm_requester - Instance ID window for one uC transport
+ */
+struct pldm_requester {
+	struct cuc_xport *x;
+	u32 free_ids;              /* Instance IDs not in use and not quarantined */
+	u32 quarantined;
+	u8 next_iid;               /* Next ID to hand out, in ring order */
+	u8 iid_slot[PLDM_RQ_NUM_IDS];
+	u64 release_us[PLDM_RQ_NUM_IDS];  /* End of quarantine */
+	struct pldm_rq_slot slot[PLDM_RQ_NUM_IDS];
+
+	/* Tunables */
+	u64 quarantine_us;
+	unsigned int max_retries;
+	u32 backoff_us;
+
+	/* Counters */
+	unsigned long requests;    /* Transactions sent, including retries */
+	unsigned long not_ready;   /* PLDM_ERROR_NOT_READY responses */
+	unsigned long timeouts;    /* IDs quarantined */
+};
+
+/**
+ * pldm_rq_init() - Initialize a requester on top of a transport
+ * @rq: Requester
+ * @x: Transport; its default timeout is also the quarantine period
+ */
+static inline void pldm_rq_init(struct pldm_requester *rq, struct cuc_xport *x)
+{
+	memset(rq, 0, sizeof(*rq));
+	rq->x = x;
+	rq->free_ids = ~(u32)0;
+	rq->quarantine_us = x->default_timeout_us;
+	rq->max_retries = PLDM_RQ_MAX_RETRIES;
+	rq->backoff_us = PLDM_RQ_BACKOFF_US;
+}
+
+/* Take the next free instance ID after the last one handed out. Returns -1 if none. */
+static inline int pldm_rq_alloc_iid(struct pldm_requester *rq)
+{
+	u32 m = rq->free_ids;
+	unsigned int id;
+
+	if (!m)
+		return -1;
+	m = (m >> rq->next_iid) | (rq->next_iid ? m << (PLDM_RQ_NUM_IDS - rq->next_iid) : 0);
+	id = (rq->next_iid + (unsigned int)__builtin_ctz(m)) % PLDM_RQ_NUM_IDS;
+	rq->free_ids &= ~(1u << id);
+	rq->next_iid = (u8)((id + 1) % PLDM_RQ_NUM_IDS);
+	return (int)id;
+}
+
+/* Return quarantined IDs whose period is over to the free set. Returns the earliest remaining release time. */
+static inline u64 pldm_rq_release(struct pldm_requester *rq, u64 now)
+{
+	u64 next = (u64)-1;
+	u32 m = rq->quarantined;
+
+	while (m) {
+		unsigned int id = (unsigned int)__builtin_ctz(m);
+
+		m &= m - 1;
+		if (rq->release_us[id] <= now) {
+			rq->quarantined &= ~(1u << id);
+			rq->free_ids |= 1u << id;
+		} else if (rq->release_us[id] < next) {
+			next = rq->release_us[id];
+		}
+	}
+	return next;
+}
+
+/**
+ * pldm_rq_get_iid() - Take an instance ID for a request sent outside pldm_rq_run()
+ * @rq: Requester
+ *
+ * Return: The ID, or -EAGAIN if every ID is in use or quarantined
+ */
+static inline int pldm_rq_get_iid(struct pldm_requester *rq)
+{
+	int id;
+
+	pldm_rq_release(rq, cuc_xport_now_us());
+	id = pldm_rq_alloc_iid(rq);
+	return id < 0 ? -EAGAIN : id;
+}
+
+/**
+ * pldm_rq_put_iid() - Give back an instance ID
+ * @rq: Requester
+ * @iid: ID from pldm_rq_get_iid()
+ * @status: Status of the request that used it; -ETIMEDOUT quarantines the ID
+ */
+static inline void pldm_rq_put_iid(struct pldm_requester *rq, u8 iid, int status)
+{
+	if (status == -ETIMEDOUT) {
+		/* The uC may still answer; keep the ID out of use until that can no longer happen */
+		rq->quarantined |= 1u << iid;
+		rq->release_us[iid] = cuc_xport_now_us() + rq->quarantine_us;
+		rq->timeouts++;
+	} else {
+		rq->free_ids |= 1u << iid;
+	}
+}
+
+static inline void pldm_rq_done(struct cuc_xport_req *r)
+{
+	struct pldm_requester *rq = (struct pldm_requester *)r->priv;
+
+	rq->slot[rq->iid_slot[r->req.data[0] & 0x1F]].state = PLDM_RQ_SLOT_RX;
+}
+
+/*
+ * Send the request of slot 'k' on instance ID 'iid'. On failure the request is still
+ * owned by an earlier submission: it is restored as it was, the ID is given back and
+ * the slot is freed. Returns 0 or the cuc_xport_submit() error.
+ */
+static inline int pldm_rq_send(struct pldm_requester *rq, struct pldm_rq_slot *s, unsigned int k, u8 iid)
+{
+	struct cuc_xport_req *r = s->r;
+	struct cuc_xport_req *one = r;
+	u8 hdr = r->req.data[0];
+	int rc;
+
+	s->iid = iid;
+	s->state = PLDM_RQ_SLOT_OUT;
+	rq->iid_slot[iid] = (u8)k;
+	r->req.data[0] = (u8)((hdr & ~0x1F) | iid);
+	r->done = pldm_rq_done;
+	r->priv = rq;
+	rc = cuc_xport_submit(rq->x, &one, 1);
+	if (rc < 0) {
+		r->req.data[0] = hdr;
+		r->done = s->done;
+		r->priv = s->priv;
+		rq->free_ids |= 1u << iid;
+		s->state = PLDM_RQ_SLOT_FREE;
+		return rc;
+	}
+	rq->requests++;
+	return 0;
+}
+
+/* Handle a completed transaction. Returns 1 when the request is finished, 0 if it will be retried. */
+static inline int pldm_rq_complete(struct pldm_requester *rq, struct pldm_rq_slot *s, u64 now)
+{
+	struct cuc_xport_req *r = s->r;
+	u32 backoff;
+
+	pldm_rq_put_iid(rq, s->iid, r->status);
+	r->state = CUC_XPORT_REQ_IDLE;
+	r->done = s->done;
+	r->priv = s->priv;
+
+	if (!r->status && r->rsp.type == CUC_TYPE_RSP_PLDM && cuc_xport_rsp_len(r) > sizeof(struct pldm_hdr) &&
+	    r->rsp.data[sizeof(struct pldm_hdr)] == PLDM_ERROR_NOT_READY) {
+		rq->not_ready++;
+		if (s->retries < rq->max_retries) {
+			backoff = rq->backoff_us << s->retries;
+			if (backoff > PLDM_RQ_BACKOFF_MAX_US || backoff < rq->backoff_us)
+				backoff = PLDM_RQ_BACKOFF_MAX_US;
+			s->retries++;
+			s->not_before_us = now + backoff;
+			s->state = PLDM_RQ_SLOT_WAIT;
+			return 0;
+		}
+	}
+	s->state = PLDM_RQ_SLOT_FREE;
+	return 1;
+}
+
+/**
+ * pldm_rq_run() - Execute a batch of PLDM requests, pipelined
+ * @rq: Requester
+ * @reqs: CUC_CMD_PLDM requests; the instance ID they were built with is replaced
+ * @n: Number of requests
+ *
+ * Up to 32 requests are kept outstanding, fewer if the transport window is smaller.
+ * Each request completes like cuc_xport_exec(): status is 0 when a PLDM response was
+ * received and the completion code is left in the response for the caller to check.
+ * It is still PLDM_ERROR_NOT_READY if the uC was not ready after max_retries retries.
+ * 'done' callbacks are not called.
+ *
+ * Return: 0 when every request has completed, or a negative errno on transport
+ * failure. Requests that were not sent then complete with that errno. A request
+ * still in flight from an earlier submission is left untouched and fails the batch
+ * with -EBUSY. If nothing is outstanding and every instance ID is held through
+ * pldm_rq_get_iid(), none can come back while the batch waits, and it fails with
+ * -EAGAIN.
+ */
+static inline int pldm_rq_run(struct pldm_requester *rq, struct cuc_xport_req *reqs, unsigned int n)
+{
+	unsigned int next = 0, finished = 0, k;
+	int err = 0;
+	int rc;
+
+	while (finished < n) {
+		u64 now = cuc_xport_now_us();
+		u64 wake = pldm_rq_release(rq, now);
+		unsigned int out = 0;
+
+		for (k = 0; k < PLDM_RQ_NUM_IDS; k++) {
+			struct pldm_rq_slot *s = &rq->slot[k];
+
+			if (s->state == PLDM_RQ_SLOT_RX)
+				finished += pldm_rq_complete(rq, s, now);
+
+			if (s->state == PLDM_RQ_SLOT_FREE && next < n) {
+				s->r = &reqs[next++];
+				s->done = s->r->done;
+				s->priv = s->r->priv;
+				s->retries = 0;
+				s->not_before_us = 0;
+				s->state = PLDM_RQ_SLOT_WAIT;
+			}
+
+			if (s->state == PLDM_RQ_SLOT_WAIT) {
+				if (err) {
+					s->r->status = err;
+					s->state = PLDM_RQ_SLOT_FREE;
+					finished++;
+					continue;
+				}
+				if (s->not_before_us > now) {
+					if (s->not_before_us < wake)
+						wake = s->not_before_us;
+				} else if ((rc = pldm_rq_alloc_iid(rq)) >= 0) {
+					rc = pldm_rq_send(rq, s, k, (u8)rc);
+					if (rc < 0) {
+						err = rc;
+						finished++;
+						continue;
+					}
+				}
+			}
+			if (s->state == PLDM_RQ_SLOT_OUT || s->state == PLDM_RQ_SLOT_RX)
+				out++;
+		}
+
+		if (finished == n)
+			break;
+		if (err && !out) {
+			while (next < n)
+				reqs[next++].status = err;
+			break;
+		}
+		if (!out && wake == (u64)-1 && !rq->free_ids) {
+			/* Waiting for an ID that is neither ours nor quarantined would never end */
+			err = -EAGAIN;
+			continue;
+		}
+
+		if (out) {
+			now = cuc_xport_now_us();
+			if (wake > now + rq->x->default_timeout_us)
+				wake = now + rq->x->default_timeout_us;
+			rc = cuc_xport_progress(rq->x, wake > now ? (long)(wake - now) : 0);
+			if (rc < 0 && !err) {
+				/* Stop issuing; what is already on the wire completes or times out */
+				err = rc;
+			}
+		} else if (wake != (u64)-1) {
+			now = cuc_xport_now_us();
+			if (wake > now)
+				usleep((useconds_t)(wake - now));
+		}
+	}
+	return err;
+}
+
+#endif /* PLDM_REQUESTER_H */
@@ -0,0 +1,455 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* This file implements conversion of raw numeric sensor readings to engineering
+ * units, one at a time and in vectorized batches.
+ *
+ * For a linear sensor (DSP0248 section 27.2) the reading is
+ *
+ *     value = (raw * resolution + offset) * 10^unit_modifier
+ *
+ * in the unit named by base_unit. The batch converter keeps readings in a
+ * structure-of-arrays table grouped by enum pldm_data_size, so each group is one
+ * homogeneous array that SSE4.1 or AVX2 kernels (selected at run time, with a scalar
+ * fallback) convert to double and float. All paths evaluate the same sequence of
+ * IEEE double operations, so batch results are bit-identical to
+ * pldm_sensor_convert(). When building with FMA enabled, also pass -ffp-contract=off
+ * so that the compiler does not fuse the scalar multiply and add.
+ */
+
+#ifndef PLDM_SENSOR_CONV_H
+#define PLDM_SENSOR_CONV_H
+
+#include <errno.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PLDM_CONV_X86  1
+#endif
+
+#include "pldm_cxi.h"
+
+#define PLDM_DATA_SIZE_COUNT  (PLDM_DATA_SIZE_SINT32 + 1)
+
+/* Bytes per raw reading for each enum pldm_data_size */
+static inline unsigned int pldm_data_size_bytes(unsigned int size)
+{
+	static const u8 bytes[PLDM_DATA_SIZE_COUNT] = { 1, 1, 2, 2, 4, 4 };
+
+	return size < PLDM_DATA_SIZE_COUNT ? bytes[size] : 0;
+}
+
+/* 10^unit_modifier */
+static inline double pldm_unit_scale(int unit_modifier)
+{
+	static const double pos[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12 };
+	static const double neg[] = { 1e0, 1e-1, 1e-2, 1e-3, 1e-4, 1e-5, 1e-6, 1e-7, 1e-8, 1e-9, 1e-10,
+				      1e-11, 1e-12 };
+
+	if (unit_modifier >= 0 && unit_modifier <= 12)
+		return pos[unit_modifier];
+	if (unit_modifier < 0 && unit_modifier >= -12)
+		return neg[-unit_modifier];
+	return pow(10.0, unit_modifier);
+}
+
+/* Short name of an enum sensor_unit */
+static inline const char *pldm_sensor_unit_name(unsigned int base_unit)
+{
+	switch (base_unit) {
+	case PLDM_UNIT_NONE:
+		return "";
+	case PLDM_UNIT_DEGREES_C:
+		return "C";
+	case PLDM_UNIT_VOLTS:
+		return "V";
+	case PLDM_UNIT_AMPS:
+		return "A";
+	case PLDM_UNIT_WATTS:
+		return "W";
+	default:
+		return "?";
+	}
+}
+
+/* Raw reading as a double, exactly */
+static inline double pldm_sensor_raw(unsigned int size, union sensor_value v)
+{
+	switch (size) {
+	case PLDM_DATA_SIZE_UINT8:
+		return v.value_UINT8;
+	case PLDM_DATA_SIZE_SINT8:
+		return v.value_SINT8;
+	case PLDM_DATA_SIZE_UINT16:
+		return v.value_UINT16;
+	case PLDM_DATA_SIZE_SINT16:
+		return v.value_SINT16;
+	case PLDM_DATA_SIZE_UINT32:
+		return v.value_UINT32;
+	case PLDM_DATA_SIZE_SINT32:
+		return v.value_SINT32;
+	default:
+		return NAN;
+	}
+}
+
+/* The one formula every conversion path evaluates */
+static inline double pldm_conv_eval(double raw, double resolution, double offset, double scale)
+{
+	return (raw * resolution + offset) * scale;
+}
+
+/**
+ * pldm_sensor_convert() - Scalar reference conversion
+ * @pdr: The sensor's numeric sensor PDR
+ * @v: Raw present_reading from GetSensorReading
+ *
+ * Return: The reading in units of pdr->base_unit, or NaN for non-linear sensors and
+ *         unknown data sizes
+ */
+static inline double pldm_sensor_convert(const struct numeric_sensor_pdr *pdr, union sensor_value v)
+{
+	float res, off;
+
+	if (!pdr->is_linear)
+		return NAN;
+	memcpy(&res, &pdr->resolution, sizeof(res));
+	memcpy(&off, &pdr->offset, sizeof(off));
+	return pldm_conv_eval(pldm_sensor_raw(pdr->sensor_data_size, v), res, off,
+			      pldm_unit_scale(pdr->unit_modifier));
+}
+
+/*
+ * Batch kernels. Each converts n raw readings of one data size:
+ *     out_d[i] = (raw[i] * res[i] + off[i]) * scale[i];  out_f[i] = (float)out_d[i]
+ * out_f may be NULL.
+ */
+static inline void pldm_conv_scalar(unsigned int size, const void *raw, const double *res, const double *off,
+				    const double *scale, double *out_d, float *out_f, size_t n)
+{
+	size_t i;
+	double r;
+
+	for (i = 0; i < n; i++) {
+		switch (size) {
+		case PLDM_DATA_SIZE_UINT8:
+			r = ((const u8 *)raw)[i];
+			break;
+		case PLDM_DATA_SIZE_SINT8:
+			r = ((const s8 *)raw)[i];
+			break;
+		case PLDM_DATA_SIZE_UINT16:
+			r = ((const u16 *)raw)[i];
+			break;
+		case PLDM_DATA_SIZE_SINT16:
+			r = ((const s16 *)raw)[i];
+			break;
+		case PLDM_DATA_SIZE_UINT32:
+			r = ((const u32 *)raw)[i];
+			break;
+		default:
+			r = ((const s32 *)raw)[i];
+			break;
+		}
+		out_d[i] = pldm_conv_eval(r, res[i], off[i], scale[i]);
+		if (out_f)
+			out_f[i] = (float)out_d[i];
+	}
+}
+
+#ifdef PLDM_CONV_X86
+
+/* Load four raw readings starting at index i, widened to signed 32-bit lanes */
+__attribute__((target("sse4.1")))
+static inline __m128i pldm_conv_load4(unsigned int size, const void *raw, size_t i)
+{
+	int v32;
+
+	switch (size) {
+	case PLDM_DATA_SIZE_UINT8:
+		memcpy(&v32, (const u8 *)raw + i, 4);
+		return _mm_cvtepu8_epi32(_mm_cvtsi32_si128(v32));
+	case PLDM_DATA_SIZE_SINT8:
+		memcpy(&v32, (const s8 *)raw + i, 4);
+		return _mm_cvtepi8_epi32(_mm_cvtsi32_si128(v32));
+	case PLDM_DATA_SIZE_UINT16:
+		return _mm_cvtepu16_epi32(_mm_loadl_epi64((const __m128i *)((const u16 *)raw + i)));
+	case PLDM_DATA_SIZE_SINT16:
+		return _mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i *)((const s16 *)raw + i)));
+	case PLDM_DATA_SIZE_UINT32:
+		/* Bias into signed range; the kernels add 2^31 back exactly */
+		return _mm_xor_si128(_mm_loadu_si128((const __m128i *)((const u32 *)raw + i)),
+				     _mm_set1_epi32((int)0x80000000));
+	default:
+		return _mm_loadu_si128((const __m128i *)((const s32 *)raw + i));
+	}
+}
+
+__attribute__((target("sse4.1")))
+static inline void pldm_conv_sse41(unsigned int size, const void *raw, const double *res, const double *off,
+				   const double *scale, double *out_d, float *out_f, size_t n)
+{
+	const __m128d bias = _mm_set1_pd(size == PLDM_DATA_SIZE_UINT32 ? 2147483648.0 : 0.0);
+	size_t i;
+
+	for (i = 0; i + 4 <= n; i += 4) {
+		__m128i v = pldm_conv_load4(size, raw, i);
+		__m128d lo = _mm_add_pd(_mm_cvtepi32_pd(v), bias);
+		__m128d hi = _mm_add_pd(_mm_cvtepi32_pd(_mm_unpackhi_epi64(v, v)), bias);
+
+		lo = _mm_mul_pd(_mm_add_pd(_mm_mul_pd(lo, _mm_loadu_pd(res + i)), _mm_loadu_pd(off + i)),
+				_mm_loadu_pd(scale + i));
+		hi = _mm_mul_pd(_mm_add_pd(_mm_mul_pd(hi, _mm_loadu_pd(res + i + 2)), _mm_loadu_pd(off + i + 2)),
+				_mm_loadu_pd(scale + i + 2));
+		_mm_storeu_pd(out_d + i, lo);
+		_mm_storeu_pd(out_d + i + 2, hi);
+		if (out_f)
+			_mm_storeu_ps(out_f + i, _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi)));
+	}
+	pldm_conv_scalar(size, (const u8 *)raw + i * pldm_data_size_bytes(size), res + i, off + i, scale + i,
+			 out_d + i, out_f ? out_f + i : NULL, n - i);
+}
+
+__attribute__((target("avx2")))
+static inline void pldm_conv_avx2(unsigned int size, const void *raw, const double *res, const double *off,
+				  const double *scale, double *out_d, float *out_f, size_t n)
+{
+	const __m256d bias = _mm256_set1_pd(size == PLDM_DATA_SIZE_UINT32 ? 2147483648.0 : 0.0);
+	size_t i;
+
+	for (i = 0; i + 8 <= n; i += 8) {
+		__m256d a = _mm256_add_pd(_mm256_cvtepi32_pd(pldm_conv_load4(size, raw, i)), bias);
+		__m256d b = _mm256_add_pd(_mm256_cvtepi32_pd(pldm_conv_load4(size, raw, i + 4)), bias);
+
+		a = _mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(a, _mm256_loadu_pd(res + i)),
+						_mm256_loadu_pd(off + i)),
+				  _mm256_loadu_pd(scale + i));
+		b = _mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(b, _mm256_loadu_pd(res + i + 4)),
+						_mm256_loadu_pd(off + i + 4)),
+				  _mm256_loadu_pd(scale + i + 4));
+		_mm256_storeu_pd(out_d + i, a);
+		_mm256_storeu_pd(out_d + i + 4, b);
+		if (out_f) {
+			_mm_storeu_ps(out_f + i, _mm256_cvtpd_ps(a));
+			_mm_storeu_ps(out_f + i + 4, _mm256_cvtpd_ps(b));
+		}
+	}
+	pldm_conv_scalar(size, (const u8 *)raw + i * pldm_data_size_bytes(size), res + i, off + i, scale + i,
+			 out_d + i, out_f ? out_f + i : NULL, n - i);
+}
+
+#endif /* PLDM_CONV_X86 */
+
+enum pldm_conv_isa {
+	PLDM_CONV_ISA_AUTO,
+	PLDM_CONV_ISA_SCALAR,
+	PLDM_CONV_ISA_SSE41,
+	PLDM_CONV_ISA_AVX2,
+};
+
+/* Best kernel supported by this CPU */
+static inline enum pldm_conv_isa pldm_conv_best_isa(void)
+{
+#ifdef PLDM_CONV_X86
+	if (__builtin_cpu_supports("avx2"))
+		return PLDM_CONV_ISA_AVX2;
+	if (__builtin_cpu_supports("sse4.1"))
+		return PLDM_CONV_ISA_SSE41;
+#endif
+	return PLDM_CONV_ISA_SCALAR;
+}
+
+/**
+ * pldm_conv_batch() - Convert an array of raw readings of one data size
+ * @isa: Kernel to use, or PLDM_CONV_ISA_AUTO
+ * @size: enum pldm_data_size of every element of @raw
+ * @raw: Raw readings, packed at their native width
+ * @res: Per-reading resolution
+ * @off: Per-reading offset
+ * @scale: Per-reading 10^unit_modifier (NaN for non-linear sensors)
+ * @out_d: Converted values
+ * @out_f: Converted values as float, may be NULL
+ * @n: Number of readings
+ *
+ * Return: 0, or -EINVAL for an unknown data size or an unsupported @isa
+ */
+static inline int pldm_conv_batch(enum pldm_conv_isa isa, unsigned int size, const void *raw,
+				  const double *res, const double *off, const double *scale,
+				  double *out_d, float *out_f, size_t n)
+{
+	if (size >= PLDM_DATA_SIZE_COUNT)
+		return -EINVAL;
+	if (isa == PLDM_CONV_ISA_AUTO)
+		isa = pldm_conv_best_isa();
+
+	switch (isa) {
+#ifdef PLDM_CONV_X86
+	case PLDM_CONV_ISA_AVX2:
+		if (!__builtin_cpu_supports("avx2"))
+			return -EINVAL;
+		pldm_conv_avx2(size, raw, res, off, scale, out_d, out_f, n);
+		return 0;
+	case PLDM_CONV_ISA_SSE41:
+		if (!__builtin_cpu_supports("sse4.1"))
+			return -EINVAL;
+		pldm_conv_sse41(size, raw, res, off, scale, out_d, out_f, n);
+		return 0;
+#endif
+	case PLDM_CONV_ISA_SCALAR:
+		pldm_conv_scalar(size, raw, res, off, scale, out_d, out_f, n);
+		return 0;
+	default:
+		return -EINVAL;
+	}
+}
+
+/**
+ * struct pldm_conv_group - Structure-of-arrays for all sensors of one data size
+ */
+struct pldm_conv_group {
+	u32 n;
+	u32 cap;
+	void *raw;                 /* Raw readings at native width */
+	double *res;
+	double *off;
+	double *scale;
+	double *value;             /* Converted readings */
+	float *value_f;
+	u16 *sensor_id;
+	u8 *base_unit;             /* enum sensor_unit */
+};
+
+/**
+ * struct pldm_conv_table - Conversion table for a set of numeric sensors
+ *
+ * A sensor is addressed by a handle that encodes its group and index, as returned
+ * by pldm_conv_table_add().
+ */
+struct pldm_conv_table {
+	struct pldm_conv_group group[PLDM_DATA_SIZE_COUNT];
+	enum pldm_conv_isa isa;
+};
+
+#define PLDM_CONV_HANDLE(size, idx)   (((u32)(size) << 28) | (u32)(idx))
+#define PLDM_CONV_HANDLE_SIZE(h)      ((h) >> 28)
+#define PLDM_CONV_HANDLE_IDX(h)       ((h) & 0x0FFFFFFF)
+
+static inline void pldm_conv_table_init(struct pldm_conv_table *t)
+{
+	memset(t, 0, sizeof(*t));
+	t->isa = pldm_conv_best_isa();
+}
+
+static inline void pldm_conv_table_fini(struct pldm_conv_table *t)
+{
+	unsigned int s;
+
+	for (s = 0; s < PLDM_DATA_SIZE_COUNT; s++) {
+		struct pldm_conv_group *g = &t->group[s];
+
+		free(g->raw);
+		free(g->res);
+		free(g->off);
+		free(g->scale);
+		free(g->value);
+		free(g->value_f);
+		free(g->sensor_id);
+		free(g->base_unit);
+	}
+	memset(t, 0, sizeof(*t));
+}
+
+static inline int pldm_conv_group_grow(struct pldm_conv_group *g, unsigned int size)
+{
+	u32 cap = g->cap ? g->cap * 2 : 64;
+	void *p;
+
+#define PLDM_CONV_GROW(field, elem)                                  \
+	do {                                                         \
+		p = realloc(g->field, (size_t)cap * (elem));         \
+		if (!p)                                              \
+			return -ENOMEM;                              \
+		g->field = (__typeof__(g->field))p;                  \
+	} while (0)
+
+	PLDM_CONV_GROW(raw, pldm_data_size_bytes(size));
+	PLDM_CONV_GROW(res, sizeof(double));
+	PLDM_CONV_GROW(off, sizeof(double));
+	PLDM_CONV_GROW(scale, sizeof(double));
+	PLDM_CONV_GROW(value, sizeof(double));
+	PLDM_CONV_GROW(value_f, sizeof(float));
+	PLDM_CONV_GROW(sensor_id, sizeof(u16));
+	PLDM_CONV_GROW(base_unit, sizeof(u8));
+#undef PLDM_CONV_GROW
+
+	g->cap = cap;
+	return 0;
+}
+
+/**
+ * pldm_conv_table_add() - Add a sensor to the table
+ *
+ * Return: Handle (>= 0), or a negative errno
+ */
+static inline long pldm_conv_table_add(struct pldm_conv_table *t, const struct numeric_sensor_pdr *pdr)
+{
+	unsigned int size = pdr->sensor_data_size;
+	struct pldm_conv_group *g;
+	float res, off;
+	u32 i;
+
+	if (size >= PLDM_DATA_SIZE_COUNT)
+		return -EINVAL;
+	g = &t->group[size];
+	if (g->n >= 0x0FFFFFFF)
+		return -ENOSPC;
+	if (g->n == g->cap && pldm_conv_group_grow(g, size))
+		return -ENOMEM;
+
+	memcpy(&res, &pdr->resolution, sizeof(res));
+	memcpy(&off, &pdr->offset, sizeof(off));
+	i = g->n++;
+	memset((u8 *)g->raw + (size_t)i * pldm_data_size_bytes(size), 0, pldm_data_size_bytes(size));
+	g->res[i] = res;
+	g->off[i] = off;
+	g->scale[i] = pdr->is_linear ? pldm_unit_scale(pdr->unit_modifier) : NAN;
+	g->value[i] = NAN;
+	g->value_f[i] = NAN;
+	g->sensor_id[i] = pdr->sensor_id;
+	g->base_unit[i] = pdr->base_unit;
+	return (long)PLDM_CONV_HANDLE(size, i);
+}
+
+/* Store the raw present_reading of a sensor */
+static inline void pldm_conv_table_set(struct pldm_conv_table *t, u32 handle, union sensor_value v)
+{
+	unsigned int size = PLDM_CONV_HANDLE_SIZE(handle);
+	struct pldm_conv_group *g = &t->group[size];
+	unsigned int bytes = pldm_data_size_bytes(size);
+
+	memcpy((u8 *)g->raw + (size_t)PLDM_CONV_HANDLE_IDX(handle) * bytes, &v, bytes);
+}
+
+static inline double pldm_conv_table_value(const struct pldm_conv_table *t, u32 handle)
+{
+	return t->group[PLDM_CONV_HANDLE_SIZE(handle)].value[PLDM_CONV_HANDLE_IDX(handle)];
+}
+
+/* Convert every sensor in the table */
+static inline void pldm_conv_table_run(struct pldm_conv_table *t)
+{
+	unsigned int s;
+
+	for (s = 0; s < PLDM_DATA_SIZE_COUNT; s++) {
+		struct pldm_conv_group *g = &t->group[s];
+
+		if (g->n)
+			pldm_conv_batch(t->isa, s, g->raw, g->res, g->off, g->scale, g->value, g->value_f, g->n);
+	}
+}
+
+#endif /* PLDM_SENSOR_CONV_H */
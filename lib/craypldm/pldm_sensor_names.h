@@ -0,0 +1,413 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* This file implements a sensor name table built from a PDR cache.
+ *
+ * Sensor auxiliary name PDRs carry their names as UTF-16. pldm_names_build() decodes
+ * every name once into a UTF-8 arena, storing identical names only once. The table
+ * is tied to the pldm_pdr_cache_key (board and uC firmware version) of the cache it
+ * was built from.
+ *
+ * Lookup by name goes through a minimal perfect hash (PTHash-style). Names are
+ * split into buckets of about four. Each bucket stores a pilot, chosen at build
+ * time, that is XORed into the hash of its names to move them to free slots of a
+ * table with exactly one slot per name. A lookup hashes the name, reads one pilot,
+ * computes the slot and confirms it with one comparison, so unknown names are
+ * rejected too. Lookup by sensor_id is a direct index.
+ *
+ * When several sensors share a name, the name resolves to the lowest sensor_id.
+ * Every sensor still maps back to its name.
+ */
+
+#ifndef PLDM_SENSOR_NAMES_H
+#define PLDM_SENSOR_NAMES_H
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pldm_cxi.h"
+#include "pldm_pdr_cache.h"
+
+#define PLDM_NAMES_NONE         0xFFFFFFFF
+#define PLDM_NAMES_BUCKET_SIZE  4
+#define PLDM_NAMES_MAX_SEEDS    16
+
+/* Longest UTF-8 encoding of an AUX_NAME_MAX name, with its NUL */
+#define PLDM_NAMES_UTF8_MAX     (AUX_NAME_MAX * 3 + 1)
+
+/**
+ * struct pldm_name - One distinct sensor name
+ */
+struct pldm_name {
+	u32 name_off;        /* Offset of the NUL-terminated UTF-8 name in the arena */
+	u16 name_len;
+	u16 sensor_id;       /* Lowest sensor_id with this name */
+	u32 numeric_idx;     /* Index for pldm_pdr_cache_numeric_at(), or PLDM_NAMES_NONE */
+	u32 hash;            /* Upper half of the name hash, to reject most misses cheaply */
+};
+
+/**
+ * struct pldm_names - Interned sensor names of one PDR repository
+ */
+struct pldm_names {
+	struct pldm_pdr_cache_key key;
+	char *arena;
+	u32 arena_len;
+	u32 n;                   /* Distinct names, and slots in 'slot' */
+	u32 duplicates;          /* Sensors whose name was already taken */
+	u32 nbuckets;
+	u64 seed;
+	u32 *pilot;              /* [nbuckets], already mixed */
+	struct pldm_name *slot;  /* [n], in hash order */
+	u32 *by_id;              /* [nids] arena offset of each sensor_id's name */
+	u32 nids;
+};
+
+static inline u64 pldm_names_mix(u64 h)
+{
+	h ^= h >> 30;
+	h *= 0xBF58476D1CE4E5B9ULL;
+	h ^= h >> 27;
+	h *= 0x94D049BB133111EBULL;
+	h ^= h >> 31;
+	return h;
+}
+
+static inline u64 pldm_names_hash(const char *s, size_t len, u64 seed)
+{
+	u64 h = seed ^ (len * 0x9E3779B97F4A7C15ULL), v;
+
+	for (; len >= 8; s += 8, len -= 8) {
+		memcpy(&v, s, 8);
+		h = (h ^ v) * 0x9FB21C651E98DF25ULL;
+		h ^= h >> 29;
+	}
+	if (len) {
+		v = 0;
+		memcpy(&v, s, len);
+		h = (h ^ v) * 0x9FB21C651E98DF25ULL;
+	}
+	return pldm_names_mix(h);
+}
+
+/* Map 32 random bits onto [0, n) without a division */
+static inline u32 pldm_names_range(u32 x, u32 n)
+{
+	return (u32)(((u64)x * n) >> 32);
+}
+
+static inline u32 pldm_names_bucket(const struct pldm_names *t, u64 h)
+{
+	return pldm_names_range((u32)(h >> 32), t->nbuckets);
+}
+
+static inline u32 pldm_names_pilot(u32 p)
+{
+	return (u32)pldm_names_mix((u64)(p + 1) * 0xC2B2AE3D27D4EB4FULL);
+}
+
+/* The multiply carries the low bits of the hash up into the bits the range uses */
+static inline u32 pldm_names_pos(u64 h, u32 pilot, u32 n)
+{
+	return pldm_names_range((u32)(((h ^ pilot) * 0x9E3779B97F4A7C15ULL) >> 32), n);
+}
+
+/**
+ * pldm_utf16_to_utf8() - Decode a NUL-terminated little-endian UTF-16 name
+ * @s: Name; need not be aligned
+ * @max: Code units readable at @s; decoding stops there if no NUL comes first
+ * @out: Output, PLDM_NAMES_UTF8_MAX bytes hold any AUX_NAME_MAX name
+ * @size: Size of @out; a character that does not fit ends the name
+ *
+ * Unpaired surrogates decode as U+FFFD.
+ *
+ * Return: Length of the NUL-terminated result
+ */
+static inline size_t pldm_utf16_to_utf8(const void *s, unsigned int max, char *out, size_t size)
+{
+	const u8 *p = (const u8 *)s;
+	size_t n = 0;
+	unsigned int i;
+
+	for (i = 0; i < max; i++) {
+		u32 c = p[2 * i] | (u32)p[2 * i + 1] << 8, lo;
+		u8 b[4];
+		unsigned int k, len;
+
+		if (!c)
+			break;
+		lo = i + 1 < max ? p[2 * i + 2] | (u32)p[2 * i + 3] << 8 : 0;
+		if (c >= 0xD800 && c <= 0xDBFF && lo >= 0xDC00 && lo <= 0xDFFF) {
+			c = 0x10000 + ((c - 0xD800) << 10) + (lo - 0xDC00);
+			i++;
+		} else if (c >= 0xD800 && c <= 0xDFFF) {
+			c = 0xFFFD;
+		}
+		if (c < 0x80) {
+			b[0] = (u8)c;
+			len = 1;
+		} else if (c < 0x800) {
+			b[0] = (u8)(0xC0 | c >> 6);
+			b[1] = (u8)(0x80 | (c & 0x3F));
+			len = 2;
+		} else if (c < 0x10000) {
+			b[0] = (u8)(0xE0 | c >> 12);
+			b[1] = (u8)(0x80 | ((c >> 6) & 0x3F));
+			b[2] = (u8)(0x80 | (c & 0x3F));
+			len = 3;
+		} else {
+			b[0] = (u8)(0xF0 | c >> 18);
+			b[1] = (u8)(0x80 | ((c >> 12) & 0x3F));
+			b[2] = (u8)(0x80 | ((c >> 6) & 0x3F));
+			b[3] = (u8)(0x80 | (c & 0x3F));
+			len = 4;
+		}
+		if (n + len >= size)
+			break;
+		for (k = 0; k < len; k++)
+			out[n++] = (char)b[k];
+	}
+	if (size)
+		out[n] = '\0';
+	return n;
+}
+
+static inline void pldm_names_fini(struct pldm_names *t)
+{
+	free(t->arena);
+	free(t->pilot);
+	free(t->slot);
+	free(t->by_id);
+	memset(t, 0, sizeof(*t));
+}
+
+/* Build entry while the table is assembled */
+struct pldm_names_tmp {
+	const char *name;
+	u32 len;
+	u16 sensor_id;
+	u32 numeric_idx;
+	u64 hash;
+};
+
+static inline int pldm_names_cmp(const void *a, const void *b)
+{
+	const struct pldm_names_tmp *x = (const struct pldm_names_tmp *)a;
+	const struct pldm_names_tmp *y = (const struct pldm_names_tmp *)b;
+	int c;
+
+	if (x->len != y->len)
+		return x->len < y->len ? -1 : 1;
+	c = memcmp(x->name, y->name, x->len);
+	if (c)
+		return c;
+	return (x->sensor_id > y->sensor_id) - (x->sensor_id < y->sensor_id);
+}
+
+/*
+ * Find a pilot for every bucket, largest buckets first, so that the names of each
+ * bucket land on distinct free slots. On return slot[].name_off holds the index
+ * of the name in u[]. Returns -EAGAIN if some bucket needs a new seed.
+ */
+static inline int pldm_names_place(struct pldm_names *t, const struct pldm_names_tmp *u, u32 *order,
+				   u32 *start, u8 *taken, u32 *pos)
+{
+	u32 b, i, j, p, pm, size, max = 0, n = t->n, nb = t->nbuckets;
+
+	/* Counting sort of the names by bucket */
+	memset(start, 0, (nb + 1) * sizeof(*start));
+	for (i = 0; i < n; i++)
+		start[pldm_names_bucket(t, u[i].hash) + 1]++;
+	for (b = 0; b < nb; b++) {
+		if (start[b + 1] > max)
+			max = start[b + 1];
+		start[b + 1] += start[b];
+	}
+	for (i = 0; i < n; i++)
+		order[start[pldm_names_bucket(t, u[i].hash)]++] = i;
+	for (b = nb; b > 0; b--)
+		start[b] = start[b - 1];
+	start[0] = 0;
+
+	memset(taken, 0, n);
+	for (size = max; size > 0; size--) {
+		for (b = 0; b < nb; b++) {
+			if (start[b + 1] - start[b] != size)
+				continue;
+			for (p = 0; p <= 0xFFFF; p++) {
+				pm = pldm_names_pilot(p);
+				for (i = 0; i < size; i++) {
+					pos[i] = pldm_names_pos(u[order[start[b] + i]].hash, pm, n);
+					if (taken[pos[i]])
+						break;
+					for (j = 0; j < i && pos[j] != pos[i]; j++)
+						;
+					if (j < i)
+						break;
+				}
+				if (i == size)
+					break;
+			}
+			if (p > 0xFFFF)
+				return -EAGAIN;
+			t->pilot[b] = pm;
+			for (i = 0; i < size; i++) {
+				const struct pldm_names_tmp *e = &u[order[start[b] + i]];
+				struct pldm_name *sl = &t->slot[pos[i]];
+
+				taken[pos[i]] = 1;
+				sl->name_off = order[start[b] + i];
+				sl->name_len = (u16)e->len;
+				sl->sensor_id = e->sensor_id;
+				sl->numeric_idx = e->numeric_idx;
+				sl->hash = (u32)(e->hash >> 32);
+			}
+		}
+	}
+	return 0;
+}
+
+/**
+ * pldm_names_build() - Build the name table of a PDR cache
+ * @t: Table to initialize; pldm_names_fini() releases it
+ * @c: Open PDR cache
+ *
+ * Return: 0 on success, -ENOENT if the cache has no names, -ENOMEM, or -EAGAIN if
+ * no perfect hash was found
+ */
+static inline int pldm_names_build(struct pldm_names *t, const struct pldm_pdr_cache *c)
+{
+	struct pldm_names_tmp *tmp = NULL, *u = NULL;
+	char *scratch = NULL;
+	u32 *order = NULL, *start = NULL, *pos = NULL;
+	u8 *taken = NULL;
+	u32 naux, i, j, nn = 0, nu = 0, max_id = 0, seed;
+	size_t off = 0;
+	int rc = -ENOMEM;
+
+	memset(t, 0, sizeof(*t));
+	if (!c->file || !c->file->num_aux_names)
+		return -ENOENT;
+	t->key = c->file->key;
+	naux = c->file->num_aux_names;
+
+	tmp = (struct pldm_names_tmp *)calloc(naux, sizeof(*tmp));
+	scratch = (char *)malloc((size_t)naux * PLDM_NAMES_UTF8_MAX);
+	if (!tmp || !scratch)
+		goto out;
+
+	/* Both indexes are sorted by sensor_id, so one merge pass pairs them */
+	for (i = 0; i < naux; i++) {
+		const struct aux_name_pdr *a = (const struct aux_name_pdr *)pldm_pdr_cache_record(c, c->aux_names[i]);
+		struct pldm_names_tmp *e = &tmp[i];
+		/* The index only holds records that reach sensor_name; the name may be shorter */
+		unsigned int units = (c->entries[c->aux_names[i]].length - offsetof(struct aux_name_pdr, sensor_name)) / 2;
+
+		e->name = scratch + off;
+		e->len = (u32)pldm_utf16_to_utf8(a->sensor_name, units < AUX_NAME_MAX ? units : AUX_NAME_MAX,
+						 scratch + off, PLDM_NAMES_UTF8_MAX);
+		off += e->len + 1;
+		e->sensor_id = a->sensor_id;
+		while (nn < c->file->num_numeric && pldm_pdr_cache_numeric_at(c, nn)->sensor_id < a->sensor_id)
+			nn++;
+		e->numeric_idx = nn < c->file->num_numeric && pldm_pdr_cache_numeric_at(c, nn)->sensor_id == a->sensor_id ?
+				 nn : PLDM_NAMES_NONE;
+		if (a->sensor_id > max_id)
+			max_id = a->sensor_id;
+	}
+
+	/* Intern: sort so equal names are adjacent, lowest sensor_id first */
+	qsort(tmp, naux, sizeof(*tmp), pldm_names_cmp);
+	u = (struct pldm_names_tmp *)malloc(naux * sizeof(*u));
+	t->arena = (char *)malloc(off ? off : 1);
+	t->nids = max_id + 1;
+	t->by_id = (u32 *)malloc(t->nids * sizeof(*t->by_id));
+	if (!u || !t->arena || !t->by_id)
+		goto out;
+	memset(t->by_id, 0xFF, t->nids * sizeof(*t->by_id));
+	for (i = 0; i < naux; i = j) {
+		memcpy(t->arena + t->arena_len, tmp[i].name, tmp[i].len + 1);
+		for (j = i; j < naux && tmp[j].len == tmp[i].len && !memcmp(tmp[j].name, tmp[i].name, tmp[i].len); j++)
+			t->by_id[tmp[j].sensor_id] = t->arena_len;
+		t->duplicates += j - i - 1;
+		u[nu] = tmp[i];
+		u[nu].name = t->arena + t->arena_len;
+		nu++;
+		t->arena_len += tmp[i].len + 1;
+	}
+
+	t->n = nu;
+	t->nbuckets = (nu + PLDM_NAMES_BUCKET_SIZE - 1) / PLDM_NAMES_BUCKET_SIZE;
+	t->pilot = (u32 *)calloc(t->nbuckets, sizeof(*t->pilot));
+	t->slot = (struct pldm_name *)malloc(nu * sizeof(*t->slot));
+	order = (u32 *)malloc(nu * sizeof(*order));
+	start = (u32 *)malloc((t->nbuckets + 1) * sizeof(*start));
+	pos = (u32 *)malloc(nu * sizeof(*pos));
+	taken = (u8 *)malloc(nu);
+	if (!t->pilot || !t->slot || !order || !start || !pos || !taken)
+		goto out;
+
+	rc = -EAGAIN;
+	for (seed = 0; seed < PLDM_NAMES_MAX_SEEDS && rc == -EAGAIN; seed++) {
+		t->seed = pldm_names_mix(0x5EED0000ULL + seed);
+		for (i = 0; i < nu; i++)
+			u[i].hash = pldm_names_hash(u[i].name, u[i].len, t->seed);
+		rc = pldm_names_place(t, u, order, start, taken, pos);
+	}
+	if (!rc)
+		for (i = 0; i < nu; i++)
+			t->slot[i].name_off = (u32)(u[t->slot[i].name_off].name - t->arena);
+
+out:
+	free(tmp);
+	free(scratch);
+	free(u);
+	free(order);
+	free(start);
+	free(pos);
+	free(taken);
+	if (rc)
+		pldm_names_fini(t);
+	return rc;
+}
+
+/* The UTF-8 name of an entry */
+static inline const char *pldm_name_str(const struct pldm_names *t, const struct pldm_name *e)
+{
+	return t->arena + e->name_off;
+}
+
+/**
+ * pldm_names_find() - Look up a sensor by its UTF-8 name
+ *
+ * Return: The entry, or NULL if no sensor has that name
+ */
+static inline const struct pldm_name *pldm_names_find(const struct pldm_names *t, const char *name, size_t len)
+{
+	const struct pldm_name *e;
+	u64 h;
+
+	if (!t->n)
+		return NULL;
+	h = pldm_names_hash(name, len, t->seed);
+	e = &t->slot[pldm_names_pos(h, t->pilot[pldm_names_bucket(t, h)], t->n)];
+	if (e->hash != (u32)(h >> 32) || e->name_len != len || memcmp(t->arena + e->name_off, name, len))
+		return NULL;
+	return e;
+}
+
+static inline const struct pldm_name *pldm_names_find_str(const struct pldm_names *t, const char *name)
+{
+	return pldm_names_find(t, name, strlen(name));
+}
+
+/* The UTF-8 name of a sensor, or NULL */
+static inline const char *pldm_names_by_id(const struct pldm_names *t, u16 sensor_id)
+{
+	if (sensor_id >= t->nids || t->by_id[sensor_id] == PLDM_NAMES_NONE)
+		return NULL;
+	return t->arena + t->by_id[sensor_id];
+}
+
+#endif /* PLDM_SENSOR_NAMES_H */
@@ -0,0 +1,489 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* This file implements a numeric sensor polling scheduler driven by the
+ * update_interval and state_transition_interval fields of the numeric sensor PDR.
+ *
+ * A sensor cannot return a new reading more often than the uC refreshes it, so each
+ * sensor is polled at its declared interval, rounded down to a power-of-two multiple
+ * of a base period so that no fresh reading is missed. Sensors with the same period
+ * share a bucket and are given evenly spaced phases, interleaved across transports,
+ * so the load on each uC is flat rather than bursty. Due sensors are read with
+ * batches of GetSensorReading requests over CUC_CMD_PLDM through the pipelined
+ * transport in cuc_xport.h. Each request holds a distinct PLDM instance ID taken from
+ * the transport's requester (pldm_requester.h), shared with the other PLDM users.
+ */
+
+#ifndef PLDM_SENSOR_POLL_H
+#define PLDM_SENSOR_POLL_H
+
+#include <errno.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "cuc_cxi.h"
+#include "cuc_xport.h"
+#include "pldm_cxi.h"
+#include "pldm_requester.h"
+
+#define PLDM_POLL_MAX_BUCKETS       16
+#define PLDM_POLL_MAX_XPORTS        64
+#define PLDM_POLL_DEFAULT_BASE_US   (100 * 1000)  /* Shortest polling period */
+#define PLDM_POLL_DEFAULT_PERIOD_US (1000 * 1000) /* For sensors with no declared interval */
+/* Longest base period whose slowest bucket still fits the u32 periods */
+#define PLDM_POLL_MAX_BASE_US       (UINT32_MAX >> (PLDM_POLL_MAX_BUCKETS - 1))
+
+/* Offset of the update_interval/state_transition_interval fields; identical in every SSD variant */
+#define PLDM_POLL_SSD_STI_OFF  offsetof(struct numeric_sensor_ssd8, state_transition_interval)
+#define PLDM_POLL_SSD_UI_OFF   offsetof(struct numeric_sensor_ssd8, update_interval)
+
+/**
+ * struct pldm_poll_sensor - One polled sensor
+ */
+struct pldm_poll_sensor {
+	u16 sensor_id;
+	u8 xport;                  /* Index of the transport reaching the sensor's uC */
+	u8 bucket;
+	u32 period_us;             /* Polling period after rounding */
+	u64 next_due_us;
+	u64 last_read_us;
+	void *priv;                /* Caller cookie */
+};
+
+struct pldm_poll;
+
+/* Called for every completed read. 'rsp' is NULL when status is non-zero. */
+typedef void (*pldm_poll_fn)(struct pldm_poll *p, struct pldm_poll_sensor *s,
+			     const struct get_sensor_reading_rsp *rsp, int status);
+
+struct pldm_poll_bucket {
+	u32 period_us;
+	u32 *idx;                  /* Sensor indexes in phase order */
+	u32 count;
+	u32 cap;
+	u32 cursor;                /* Next sensor to come due */
+};
+
+/*
+ * Per-transport request slots; bounded by the 32 PLDM instance IDs. Completions
+ * arrive through a 'done' callback, so other users of the transport never see them.
+ */
+struct pldm_poll_port {
+	struct cuc_xport *x;
+	struct pldm_requester *rq; /* Instance ID allocator of x */
+	struct cuc_xport_req req[CUC_XPORT_MAX_INFLIGHT];
+	u32 sensor[CUC_XPORT_MAX_INFLIGHT];
+	u32 free_mask;             /* Bit set for each free slot */
+	u32 done_mask;             /* Bit set for each completed slot not yet processed */
+};
+
+/**
+ * struct pldm_poll - Sensor polling scheduler
+ */
+struct pldm_poll {
+	struct pldm_poll_sensor *sensors;
+	u32 num_sensors;
+	u32 max_sensors;
+	u32 base_us;
+	int use_state_interval;    /* Also honour state_transition_interval */
+	pldm_poll_fn fn;
+	void *priv;
+
+	struct pldm_poll_bucket bucket[PLDM_POLL_MAX_BUCKETS];
+	struct pldm_poll_port port[PLDM_POLL_MAX_XPORTS];
+	u32 num_ports;
+	u8 dirty;                  /* Phases need to be recomputed */
+
+	/* Counters */
+	unsigned long reads;
+	unsigned long errors;
+};
+
+/**
+ * pldm_poll_init() - Initialize a scheduler
+ * @p: Scheduler
+ * @max_sensors: Capacity
+ * @base_us: Shortest polling period, 0 for the default; at most PLDM_POLL_MAX_BASE_US
+ * @fn: Completion callback
+ * @priv: Caller cookie
+ *
+ * Return: 0 on success, -EINVAL if @base_us is too long, or -ENOMEM
+ */
+static inline int pldm_poll_init(struct pldm_poll *p, u32 max_sensors, u32 base_us, pldm_poll_fn fn, void *priv)
+{
+	unsigned int b;
+
+	memset(p, 0, sizeof(*p));
+	if (base_us > PLDM_POLL_MAX_BASE_US)
+		return -EINVAL;
+	p->sensors = (struct pldm_poll_sensor *)calloc(max_sensors ? max_sensors : 1, sizeof(*p->sensors));
+	if (!p->sensors)
+		return -ENOMEM;
+	p->max_sensors = max_sensors;
+	p->base_us = base_us ? base_us : PLDM_POLL_DEFAULT_BASE_US;
+	p->fn = fn;
+	p->priv = priv;
+	for (b = 0; b < PLDM_POLL_MAX_BUCKETS; b++)
+		p->bucket[b].period_us = p->base_us << b;
+	return 0;
+}
+
+static inline void pldm_poll_fini(struct pldm_poll *p)
+{
+	unsigned int b;
+
+	for (b = 0; b < PLDM_POLL_MAX_BUCKETS; b++)
+		free(p->bucket[b].idx);
+	free(p->sensors);
+	memset(p, 0, sizeof(*p));
+}
+
+/**
+ * pldm_poll_add_xport() - Register a transport
+ * @p: Scheduler
+ * @rq: Requester of the transport; reads take their instance IDs from it
+ *
+ * Return: Transport index for pldm_poll_add_sensor(), or -ENOSPC
+ */
+static inline int pldm_poll_add_xport(struct pldm_poll *p, struct pldm_requester *rq)
+{
+	struct pldm_poll_port *port;
+
+	if (p->num_ports >= PLDM_POLL_MAX_XPORTS)
+		return -ENOSPC;
+	port = &p->port[p->num_ports];
+	memset(port, 0, sizeof(*port));
+	port->x = rq->x;
+	port->rq = rq;
+	port->free_mask = (u32)~0u;
+	return (int)p->num_ports++;
+}
+
+/* Polling period implied by a sensor's declared intervals (seconds) */
+static inline u32 pldm_poll_period_us(const struct pldm_poll *p, float update_interval, float state_interval)
+{
+	double sec = 0;
+	u32 period, b;
+
+	if (isfinite(update_interval) && update_interval > 0)
+		sec = update_interval;
+	if (p->use_state_interval && isfinite(state_interval) && state_interval > 0 &&
+	    (sec == 0 || state_interval < sec))
+		sec = state_interval;
+	if (sec == 0)
+		sec = PLDM_POLL_DEFAULT_PERIOD_US / 1e6;
+
+	/* Round down to a bucket period so no update is missed */
+	period = sec * 1e6 >= (double)(p->base_us << (PLDM_POLL_MAX_BUCKETS - 1)) ?
+		 p->base_us << (PLDM_POLL_MAX_BUCKETS - 1) : (u32)(sec * 1e6);
+	for (b = PLDM_POLL_MAX_BUCKETS - 1; b > 0; b--)
+		if ((p->base_us << b) <= period)
+			break;
+	return p->base_us << b;
+}
+
+/**
+ * pldm_poll_add_sensor() - Schedule a numeric sensor
+ * @p: Scheduler
+ * @xport: Transport index from pldm_poll_add_xport()
+ * @pdr: The sensor's numeric sensor PDR
+ * @priv: Caller cookie stored in the sensor
+ *
+ * Return: Sensor index, or a negative errno
+ */
+static inline int pldm_poll_add_sensor(struct pldm_poll *p, unsigned int xport,
+				       const struct numeric_sensor_pdr *pdr, void *priv)
+{
+	const u8 *ssd = (const u8 *)&pdr->ssd;
+	struct pldm_poll_sensor *s;
+	struct pldm_poll_bucket *bk;
+	float ui, sti;
+	u32 period, b, *idx;
+
+	if (xport >= p->num_ports)
+		return -EINVAL;
+	if (p->num_sensors >= p->max_sensors)
+		return -ENOSPC;
+
+	/* The interval fields follow a size-dependent hysteresis field */
+	switch (pdr->sensor_data_size) {
+	case PLDM_DATA_SIZE_UINT8:
+	case PLDM_DATA_SIZE_SINT8:
+		break;
+	case PLDM_DATA_SIZE_UINT16:
+	case PLDM_DATA_SIZE_SINT16:
+		ssd += 1;
+		break;
+	case PLDM_DATA_SIZE_UINT32:
+	case PLDM_DATA_SIZE_SINT32:
+		ssd += 3;
+		break;
+	default:
+		return -EINVAL;
+	}
+	memcpy(&sti, ssd + PLDM_POLL_SSD_STI_OFF, sizeof(sti));
+	memcpy(&ui, ssd + PLDM_POLL_SSD_UI_OFF, sizeof(ui));
+
+	period = pldm_poll_period_us(p, ui, sti);
+	for (b = 0; b < PLDM_POLL_MAX_BUCKETS - 1; b++)
+		if (p->bucket[b].period_us == period)
+			break;
+
+	bk = &p->bucket[b];
+	if (bk->count == bk->cap) {
+		u32 cap = bk->cap ? bk->cap * 2 : 64;
+
+		idx = (u32 *)realloc(bk->idx, cap * sizeof(*idx));
+		if (!idx)
+			return -ENOMEM;
+		bk->idx = idx;
+		bk->cap = cap;
+	}
+
+	s = &p->sensors[p->num_sensors];
+	memset(s, 0, sizeof(*s));
+	s->sensor_id = pdr->sensor_id;
+	s->xport = (u8)xport;
+	s->bucket = (u8)b;
+	s->period_us = period;
+	s->priv = priv;
+	bk->idx[bk->count++] = p->num_sensors;
+	p->dirty = 1;
+	return (int)p->num_sensors++;
+}
+
+/*
+ * Order each bucket so that consecutive sensors belong to different transports, then
+ * spread their first due times evenly across the bucket period.
+ */
+static inline void pldm_poll_layout(struct pldm_poll *p, u64 now)
+{
+	u32 pos[PLDM_POLL_MAX_XPORTS];
+	unsigned int b, x;
+	u32 i, n, out, *tmp;
+
+	for (b = 0; b < PLDM_POLL_MAX_BUCKETS; b++) {
+		struct pldm_poll_bucket *bk = &p->bucket[b];
+
+		n = bk->count;
+		if (!n)
+			continue;
+
+		tmp = (u32 *)malloc(n * sizeof(*tmp));
+		if (tmp) {
+			/* Take the next unplaced sensor of each transport in turn */
+			memset(pos, 0, sizeof(pos));
+			for (out = 0; out < n;) {
+				for (x = 0; x < p->num_ports && out < n; x++) {
+					for (i = pos[x]; i < n; i++)
+						if (p->sensors[bk->idx[i]].xport == x)
+							break;
+					if (i < n)
+						tmp[out++] = bk->idx[i];
+					pos[x] = i < n ? i + 1 : n;
+				}
+			}
+			memcpy(bk->idx, tmp, n * sizeof(*tmp));
+			free(tmp);
+		}
+
+		for (i = 0; i < n; i++)
+			p->sensors[bk->idx[i]].next_due_us = now + (u64)bk->period_us * i / n;
+		bk->cursor = 0;
+	}
+	p->dirty = 0;
+}
+
+static inline void pldm_poll_sensor_req_init(struct cuc_xport_req *r, u8 instance_id, u16 sensor_id)
+{
+	struct get_sensor_reading_req req;
+
+	memset(&req, 0, sizeof(req));
+	req.hdr.instance_id = instance_id & 0x1F;
+	req.hdr.rq = 1;
+	req.hdr.pldm_type = PLDM_TYPE_PLATFORM_MONITORING_AND_CONTROL;
+	req.hdr.pldm_command_code = PLDM_CMD_GET_SENSOR_READING;
+	req.sensor_id = sensor_id;
+	req.rearm_event_status = 0;
+	cuc_xport_req_init(r, CUC_CMD_PLDM, &req, sizeof(req));
+}
+
+static inline void pldm_poll_req_done(struct cuc_xport_req *r)
+{
+	struct pldm_poll_port *port = (struct pldm_poll_port *)r->priv;
+
+	port->done_mask |= 1u << (unsigned int)(r - port->req);
+}
+
+/*
+ * Queue a read of sensor 'si' on its transport. Returns 0, -EBUSY if no slot or
+ * instance ID is free until the port's outstanding reads complete, or -EAGAIN if
+ * every instance ID is quarantined.
+ */
+static inline int pldm_poll_queue(struct pldm_poll *p, u32 si)
+{
+	struct pldm_poll_sensor *s = &p->sensors[si];
+	struct pldm_poll_port *port = &p->port[s->xport];
+	struct cuc_xport_req *r;
+	unsigned int slot;
+	int iid, rc;
+
+	if (!port->free_mask)
+		return -EBUSY;
+	iid = pldm_rq_get_iid(port->rq);
+	if (iid < 0)
+		return port->free_mask != (u32)~0u ? -EBUSY : iid;
+	slot = (unsigned int)__builtin_ctz(port->free_mask);
+	port->free_mask &= ~(1u << slot);
+	port->sensor[slot] = si;
+
+	r = &port->req[slot];
+	pldm_poll_sensor_req_init(r, (u8)iid, s->sensor_id);
+	r->done = pldm_poll_req_done;
+	r->priv = port;
+	rc = cuc_xport_submit(port->x, &r, 1);
+	if (rc < 0) {
+		pldm_rq_put_iid(port->rq, (u8)iid, 0);
+		port->free_mask |= 1u << slot;
+		return rc;
+	}
+	return 0;
+}
+
+static inline void pldm_poll_finish(struct pldm_poll *p, struct pldm_poll_port *port, unsigned int slot, u64 now)
+{
+	struct cuc_xport_req *r = &port->req[slot];
+	struct pldm_poll_sensor *s = &p->sensors[port->sensor[slot]];
+	const struct get_sensor_reading_rsp *rsp = NULL;
+	int status = r->status;
+
+	r->state = CUC_XPORT_REQ_IDLE;
+	pldm_rq_put_iid(port->rq, r->req.data[0] & 0x1F, status);
+	port->done_mask &= ~(1u << slot);
+	port->free_mask |= 1u << slot;
+
+	if (!status) {
+		unsigned int len = cuc_xport_rsp_len(r);
+
+		rsp = (const struct get_sensor_reading_rsp *)r->rsp.data;
+		if (len < offsetof(struct get_sensor_reading_rsp, sensor_data_size)) {
+			status = -EPROTO;
+			rsp = NULL;
+		} else if (rsp->completion_code == PLDM_ERROR_NOT_READY) {
+			status = -EAGAIN;
+			rsp = NULL;
+		} else if (rsp->completion_code != PLDM_SUCCESS) {
+			status = -EIO;
+			rsp = NULL;
+		} else if (len < offsetof(struct get_sensor_reading_rsp, present_reading)) {
+			status = -EPROTO;
+			rsp = NULL;
+		}
+	}
+
+	if (status) {
+		p->errors++;
+	} else {
+		p->reads++;
+		s->last_read_us = now;
+	}
+	if (p->fn)
+		p->fn(p, s, rsp, status);
+}
+
+/**
+ * pldm_poll_run() - Read every sensor that is due
+ * @p: Scheduler
+ * @now: Current time from cuc_xport_now_us()
+ *
+ * Due sensors are queued on their transports (up to 32 outstanding per transport)
+ * and all of them are completed before returning, so a sensor is never due while
+ * its previous read is still in flight. A read that cannot be queued is reported
+ * to the callback with the error.
+ *
+ * Return: Time at which the next sensor comes due
+ */
+static inline u64 pldm_poll_run(struct pldm_poll *p, u64 now)
+{
+	u64 next = (u64)-1;
+	unsigned int b, x;
+	int pending, rc;
+
+	if (p->dirty)
+		pldm_poll_layout(p, now);
+
+	do {
+		pending = 0;
+
+		for (b = 0; b < PLDM_POLL_MAX_BUCKETS; b++) {
+			struct pldm_poll_bucket *bk = &p->bucket[b];
+			u32 scanned;
+
+			for (scanned = 0; scanned < bk->count; scanned++) {
+				u32 si = bk->idx[bk->cursor];
+				struct pldm_poll_sensor *s = &p->sensors[si];
+
+				if (s->next_due_us > now)
+					break;
+				rc = pldm_poll_queue(p, si);
+				if (rc == -EBUSY) {
+					/* Transport saturated; pick this sensor up next round */
+					pending = 1;
+					break;
+				}
+				if (rc < 0) {
+					p->errors++;
+					if (p->fn)
+						p->fn(p, s, NULL, rc);
+				}
+				s->next_due_us += bk->period_us;
+				if (s->next_due_us <= now)
+					s->next_due_us = now + bk->period_us;
+				bk->cursor = (bk->cursor + 1) % bk->count;
+			}
+		}
+
+		for (x = 0; x < p->num_ports; x++) {
+			struct pldm_poll_port *port = &p->port[x];
+
+			/* Every outstanding read completes, if only by timing out */
+			while (port->free_mask != (u32)~0u) {
+				if (!port->done_mask)
+					cuc_xport_progress(port->x, (long)port->x->default_timeout_us);
+				while (port->done_mask)
+					pldm_poll_finish(p, port, (unsigned int)__builtin_ctz(port->done_mask), now);
+			}
+		}
+	} while (pending);
+
+	for (b = 0; b < PLDM_POLL_MAX_BUCKETS; b++) {
+		struct pldm_poll_bucket *bk = &p->bucket[b];
+
+		if (bk->count && p->sensors[bk->idx[bk->cursor]].next_due_us < next)
+			next = p->sensors[bk->idx[bk->cursor]].next_due_us;
+	}
+	return next;
+}
+
+/**
+ * pldm_rq_get_sensor_readings() - Read several numeric sensors
+ * @rq: Requester
+ * @reqs: One request per sensor; each receives its GetSensorReading response
+ * @sensor_ids: Sensors to read
+ * @n: Number of sensors
+ *
+ * Return: As pldm_rq_run()
+ */
+static inline int pldm_rq_get_sensor_readings(struct pldm_requester *rq, struct cuc_xport_req *reqs,
+					      const u16 *sensor_ids, unsigned int n)
+{
+	unsigned int i;
+
+	for (i = 0; i < n; i++)
+		pldm_poll_sensor_req_init(&reqs[i], 0, sensor_ids[i]);
+	return pldm_rq_run(rq, reqs, n);
+}
+
+#endif /* PLDM_SENSOR_POLL_H */
@@ -0,0 +1,368 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* This file implements host-side threshold and hysteresis evaluation for numeric
+ * sensors.
+ *
+ * The warning, critical and fatal thresholds and the hysteresis of every sensor are
+ * converted to engineering units once, from its numeric sensor PDR, and kept in a
+ * structure-of-arrays table. Thresholds that are not set in supported_thresholds are
+ * stored as +/-infinity so they never trip. Each evaluation pass compares all
+ * readings against all thresholds without per-sensor branches (AVX2 when available,
+ * otherwise a branch-free scalar loop) and only then emits compact events for the
+ * sensors whose state changed.
+ *
+ * A sensor moves to a more severe state as soon as a threshold is reached, and back
+ * towards normal only once the reading has moved past the threshold by the sensor's
+ * hysteresis. States use the values of enum pldm_sensor_state, as reported in
+ * present_state/previous_state/event_state by GetSensorReading.
+ */
+
+#ifndef PLDM_THRESHOLD_H
+#define PLDM_THRESHOLD_H
+
+#include <errno.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pldm_cxi.h"
+#include "pldm_sensor_conv.h"
+
+/* Value of pldm_thr_table.level for a sensor whose reading is not a number */
+#define PLDM_THR_LEVEL_UNKNOWN  127
+
+/**
+ * struct pldm_thr_event - One sensor state transition
+ */
+struct pldm_thr_event {
+	u32 index;            /* Table index of the sensor */
+	u16 sensor_id;
+	u8 present_state;     /* enum pldm_sensor_state */
+	u8 previous_state;
+	u8 event_state;       /* State that raised the event: present_state, as in a PLDM sensorEvent */
+};
+
+/**
+ * struct pldm_thr_table - Threshold table
+ *
+ * 'value' is written by the caller (e.g. from pldm_conv_group.value_f) before each
+ * pldm_thr_eval(). 'level' holds the current state of each sensor: 0 for normal,
+ * 1 to 3 for upper warning/critical/fatal, -1 to -3 for the lower states, or
+ * PLDM_THR_LEVEL_UNKNOWN.
+ */
+struct pldm_thr_table {
+	u32 n;
+	u32 cap;
+	float *value;
+	float *thr[PLDM_THRESHOLD_COUNT];  /* Indexed by enum pldm_threshold */
+	float *hyst;
+	s8 *level;
+	s8 *next;                          /* Scratch: levels computed by the last pass */
+	u16 *sensor_id;
+	enum pldm_conv_isa isa;
+};
+
+static inline void pldm_thr_table_init(struct pldm_thr_table *t)
+{
+	memset(t, 0, sizeof(*t));
+	t->isa = pldm_conv_best_isa();
+}
+
+static inline void pldm_thr_table_fini(struct pldm_thr_table *t)
+{
+	unsigned int i;
+
+	free(t->value);
+	for (i = 0; i < PLDM_THRESHOLD_COUNT; i++)
+		free(t->thr[i]);
+	free(t->hyst);
+	free(t->level);
+	free(t->next);
+	free(t->sensor_id);
+	memset(t, 0, sizeof(*t));
+}
+
+/* Offset of each threshold within the size-dependent part of the PDR, in enum pldm_threshold order */
+static inline unsigned int pldm_thr_ssd_offset(unsigned int size, unsigned int which)
+{
+	static const u8 off8[PLDM_THRESHOLD_COUNT] = {
+		offsetof(struct numeric_sensor_ssd8, warning_high),
+		offsetof(struct numeric_sensor_ssd8, critical_high),
+		offsetof(struct numeric_sensor_ssd8, fatal_high),
+		offsetof(struct numeric_sensor_ssd8, warning_low),
+		offsetof(struct numeric_sensor_ssd8, critical_low),
+		offsetof(struct numeric_sensor_ssd8, fatal_low),
+	};
+	static const u8 off16[PLDM_THRESHOLD_COUNT] = {
+		offsetof(struct numeric_sensor_ssd16, warning_high),
+		offsetof(struct numeric_sensor_ssd16, critical_high),
+		offsetof(struct numeric_sensor_ssd16, fatal_high),
+		offsetof(struct numeric_sensor_ssd16, warning_low),
+		offsetof(struct numeric_sensor_ssd16, critical_low),
+		offsetof(struct numeric_sensor_ssd16, fatal_low),
+	};
+	static const u8 off32[PLDM_THRESHOLD_COUNT] = {
+		offsetof(struct numeric_sensor_ssd32, warning_high),
+		offsetof(struct numeric_sensor_ssd32, critical_high),
+		offsetof(struct numeric_sensor_ssd32, fatal_high),
+		offsetof(struct numeric_sensor_ssd32, warning_low),
+		offsetof(struct numeric_sensor_ssd32, critical_low),
+		offsetof(struct numeric_sensor_ssd32, fatal_low),
+	};
+
+	switch (pldm_data_size_bytes(size)) {
+	case 1:
+		return off8[which];
+	case 2:
+		return off16[which];
+	default:
+		return off32[which];
+	}
+}
+
+static inline int pldm_thr_table_grow(struct pldm_thr_table *t)
+{
+	u32 cap = t->cap ? t->cap * 2 : 256;
+	unsigned int i;
+	void *p;
+
+#define PLDM_THR_GROW(field, elem)                                     \
+	do {                                                           \
+		p = realloc(t->field, (size_t)cap * (elem));           \
+		if (!p)                                                \
+			return -ENOMEM;                                \
+		t->field = (__typeof__(t->field))p;                    \
+	} while (0)
+
+	PLDM_THR_GROW(value, sizeof(float));
+	for (i = 0; i < PLDM_THRESHOLD_COUNT; i++)
+		PLDM_THR_GROW(thr[i], sizeof(float));
+	PLDM_THR_GROW(hyst, sizeof(float));
+	PLDM_THR_GROW(level, 1);
+	PLDM_THR_GROW(next, 1);
+	PLDM_THR_GROW(sensor_id, sizeof(u16));
+#undef PLDM_THR_GROW
+
+	t->cap = cap;
+	return 0;
+}
+
+/**
+ * pldm_thr_table_add() - Add a sensor from its numeric sensor PDR
+ *
+ * Return: Table index, or a negative errno
+ */
+static inline long pldm_thr_table_add(struct pldm_thr_table *t, const struct numeric_sensor_pdr *pdr)
+{
+	unsigned int size = pdr->sensor_data_size;
+	unsigned int bytes = pldm_data_size_bytes(size);
+	const u8 *ssd = (const u8 *)&pdr->ssd;
+	union sensor_value v;
+	u8 supported;
+	float res;
+	double h;
+	unsigned int k;
+	u32 i;
+
+	if (!bytes)
+		return -EINVAL;
+	if (t->n == t->cap && pldm_thr_table_grow(t))
+		return -ENOMEM;
+
+	/* supported_thresholds directly follows the size-dependent hysteresis field */
+	supported = ssd[bytes];
+	i = t->n++;
+	for (k = 0; k < PLDM_THRESHOLD_COUNT; k++) {
+		int upper = k <= PLDM_THRESHOLD_UPPER_FATAL;
+
+		if (!(supported & (1u << k))) {
+			t->thr[k][i] = upper ? INFINITY : -INFINITY;
+			continue;
+		}
+		memset(&v, 0, sizeof(v));
+		memcpy(&v, ssd + pldm_thr_ssd_offset(size, k), bytes);
+		t->thr[k][i] = (float)pldm_sensor_convert(pdr, v);
+	}
+
+	/* Hysteresis is an unsigned magnitude in raw units */
+	memset(&v, 0, sizeof(v));
+	memcpy(&v, ssd, bytes);
+	memcpy(&res, &pdr->resolution, sizeof(res));
+	h = fabs((bytes == 1 ? v.value_UINT8 : bytes == 2 ? v.value_UINT16 : v.value_UINT32) * (double)res *
+		 pldm_unit_scale(pdr->unit_modifier));
+	t->hyst[i] = (float)h;
+
+	t->value[i] = NAN;
+	t->level[i] = PLDM_THR_LEVEL_UNKNOWN;
+	t->next[i] = PLDM_THR_LEVEL_UNKNOWN;
+	t->sensor_id[i] = pdr->sensor_id;
+	return (long)i;
+}
+
+/* enum pldm_sensor_state for a level */
+static inline u8 pldm_thr_level_state(s8 level)
+{
+	static const u8 state[7] = {
+		PLDM_SENSOR_STATE_LOWER_FATAL, PLDM_SENSOR_STATE_LOWER_CRITICAL, PLDM_SENSOR_STATE_LOWER_WARNING,
+		PLDM_SENSOR_STATE_NORMAL,
+		PLDM_SENSOR_STATE_UPPER_WARNING, PLDM_SENSOR_STATE_UPPER_CRITICAL, PLDM_SENSOR_STATE_UPPER_FATAL,
+	};
+
+	if (level < -3 || level > 3)
+		return PLDM_SENSOR_STATE_UNKNOWN;
+	return state[level + 3];
+}
+
+static inline int pldm_thr_max(int a, int b)
+{
+	return a > b ? a : b;
+}
+
+static inline int pldm_thr_min(int a, int b)
+{
+	return a < b ? a : b;
+}
+
+/* Branch-free reference kernel: next[i] for i in [begin, end) */
+static inline void pldm_thr_kernel_scalar(struct pldm_thr_table *t, u32 begin, u32 end)
+{
+	const float *uw = t->thr[PLDM_THRESHOLD_UPPER_WARNING];
+	const float *uc = t->thr[PLDM_THRESHOLD_UPPER_CRITICAL];
+	const float *uf = t->thr[PLDM_THRESHOLD_UPPER_FATAL];
+	const float *lw = t->thr[PLDM_THRESHOLD_LOWER_WARNING];
+	const float *lc = t->thr[PLDM_THRESHOLD_LOWER_CRITICAL];
+	const float *lf = t->thr[PLDM_THRESHOLD_LOWER_FATAL];
+	u32 i;
+
+	for (i = begin; i < end; i++) {
+		float v = t->value[i], h = t->hyst[i];
+		int up = (v >= uw[i]) + (v >= uc[i]) + (v >= uf[i]);
+		int uph = (v >= uw[i] - h) + (v >= uc[i] - h) + (v >= uf[i] - h);
+		int dn = (v <= lw[i]) + (v <= lc[i]) + (v <= lf[i]);
+		int dnh = (v <= lw[i] + h) + (v <= lc[i] + h) + (v <= lf[i] + h);
+		int cur = t->level[i] == PLDM_THR_LEVEL_UNKNOWN ? 0 : t->level[i];
+		int nu = pldm_thr_max(up, pldm_thr_min(pldm_thr_max(cur, 0), uph));
+		int nd = pldm_thr_max(dn, pldm_thr_min(pldm_thr_max(-cur, 0), dnh));
+		int lvl = nu > 0 ? nu : -nd;
+
+		t->next[i] = (s8)(v != v ? PLDM_THR_LEVEL_UNKNOWN : lvl);
+	}
+}
+
+#ifdef PLDM_CONV_X86
+
+/* Number of thresholds in a, b, c that compare true, as a positive epi32 count */
+__attribute__((target("avx2")))
+static inline __m256i pldm_thr_count3(__m256 a, __m256 b, __m256 c)
+{
+	__m256i s = _mm256_add_epi32(_mm256_castps_si256(a), _mm256_castps_si256(b));
+
+	return _mm256_sub_epi32(_mm256_setzero_si256(), _mm256_add_epi32(s, _mm256_castps_si256(c)));
+}
+
+__attribute__((target("avx2")))
+static inline void pldm_thr_kernel_avx2(struct pldm_thr_table *t, u32 begin, u32 end)
+{
+	const float *uw = t->thr[PLDM_THRESHOLD_UPPER_WARNING];
+	const float *uc = t->thr[PLDM_THRESHOLD_UPPER_CRITICAL];
+	const float *uf = t->thr[PLDM_THRESHOLD_UPPER_FATAL];
+	const float *lw = t->thr[PLDM_THRESHOLD_LOWER_WARNING];
+	const float *lc = t->thr[PLDM_THRESHOLD_LOWER_CRITICAL];
+	const float *lf = t->thr[PLDM_THRESHOLD_LOWER_FATAL];
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i unknown = _mm256_set1_epi32(PLDM_THR_LEVEL_UNKNOWN);
+	u32 i;
+
+	for (i = begin; i + 8 <= end; i += 8) {
+		__m256 v = _mm256_loadu_ps(t->value + i);
+		__m256 h = _mm256_loadu_ps(t->hyst + i);
+		__m256 a = _mm256_loadu_ps(uw + i), b = _mm256_loadu_ps(uc + i), c = _mm256_loadu_ps(uf + i);
+		__m256 x = _mm256_loadu_ps(lw + i), y = _mm256_loadu_ps(lc + i), z = _mm256_loadu_ps(lf + i);
+		__m256i up, uph, dn, dnh, cur, nu, nd, lvl, nan;
+		__m128i packed;
+
+		up = pldm_thr_count3(_mm256_cmp_ps(v, a, _CMP_GE_OQ), _mm256_cmp_ps(v, b, _CMP_GE_OQ),
+				     _mm256_cmp_ps(v, c, _CMP_GE_OQ));
+		uph = pldm_thr_count3(_mm256_cmp_ps(v, _mm256_sub_ps(a, h), _CMP_GE_OQ),
+				      _mm256_cmp_ps(v, _mm256_sub_ps(b, h), _CMP_GE_OQ),
+				      _mm256_cmp_ps(v, _mm256_sub_ps(c, h), _CMP_GE_OQ));
+		dn = pldm_thr_count3(_mm256_cmp_ps(v, x, _CMP_LE_OQ), _mm256_cmp_ps(v, y, _CMP_LE_OQ),
+				     _mm256_cmp_ps(v, z, _CMP_LE_OQ));
+		dnh = pldm_thr_count3(_mm256_cmp_ps(v, _mm256_add_ps(x, h), _CMP_LE_OQ),
+				      _mm256_cmp_ps(v, _mm256_add_ps(y, h), _CMP_LE_OQ),
+				      _mm256_cmp_ps(v, _mm256_add_ps(z, h), _CMP_LE_OQ));
+
+		cur = _mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i *)(t->level + i)));
+		cur = _mm256_andnot_si256(_mm256_cmpeq_epi32(cur, unknown), cur);
+
+		nu = _mm256_max_epi32(up, _mm256_min_epi32(_mm256_max_epi32(cur, zero), uph));
+		nd = _mm256_max_epi32(dn, _mm256_min_epi32(_mm256_max_epi32(_mm256_sub_epi32(zero, cur), zero), dnh));
+		lvl = _mm256_blendv_epi8(_mm256_sub_epi32(zero, nd), nu, _mm256_cmpgt_epi32(nu, zero));
+		nan = _mm256_castps_si256(_mm256_cmp_ps(v, v, _CMP_UNORD_Q));
+		lvl = _mm256_blendv_epi8(lvl, unknown, nan);
+
+		/* Narrow eight epi32 lanes to eight bytes */
+		lvl = _mm256_packs_epi32(lvl, lvl);
+		lvl = _mm256_permute4x64_epi64(lvl, 0x08);
+		packed = _mm_packs_epi16(_mm256_castsi256_si128(lvl), _mm256_castsi256_si128(lvl));
+		_mm_storel_epi64((__m128i *)(t->next + i), packed);
+	}
+	pldm_thr_kernel_scalar(t, i, end);
+}
+
+#endif /* PLDM_CONV_X86 */
+
+/**
+ * pldm_thr_eval() - Evaluate every sensor and report state changes
+ * @t: Threshold table, with 'value' filled in
+ * @events: Event buffer
+ * @max: Size of @events
+ *
+ * If more sensors changed state than @events can hold, the remaining sensors keep
+ * their old state and are reported by the next call.
+ *
+ * Return: Number of events stored
+ */
+static inline unsigned int pldm_thr_eval(struct pldm_thr_table *t, struct pldm_thr_event *events, unsigned int max)
+{
+	unsigned int nev = 0;
+	u32 i;
+
+#ifdef PLDM_CONV_X86
+	if (t->isa == PLDM_CONV_ISA_AVX2)
+		pldm_thr_kernel_avx2(t, 0, t->n);
+	else
+#endif
+		pldm_thr_kernel_scalar(t, 0, t->n);
+
+	for (i = 0; i < t->n; i++) {
+		u64 a, b;
+
+		/* Skip unchanged sensors eight at a time */
+		if (i + 8 <= t->n && !(i & 7)) {
+			memcpy(&a, t->level + i, 8);
+			memcpy(&b, t->next + i, 8);
+			if (a == b) {
+				i += 7;
+				continue;
+			}
+		}
+		if (t->level[i] == t->next[i])
+			continue;
+		if (nev == max)
+			break;
+
+		events[nev].index = i;
+		events[nev].sensor_id = t->sensor_id[i];
+		events[nev].previous_state = pldm_thr_level_state(t->level[i]);
+		events[nev].present_state = pldm_thr_level_state(t->next[i]);
+		events[nev].event_state = events[nev].present_state;
+		nev++;
+		t->level[i] = t->next[i];
+	}
+	return nev;
+}
+
+#endif /* PLDM_THRESHOLD_H */
@@ -0,0 +1,65 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* The board profiles of cuc_board.hpp are compile-time tables: the checks are
+ * static_asserts, so this test fails to build rather than to run.
+ */
+
+#include "cuc_board.hpp"
+
+namespace {
+
+using namespace cuc::board;
+
+/* Targets come from the blob lists and the enum, not from the profiles themselves */
+static_assert(profile<sawtooth>::fw_targets.size() == common_fw_targets.size() + 1);
+static_assert(profile<sawtooth>::has_fw_target(FW_ISL68124_SAW));
+static_assert(!profile<sawtooth>::has_fw_target(FW_ISL68124_BRZ));
+static_assert(!profile<sawtooth>::has_fw_target(FW_NUM_ENTRIES));
+static_assert(profile<brazos>::regulator_mask == ((1u << FW_ISL68124_BRZ) | (1u << FW_IR38060_QSFP_BRZ)));
+static_assert(profile<washington>::mfpga_mask == 1u << FW_MFPGA_WAS);
+static_assert(profile<washington>::fw_target_mask ==
+	      (profile<washington>::regulator_mask | profile<washington>::mfpga_mask |
+	       (1u << FW_UC_APPLICATION) | (1u << FW_UC_BOOTLOADER) | (1u << FW_QSPI_BLOB) | (1u << FW_OPROM) |
+	       (1u << FW_CSR1) | (1u << FW_CSR2) | (1u << FW_SRDS)));
+static_assert(profile<pangani>::fw_targets.size() == common_fw_targets.size() && !profile<pangani>::regulator_mask);
+static_assert(profile<souhegan>::has_fw_target(FW_IR38063_2_SOU) && !profile<souhegan>::has_fw_target(FW_MFPGA_WAS));
+
+/* Generations agree with the C macros */
+static_assert(!profile<sawtooth>::cas2 && !profile<brazos>::cas2);
+static_assert(profile<kennebec>::cas2 && profile<souhegan>::cas2);
+
+/* Runtime lookup, evaluated at compile time */
+static_assert(infos.size() == CUC_BOARD_TYPE_SOUHEGAN + 1);
+static_assert(find(CUC_BOARD_TYPE_KENNEBEC)->regulator_mask == profile<kennebec>::regulator_mask);
+static_assert(find(CUC_BOARD_TYPE_UNKNOWN) == nullptr && find(CUC_BOARD_TYPE_SOUHEGAN + 1) == nullptr);
+static_assert(*dispatch(CUC_BOARD_TYPE_BRAZOS, [](auto p) { return decltype(p)::type; }) ==
+	      CUC_BOARD_TYPE_BRAZOS);
+static_assert(!dispatch(CUC_BOARD_TYPE_UNKNOWN, [](auto p) { return decltype(p)::type; }));
+
+constexpr unsigned int count_targets(int type)
+{
+	return *dispatch(type, [](auto p) {
+		unsigned int n = 0;
+
+		for_each_fw_target<decltype(p)>([&n](auto t) {
+			static_assert(decltype(p)::has_fw_target(decltype(t)::value));
+			n++;
+		});
+		return n;
+	});
+}
+static_assert(count_targets(CUC_BOARD_TYPE_SOUHEGAN) == profile<souhegan>::fw_targets.size());
+
+/* The NIC 1 events are only reported with a second NIC */
+static_assert(timing_mask(2) == (1u << TIMING_NUM_ENTRIES) - 1);
+static_assert(!(timing_mask(1) & (1u << TIMING_PCIE_LINK_UP_NIC_1)));
+static_assert(timing_mask(1) & (1u << TIMING_PCIE_LINK_UP_NIC_0));
+static_assert(!(timing_mask(1) & (1u << TIMING_PERST_NIC_1_N_DEASSERTED)));
+
+} /* namespace */
+
+int main()
+{
+	return 0;
+}
@@ -0,0 +1,233 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* Coroutine awaiters: a task resumes exactly once whether its requests complete
+ * inside submit or later, cancellation reaches a window of requests, and PLDM
+ * transactions take their instance IDs from the transport's requester.
+ */
+
+#include <cassert>
+#include <cstring>
+
+#include "cuc_co.hpp"
+#include "cuc_sim.h"
+
+namespace {
+
+using namespace cuc::co;
+
+constexpr unsigned int nreqs = 40;     /* More than the transport window */
+
+struct cuc_sim sim;
+struct cuc_xport_ops ops;
+struct cuc_xport x;
+struct cuc_xport_req reqs[nreqs];
+unsigned int resumed;
+int result;
+
+int failing_send(void *priv, const struct cuc_pkt *pkt)
+{
+	(void)priv;
+	(void)pkt;
+	return -EIO;
+}
+
+void setup(u32 latency_us)
+{
+	static struct cuc_sim_sensor ss;
+	struct cuc_sim_cmd_cfg cfg;
+
+	cuc_sim_init(&sim, CUC_BOARD_TYPE_WASHINGTON, 1, 2);
+	std::memset(&cfg, 0, sizeof(cfg));
+	cfg.latency_us = latency_us;
+	cuc_sim_set_cmd_cfg(&sim, -1, &cfg);
+	std::memset(&ss, 0, sizeof(ss));
+	ss.sensor_id = 1;
+	ss.data_size = PLDM_DATA_SIZE_UINT16;
+	ss.value.value_UINT16 = 1234;
+	cuc_sim_set_sensors(&sim, &ss, 1);
+	cuc_sim_xport_init(&x, &ops, &sim);
+	for (auto &r : reqs)
+		cuc_xport_req_init(&r, CUC_CMD_GET_FAN_RPM, nullptr, 0);
+	resumed = 0;
+	result = 1;
+}
+
+task<void> do_exec(loop &l, cancel_token *ct)
+{
+	result = co_await l.exec(&x, reqs[0], ct);
+	resumed++;
+}
+
+task<void> do_exec_all(loop &l, unsigned int n, cancel_token *ct)
+{
+	result = co_await l.exec_all(&x, reqs, n, ct);
+	resumed++;
+}
+
+task<void> do_cancel(cancel_token *ct)
+{
+	ct->cancel();
+	co_return;
+}
+
+task<void> do_pldm(loop &l, endpoint &ep)
+{
+	struct get_sensor_reading_rsp rsp;
+
+	result = co_await get_sensor_reading(l, ep, 1, rsp);
+	if (!result)
+		result = rsp.present_reading.value_UINT16;
+	resumed++;
+}
+
+task<void> do_readings(loop &l, endpoint &ep)
+{
+	struct get_sensor_reading_rsp rsp;
+	int rc;
+
+	for (int i = 0; i < 2; i++) {
+		rc = co_await get_sensor_reading(l, ep, 1, rsp);
+		if (!rc && rsp.present_reading.value_UINT16 == 1234)
+			resumed++;
+	}
+}
+
+task<void> do_cancel_after(loop &l, u64 us, cancel_token *ct)
+{
+	co_await l.sleep_for(us);
+	ct->cancel();
+}
+
+task<void> do_pldm_cancel(loop &l, endpoint &ep, cancel_token *ct)
+{
+	struct get_sensor_reading_rsp rsp;
+
+	result = co_await get_sensor_reading(l, ep, 1, rsp, ct);
+	resumed++;
+}
+
+/* Requests that fail inside submit resume their task once, and leave no cancel entry */
+void test_sync_completion()
+{
+	cancel_token ct;
+	loop l;
+
+	setup(0);
+	ops.send = failing_send;
+	l.add(&x);
+	l.spawn(do_exec(l, &ct));
+	assert(l.run() == 0 && resumed == 1 && result == -EIO);
+	assert(ct.empty());
+
+	setup(0);
+	ops.send = failing_send;
+	l.spawn(do_exec_all(l, 3, &ct));
+	assert(l.run() == 0 && resumed == 1 && result == -EIO);
+	assert(ct.empty());
+}
+
+/* A request the transport still holds is refused without being touched */
+void test_busy()
+{
+	struct cuc_xport_req *one = &reqs[1];
+	loop l;
+
+	setup(100);
+	assert(cuc_xport_submit(&x, &one, 1) == 1);
+	l.add(&x);
+	l.spawn(do_exec_all(l, 2, nullptr));
+	assert(l.run() == 0 && resumed == 1 && result == -EBUSY);
+	assert(reqs[0].state == CUC_XPORT_REQ_IDLE && !reqs[1].done && !reqs[1].priv);
+	assert(cuc_xport_wait(&x, &reqs[1]) == 0);
+}
+
+/* Cancelling completes the unsent requests of the window and the rest when answered */
+void test_exec_all_cancel()
+{
+	cancel_token ct;
+	loop l;
+
+	setup(1000);
+	l.add(&x);
+	l.spawn(do_exec_all(l, nreqs, &ct));
+	l.spawn(do_cancel(&ct));
+	assert(l.run() == 0 && resumed == 1 && result == -ECANCELED);
+	for (auto &r : reqs)
+		assert(r.status == -ECANCELED && r.state == CUC_XPORT_REQ_IDLE);
+	assert(ct.empty() && cuc_xport_idle(&x));
+}
+
+/* Instance IDs come from the requester; with all of them quarantined there is none */
+void test_pldm_ids()
+{
+	struct pldm_requester rq;
+	unsigned int i;
+	loop l;
+
+	setup(0);
+	pldm_rq_init(&rq, &x);
+	endpoint ep(&rq);
+	l.add(&x);
+	l.spawn(do_pldm(l, ep));
+	assert(l.run() == 0 && resumed == 1 && result == 1234);
+	assert(rq.free_ids == ~(u32)0);
+
+	for (i = 0; i < PLDM_RQ_NUM_IDS; i++)
+		assert(pldm_rq_get_iid(&rq) >= 0);
+	for (i = 0; i < PLDM_RQ_NUM_IDS; i++)
+		pldm_rq_put_iid(&rq, (u8)i, -ETIMEDOUT);
+	l.spawn(do_pldm(l, ep));
+	assert(l.run() == 0 && resumed == 2 && result == -EAGAIN);
+}
+
+/* More tasks than IDs: a freed ID goes to the task that waited for it, not to the next asker */
+void test_pldm_id_handoff()
+{
+	struct pldm_requester rq;
+	loop l;
+
+	setup(200);
+	pldm_rq_init(&rq, &x);
+	endpoint ep(&rq);
+	l.add(&x);
+	for (unsigned int i = 0; i < PLDM_RQ_NUM_IDS + 1; i++)
+		l.spawn(do_readings(l, ep));
+	assert(l.run() == 0 && resumed == 2 * (PLDM_RQ_NUM_IDS + 1));
+	assert(rq.free_ids == ~(u32)0 && !ep.iid_head);
+}
+
+/* An ID is quarantined if its request was cancelled on the wire, not if before */
+void test_pldm_cancel()
+{
+	struct pldm_requester rq;
+	cancel_token ct, early;
+	loop l;
+
+	setup(2000);
+	pldm_rq_init(&rq, &x);
+	endpoint ep(&rq);
+	l.add(&x);
+	l.spawn(do_pldm_cancel(l, ep, &ct));
+	l.spawn(do_cancel_after(l, 500, &ct));
+	assert(l.run() == 0 && resumed == 1 && result == -ECANCELED);
+	assert(rq.quarantined == 1u && rq.timeouts == 1 && rq.free_ids == ~(u32)1);
+
+	early.cancel();
+	l.spawn(do_pldm_cancel(l, ep, &early));
+	assert(l.run() == 0 && resumed == 2 && result == -ECANCELED);
+	assert(rq.timeouts == 1 && sim.requests[CUC_CMD_PLDM] == 1);
+}
+
+} /* namespace */
+
+int main()
+{
+	test_sync_completion();
+	test_busy();
+	test_exec_all_cancel();
+	test_pldm_ids();
+	test_pldm_id_handoff();
+	test_pldm_cancel();
+	return 0;
+}
@@ -0,0 +1,227 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* Entity tree: every entity named by a record is placed, entities contained only
+ * in each other (a cycle with no root) fail the build and the update, and an
+ * update gives the tree a full build would, whether it splices or not.
+ */
+
+#include <assert.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "pldm_entity.h"
+
+static const char path[] = "entity_test.cache";
+static u8 repo[4096];
+static size_t repo_len;
+static u32 next_handle;
+static u16 changes[16];            /* Changes made to each record since the first version */
+
+static const struct pldm_entity_id board = { 64, 1, 0 };
+static const struct pldm_entity_id nic = { 66, 1, 1 };
+static const struct pldm_entity_id cage = { 185, 1, 2 };
+static const struct pldm_entity_id x = { 120, 1, 7 };
+static const struct pldm_entity_id y = { 120, 2, 7 };
+static const struct pldm_entity_id shelf = { 64, 2, 0 };
+static const struct pldm_entity_id fan = { 29, 1, 3 };
+static const struct pldm_entity_id psu = { 120, 5, 3 };
+
+static void hdr(struct pdr_hdr *h, u8 type, size_t length)
+{
+	h->record_handle = next_handle++;
+	h->pdr_header_version = 1;
+	h->pdr_type = type;
+	h->record_change_number = (u16)(1 + changes[h->record_handle % 16]);
+	h->data_length = (u16)(length - sizeof(*h));
+}
+
+static void add_assoc_n(const struct pldm_entity_id *container, const struct pldm_entity_id *const *child,
+			u8 n)
+{
+	struct entity_association_pdr *a = (struct entity_association_pdr *)(repo + repo_len);
+	size_t length = sizeof(*a) + n * sizeof(a->contained[0]);
+	u8 i;
+
+	memset(a, 0, length);
+	hdr(&a->hdr, PLDM_PDR_ENTITY_ASSOCIATION, length);
+	a->association_type = PLDM_ENTITY_ASSOCIATION_PHYSICAL;
+	a->container = *container;
+	a->contained_entity_count = n;
+	for (i = 0; i < n; i++)
+		a->contained[i] = *child[i];
+	repo_len += length;
+}
+
+static void add_assoc(const struct pldm_entity_id *container, const struct pldm_entity_id *child)
+{
+	add_assoc_n(container, &child, 1);
+}
+
+static void add_sensor(u16 sensor_id, const struct pldm_entity_id *id)
+{
+	struct numeric_sensor_pdr p;
+	size_t length = offsetof(struct numeric_sensor_pdr, ssd) + sizeof(struct numeric_sensor_ssd16);
+
+	memset(&p, 0, sizeof(p));
+	hdr(&p.hdr, PLDM_PDR_NUMERIC_SENSOR, length);
+	p.sensor_id = sensor_id;
+	p.entity_type = id->entity_type;
+	p.entity_instance_number = id->entity_instance_number;
+	p.container_id = id->container_id;
+	p.sensor_data_size = PLDM_DATA_SIZE_UINT16;
+	memcpy(repo + repo_len, &p, length);
+	repo_len += length;
+}
+
+static void open_cache(struct pldm_pdr_cache *c)
+{
+	struct pldm_pdr_cache_key key;
+
+	memset(&key, 0, sizeof(key));
+	assert(pldm_pdr_cache_write(path, &key, repo, repo_len) == 0);
+	assert(pldm_pdr_cache_open(c, path, &key) == 0);
+}
+
+static void hierarchy(int cycle)
+{
+	repo_len = 0;
+	next_handle = 1;
+	add_assoc(&board, &nic);
+	add_assoc(&nic, &cage);
+	add_sensor(1, &cage);
+	add_sensor(2, &x);
+	if (cycle) {
+		add_assoc(&x, &y);
+		add_assoc(&y, &x);
+	}
+}
+
+/* The tree an update produced is the one a full build gives */
+static void check_same(const struct pldm_entity_tree *t, const struct pldm_pdr_cache *c)
+{
+	struct pldm_entity_tree full;
+	u32 i;
+
+	assert(pldm_entity_tree_build(&full, c) == 0);
+	assert(t->nnodes == full.nnodes && t->nsensors == full.nsensors);
+	for (i = 0; i < t->nnodes; i++) {
+		const struct pldm_entity_node *a = &t->node[i], *b = &full.node[i];
+
+		assert(!pldm_entity_id_cmp(&a->id, &b->id) && a->parent == b->parent && a->size == b->size);
+		assert(a->sensor_begin == b->sensor_begin && a->sensor_end == b->sensor_end && a->nown == b->nown);
+	}
+	for (i = 0; i < t->nsensors; i++)
+		assert(t->sensor[i].sensor_id == full.sensor[i].sensor_id &&
+		       t->sensor[i].numeric_idx == full.sensor[i].numeric_idx);
+	for (i = 0; i < t->nnodes; i++)
+		assert(pldm_entity_find(t, &t->node[i].id) == i);
+	pldm_entity_tree_fini(&full);
+}
+
+/*
+ * board holds nic and 'board_has' (if not NULL); shelf holds the fan and psu, and
+ * the psu has sensor 3. The board's record is handle 1, the psu's sensor handle 5.
+ */
+static void two_roots(const struct pldm_entity_id *board_has)
+{
+	const struct pldm_entity_id *on_board[2] = { &nic, board_has };
+	const struct pldm_entity_id *on_shelf[2] = { &fan, &psu };
+
+	repo_len = 0;
+	next_handle = 1;
+	add_assoc_n(&board, on_board, board_has ? 2 : 1);
+	add_assoc(&nic, &cage);
+	add_assoc_n(&shelf, on_shelf, 2);
+	add_sensor(1, &cage);
+	add_sensor(3, &psu);
+}
+
+static void test_update(void)
+{
+	struct pldm_entity_tree t;
+	struct pldm_pdr_cache c;
+	u32 n, i;
+
+	/* The board gains a new entity: only its subtree is rebuilt and spliced */
+	memset(changes, 0, sizeof(changes));
+	two_roots(NULL);
+	open_cache(&c);
+	assert(pldm_entity_tree_build(&t, &c) == 0 && t.nnodes == 6);
+	pldm_pdr_cache_close(&c);
+	changes[1]++;
+	two_roots(&x);
+	open_cache(&c);
+	assert(pldm_entity_tree_update(&t, &c) == 0);
+	assert(t.nnodes == 7 && t.rebuilt == 4);
+	assert(t.node[pldm_entity_find(&t, &x)].parent == pldm_entity_find(&t, &board));
+	check_same(&t, &c);
+	pldm_pdr_cache_close(&c);
+
+	/* A sensor record changes: its entity alone is rebuilt */
+	changes[5]++;
+	two_roots(&x);
+	open_cache(&c);
+	assert(pldm_entity_tree_update(&t, &c) == 0 && t.rebuilt == 1);
+	check_same(&t, &c);
+	pldm_pdr_cache_close(&c);
+	pldm_entity_tree_fini(&t);
+
+	/*
+	 * The psu is in both containers and placed on the board. Once the board lets
+	 * go of it, it belongs on the shelf, whose subtree did not change.
+	 */
+	memset(changes, 0, sizeof(changes));
+	two_roots(&psu);
+	open_cache(&c);
+	assert(pldm_entity_tree_build(&t, &c) == 0 && t.nnodes == 6);
+	assert(t.node[pldm_entity_find(&t, &psu)].parent == pldm_entity_find(&t, &board));
+	pldm_pdr_cache_close(&c);
+	changes[1]++;
+	two_roots(NULL);
+	open_cache(&c);
+	assert(pldm_entity_tree_update(&t, &c) == 0 && t.nnodes == 6);
+	i = pldm_entity_find(&t, &psu);
+	assert(i != PLDM_ENTITY_NONE && t.node[i].parent == pldm_entity_find(&t, &shelf));
+	assert(pldm_entity_sensors(&t, pldm_entity_find(&t, &shelf), &n)->sensor_id == 3 && n == 1);
+	check_same(&t, &c);
+	pldm_pdr_cache_close(&c);
+
+	/* And back: the board takes it again, and it must leave the shelf */
+	changes[1]++;
+	two_roots(&psu);
+	open_cache(&c);
+	assert(pldm_entity_tree_update(&t, &c) == 0 && t.nnodes == 6);
+	assert(t.node[pldm_entity_find(&t, &psu)].parent == pldm_entity_find(&t, &board));
+	assert(!pldm_entity_sensors(&t, pldm_entity_find(&t, &shelf), &n) || n == 0);
+	check_same(&t, &c);
+	pldm_pdr_cache_close(&c);
+	pldm_entity_tree_fini(&t);
+}
+
+int main(void)
+{
+	struct pldm_entity_tree t;
+	struct pldm_pdr_cache c;
+	u32 n;
+
+	hierarchy(0);
+	open_cache(&c);
+	assert(pldm_entity_tree_build(&t, &c) == 0);
+	/* board > nic > cage, and x on its own */
+	assert(t.nnodes == 4);
+	assert(pldm_entity_sensors(&t, pldm_entity_find(&t, &board), &n)->sensor_id == 1 && n == 1);
+	pldm_pdr_cache_close(&c);
+
+	/* x and y only contain each other; no tree can place them */
+	hierarchy(1);
+	open_cache(&c);
+	assert(pldm_entity_tree_update(&t, &c) == -ELOOP);
+	assert(t.nnodes == 0);
+	assert(pldm_entity_tree_build(&t, &c) == -ELOOP);
+	pldm_pdr_cache_close(&c);
+
+	test_update();
+	unlink(path);
+	return 0;
+}
@@ -0,0 +1,183 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* FRU index: fields of every record set are found by type, the first of duplicate
+ * fields wins, and tables with a truncated or oversized record or field, too many
+ * record sets, or non-zero padding are rejected.
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "pldm_fru.h"
+
+static u8 table[PLDM_FRU_MAX_TABLE + 1];
+static size_t table_len;
+static struct pldm_fru_record *rec;
+
+static void reset(void)
+{
+	memset(table, 0, sizeof(table));
+	table_len = 0;
+	rec = NULL;
+}
+
+static void add_record(u16 set, u8 type, u8 encoding)
+{
+	rec = (struct pldm_fru_record *)(table + table_len);
+	rec->record_set_id = set;
+	rec->record_type = type;
+	rec->num_fields = 0;
+	rec->field_encoding = encoding;
+	table_len += sizeof(*rec);
+}
+
+static void add_field_len(u8 type, const char *value, u8 len)
+{
+	struct pldm_fru_field *f = (struct pldm_fru_field *)(table + table_len);
+
+	f->field_type = type;
+	f->length = len;
+	memcpy(f->value, value, strlen(value));
+	table_len += sizeof(*f) + len;
+	rec->num_fields++;
+}
+
+static void add_field(u8 type, const char *value)
+{
+	add_field_len(type, value, (u8)strlen(value));
+}
+
+static int build(struct pldm_fru_index *ix)
+{
+	return pldm_fru_index_build(ix, table, table_len);
+}
+
+static int str_eq(struct pldm_fru_str v, const char *s)
+{
+	return v.s && v.len == strlen(s) && !memcmp(v.s, s, v.len);
+}
+
+static void test_lookup(void)
+{
+	struct pldm_fru_index ix;
+	const struct pldm_fru_set *set;
+	struct pldm_fru_str v;
+	char buf[8];
+
+	reset();
+	add_record(1, PLDM_FRU_RECORD_GENERAL, PLDM_FRU_ENCODING_ASCII);
+	add_field(PLDM_FRU_FIELD_SERIAL_NUMBER, "SN0001");
+	add_field(PLDM_FRU_FIELD_PART_NUMBER, "P12345-001");
+	add_field(PLDM_FRU_FIELD_SERIAL_NUMBER, "SN-duplicate");
+	add_field(PLDM_FRU_FIELD_NAME, "");
+	add_field(200, "not indexed");
+	add_record(2, PLDM_FRU_RECORD_GENERAL, PLDM_FRU_ENCODING_UTF8);
+	add_field(PLDM_FRU_FIELD_SERIAL_NUMBER, "SN0002");
+	add_record(1, PLDM_FRU_RECORD_OEM, PLDM_FRU_ENCODING_UTF8);
+	add_field(1, "oem one");
+	add_record(1, 3, PLDM_FRU_ENCODING_ASCII);           /* Neither General nor OEM */
+	add_field(PLDM_FRU_FIELD_MODEL, "other record");
+	add_record(1, PLDM_FRU_RECORD_GENERAL, PLDM_FRU_ENCODING_ASCII);
+	add_field(PLDM_FRU_FIELD_MODEL, "second general");
+	table_len += 3;                                        /* Padding to a multiple of 4 */
+
+	assert(build(&ix) == 0);
+	assert(ix.nrecords == 5 && ix.nfields == 9 && ix.nsets == 2);
+	assert(ix.set[0].record_set_id == 1 && ix.set[1].record_set_id == 2);
+
+	v = pldm_fru_general(&ix, PLDM_FRU_FIELD_SERIAL_NUMBER);
+	assert(str_eq(v, "SN0001") && v.encoding == PLDM_FRU_ENCODING_ASCII);
+	assert((const u8 *)v.s > table && (const u8 *)v.s < table + table_len);
+	assert(str_eq(pldm_fru_general(&ix, PLDM_FRU_FIELD_PART_NUMBER), "P12345-001"));
+	v = pldm_fru_general(&ix, PLDM_FRU_FIELD_NAME);
+	assert(v.s && v.len == 0);
+	assert(!pldm_fru_general(&ix, PLDM_FRU_FIELD_SKU).s);
+	assert(!pldm_fru_general(&ix, 200).s);
+
+	/* Later records of a set add fields it did not have; the record type not indexed adds none */
+	assert(str_eq(pldm_fru_general(&ix, PLDM_FRU_FIELD_MODEL), "second general"));
+
+	set = pldm_fru_set_find(&ix, 2);
+	assert(set == &ix.set[1]);
+	v = pldm_fru_lookup(&ix, set, PLDM_FRU_RECORD_GENERAL, PLDM_FRU_FIELD_SERIAL_NUMBER);
+	assert(str_eq(v, "SN0002") && v.encoding == PLDM_FRU_ENCODING_UTF8);
+	assert(!pldm_fru_lookup(&ix, set, PLDM_FRU_RECORD_OEM, 1).s);
+
+	set = pldm_fru_set_find(&ix, 1);
+	v = pldm_fru_lookup(&ix, set, PLDM_FRU_RECORD_OEM, 1);
+	assert(str_eq(v, "oem one") && v.encoding == PLDM_FRU_ENCODING_UTF8);
+	assert(!pldm_fru_lookup(&ix, set, 3, PLDM_FRU_FIELD_MODEL).s);
+	assert(!pldm_fru_lookup(&ix, NULL, PLDM_FRU_RECORD_GENERAL, PLDM_FRU_FIELD_MODEL).s);
+	assert(!pldm_fru_set_find(&ix, 3));
+
+	/* Copies are NUL terminated and truncated to the buffer */
+	v = pldm_fru_general(&ix, PLDM_FRU_FIELD_PART_NUMBER);
+	assert(pldm_fru_str_copy(v, buf, sizeof(buf)) == 10 && !strcmp(buf, "P12345-"));
+	assert(pldm_fru_str_copy(v, buf, 0) == 10);
+	v = pldm_fru_general(&ix, PLDM_FRU_FIELD_SERIAL_NUMBER);
+	assert(pldm_fru_str_copy(v, buf, sizeof(buf)) == 6 && !strcmp(buf, "SN0001"));
+
+	/* An empty table has no sets */
+	assert(pldm_fru_index_build(&ix, table, 0) == 0 && !ix.nsets);
+	assert(!pldm_fru_general(&ix, PLDM_FRU_FIELD_SERIAL_NUMBER).s);
+}
+
+static void test_malformed(void)
+{
+	struct pldm_fru_index ix;
+	size_t full;
+	unsigned int i;
+
+	reset();
+	add_record(1, PLDM_FRU_RECORD_GENERAL, PLDM_FRU_ENCODING_ASCII);
+	add_field(PLDM_FRU_FIELD_SERIAL_NUMBER, "SN0001");
+	add_field(PLDM_FRU_FIELD_MODEL, "model");
+	full = table_len;
+	assert(build(&ix) == 0);
+
+	/* Every truncation that cuts into the record is caught */
+	for (table_len = 4; table_len < full; table_len++)
+		assert(build(&ix) == -EPROTO);
+
+	/* A field longer than what is left of the table */
+	table_len = full;
+	add_record(2, PLDM_FRU_RECORD_GENERAL, PLDM_FRU_ENCODING_ASCII);
+	add_field_len(PLDM_FRU_FIELD_MODEL, "x", 200);
+	table_len -= 199;
+	assert(build(&ix) == -EPROTO);
+
+	/* A record that claims more fields than it has */
+	table_len = full;
+	add_record(2, PLDM_FRU_RECORD_GENERAL, PLDM_FRU_ENCODING_ASCII);
+	add_field(PLDM_FRU_FIELD_MODEL, "m");
+	rec->num_fields = 2;
+	assert(build(&ix) == -EPROTO);
+	rec->num_fields = 1;
+	assert(build(&ix) == 0 && ix.nsets == 2);
+
+	/* Padding is up to three zero bytes */
+	table_len += 3;
+	assert(build(&ix) == 0);
+	table[table_len - 1] = 1;
+	assert(build(&ix) == -EPROTO);
+	table[table_len - 1] = 0;
+	table_len += 1;
+	assert(build(&ix) == -EPROTO);
+
+	/* Too many record sets, and a table larger than the format allows */
+	reset();
+	for (i = 0; i <= PLDM_FRU_MAX_SETS; i++) {
+		add_record((u16)(i + 1), PLDM_FRU_RECORD_GENERAL, PLDM_FRU_ENCODING_ASCII);
+		add_field(PLDM_FRU_FIELD_SERIAL_NUMBER, "SN");
+		assert(build(&ix) == (i < PLDM_FRU_MAX_SETS ? 0 : -ENOSPC));
+	}
+	assert(pldm_fru_index_build(&ix, table, PLDM_FRU_MAX_TABLE + 1) == -EINVAL);
+}
+
+int main(void)
+{
+	test_lookup();
+	test_malformed();
+	return 0;
+}
@@ -0,0 +1,100 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* Firmware inventory: a finished update drops the entries of the slot it wrote, and
+ * responses to queries issued before an invalidation are not cached.
+ */
+
+#include <assert.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "cuc_fwu.h"
+#include "cuc_sim.h"
+
+static struct cuc_sim sim;
+static struct cuc_xport_ops ops;
+static struct cuc_xport x;
+static struct cuc_fw_inv inv;
+
+static void setup(void)
+{
+	cuc_sim_init(&sim, CUC_BOARD_TYPE_WASHINGTON, 1, 2);
+	cuc_sim_set_fw_version(&sim, FW_UC_APPLICATION, 0, CUC_SIM_FW_RUNNING, "1.0");
+	cuc_sim_set_fw_version(&sim, FW_UC_APPLICATION, 0, CUC_SIM_FW_FLASH_SLOT0, "1.0");
+	cuc_sim_set_fw_version(&sim, FW_UC_APPLICATION, 0, CUC_SIM_FW_FLASH_SLOT1, "0.9");
+	cuc_sim_xport_init(&x, &ops, &sim);
+	cuc_fw_inv_init(&inv, &x, 2);
+}
+
+static const char *version(unsigned int nic, unsigned int copy)
+{
+	const struct cuc_fw_inv_entry *e = cuc_fw_inv_get(&inv, FW_UC_APPLICATION, nic, copy);
+
+	return e->state == CUC_FW_INV_VALID ? e->version : NULL;
+}
+
+static void test_update_invalidates_slot(void)
+{
+	static const char path[] = "fw_inventory_test.img";
+	static u8 buf[4096];
+	struct cuc_fwu_image img;
+	struct cuc_fwu_job job;
+	struct cuc_fwu f;
+	unsigned long queries;
+	int fd;
+
+	setup();
+	assert(cuc_fw_inv_refresh(&inv) == 0);
+	assert(!strcmp(version(0, CUC_FW_INV_SLOT0), "1.0"));
+
+	fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	assert(fd >= 0 && write(fd, buf, sizeof(buf)) == (ssize_t)sizeof(buf));
+	close(fd);
+	assert(cuc_fwu_image_open(&img, path) == 0);
+	cuc_sim_set_fwu_image_version(&sim, FW_UC_APPLICATION, "2.0");
+
+	cuc_fwu_init(&f, 1);
+	cuc_fwu_job_init(&job, &x, &img, 0, FW_SLOT_0);
+	job.inv = &inv;
+	assert(cuc_fwu_add(&f, &job) == 0);
+	cuc_fwu_run(&f);
+	assert(job.status == 0);
+
+	/* Only the rewritten slot is queried again */
+	assert(!version(0, CUC_FW_INV_SLOT0) && !strcmp(version(0, CUC_FW_INV_SLOT1), "0.9"));
+	assert(!strcmp(version(0, CUC_FW_INV_RUNNING), "1.0"));
+	queries = inv.queries;
+	assert(cuc_fw_inv_refresh(&inv) == 0);
+	assert(inv.queries - queries == inv.ntargets);
+	assert(!strcmp(version(0, CUC_FW_INV_SLOT0), "2.0"));
+
+	cuc_fwu_image_close(&img);
+	unlink(path);
+}
+
+static void test_invalidate_in_flight(void)
+{
+	setup();
+	assert(cuc_fw_inv_set_board_type(&inv, CUC_BOARD_TYPE_WASHINGTON) == 0);
+	cuc_fw_inv_start(&inv);
+	assert(inv.inflight);
+	/* The uC resets into new firmware while the old running versions are being read */
+	cuc_sim_set_fw_version(&sim, FW_UC_APPLICATION, 0, CUC_SIM_FW_RUNNING, "1.1");
+	cuc_fw_inv_intr(&inv, 0, ATT1_UC_RESET);
+	while (inv.inflight)
+		assert(cuc_xport_progress(&x, CUC_XPORT_DEFAULT_TIMEOUT_US) >= 0);
+	assert(inv.err == -EAGAIN && inv.dropped == CUC_FW_INV_DEPTH);
+	assert(!version(0, CUC_FW_INV_RUNNING) && !strcmp(version(0, CUC_FW_INV_SLOT0), "1.0"));
+
+	assert(cuc_fw_inv_refresh(&inv) == 0);
+	assert(!strcmp(version(0, CUC_FW_INV_RUNNING), "1.1"));
+}
+
+int main(void)
+{
+	test_update_invalidates_slot();
+	test_invalidate_in_flight();
+	return 0;
+}
@@ -0,0 +1,171 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* Firmware update checkpoints: a job stopped with every chunk acknowledged resumes
+ * where it stopped, a record left mid-segment or written for other image bytes is
+ * not trusted, and a uC still busy with the abandoned update is reset before the new
+ * one starts.
+ */
+
+#include <assert.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "cuc_fwu.h"
+#include "cuc_sim.h"
+
+#define IMAGE_SIZE  (200 * 1000)
+
+static const char image_path[] = "fwu_test.img";
+static const char ckpt_path[] = "fwu_test.ckpt";
+
+static struct cuc_sim sim;
+static struct cuc_xport_ops ops;
+static struct cuc_xport x;
+static struct cuc_fwu_image img;
+static struct cuc_fwu f;
+
+static void make_image(void)
+{
+	static u8 buf[IMAGE_SIZE];
+	unsigned int i;
+	int fd;
+
+	for (i = 0; i < IMAGE_SIZE; i++)
+		buf[i] = (u8)(i * 7 + (i >> 8));
+	fd = open(image_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	assert(fd >= 0);
+	assert(write(fd, buf, sizeof(buf)) == (ssize_t)sizeof(buf));
+	close(fd);
+	assert(cuc_fwu_image_open(&img, image_path) == 0);
+}
+
+static void read_ckpt(struct cuc_fwu_ckpt *c)
+{
+	int fd = open(ckpt_path, O_RDONLY);
+
+	assert(fd >= 0);
+	assert(pread(fd, c, sizeof(*c), 0) == (ssize_t)sizeof(*c));
+	close(fd);
+}
+
+static void write_ckpt(const struct cuc_fwu_ckpt *c)
+{
+	int fd = open(ckpt_path, O_WRONLY);
+
+	assert(fd >= 0);
+	assert(pwrite(fd, c, sizeof(*c), 0) == (ssize_t)sizeof(*c));
+	close(fd);
+}
+
+/* Run a job until 'stop_at' bytes are acknowledged, then make it time out */
+static void interrupt(struct cuc_fwu_job *job, u32 stop_at)
+{
+	cuc_fwu_job_init(job, &x, &img, 0, FW_SLOT_0);
+	job->ckpt_path = ckpt_path;
+	assert(cuc_fwu_add(&f, job) == 0);
+	while (job->acked < stop_at)
+		assert(cuc_fwu_step(&f, 1000));
+	job->timeout_us = 1;
+	while (cuc_fwu_step(&f, 1000))
+		;
+	assert(job->status == -ETIMEDOUT);
+	assert(sim.fwu_status == FWU_STATUS_DOWNLOADING && sim.fwu_received == job->acked);
+}
+
+static void test_resume(void)
+{
+	struct cuc_fwu_job job;
+	struct cuc_fwu_ckpt c;
+	u32 acked;
+
+	interrupt(&job, 100 * 1000);
+	acked = job.acked;
+	read_ckpt(&c);
+	assert(c.acked == acked && c.sent == acked);
+
+	job.timeout_us = 0;
+	assert(cuc_fwu_add(&f, &job) == 0);
+	assert(cuc_fwu_run(&f) == 0);
+	assert(job.status == 0 && job.resumed && job.resume_offset == acked && !job.reset);
+	assert(sim.fwu_status == FWU_STATUS_SUCCESS && sim.fwu_received == IMAGE_SIZE);
+	assert(f.bytes_saved == acked);
+	assert(access(ckpt_path, F_OK) < 0);
+}
+
+static void test_mid_segment(void)
+{
+	struct cuc_fwu_job job;
+	struct cuc_fwu_ckpt c;
+
+	/* What a crash leaves behind: the uC may hold anything up to 'sent' */
+	interrupt(&job, 100 * 1000);
+	read_ckpt(&c);
+	c.sent = c.acked + 10 * CUC_DATA_BYTES;
+	write_ckpt(&c);
+
+	job.timeout_us = 0;
+	assert(cuc_fwu_add(&f, &job) == 0);
+	assert(cuc_fwu_run(&f) == 0);
+	assert(job.status == 0 && !job.resumed && job.reset);
+	assert(sim.fwu_status == FWU_STATUS_SUCCESS && sim.fwu_received == IMAGE_SIZE);
+	assert(access(ckpt_path, F_OK) < 0);
+}
+
+/* A checkpoint of another image of the same size */
+static void test_other_image(void)
+{
+	struct cuc_fwu_job job;
+	struct cuc_fwu_ckpt c;
+
+	interrupt(&job, 50 * 1000);
+	read_ckpt(&c);
+	assert(c.acked == c.sent && c.acked == job.acked);
+	c.acked_sum ^= 1;
+	write_ckpt(&c);
+
+	job.timeout_us = 0;
+	assert(cuc_fwu_add(&f, &job) == 0);
+	assert(cuc_fwu_run(&f) == 0);
+	assert(job.status == 0 && !job.resumed && job.reset);
+	assert(sim.fwu_received == IMAGE_SIZE);
+}
+
+static void test_busy_without_checkpoint(void)
+{
+	struct cuc_fwu_job job;
+
+	interrupt(&job, 10 * 1000);
+	unlink(ckpt_path);
+
+	/* Nothing says the update in progress is ours: leave it alone */
+	cuc_fwu_job_init(&job, &x, &img, 0, FW_SLOT_0);
+	assert(cuc_fwu_add(&f, &job) == 0);
+	assert(cuc_fwu_run(&f) == 1);
+	assert(job.status == -EBUSY && !job.reset);
+	assert(sim.fwu_status == FWU_STATUS_DOWNLOADING);
+}
+
+int main(void)
+{
+	struct cuc_sim_cmd_cfg cfg;
+
+	cuc_sim_init(&sim, CUC_BOARD_TYPE_WASHINGTON, 1, 2);
+	memset(&cfg, 0, sizeof(cfg));
+	cfg.latency_us = 20;
+	cuc_sim_set_cmd_cfg(&sim, -1, &cfg);
+	cuc_sim_xport_init(&x, &ops, &sim);
+	cuc_fwu_init(&f, 1);
+	make_image();
+
+	test_resume();
+	test_mid_segment();
+	test_other_image();
+	test_busy_without_checkpoint();
+
+	cuc_fwu_image_close(&img);
+	unlink(image_path);
+	return 0;
+}
@@ -0,0 +1,274 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* Bulk I2C: segments are merged into as few transactions as possible, writes are
+ * cut at page and redirect half boundaries, out-of-range segments are rejected,
+ * transport errors reach the segments they concern, and a transaction slot still
+ * held by the transport is never rebuilt.
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "cuc_i2c_bulk.h"
+#include "cuc_sim.h"
+
+#define EEPROM_SIZE  0x10000
+#define PAGE         64
+#define MAX_XFERS    256
+
+struct xfer {
+	u8 cmd;
+	u8 bus;
+	u8 type;                   /* Reads only */
+	u32 offset;                /* Writes: from the offset bytes */
+	u32 len;
+};
+
+static struct cuc_sim sim;
+static struct cuc_xport_ops ops;
+static struct cuc_xport x;
+static struct cuc_i2c_bulk b;
+static u8 image[EEPROM_SIZE];
+static u8 buf[2][EEPROM_SIZE];
+static u8 qsfp[256];
+static unsigned int sends_left;
+static struct xfer xfers[MAX_XFERS];
+static unsigned int nxfers;
+
+static void observe(void *ctx, const struct cuc_xport_req *r)
+{
+	struct xfer *t = &xfers[nxfers % MAX_XFERS];
+
+	(void)ctx;
+	t->cmd = r->req.cmd;
+	if (r->req.cmd == CUC_CMD_I2C_READ) {
+		struct cuc_i2c_read_req rq;
+
+		memcpy(&rq, r->req.data, sizeof(rq));
+		t->bus = rq.bus;
+		t->type = rq.type;
+		t->offset = rq.offset;
+		t->len = rq.count;
+	} else {
+		const struct cuc_i2c_write_req *wq = (const struct cuc_i2c_write_req *)r->req.data;
+		unsigned int abytes = wq->bus == 0 && wq->addr == 0x50 ? 2 : 1;
+
+		t->bus = wq->bus;
+		t->offset = abytes == 2 ? (u32)wq->buf[0] << 8 | wq->buf[1] : wq->buf[0];
+		t->len = wq->count - abytes;
+	}
+	nxfers++;
+}
+
+static int limited_send(void *priv, const struct cuc_pkt *pkt)
+{
+	if (!sends_left)
+		return -EIO;
+	sends_left--;
+	return cuc_sim_send(priv, pkt);
+}
+
+static void setup(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < EEPROM_SIZE; i++)
+		image[i] = (u8)(i * 7 + (i >> 8));
+	for (i = 0; i < sizeof(qsfp); i++)
+		qsfp[i] = (u8)~i;
+	cuc_sim_init(&sim, CUC_BOARD_TYPE_WASHINGTON, 1, 2);
+	assert(cuc_sim_add_i2c_dev(&sim, 0, 0x50, 1, image, EEPROM_SIZE) == 0);
+	assert(cuc_sim_add_i2c_dev(&sim, 0, 0x51, 0, image, 0) == -EINVAL);
+	assert(cuc_sim_add_i2c_dev(&sim, QSFP_I2C_BUS_REDIRECT, 0x50, 0, qsfp, sizeof(qsfp)) == 0);
+	cuc_sim_xport_init(&x, &ops, &sim);
+	x.observe = observe;
+	nxfers = 0;
+	cuc_i2c_bulk_init(&b, &x);
+	assert(cuc_i2c_bulk_set_dev(&b, 0, 0x50, 1, PAGE) == 0);
+}
+
+/* Overlapping and touching segments share a run; each run is one random read, then current-address reads */
+static void test_merge(void)
+{
+	static u8 out[6][1024];
+	struct cuc_i2c_seg segs[6] = {
+		{ 0, 0x50, 0x2000, 10, out[0], 0 },
+		{ 0, 0x50, 0x110, 16, out[1], 0 },
+		{ 0, 0x50, 0x100, 16, out[2], 0 },
+		{ 0, 0x50, 0x108, 20, out[3], 0 },
+		{ 0, 0x50, 0x3000, 600, out[4], 0 },
+		{ 0, 0x50, 0x2000, 4, out[5], 0 },
+	};
+	unsigned int i, nlong = (600 + CUC_I2C_READ_MAX - 1) / CUC_I2C_READ_MAX;
+
+	setup();
+	assert(cuc_i2c_bulk_read(&b, segs, 6) == 0);
+	for (i = 0; i < 6; i++)
+		assert(!segs[i].status && !memcmp(out[i], image + segs[i].offset, segs[i].len));
+	assert(b.segs == 6 && b.runs == 3 && b.reads == 2 + nlong && nxfers == 2 + nlong);
+
+	/* In offset order: [0x100, 0x120), [0x2000, 0x200A), then the long run */
+	assert(xfers[0].offset == 0x100 && xfers[0].len == 0x20 && xfers[0].type == I2C_RANDOM_ADDR16_READ);
+	assert(xfers[1].offset == 0x2000 && xfers[1].len == 10 && xfers[1].type == I2C_RANDOM_ADDR16_READ);
+	assert(xfers[2].offset == 0x3000 && xfers[2].type == I2C_RANDOM_ADDR16_READ);
+	for (i = 3; i < 2 + nlong; i++)
+		assert(xfers[i].type == I2C_CURRENT_ADDR_READ);
+
+	/* Reads also merge across gaps up to gap_max */
+	nxfers = 0;
+	b.gap_max = 16;
+	segs[0].offset = 0x400;
+	segs[1].offset = 0x400 + 10 + 16;
+	assert(cuc_i2c_bulk_read(&b, segs, 2) == 0 && nxfers == 1 && xfers[0].len == 10 + 16 + 16);
+	assert(!memcmp(out[0], image + 0x400, 10) && !memcmp(out[1], image + 0x41A, 16));
+	nxfers = 0;
+	segs[1].offset++;
+	assert(cuc_i2c_bulk_read(&b, segs, 2) == 0 && nxfers == 2);
+}
+
+/* Scattered writes are cut at page boundaries; where segments overlap the later one wins */
+static void test_write(void)
+{
+	static u8 data[3][100];
+	struct cuc_i2c_seg segs[4] = {
+		{ 0, 0x50, 0x3F0, 40, data[0], 0 },
+		{ 0, 0x50, 0x800, 8, data[1], 0 },
+		{ 0, 0x50, 0x804, 8, data[2], 0 },
+		{ 0, 0x50, 0x1000, 100, data[0], 0 },
+	};
+	u8 expect[12];
+	unsigned int i;
+
+	setup();
+	memset(data[0], 0xA0, sizeof(data[0]));
+	memset(data[1], 0xB1, sizeof(data[1]));
+	memset(data[2], 0xC2, sizeof(data[2]));
+	assert(cuc_i2c_bulk_write(&b, segs, 4) == 0);
+	assert(!memcmp(image + 0x3F0, data[0], 40) && !memcmp(image + 0x1000, data[0], 100));
+	memset(expect, 0xB1, 4);
+	memset(expect + 4, 0xC2, 8);
+	assert(!memcmp(image + 0x800, expect, 12));
+
+	/* 0x3F0+40 crosses one page, 0x1000+100 one, 0x800+12 none */
+	assert(nxfers == 5 && b.writes == 5);
+	for (i = 0; i < nxfers; i++)
+		assert(xfers[i].cmd == CUC_CMD_I2C_WRITE && xfers[i].offset % PAGE + xfers[i].len <= PAGE);
+	assert(xfers[0].offset == 0x3F0 && xfers[0].len == 16 && xfers[1].offset == 0x400 && xfers[1].len == 24);
+
+	/* The same overlap the other way round */
+	segs[0] = segs[2];
+	segs[1].offset = 0x800;
+	assert(cuc_i2c_bulk_write(&b, segs, 2) == 0);
+	memset(expect, 0xB1, 8);
+	memset(expect + 8, 0xC2, 4);
+	assert(!memcmp(image + 0x800, expect, 12));
+}
+
+/* Redirected transfers never span the lower/upper half and always set the offset */
+static void test_redirect(void)
+{
+	u8 out[0x40], data[8];
+	struct cuc_i2c_seg seg = { QSFP_I2C_BUS_REDIRECT, 0x50, 0x70, 0x30, out, 0 };
+	unsigned int i;
+
+	setup();
+	assert(cuc_i2c_bulk_read(&b, &seg, 1) == 0 && !memcmp(out, qsfp + 0x70, 0x30));
+	assert(nxfers == 2);
+	assert(xfers[0].offset == 0x70 && xfers[0].len == 0x10 && xfers[0].type == I2C_RANDOM_ADDR8_READ);
+	assert(xfers[1].offset == 0x80 && xfers[1].len == 0x20 && xfers[1].type == I2C_RANDOM_ADDR8_READ);
+
+	nxfers = 0;
+	memset(data, 0x5A, sizeof(data));
+	seg.offset = 0x7C;
+	seg.len = sizeof(data);
+	seg.buf = data;
+	assert(cuc_i2c_bulk_write(&b, &seg, 1) == 0 && !memcmp(qsfp + 0x7C, data, sizeof(data)));
+	assert(nxfers == 2 && xfers[0].offset == 0x7C && xfers[0].len == 4);
+	assert(xfers[1].offset == 0x80 && xfers[1].len == 4);
+	for (i = 0; i < nxfers; i++)
+		assert(xfers[i].bus == QSFP_I2C_BUS_REDIRECT);
+	assert(cuc_i2c_bulk_set_dev(&b, QSFP_I2C_BUS_REDIRECT, 0x50, 1, 0) == -EINVAL);
+}
+
+/* Segments must lie within the device's offset space */
+static void test_bounds(void)
+{
+	u8 out[2];
+	struct cuc_i2c_seg seg = { QSFP_I2C_BUS_REDIRECT, 0x50, 0x200, 1, out, 0 };
+
+	setup();
+	/* 8-bit offsets */
+	assert(cuc_i2c_bulk_read(&b, &seg, 1) == -EINVAL);
+	seg.offset = 0x100;
+	assert(cuc_i2c_bulk_read(&b, &seg, 1) == -EINVAL);
+	seg.offset = 0xFF;
+	assert(cuc_i2c_bulk_read(&b, &seg, 1) == 0 && out[0] == qsfp[0xFF]);
+	seg.len = 2;
+	assert(cuc_i2c_bulk_read(&b, &seg, 1) == -EINVAL);
+	seg.len = 0;
+	assert(cuc_i2c_bulk_read(&b, &seg, 1) == -EINVAL);
+
+	/* 16-bit offsets */
+	seg.bus = 0;
+	seg.len = 1;
+	seg.offset = 0xFFFF;
+	assert(cuc_i2c_bulk_read(&b, &seg, 1) == 0 && out[0] == image[0xFFFF]);
+	seg.offset = 0x10000;
+	assert(cuc_i2c_bulk_write(&b, &seg, 1) == -EINVAL);
+	seg.offset = 0x80000000u;
+	assert(cuc_i2c_bulk_read(&b, &seg, 1) == -EINVAL);
+	assert(nxfers == 2);
+}
+
+static void test_send_error(void)
+{
+	struct cuc_i2c_seg segs[2] = {
+		{ 0, 0x50, 0, 100, buf[0], 0 },
+		{ 0, 0x50, 0x8000, 0x8000, buf[1], 0 },
+	};
+
+	setup();
+	/* The first wave goes out, then the link fails in the middle of the second run */
+	sends_left = CUC_I2C_BULK_WAVE;
+	ops.send = limited_send;
+	assert(cuc_i2c_bulk_read(&b, segs, 2) == -EIO);
+	assert(segs[0].status == 0 && !memcmp(buf[0], image, 100));
+	assert(segs[1].status == -EIO);
+
+	/* Nothing was left behind on the transport */
+	ops.send = cuc_sim_send;
+	assert(!x.ninflight && !x.npending);
+	assert(cuc_i2c_bulk_read(&b, segs, 2) == 0);
+	assert(!memcmp(buf[1], image + 0x8000, 0x8000));
+}
+
+static void test_busy_slot(void)
+{
+	struct cuc_i2c_read_req rq = { 0, 0x50, I2C_RANDOM_ADDR16_READ, 16, 0 };
+	struct cuc_xport_req *one = &b.req[3];
+
+	setup();
+	/* An earlier transaction of the engine is still on the wire */
+	cuc_xport_req_init(&b.req[3], CUC_CMD_I2C_READ, &rq, sizeof(rq));
+	assert(cuc_xport_submit(&x, &one, 1) == 1);
+	assert(b.req[3].state == CUC_XPORT_REQ_INFLIGHT);
+
+	assert(cuc_i2c_bulk_read_image(&b, 0, 0x50, 0, buf[0], 4096) == -EBUSY);
+	assert(b.req[3].state == CUC_XPORT_REQ_INFLIGHT && x.ninflight == 1);
+
+	assert(cuc_xport_wait(&x, &b.req[3]) == 0 && !memcmp(b.req[3].rsp.data, image, 16));
+	assert(cuc_i2c_bulk_read_image(&b, 0, 0x50, 0, buf[0], 4096) == 0);
+	assert(!memcmp(buf[0], image, 4096));
+}
+
+int main(void)
+{
+	test_merge();
+	test_write();
+	test_redirect();
+	test_bounds();
+	test_send_error();
+	test_busy_slot();
+	return 0;
+}
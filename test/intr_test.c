@@ -0,0 +1,196 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* Interrupt dispatcher: handlers see only their NICs and bits, status is cleared
+ * before they run, no request is sent without attention or a due sweep, and a
+ * failed read or clear leaves the NIC marked for service.
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "cuc_intr.h"
+#include "cuc_sim.h"
+
+#define MAX_CALLS  16
+
+struct call {
+	int handler;
+	u8 nic;
+	u32 bits;
+};
+
+static struct cuc_sim sim;
+static struct cuc_xport_ops ops;
+static struct cuc_xport x;
+static struct cuc_intr d;
+static struct call calls[MAX_CALLS];
+static unsigned int ncalls;
+static u32 reraise;                /* Bits handler 0 raises again on the NIC it handles */
+
+static void handler(struct cuc_intr *di, u8 nic, u32 bits, void *priv)
+{
+	int h = (int)(long)priv;
+
+	(void)di;
+	assert(ncalls < MAX_CALLS);
+	calls[ncalls].handler = h;
+	calls[ncalls].nic = nic;
+	calls[ncalls].bits = bits;
+	ncalls++;
+	if (h == 0 && reraise)
+		cuc_sim_raise(&sim, nic, reraise);
+}
+
+static unsigned long sent(int cmd)
+{
+	return sim.requests[cmd];
+}
+
+static void setup(void)
+{
+	cuc_sim_init(&sim, CUC_BOARD_TYPE_WASHINGTON, 1, 2);
+	cuc_sim_xport_init(&x, &ops, &sim);
+	cuc_intr_init(&d, &x, 2);
+	d.sweep_us = 0;
+	ncalls = 0;
+	reraise = 0;
+	assert(cuc_intr_register(&d, ATT1_UC_RESET | ATT1_QSFP_INSERT, 0, handler, (void *)0L) == 0);
+	assert(cuc_intr_register(&d, ATT1_FAN_FAIL | ATT1_QSFP_INT, 1u << 1, handler, (void *)1L) == 0);
+}
+
+static void test_dispatch(void)
+{
+	u64 now = cuc_xport_now_us();
+
+	setup();
+	/* The reset latched at start-up is read from both NICs in one batch */
+	assert(cuc_intr_service(&d, now) == 2);
+	assert(sent(CUC_CMD_GET_INTR) == 2 && sent(CUC_CMD_CLEAR_ISR) == 2);
+	assert(calls[0].handler == 0 && calls[0].nic == 0 && calls[0].bits == ATT1_UC_RESET);
+	assert(calls[1].handler == 0 && calls[1].nic == 1 && calls[1].bits == ATT1_UC_RESET);
+	assert(!sim.nic[0].isr && !sim.nic[1].isr);
+
+	/* Without attention nothing is sent */
+	ncalls = 0;
+	cuc_sim_raise(&sim, 1, ATT1_FAN_FAIL);
+	assert(cuc_intr_next(&d) == (u64)-1);
+	assert(cuc_intr_service(&d, now) == 0 && sent(CUC_CMD_GET_INTR) == 2);
+
+	/* Only the handler of NIC 1 sees its bits; QSFP_INT clears itself and is not cleared */
+	cuc_sim_raise(&sim, 1, ATT1_QSFP_INT);
+	cuc_sim_raise(&sim, 0, ATT1_FAN_FAIL | ATT1_QSFP_INT);
+	assert(cuc_sim_attention(&sim, 0) && cuc_sim_attention(&sim, 1));
+	cuc_intr_attention(&d, 1u << 1);
+	assert(cuc_intr_next(&d) == 0);
+	assert(cuc_intr_service(&d, now) == 1);
+	assert(sent(CUC_CMD_GET_INTR) == 3 && sent(CUC_CMD_CLEAR_ISR) == 3);
+	assert(ncalls == 1 && calls[0].handler == 1 && calls[0].nic == 1);
+	assert(calls[0].bits == (ATT1_FAN_FAIL | ATT1_QSFP_INT));
+	assert(sim.nic[1].isr == ATT1_QSFP_INT);
+	assert(d.nic[1].isr == (ATT1_FAN_FAIL | ATT1_QSFP_INT) && d.events[2] == 1);
+
+	/* NIC 0 has no handler for what it raised: read and cleared, nobody called */
+	ncalls = 0;
+	cuc_intr_attention(&d, 1u << 0);
+	assert(cuc_intr_service(&d, now) == 0 && !ncalls);
+	assert(sim.nic[0].isr == ATT1_QSFP_INT);
+}
+
+/* An event that recurs while its handler runs is latched again and dispatched again */
+static void test_recur(void)
+{
+	u64 now = cuc_xport_now_us();
+
+	setup();
+	reraise = ATT1_QSFP_INSERT;
+	assert(cuc_intr_service(&d, now) == 2);
+	assert(sim.nic[0].isr == ATT1_QSFP_INSERT && sim.nic[1].isr == ATT1_QSFP_INSERT);
+	assert(cuc_sim_attention(&sim, 0));
+
+	reraise = 0;
+	ncalls = 0;
+	cuc_intr_attention(&d, 3);
+	assert(cuc_intr_service(&d, now) == 2);
+	assert(calls[0].bits == ATT1_QSFP_INSERT && calls[1].bits == ATT1_QSFP_INSERT);
+	assert(!sim.nic[0].isr && !sim.nic[1].isr);
+}
+
+/* Enables follow the handlers, plus ATT1_UC_RESET */
+static void test_sync_ier(void)
+{
+	u64 now = cuc_xport_now_us();
+
+	setup();
+	assert(cuc_intr_service(&d, now) == 2);
+	assert(cuc_intr_sync_ier(&d) == 0 && sent(CUC_CMD_UPDATE_IER) == 2);
+	assert(sim.nic[0].ier == (ATT1_UC_RESET | ATT1_QSFP_INSERT));
+	assert(sim.nic[1].ier == (ATT1_UC_RESET | ATT1_QSFP_INSERT | ATT1_FAN_FAIL | ATT1_QSFP_INT));
+
+	/* Already in step: nothing to send */
+	assert(cuc_intr_sync_ier(&d) == 0 && sent(CUC_CMD_UPDATE_IER) == 2);
+
+	/* A bit nobody handles no longer raises attention */
+	cuc_sim_raise(&sim, 0, ATT1_ASIC_PWR_FAIL);
+	assert(!cuc_sim_attention(&sim, 0));
+	cuc_sim_raise(&sim, 0, ATT1_QSFP_INSERT);
+	assert(cuc_sim_attention(&sim, 0));
+}
+
+/* The sweep reads NICs that raised nothing, once due */
+static void test_sweep(void)
+{
+	u64 now = cuc_xport_now_us();
+
+	setup();
+	d.sweep_us = 1000;
+	assert(cuc_intr_service(&d, now) == 2);
+	assert(cuc_intr_next(&d) == now + 1000);
+
+	ncalls = 0;
+	cuc_sim_raise(&sim, 1, ATT1_FAN_FAIL);
+	assert(cuc_intr_service(&d, now + 999) == 0 && sent(CUC_CMD_GET_INTR) == 2);
+	assert(cuc_intr_service(&d, now + 1000) == 1 && sent(CUC_CMD_GET_INTR) == 4);
+	assert(calls[0].handler == 1 && calls[0].bits == ATT1_FAN_FAIL);
+	assert(cuc_intr_next(&d) == now + 2000);
+}
+
+/* Failed reads are not dispatched, failed clears are; both are serviced again */
+static void test_errors(void)
+{
+	struct cuc_sim_cmd_cfg cfg;
+	u64 now = cuc_xport_now_us();
+
+	setup();
+	memset(&cfg, 0, sizeof(cfg));
+	cfg.error_ppm = 1000000;
+	cuc_sim_set_cmd_cfg(&sim, CUC_CMD_GET_INTR, &cfg);
+	assert(cuc_intr_service(&d, now) < 0);
+	assert(!ncalls && d.nic[0].attention && d.nic[1].attention);
+	assert(sim.nic[0].isr == ATT1_UC_RESET);
+
+	cfg.error_ppm = 0;
+	cuc_sim_set_cmd_cfg(&sim, CUC_CMD_GET_INTR, &cfg);
+	cfg.error_ppm = 1000000;
+	cuc_sim_set_cmd_cfg(&sim, CUC_CMD_CLEAR_ISR, &cfg);
+	assert(cuc_intr_service(&d, now) < 0);
+	assert(ncalls == 2 && d.nic[0].attention && d.nic[1].attention);
+	assert(sim.nic[0].isr == ATT1_UC_RESET);
+
+	/* Still latched, so dispatched again once the clear goes through */
+	cfg.error_ppm = 0;
+	cuc_sim_set_cmd_cfg(&sim, CUC_CMD_CLEAR_ISR, &cfg);
+	ncalls = 0;
+	assert(cuc_intr_service(&d, now) == 2);
+	assert(!d.nic[0].attention && !d.nic[1].attention && !sim.nic[0].isr);
+}
+
+int main(void)
+{
+	test_dispatch();
+	test_recur();
+	test_sync_ier();
+	test_sweep();
+	test_errors();
+	return 0;
+}
@@ -0,0 +1,147 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* PDR cache: truncated records are kept out of the typed indexes, oversized records
+ * are refused, and a refresh survives PLDM_ERROR_NOT_READY from the simulated uC.
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "cuc_sim.h"
+#include "pldm_pdr_cache.h"
+
+static u8 repo[128 * 1024];      /* Room for the record past the u16 limit */
+static size_t repo_len;
+static u32 next_handle = 1;
+
+/* Append a record of 'type' whose total length is 'length' (0 for the full struct) */
+static void *add(u8 type, size_t full, size_t length)
+{
+	struct pdr_hdr *h = (struct pdr_hdr *)(repo + repo_len);
+
+	if (!length)
+		length = full;
+	memset(h, 0, full > length ? full : length);
+	h->record_handle = next_handle++;
+	h->pdr_header_version = 1;
+	h->pdr_type = type;
+	h->record_change_number = 1;
+	h->data_length = (u16)(length - sizeof(*h));
+	repo_len += length;
+	return h;
+}
+
+static void add_numeric(u16 sensor_id, u8 size, size_t length)
+{
+	struct numeric_sensor_pdr p;
+	size_t at = repo_len;
+
+	memset(&p, 0, sizeof(p));
+	p.sensor_id = sensor_id;
+	p.sensor_data_size = size;
+	p.is_linear = 1;
+	p.resolution = 1.0f;
+	add(PLDM_PDR_NUMERIC_SENSOR, sizeof(p), length);
+	/* Copy the body over what add() set up, keeping its header */
+	memcpy(repo + at + sizeof(struct pdr_hdr), (u8 *)&p + sizeof(struct pdr_hdr),
+	       (length ? length : sizeof(p)) - sizeof(struct pdr_hdr));
+}
+
+static void add_aux(u16 sensor_id, size_t length)
+{
+	struct aux_name_pdr *a = (struct aux_name_pdr *)add(PLDM_PDR_SENSOR_AUXILIARY_NAMES,
+							       sizeof(struct aux_name_pdr), length);
+
+	if (!length || length >= offsetof(struct aux_name_pdr, sensor_count))
+		a->sensor_id = sensor_id;
+}
+
+static void test_index_lengths(void)
+{
+	static const char path[] = "pdr_cache_test.cache";
+	struct pldm_pdr_cache_key key;
+	struct pldm_pdr_cache c;
+	size_t ssd = offsetof(struct numeric_sensor_pdr, ssd);
+
+	repo_len = 0;
+	add_numeric(1, PLDM_DATA_SIZE_UINT16, 0);
+	add_numeric(2, PLDM_DATA_SIZE_UINT16, offsetof(struct numeric_sensor_pdr, entity_type));
+	add_numeric(3, PLDM_DATA_SIZE_SINT32, ssd + sizeof(struct numeric_sensor_ssd32) - 1);
+	add_numeric(4, 9, 0);
+	add_numeric(5, PLDM_DATA_SIZE_UINT8, ssd + sizeof(struct numeric_sensor_ssd8));
+	add_aux(1, 0);
+	add_aux(2, offsetof(struct aux_name_pdr, sensor_count));
+	add(PLDM_PDR_FRU_RECORD_SET, sizeof(struct fru_record_set_pdr), 0);
+	add(PLDM_PDR_FRU_RECORD_SET, sizeof(struct fru_record_set_pdr), sizeof(struct fru_record_set_pdr) - 2);
+
+	memset(&key, 0, sizeof(key));
+	assert(pldm_pdr_cache_write(path, &key, repo, repo_len) == 0);
+	assert(pldm_pdr_cache_open(&c, path, &key) == 0);
+	assert(pldm_pdr_cache_count(&c) == 9);
+	assert(c.file->num_numeric == 2 && c.file->num_aux_names == 1 && c.file->num_fru_sets == 1);
+	assert(pldm_pdr_cache_numeric_sensor(&c, 1) && pldm_pdr_cache_numeric_sensor(&c, 5));
+	assert(!pldm_pdr_cache_numeric_sensor(&c, 2) && !pldm_pdr_cache_numeric_sensor(&c, 3));
+	assert(!pldm_pdr_cache_numeric_sensor(&c, 4));
+	assert(pldm_pdr_cache_aux_name(&c, 1) && !pldm_pdr_cache_aux_name(&c, 2));
+	/* Truncated records are still reachable by handle */
+	assert(pldm_pdr_cache_find(&c, 2) && pldm_pdr_cache_find(&c, 9));
+	pldm_pdr_cache_close(&c);
+
+	/* A record whose length does not fit in the u16 entry length is refused */
+	repo_len = 0;
+	add(PLDM_PDR_OEM, sizeof(struct pdr_hdr) + 0xFFFF, 0);
+	assert(pldm_pdr_cache_write(path, &key, repo, repo_len) == -EINVAL);
+	unlink(path);
+}
+
+static void test_refresh_not_ready(void)
+{
+	static const char path[] = "pdr_cache_test_refresh.cache";
+	static struct cuc_sim sim;
+	struct cuc_xport_ops ops;
+	struct cuc_xport x;
+	struct pldm_requester rq;
+	struct cuc_sim_cmd_cfg cfg;
+	struct pldm_pdr_cache_key key;
+	struct pldm_pdr_cache c;
+	u16 i;
+
+	repo_len = 0;
+	for (i = 0; i < 40; i++) {
+		add_numeric((u16)(100 + i), PLDM_DATA_SIZE_UINT16, 0);
+		add_aux((u16)(100 + i), 0);
+	}
+
+	cuc_sim_init(&sim, CUC_BOARD_TYPE_WASHINGTON, 1, 2);
+	memset(&cfg, 0, sizeof(cfg));
+	cfg.latency_us = 20;
+	cuc_sim_set_cmd_cfg(&sim, -1, &cfg);
+	assert(cuc_sim_set_pdr_repo(&sim, repo, repo_len) == 80);
+	cuc_sim_xport_init(&x, &ops, &sim);
+	pldm_rq_init(&rq, &x);
+
+	memset(&key, 0, sizeof(key));
+	unlink(path);
+	assert(pldm_pdr_cache_refresh(&c, path, &key, &rq) == 0);
+	assert(pldm_pdr_cache_count(&c) == 80 && c.file->num_numeric == 40);
+	pldm_pdr_cache_close(&c);
+
+	/* Revalidation must retry the header requests the uC is not ready for */
+	sim.pldm_not_ready_ppm = 300000;
+	assert(pldm_pdr_cache_refresh(&c, path, &key, &rq) == 0);
+	assert(c.revalidated == 80 && c.fetched == 0);
+	assert(c.requests > 80);
+	pldm_pdr_cache_close(&c);
+	unlink(path);
+}
+
+int main(void)
+{
+	test_index_lengths();
+	test_refresh_not_ready();
+	return 0;
+}
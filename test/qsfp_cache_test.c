@@ -0,0 +1,80 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* QSFP page cache: a short page is an error and is not cached, and a cache attached
+ * to a cuc_intr dispatcher is dropped when a module is inserted.
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "cuc_qsfp_cache.h"
+#include "cuc_sim.h"
+
+/* Simulator backend that can truncate the next response */
+struct short_rsp {
+	struct cuc_sim sim;
+	unsigned int truncate;  /* Payload bytes to keep in the next response, 0 for all */
+};
+
+static int short_send(void *priv, const struct cuc_pkt *pkt)
+{
+	return cuc_sim_send(&((struct short_rsp *)priv)->sim, pkt);
+}
+
+static int short_recv(void *priv, struct cuc_pkt *pkt, long timeout_us)
+{
+	struct short_rsp *s = (struct short_rsp *)priv;
+	int rc = cuc_sim_recv(&s->sim, pkt, timeout_us);
+
+	if (rc >= 0 && s->truncate) {
+		pkt->count = (u8)(1 + s->truncate);
+		s->truncate = 0;
+	}
+	return rc;
+}
+
+int main(void)
+{
+	static struct short_rsp s;
+	static struct cuc_qsfp_cache c;
+	static struct cuc_intr d;
+	struct cuc_xport_ops ops;
+	struct cuc_xport x;
+	u8 buf[16];
+
+	memset(&s, 0, sizeof(s));
+	cuc_sim_init(&s.sim, CUC_BOARD_TYPE_WASHINGTON, 1, 2);
+	memset(&ops, 0, sizeof(ops));
+	ops.kind = CUC_XPORT_SIM;
+	ops.max_inflight = 4;
+	ops.send = short_send;
+	ops.recv = short_recv;
+	cuc_xport_init(&x, &ops, &s);
+	s.sim.nic[0].qsfp_upper[0][20] = 0x5A;
+
+	cuc_qsfp_cache_init(&c, &x);
+
+	/* A page that comes back short is neither cached nor returned */
+	s.truncate = CUC_QSFP_PAGE_SIZE / 2;
+	assert(cuc_qsfp_cache_read(&c, 0, 0, 148, buf, 1) == -EPROTO);
+	assert(!(c.nic[0].valid & 1));
+	s.truncate = CUC_QSFP_PAGE_SIZE / 2;
+	assert(cuc_qsfp_cache_prefetch(&c, 0) == -EPROTO);
+	assert((c.nic[0].valid & c.static_pages) != c.static_pages);
+
+	assert(cuc_qsfp_cache_prefetch(&c, 0) == 0);
+	assert(c.nic[0].valid == c.static_pages);
+	assert(cuc_qsfp_cache_read(&c, 0, 0, 148, buf, 1) == 0 && buf[0] == 0x5A);
+
+	/* Module swap reported through the dispatcher */
+	cuc_intr_init(&d, &x, 2);
+	assert(cuc_qsfp_cache_attach(&c, &d) == 0);
+	assert(cuc_intr_service(&d, cuc_xport_now_us()) >= 0);
+	assert(c.nic[0].valid == c.static_pages);
+	cuc_sim_raise(&s.sim, 0, ATT1_QSFP_INSERT);
+	cuc_intr_attention(&d, 1u << 0);
+	assert(cuc_intr_service(&d, cuc_xport_now_us()) == 1);
+	assert(c.nic[0].valid == 0 && c.invalidations == 1);
+	return 0;
+}
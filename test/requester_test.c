@@ -0,0 +1,173 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* Requester: the sensor poller and batches share its instance IDs without ever
+ * reusing one that is held, a request it cannot submit is left untouched, and a
+ * batch fails instead of waiting for IDs that nothing will give back.
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "cuc_sim.h"
+#include "pldm_sensor_poll.h"
+
+#define NUM_SENSORS  40
+
+static struct cuc_sim sim;
+static struct cuc_xport_ops ops;
+static struct cuc_xport x;
+static struct pldm_requester rq;
+static unsigned int reads, errors;
+static u32 used;                   /* Instance IDs seen on the wire */
+
+static void observe(void *ctx, const struct cuc_xport_req *r)
+{
+	(void)ctx;
+	if (r->req.cmd == CUC_CMD_PLDM)
+		used |= 1u << (r->req.data[0] & 0x1F);
+}
+
+static void on_read(struct pldm_poll *p, struct pldm_poll_sensor *s, const struct get_sensor_reading_rsp *rsp,
+		    int status)
+{
+	(void)p;
+	(void)s;
+	if (status) {
+		assert(status == -EAGAIN && !rsp);
+		errors++;
+	} else {
+		reads++;
+	}
+}
+
+static void setup(void)
+{
+	static struct cuc_sim_sensor ss[NUM_SENSORS];
+	struct cuc_sim_cmd_cfg cfg;
+	u16 i;
+
+	cuc_sim_init(&sim, CUC_BOARD_TYPE_WASHINGTON, 1, 2);
+	memset(&cfg, 0, sizeof(cfg));
+	cfg.latency_us = 50;
+	cuc_sim_set_cmd_cfg(&sim, -1, &cfg);
+	for (i = 0; i < NUM_SENSORS; i++) {
+		memset(&ss[i], 0, sizeof(ss[i]));
+		ss[i].sensor_id = i;
+		ss[i].data_size = PLDM_DATA_SIZE_UINT16;
+	}
+	cuc_sim_set_sensors(&sim, ss, NUM_SENSORS);
+	cuc_sim_xport_init(&x, &ops, &sim);
+	x.observe = observe;
+	used = 0;
+	pldm_rq_init(&rq, &x);
+}
+
+static void test_shared_ids(void)
+{
+	static struct pldm_poll p;
+	static struct cuc_xport_req reqs[NUM_SENSORS];
+	struct numeric_sensor_pdr pdr;
+	u16 ids[NUM_SENSORS];
+	u32 held = 0;
+	u64 now, period;
+	unsigned int i;
+	int iid;
+
+	setup();
+	/* Another user holds all IDs but one */
+	for (i = 0; i < PLDM_RQ_NUM_IDS - 1; i++) {
+		iid = pldm_rq_get_iid(&rq);
+		assert(iid >= 0);
+		held |= 1u << iid;
+	}
+
+	assert(pldm_poll_init(&p, NUM_SENSORS, 0, on_read, NULL) == 0);
+	assert(pldm_poll_add_xport(&p, &rq) == 0);
+	memset(&pdr, 0, sizeof(pdr));
+	pdr.sensor_data_size = PLDM_DATA_SIZE_UINT16;
+	for (i = 0; i < NUM_SENSORS; i++) {
+		pdr.sensor_id = (u16)i;
+		ids[i] = (u16)i;
+		assert(pldm_poll_add_sensor(&p, 0, &pdr, NULL) == (int)i);
+	}
+	now = cuc_xport_now_us();
+	pldm_poll_run(&p, now);
+	period = p.sensors[0].period_us;
+	pldm_poll_run(&p, now + period - 1);
+	assert(reads == NUM_SENSORS && !errors);
+	assert(!(used & held) && rq.free_ids == ~held);
+
+	assert(pldm_rq_get_sensor_readings(&rq, reqs, ids, NUM_SENSORS) == 0);
+	for (i = 0; i < NUM_SENSORS; i++)
+		assert(reqs[i].status == 0 && reqs[i].rsp.data[sizeof(struct pldm_hdr)] == PLDM_SUCCESS);
+	assert(!(used & held) && rq.free_ids == ~held);
+
+	/* With no ID left the reads fail rather than reuse one */
+	iid = pldm_rq_get_iid(&rq);
+	assert(iid >= 0 && pldm_rq_get_iid(&rq) == -EAGAIN);
+	pldm_poll_run(&p, now + 2 * period - 1);
+	assert(reads == NUM_SENSORS && errors == NUM_SENSORS);
+
+	for (i = 0; i < PLDM_RQ_NUM_IDS; i++)
+		pldm_rq_put_iid(&rq, (u8)i, 0);
+	assert(rq.free_ids == ~(u32)0);
+	pldm_poll_fini(&p);
+}
+
+static void test_submit_busy(void)
+{
+	struct cuc_xport_req reqs[2];
+	struct cuc_xport_req *one = &reqs[0];
+
+	setup();
+	pldm_poll_sensor_req_init(&reqs[0], 7, 1);
+	pldm_poll_sensor_req_init(&reqs[1], 0, 2);
+	assert(cuc_xport_submit(&x, &one, 1) == 1);
+	assert(reqs[0].state == CUC_XPORT_REQ_INFLIGHT);
+
+	/* The first request is still owned by its own submission */
+	assert(pldm_rq_run(&rq, reqs, 2) == -EBUSY);
+	assert(reqs[1].status == -EBUSY && reqs[1].state == CUC_XPORT_REQ_IDLE);
+	assert(!reqs[0].done && !reqs[0].priv && (reqs[0].req.data[0] & 0x1F) == 7);
+	assert(rq.free_ids == ~(u32)0 && rq.requests == 0);
+
+	assert(cuc_xport_wait(&x, &reqs[0]) == 0 && (reqs[0].rsp.data[0] & 0x1F) == 7);
+}
+
+static void test_no_ids(void)
+{
+	struct cuc_xport_req reqs[3];
+	unsigned int i;
+	u64 start;
+
+	setup();
+	for (i = 0; i < PLDM_RQ_NUM_IDS; i++)
+		assert(pldm_rq_get_iid(&rq) == (int)i);
+	for (i = 0; i < 3; i++)
+		pldm_poll_sensor_req_init(&reqs[i], 0, (u16)i);
+
+	/* Every ID is held outside the batch */
+	assert(pldm_rq_run(&rq, reqs, 3) == -EAGAIN);
+	for (i = 0; i < 3; i++)
+		assert(reqs[i].status == -EAGAIN && reqs[i].state == CUC_XPORT_REQ_IDLE && !reqs[i].done);
+	assert(rq.requests == 0 && !used);
+
+	/* A quarantined ID comes back by itself, so the batch waits for it */
+	rq.quarantine_us = 2000;
+	pldm_rq_put_iid(&rq, 5, -ETIMEDOUT);
+	start = cuc_xport_now_us();
+	assert(pldm_rq_run(&rq, reqs, 3) == 0);
+	assert(cuc_xport_now_us() - start >= 2000);
+	for (i = 0; i < 3; i++)
+		assert(reqs[i].status == 0 && (reqs[i].req.data[0] & 0x1F) == 5);
+	assert(used == 1u << 5 && rq.free_ids == 1u << 5);
+}
+
+int main(void)
+{
+	test_shared_ids();
+	test_submit_busy();
+	test_no_ids();
+	return 0;
+}
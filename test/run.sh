@@ -0,0 +1,33 @@
+#!/bin/bash
+# SPDX-License-Identifier: MIT
+# Copyright 2026 Hewlett Packard Enterprise Development LP
+#
+# Build and run every test against the simulated uC. Exits non-zero on the first
+# failure:
+#
+#   test/run.sh
+#
+# CC, CXX and CFLAGS may be overridden from the environment, e.g.
+# CFLAGS="-O1 -g -fsanitize=address,undefined" test/run.sh
+
+set -euo pipefail
+
+top=$(cd "$(dirname "$0")/.." && pwd)
+out=$(mktemp -d)
+trap 'rm -rf "$out"' EXIT
+
+CC=${CC:-cc}
+CXX=${CXX:-c++}
+CFLAGS=${CFLAGS:--O2 -g}
+common=(-Wall -Wextra -I"$top/lib/casuc" -I"$top/lib/craypldm" -include "$top/bench/bench_types.h")
+
+shopt -s nullglob
+for src in "$top"/test/*_test.c "$top"/test/*_test.cpp; do
+	name=$(basename "${src%.*}")
+	case $src in
+	*.c)   $CC -std=gnu11 $CFLAGS "${common[@]}" "$src" -o "$out/$name" -lm -lpthread ;;
+	*.cpp) $CXX -std=c++20 $CFLAGS "${common[@]}" "$src" -o "$out/$name" -lm -lpthread ;;
+	esac
+	(cd "$out" && "./$name")
+	echo "$name: ok"
+done
@@ -0,0 +1,210 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* Scheduler: classes are served most urgent first, every class below the top one
+ * gets through after CUC_SCHED_STARVE_LIMIT passes, the NICs of a uC take turns
+ * within a class, and an idle worker takes over a uC whose home worker is stuck.
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "cuc_sched.h"
+
+#define MAX_TASKS  128
+
+static struct cuc_sched s;
+static struct cuc_xport xs[3];
+static struct cuc_sched_task tasks[MAX_TASKS];
+static unsigned int ntasks;
+static pthread_t ran_on[MAX_TASKS];
+static struct cuc_sched_task *order[MAX_TASKS];
+static unsigned int norder;
+
+static void nop(struct cuc_sched_task *t, struct cuc_xport *x)
+{
+	(void)t;
+	(void)x;
+}
+
+static void setup(unsigned int num_ucs)
+{
+	unsigned int i;
+
+	assert(cuc_sched_init(&s) == 0);
+	for (i = 0; i < num_ucs; i++)
+		assert(cuc_sched_add_uc(&s, &xs[i]) == (int)i);
+	memset(tasks, 0, sizeof(tasks));
+	ntasks = 0;
+	norder = 0;
+}
+
+static struct cuc_sched_task *submit(cuc_sched_fn fn, u8 uc, u8 nic, u8 prio)
+{
+	struct cuc_sched_task *t = &tasks[ntasks++];
+
+	assert(ntasks <= MAX_TASKS);
+	t->fn = fn;
+	t->uc = uc;
+	t->nic = nic;
+	t->prio = prio;
+	assert(cuc_sched_submit(&s, t) == 0);
+	return t;
+}
+
+/* Take the tasks of uC 0 in the order a worker would run them */
+static void drain(void)
+{
+	struct cuc_sched_task *t;
+
+	while ((t = cuc_sched_dequeue(&s.uc[0])) != NULL) {
+		order[norder++] = t;
+		s.queued--;
+	}
+	assert(norder == ntasks && !s.queued);
+}
+
+static void test_order(void)
+{
+	struct cuc_sched_task bad;
+	unsigned int i;
+
+	setup(1);
+	submit(nop, 0, 0, CUC_SCHED_PRIO_BULK);
+	submit(nop, 0, 0, CUC_SCHED_PRIO_LINK);
+	submit(nop, 0, 0, CUC_SCHED_PRIO_INTR);
+	submit(nop, 0, 1, CUC_SCHED_PRIO_INTR);
+	drain();
+	assert(order[0] == &tasks[2] && order[1] == &tasks[3]);
+	assert(order[2] == &tasks[1] && order[3] == &tasks[0]);
+	cuc_sched_fini(&s);
+
+	/* NIC 0, NIC 1 and the uC as a whole take turns; any NIC above 1 is the uC */
+	setup(1);
+	for (i = 0; i < 3; i++) {
+		submit(nop, 0, 0, CUC_SCHED_PRIO_LINK);
+		submit(nop, 0, 1, CUC_SCHED_PRIO_LINK);
+	}
+	submit(nop, 0, CUC_MAC_THIS_NIC, CUC_SCHED_PRIO_LINK);
+	submit(nop, 0, 2, CUC_SCHED_PRIO_LINK);
+	drain();
+	assert(order[0] == &tasks[0] && order[1] == &tasks[1] && order[2] == &tasks[6]);
+	assert(order[3] == &tasks[2] && order[4] == &tasks[3] && order[5] == &tasks[7]);
+	assert(order[6] == &tasks[4] && order[7] == &tasks[5]);
+
+	memset(&bad, 0, sizeof(bad));
+	bad.fn = nop;
+	bad.uc = 1;
+	assert(cuc_sched_submit(&s, &bad) == -EINVAL);
+	bad.uc = 0;
+	bad.prio = CUC_SCHED_NUM_PRIO;
+	assert(cuc_sched_submit(&s, &bad) == -EINVAL);
+	cuc_sched_fini(&s);
+}
+
+/* Under a stream of interrupt work both lower classes get through, link work first */
+static void test_starve(void)
+{
+	unsigned int i, link = 0, bulk = 0, intr = 0;
+
+	setup(1);
+	for (i = 0; i < 100; i++)
+		submit(nop, 0, 0, CUC_SCHED_PRIO_INTR);
+	for (i = 0; i < 5; i++) {
+		submit(nop, 0, 0, CUC_SCHED_PRIO_LINK);
+		submit(nop, 0, 0, CUC_SCHED_PRIO_BULK);
+	}
+	drain();
+
+	for (i = 0; i < norder; i++) {
+		switch (order[i]->prio) {
+		case CUC_SCHED_PRIO_INTR:
+			assert(order[i] == &tasks[intr++]);
+			break;
+		case CUC_SCHED_PRIO_LINK:
+			/* Counted on every pass, so through on the limit-th one */
+			assert(i == (link + 1) * CUC_SCHED_STARVE_LIMIT - 1);
+			assert(order[i] == &tasks[100 + 2 * link++]);
+			break;
+		case CUC_SCHED_PRIO_BULK:
+			/* Reached the limit together with link work, so right after it */
+			assert(i == (bulk + 1) * CUC_SCHED_STARVE_LIMIT);
+			assert(order[i] == &tasks[101 + 2 * bulk++]);
+			break;
+		}
+	}
+	assert(link == 5 && bulk == 5 && intr == 100);
+	cuc_sched_fini(&s);
+}
+
+static pthread_mutex_t gate_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t gate_cond = PTHREAD_COND_INITIALIZER;
+static int blocked, released;
+
+/* Holds its worker until released */
+static void stuck(struct cuc_sched_task *t, struct cuc_xport *x)
+{
+	(void)x;
+	pthread_mutex_lock(&gate_lock);
+	ran_on[t - tasks] = pthread_self();
+	blocked = 1;
+	pthread_cond_broadcast(&gate_cond);
+	while (!released)
+		pthread_cond_wait(&gate_cond, &gate_lock);
+	pthread_mutex_unlock(&gate_lock);
+}
+
+static unsigned int ran;
+
+static void record(struct cuc_sched_task *t, struct cuc_xport *x)
+{
+	assert(x == s.uc[t->uc].x);
+	pthread_mutex_lock(&gate_lock);
+	ran_on[t - tasks] = pthread_self();
+	ran++;
+	pthread_cond_broadcast(&gate_cond);
+	pthread_mutex_unlock(&gate_lock);
+}
+
+/* uCs 0 and 2 share worker 0: while uC 0 holds one worker, the other runs uC 2 */
+static void test_steal(void)
+{
+	unsigned int i;
+
+	setup(3);
+	blocked = 0;
+	released = 0;
+	ran = 0;
+	assert(cuc_sched_start(&s, 2) == 0);
+	assert(s.uc[0].home == 0 && s.uc[1].home == 1 && s.uc[2].home == 0);
+
+	submit(stuck, 0, 0, CUC_SCHED_PRIO_BULK);
+	pthread_mutex_lock(&gate_lock);
+	while (!blocked)
+		pthread_cond_wait(&gate_cond, &gate_lock);
+	pthread_mutex_unlock(&gate_lock);
+
+	for (i = 0; i < 8; i++)
+		submit(record, 2, (u8)(i % 3), CUC_SCHED_PRIO_BULK);
+	pthread_mutex_lock(&gate_lock);
+	while (ran < 8)
+		pthread_cond_wait(&gate_cond, &gate_lock);
+	/* Whichever worker took uC 0, the other one ran all of uC 2 */
+	for (i = 1; i <= 8; i++)
+		assert(!pthread_equal(ran_on[i], ran_on[0]));
+	released = 1;
+	pthread_cond_broadcast(&gate_cond);
+	pthread_mutex_unlock(&gate_lock);
+	cuc_sched_wait_idle(&s);
+	assert(s.uc[0].executed == 1 && s.uc[2].executed == 8);
+	assert((s.uc[0].stolen == 1 && !s.uc[2].stolen) || (!s.uc[0].stolen && s.uc[2].stolen == 8));
+	cuc_sched_fini(&s);
+}
+
+int main(void)
+{
+	test_order();
+	test_starve();
+	test_steal();
+	return 0;
+}
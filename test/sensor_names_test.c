@@ -0,0 +1,61 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* Sensor names: a name is decoded only up to the end of its own record, even when
+ * the record ends before the name's terminator.
+ */
+
+#include <assert.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "pldm_sensor_names.h"
+
+static u8 repo[4096];
+static size_t repo_len;
+
+/* Append an auxiliary name PDR holding 'name' and cut to 'length' bytes (0 for all) */
+static void add_aux(u32 handle, u16 sensor_id, const char *name, size_t length)
+{
+	struct aux_name_pdr a;
+	size_t i;
+
+	memset(&a, 0, sizeof(a));
+	a.hdr.record_handle = handle;
+	a.hdr.pdr_header_version = 1;
+	a.hdr.pdr_type = PLDM_PDR_SENSOR_AUXILIARY_NAMES;
+	a.sensor_id = sensor_id;
+	a.sensor_count = 1;
+	a.name_string_count = 1;
+	for (i = 0; name[i]; i++)
+		a.sensor_name[i] = (u8)name[i];
+	if (!length)
+		length = sizeof(a);
+	a.hdr.data_length = (u16)(length - sizeof(a.hdr));
+	memcpy(repo + repo_len, &a, length);
+	repo_len += length;
+}
+
+int main(void)
+{
+	static const char path[] = "sensor_names_test.cache";
+	struct pldm_pdr_cache_key key;
+	struct pldm_pdr_cache c;
+	struct pldm_names t;
+
+	/* Three code units and no terminator, then a record whose header is not zero */
+	add_aux(1, 10, "abcdef", offsetof(struct aux_name_pdr, sensor_name) + 3 * 2);
+	add_aux(0x41414141, 11, "Temp", 0);
+
+	memset(&key, 0, sizeof(key));
+	assert(pldm_pdr_cache_write(path, &key, repo, repo_len) == 0);
+	assert(pldm_pdr_cache_open(&c, path, &key) == 0);
+	assert(pldm_names_build(&t, &c) == 0);
+	assert(!strcmp(pldm_names_by_id(&t, 10), "abc"));
+	assert(!strcmp(pldm_names_by_id(&t, 11), "Temp"));
+	assert(pldm_names_find_str(&t, "abc")->sensor_id == 10);
+	pldm_names_fini(&t);
+	pldm_pdr_cache_close(&c);
+	unlink(path);
+	return 0;
+}
@@ -0,0 +1,92 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* Sensor polling shares its transport with another user: each side only sees its
+ * own completions.
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "cuc_sim.h"
+#include "pldm_sensor_poll.h"
+
+#define NUM_SENSORS  40
+
+static unsigned int reads[NUM_SENSORS];
+
+static void on_read(struct pldm_poll *p, struct pldm_poll_sensor *s, const struct get_sensor_reading_rsp *rsp,
+		    int status)
+{
+	(void)p;
+	assert(!status && rsp);
+	assert(rsp->present_reading.value_UINT16 == 1000 + s->sensor_id);
+	reads[s->sensor_id]++;
+}
+
+int main(void)
+{
+	static struct cuc_sim sim;
+	static struct pldm_poll p;
+	static struct cuc_sim_sensor ss[NUM_SENSORS];
+	struct numeric_sensor_pdr pdr;
+	struct cuc_sim_cmd_cfg cfg;
+	struct cuc_xport_ops ops;
+	struct cuc_xport x;
+	struct pldm_requester rq;
+	struct cuc_xport_req other;
+	struct cuc_xport_req *one = &other;
+	u64 now;
+	u16 i;
+	int port;
+
+	cuc_sim_init(&sim, CUC_BOARD_TYPE_WASHINGTON, 1, 2);
+	memset(&cfg, 0, sizeof(cfg));
+	cfg.latency_us = 50;
+	cuc_sim_set_cmd_cfg(&sim, -1, &cfg);
+	for (i = 0; i < NUM_SENSORS; i++) {
+		memset(&ss[i], 0, sizeof(ss[i]));
+		ss[i].sensor_id = i;
+		ss[i].data_size = PLDM_DATA_SIZE_UINT16;
+		ss[i].value.value_UINT16 = (u16)(1000 + i);
+	}
+	cuc_sim_set_sensors(&sim, ss, NUM_SENSORS);
+	cuc_sim_xport_init(&x, &ops, &sim);
+	pldm_rq_init(&rq, &x);
+
+	/* The slowest bucket period would not fit in 32 bits */
+	assert(pldm_poll_init(&p, NUM_SENSORS, PLDM_POLL_MAX_BASE_US + 1, on_read, NULL) == -EINVAL);
+	assert(pldm_poll_init(&p, NUM_SENSORS, PLDM_POLL_MAX_BASE_US, on_read, NULL) == 0);
+	assert(p.bucket[PLDM_POLL_MAX_BUCKETS - 1].period_us == PLDM_POLL_MAX_BASE_US << (PLDM_POLL_MAX_BUCKETS - 1));
+	pldm_poll_fini(&p);
+	assert(pldm_poll_init(&p, NUM_SENSORS, 0, on_read, NULL) == 0);
+	port = pldm_poll_add_xport(&p, &rq);
+	assert(port == 0);
+	memset(&pdr, 0, sizeof(pdr));
+	pdr.sensor_data_size = PLDM_DATA_SIZE_UINT16;
+	for (i = 0; i < NUM_SENSORS; i++) {
+		pdr.sensor_id = i;
+		assert(pldm_poll_add_sensor(&p, (unsigned int)port, &pdr, NULL) == i);
+	}
+
+	/* Another user of the transport with a request reaped by cuc_xport_wait() */
+	cuc_xport_req_init(&other, CUC_CMD_GET_FAN_RPM, NULL, 0);
+	assert(cuc_xport_submit(&x, &one, 1) == 1);
+
+	/* The first run lays out the phases; every sensor comes due within one period */
+	now = cuc_xport_now_us();
+	pldm_poll_run(&p, now);
+	assert(p.sensors[0].period_us <= PLDM_POLL_DEFAULT_PERIOD_US);
+	pldm_poll_run(&p, now + p.sensors[0].period_us - 1);
+	for (i = 0; i < NUM_SENSORS; i++)
+		assert(reads[i] == 1);
+	assert(p.reads == NUM_SENSORS && p.errors == 0);
+
+	/* The other request was left alone */
+	assert(other.state == CUC_XPORT_REQ_DONE);
+	assert(cuc_xport_wait(&x, &other) == 0 && other.rsp.cmd == CUC_CMD_GET_FAN_RPM);
+	assert(x.done.head == NULL);
+
+	pldm_poll_fini(&p);
+	return 0;
+}
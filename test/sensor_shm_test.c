@@ -0,0 +1,252 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* Sensor shared memory: readers refuse a region of another layout, sensors are kept
+ * in sensor_id order, readings are converted or NaN as their state says, the fan and
+ * interrupt registers come from the uC, and a reader racing the collector never sees
+ * a publish half done.
+ */
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "cuc_sensor_shm.h"
+#include "cuc_sim.h"
+
+#define NUM_SENSORS  64
+#define NUM_PUBLISH  20000
+#define NUM_SNAPSHOTS  2000
+
+static char name[64];
+static struct numeric_sensor_pdr pdrs[NUM_SENSORS];
+
+static void make_pdr(struct numeric_sensor_pdr *pdr, u16 id)
+{
+	memset(pdr, 0, sizeof(*pdr));
+	pdr->sensor_id = id;
+	pdr->base_unit = 2;                   /* Degrees C */
+	pdr->is_linear = 1;
+	pdr->sensor_data_size = PLDM_DATA_SIZE_UINT16;
+	pdr->resolution = 0.5f;
+	pdr->offset = 1.0f;
+}
+
+static void make_rsp(struct get_sensor_reading_rsp *rsp, u8 size, u8 opstate, u16 raw)
+{
+	memset(rsp, 0, sizeof(*rsp));
+	rsp->sensor_data_size = size;
+	rsp->sensor_operational_state = opstate;
+	rsp->present_state = PLDM_SENSOR_STATE_NORMAL;
+	rsp->event_state = PLDM_SENSOR_STATE_NORMAL;
+	rsp->present_reading.value_UINT16 = raw;
+}
+
+static void test_layout(void)
+{
+	struct cuc_sensor_shm w, r;
+	int fd;
+
+	assert(cuc_sensor_shm_open(&r, name) == -ENOENT);
+
+	assert(cuc_sensor_shm_create(&w, name, 16) == 0);
+	assert(cuc_sensor_shm_open(&r, name) == 0);
+	assert(r.shm->max_sensors == 16 && r.size == cuc_sensor_shm_size(16));
+	assert(cuc_sensor_shm_snapshot(&r, w.stage) == -ENODATA);
+	cuc_sensor_shm_close(&r);
+
+	/* Any field of the layout that differs makes the reader refuse the region */
+	w.shm->version++;
+	assert(cuc_sensor_shm_open(&r, name) == -EPROTO);
+	w.shm->version--;
+	w.shm->sensor_size += 8;
+	assert(cuc_sensor_shm_open(&r, name) == -EPROTO);
+	w.shm->sensor_size -= 8;
+	w.shm->max_nics = 1;
+	assert(cuc_sensor_shm_open(&r, name) == -EPROTO);
+	w.shm->max_nics = CUC_SENSOR_SHM_MAX_NICS;
+	w.shm->max_sensors = 17;
+	assert(cuc_sensor_shm_open(&r, name) == -EPROTO);
+	w.shm->max_sensors = 16;
+	w.shm->magic = 0;
+	assert(cuc_sensor_shm_open(&r, name) == -EPROTO);
+	w.shm->magic = CUC_SENSOR_SHM_MAGIC;
+	assert(cuc_sensor_shm_open(&r, name) == 0);
+	cuc_sensor_shm_close(&r);
+	cuc_sensor_shm_close(&w);
+
+	/* A region too small for the header */
+	fd = shm_open(name, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	assert(fd >= 0 && ftruncate(fd, 16) == 0);
+	close(fd);
+	assert(cuc_sensor_shm_open(&r, name) == -EPROTO);
+	shm_unlink(name);
+}
+
+static void test_sensors(void)
+{
+	static const u16 ids[] = { 300, 10, 200, 20, 100 };
+	struct get_sensor_reading_rsp rsp;
+	struct cuc_sensor_shm_sensor out;
+	struct numeric_sensor_pdr pdr;
+	struct cuc_sensor_shm w;
+	unsigned int i;
+
+	assert(cuc_sensor_shm_create(&w, NULL, 5) == 0);
+	for (i = 0; i < 5; i++) {
+		make_pdr(&pdrs[i], ids[i]);
+		assert(cuc_sensor_shm_add_sensor(&w, &pdrs[i]) == 0);
+	}
+	make_pdr(&pdr, 10);
+	assert(cuc_sensor_shm_add_sensor(&w, &pdr) == -EEXIST);
+	make_pdr(&pdr, 5);
+	assert(cuc_sensor_shm_add_sensor(&w, &pdr) == -ENOSPC);
+
+	/* Sorted, each with its own PDR, and nothing read yet */
+	assert(w.stage->num_sensors == 5);
+	for (i = 0; i < 5; i++) {
+		const struct cuc_sensor_shm_sensor *e = &w.stage->sensor[i];
+
+		assert(i == 0 || w.stage->sensor[i - 1].sensor_id < e->sensor_id);
+		assert(w.pdr[i]->sensor_id == e->sensor_id);
+		assert(e->status == -ENODATA && isnan(e->value) && e->opstate == PLDM_OPSTATE_STATUS_UNKNOWN);
+	}
+	assert(cuc_sensor_shm_find(w.stage, 5, 10) == 0 && cuc_sensor_shm_find(w.stage, 5, 300) == 4);
+	assert(cuc_sensor_shm_find(w.stage, 5, 200) == 3 && cuc_sensor_shm_find(w.stage, 5, 150) == -1);
+	assert(cuc_sensor_shm_find(w.stage, 0, 10) == -1);
+
+	/* raw * 0.5 + 1 */
+	make_rsp(&rsp, PLDM_DATA_SIZE_UINT16, PLDM_OPSTATE_ENABLED, 100);
+	assert(cuc_sensor_shm_update_sensor(&w, 200, &rsp, 0, 1000) == 0);
+	assert(cuc_sensor_shm_update_sensor(&w, 150, &rsp, 0, 1000) == -ENOENT);
+	cuc_sensor_shm_publish(&w, 1000);
+	assert(cuc_sensor_shm_read_sensor(&w, 200, &out) == 0);
+	assert(out.value == 51.0 && !out.status && out.reads == 1 && out.read_us == 1000);
+	assert(out.opstate == PLDM_OPSTATE_ENABLED && out.base_unit == 2);
+	assert(cuc_sensor_shm_read_sensor(&w, 150, &out) == -ENOENT);
+
+	/* Disabled: the state is kept, the value is not */
+	make_rsp(&rsp, PLDM_DATA_SIZE_UINT16, PLDM_OPSTATE_DISABLED, 100);
+	assert(cuc_sensor_shm_update_sensor(&w, 200, &rsp, 0, 2000) == 0);
+	assert(isnan(w.stage->sensor[3].value) && w.stage->sensor[3].opstate == PLDM_OPSTATE_DISABLED);
+	assert(w.stage->sensor[3].reads == 2);
+
+	/* A reading of another size than the PDR says */
+	make_rsp(&rsp, PLDM_DATA_SIZE_UINT8, PLDM_OPSTATE_ENABLED, 100);
+	assert(cuc_sensor_shm_update_sensor(&w, 200, &rsp, 0, 3000) == 0);
+	assert(isnan(w.stage->sensor[3].value) && w.stage->sensor[3].opstate == PLDM_OPSTATE_ENABLED);
+
+	/* A failed read keeps the last response's fields and time */
+	make_rsp(&rsp, PLDM_DATA_SIZE_UINT16, PLDM_OPSTATE_ENABLED, 4);
+	assert(cuc_sensor_shm_update_sensor(&w, 200, &rsp, 0, 4000) == 0);
+	assert(w.stage->sensor[3].value == 3.0);
+	assert(cuc_sensor_shm_update_sensor(&w, 200, NULL, -ETIMEDOUT, 5000) == 0);
+	assert(isnan(w.stage->sensor[3].value) && w.stage->sensor[3].status == -ETIMEDOUT);
+	assert(w.stage->sensor[3].read_us == 4000 && w.stage->sensor[3].reads == 4);
+	cuc_sensor_shm_close(&w);
+}
+
+static void test_collect_uc(void)
+{
+	static struct cuc_sim sim;
+	struct cuc_sim_cmd_cfg cfg;
+	struct cuc_sensor_shm_uc u;
+	struct cuc_xport_ops ops;
+	struct cuc_sensor_shm w;
+	struct cuc_xport x;
+
+	cuc_sim_init(&sim, CUC_BOARD_TYPE_WASHINGTON, 1, 2);
+	cuc_sim_xport_init(&x, &ops, &sim);
+	cuc_sim_raise(&sim, 1, ATT1_FAN_FAIL);
+	sim.nic[0].ier = ATT1_UC_RESET;
+	assert(cuc_sensor_shm_create(&w, NULL, 4) == 0);
+
+	assert(cuc_sensor_shm_collect_uc(&w, CUC_SENSOR_SHM_MAX_UCS, &x, 2) == -EINVAL);
+	assert(cuc_sensor_shm_read_uc(&w, 0, &u) == -ENODATA);
+	assert(cuc_sensor_shm_collect_uc(&w, 1, &x, 2) == 0);
+	cuc_sensor_shm_publish(&w, cuc_xport_now_us());
+	assert(cuc_sensor_shm_read_uc(&w, 2, &u) == -ENOENT);
+	assert(cuc_sensor_shm_read_uc(&w, 1, &u) == 0);
+	assert(u.num_nics == 2 && !u.fan_status && u.fan_auto == 1 && u.fan_percent == 40);
+	assert(u.fan_rpm == 12000 / 100 * 40 && u.fan_read_us);
+	assert(!u.nic[0].status && u.nic[0].isr == ATT1_UC_RESET && u.nic[0].ier == ATT1_UC_RESET);
+	assert(!u.nic[1].status && u.nic[1].isr == (ATT1_UC_RESET | ATT1_FAN_FAIL));
+	assert(u.nic[1].ier == ATT1_ALL_INTERRUPTS);
+
+	/* Status is only read, and a failed NIC read keeps the last registers */
+	memset(&cfg, 0, sizeof(cfg));
+	cfg.error_ppm = 1000000;
+	cuc_sim_set_cmd_cfg(&sim, CUC_CMD_GET_INTR, &cfg);
+	assert(sim.nic[1].isr == (ATT1_UC_RESET | ATT1_FAN_FAIL));
+	assert(cuc_sensor_shm_collect_uc(&w, 1, &x, 2) < 0);
+	cuc_sensor_shm_publish(&w, cuc_xport_now_us());
+	assert(cuc_sensor_shm_read_uc(&w, 1, &u) == 0);
+	assert(!u.fan_status && u.nic[0].status < 0 && u.nic[1].status < 0);
+	assert(u.nic[1].isr == (ATT1_UC_RESET | ATT1_FAN_FAIL));
+	cuc_sensor_shm_close(&w);
+}
+
+static struct cuc_sensor_shm shared;
+static unsigned long snapshots;
+static int done;
+
+/* Every publish writes its generation into every field the reader checks */
+static void *reader(void *arg)
+{
+	struct cuc_sensor_shm_data *d = (struct cuc_sensor_shm_data *)malloc(cuc_sensor_shm_data_size(NUM_SENSORS));
+	u64 last = 0;
+	unsigned int i;
+
+	(void)arg;
+	assert(d);
+	while (!__atomic_load_n(&done, __ATOMIC_ACQUIRE)) {
+		if (cuc_sensor_shm_snapshot(&shared, d) == -ENODATA)
+			continue;
+		assert(d->num_sensors == NUM_SENSORS && d->generation >= last);
+		assert(d->update_us == d->generation && d->uc[0].fan_rpm == d->generation);
+		for (i = 0; i < NUM_SENSORS; i++)
+			assert(d->sensor[i].read_us == d->generation && d->sensor[i].value == (double)d->generation);
+		last = d->generation;
+		__atomic_store_n(&snapshots, snapshots + 1, __ATOMIC_RELEASE);
+	}
+	free(d);
+	return NULL;
+}
+
+static void test_concurrent(void)
+{
+	pthread_t t;
+	unsigned int i, g;
+
+	assert(cuc_sensor_shm_create(&shared, NULL, NUM_SENSORS) == 0);
+	for (i = 0; i < NUM_SENSORS; i++) {
+		make_pdr(&pdrs[i], (u16)(i + 1));
+		assert(cuc_sensor_shm_add_sensor(&shared, &pdrs[i]) == 0);
+	}
+	assert(pthread_create(&t, NULL, reader, NULL) == 0);
+
+	/* Keep publishing until the reader has raced enough of them */
+	for (g = 1; g <= NUM_PUBLISH || __atomic_load_n(&snapshots, __ATOMIC_ACQUIRE) < NUM_SNAPSHOTS; g++) {
+		for (i = 0; i < NUM_SENSORS; i++) {
+			shared.stage->sensor[i].read_us = g;
+			shared.stage->sensor[i].value = g;
+		}
+		shared.stage->uc[0].fan_rpm = g;
+		cuc_sensor_shm_publish(&shared, g);
+		assert(shared.stage->generation == g);
+	}
+	__atomic_store_n(&done, 1, __ATOMIC_RELEASE);
+	assert(pthread_join(t, NULL) == 0);
+	cuc_sensor_shm_close(&shared);
+}
+
+int main(void)
+{
+	snprintf(name, sizeof(name), "/cuc_sensor_shm_test.%d", (int)getpid());
+	test_layout();
+	test_sensors();
+	test_collect_uc();
+	test_concurrent();
+	return 0;
+}
@@ -0,0 +1,65 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* Statistics: attaching leaves an observer installed by someone else in place, and
+ * detaching only removes what cuc_stats_attach() installed.
+ */
+
+#include <assert.h>
+#include <string.h>
+
+#include "cuc_sim.h"
+#include "cuc_stats.h"
+
+static unsigned int other_calls;
+
+static void other_observe(void *ctx, const struct cuc_xport_req *r)
+{
+	(void)ctx;
+	(void)r;
+	other_calls++;
+}
+
+int main(void)
+{
+	static struct cuc_sim sim;
+	static struct cuc_stats_xport sum;
+	struct cuc_xport_ops ops;
+	struct cuc_xport x;
+	struct cuc_xport_req r;
+	struct cuc_stats s;
+	struct cuc_stats_thread *t;
+	unsigned int key;
+
+	cuc_sim_init(&sim, CUC_BOARD_TYPE_WASHINGTON, 1, 2);
+	cuc_sim_xport_init(&x, &ops, &sim);
+	assert(cuc_stats_create(&s, NULL, 2) == 0);
+	t = cuc_stats_thread_register(&s);
+	assert(t);
+	cuc_xport_req_init(&r, CUC_CMD_GET_FAN_RPM, NULL, 0);
+	key = cuc_stats_key_of(&r.req);
+
+	/* Someone else observes x */
+	x.observe = other_observe;
+	assert(cuc_stats_attach(t, &x) == -EBUSY);
+	cuc_stats_detach(&x);
+	assert(x.observe == other_observe);
+	assert(cuc_xport_exec(&x, &r) == 0);
+	assert(other_calls == 1);
+	cuc_stats_sum(&s, CUC_XPORT_SIM, &sum);
+	assert(sum.cmd[key].count == 0);
+
+	x.observe = NULL;
+	assert(cuc_stats_attach(t, &x) == 0);
+	assert(cuc_stats_attach(t, &x) == 0);
+	cuc_xport_req_init(&r, CUC_CMD_GET_FAN_RPM, NULL, 0);
+	assert(cuc_xport_exec(&x, &r) == 0);
+	cuc_stats_sum(&s, CUC_XPORT_SIM, &sum);
+	assert(sum.cmd[key].count == 1 && other_calls == 1);
+	cuc_stats_detach(&x);
+	assert(!x.observe && !x.observe_ctx);
+
+	cuc_stats_thread_release(t);
+	cuc_stats_close(&s);
+	return 0;
+}
@@ -0,0 +1,216 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* Thresholds: crossings in both directions raise one event each, a sensor only
+ * returns towards normal once past its hysteresis, and the AVX2 kernel agrees with
+ * the scalar one on every sensor.
+ */
+
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+#include "pldm_threshold.h"
+
+#define NUM_RANDOM  1003                   /* Not a multiple of the vector width */
+#define ALL_THRESHOLDS  0x3F
+
+static u32 seed = 12345;
+
+static u32 rnd(void)
+{
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+/* UINT16 sensor reading value = raw * res + off */
+static void make_pdr(struct numeric_sensor_pdr *pdr, u16 id, float res, float off, u16 hyst, u8 supported,
+		     const u16 thr[PLDM_THRESHOLD_COUNT])
+{
+	struct numeric_sensor_ssd16 *s = &pdr->ssd.ssd16;
+
+	memset(pdr, 0, sizeof(*pdr));
+	pdr->sensor_id = id;
+	pdr->is_linear = 1;
+	pdr->sensor_data_size = PLDM_DATA_SIZE_UINT16;
+	pdr->resolution = res;
+	pdr->offset = off;
+	s->hysteresis = hyst;
+	s->supported_thresholds = supported;
+	s->warning_high = thr[PLDM_THRESHOLD_UPPER_WARNING];
+	s->critical_high = thr[PLDM_THRESHOLD_UPPER_CRITICAL];
+	s->fatal_high = thr[PLDM_THRESHOLD_UPPER_FATAL];
+	s->warning_low = thr[PLDM_THRESHOLD_LOWER_WARNING];
+	s->critical_low = thr[PLDM_THRESHOLD_LOWER_CRITICAL];
+	s->fatal_low = thr[PLDM_THRESHOLD_LOWER_FATAL];
+}
+
+/* Set the reading of sensor 0, evaluate, and check its level and the event raised, if any */
+static void step(struct pldm_thr_table *t, float v, s8 level, u8 prev, u8 state)
+{
+	struct pldm_thr_event ev[2];
+	unsigned int n;
+
+	t->value[0] = v;
+	n = pldm_thr_eval(t, ev, 2);
+	assert(t->level[0] == level);
+	if (prev == state) {
+		assert(n == 0);
+		return;
+	}
+	assert(n == 1 && ev[0].index == 0 && ev[0].sensor_id == 42);
+	assert(ev[0].previous_state == prev && ev[0].present_state == state && ev[0].event_state == state);
+}
+
+static void test_crossings(enum pldm_conv_isa isa)
+{
+	static const u16 thr[PLDM_THRESHOLD_COUNT] = { 80, 90, 100, 20, 10, 5 };
+	struct numeric_sensor_pdr pdr;
+	struct pldm_thr_table t;
+	unsigned int i;
+
+	pldm_thr_table_init(&t);
+	t.isa = isa;
+	make_pdr(&pdr, 42, 1.0f, 0.0f, 2, ALL_THRESHOLDS, thr);
+	/* A full vector; the other sensors read NaN and never change */
+	for (i = 0; i < 8; i++)
+		assert(pldm_thr_table_add(&t, &pdr) == (long)i);
+	assert(t.level[0] == PLDM_THR_LEVEL_UNKNOWN);
+
+	step(&t, 50, 0, PLDM_SENSOR_STATE_UNKNOWN, PLDM_SENSOR_STATE_NORMAL);
+
+	/* Up: entered at the threshold, left only below threshold - hysteresis */
+	step(&t, 80, 1, PLDM_SENSOR_STATE_NORMAL, PLDM_SENSOR_STATE_UPPER_WARNING);
+	step(&t, 79, 1, PLDM_SENSOR_STATE_UPPER_WARNING, PLDM_SENSOR_STATE_UPPER_WARNING);
+	step(&t, 78, 1, PLDM_SENSOR_STATE_UPPER_WARNING, PLDM_SENSOR_STATE_UPPER_WARNING);
+	step(&t, 77.9f, 0, PLDM_SENSOR_STATE_UPPER_WARNING, PLDM_SENSOR_STATE_NORMAL);
+	step(&t, 95, 2, PLDM_SENSOR_STATE_NORMAL, PLDM_SENSOR_STATE_UPPER_CRITICAL);
+	step(&t, 100, 3, PLDM_SENSOR_STATE_UPPER_CRITICAL, PLDM_SENSOR_STATE_UPPER_FATAL);
+	step(&t, 98, 3, PLDM_SENSOR_STATE_UPPER_FATAL, PLDM_SENSOR_STATE_UPPER_FATAL);
+	step(&t, 97, 2, PLDM_SENSOR_STATE_UPPER_FATAL, PLDM_SENSOR_STATE_UPPER_CRITICAL);
+
+	/* A jump across normal goes straight to the lower state */
+	step(&t, 20, -1, PLDM_SENSOR_STATE_UPPER_CRITICAL, PLDM_SENSOR_STATE_LOWER_WARNING);
+	step(&t, 22, -1, PLDM_SENSOR_STATE_LOWER_WARNING, PLDM_SENSOR_STATE_LOWER_WARNING);
+	step(&t, 22.5f, 0, PLDM_SENSOR_STATE_LOWER_WARNING, PLDM_SENSOR_STATE_NORMAL);
+	step(&t, 10, -2, PLDM_SENSOR_STATE_NORMAL, PLDM_SENSOR_STATE_LOWER_CRITICAL);
+	step(&t, 4, -3, PLDM_SENSOR_STATE_LOWER_CRITICAL, PLDM_SENSOR_STATE_LOWER_FATAL);
+	step(&t, 7, -3, PLDM_SENSOR_STATE_LOWER_FATAL, PLDM_SENSOR_STATE_LOWER_FATAL);
+	step(&t, 8, -2, PLDM_SENSOR_STATE_LOWER_FATAL, PLDM_SENSOR_STATE_LOWER_CRITICAL);
+	step(&t, NAN, PLDM_THR_LEVEL_UNKNOWN, PLDM_SENSOR_STATE_LOWER_CRITICAL, PLDM_SENSOR_STATE_UNKNOWN);
+	step(&t, 50, 0, PLDM_SENSOR_STATE_UNKNOWN, PLDM_SENSOR_STATE_NORMAL);
+	pldm_thr_table_fini(&t);
+
+	/* Thresholds that are not supported never trip */
+	pldm_thr_table_init(&t);
+	t.isa = isa;
+	make_pdr(&pdr, 42, 1.0f, 0.0f, 2, PLDM_THRESHOLD_UPPER_WARNING_MASK, thr);
+	for (i = 0; i < 8; i++)
+		assert(pldm_thr_table_add(&t, &pdr) == (long)i);
+	step(&t, -1000, 0, PLDM_SENSOR_STATE_UNKNOWN, PLDM_SENSOR_STATE_NORMAL);
+	step(&t, 1000, 1, PLDM_SENSOR_STATE_NORMAL, PLDM_SENSOR_STATE_UPPER_WARNING);
+	pldm_thr_table_fini(&t);
+}
+
+/* Changes that do not fit in the event buffer are reported by the next call */
+static void test_event_overflow(void)
+{
+	static const u16 thr[PLDM_THRESHOLD_COUNT] = { 80, 90, 100, 20, 10, 5 };
+	struct numeric_sensor_pdr pdr;
+	struct pldm_thr_event ev[4];
+	struct pldm_thr_table t;
+	unsigned int i;
+
+	pldm_thr_table_init(&t);
+	for (i = 0; i < 3; i++) {
+		make_pdr(&pdr, (u16)(100 + i), 1.0f, 0.0f, 2, ALL_THRESHOLDS, thr);
+		assert(pldm_thr_table_add(&t, &pdr) == (long)i);
+		t.value[i] = 50;
+	}
+	assert(pldm_thr_eval(&t, ev, 4) == 3);
+
+	t.value[0] = 85;
+	t.value[2] = 15;
+	assert(pldm_thr_eval(&t, ev, 1) == 1);
+	assert(ev[0].sensor_id == 100 && ev[0].present_state == PLDM_SENSOR_STATE_UPPER_WARNING);
+	assert(t.level[0] == 1 && t.level[2] == 0);
+	assert(pldm_thr_eval(&t, ev, 4) == 1);
+	assert(ev[0].sensor_id == 102 && ev[0].present_state == PLDM_SENSOR_STATE_LOWER_WARNING);
+	assert(pldm_thr_eval(&t, ev, 4) == 0);
+	pldm_thr_table_fini(&t);
+}
+
+/* Random readings around random thresholds: both kernels give the same levels and events */
+static void test_kernels_agree(void)
+{
+	static struct pldm_thr_event ev[2][NUM_RANDOM];
+	struct numeric_sensor_pdr pdr;
+	struct pldm_thr_table t[2];
+	u16 thr[PLDM_THRESHOLD_COUNT];
+	unsigned int i, k, pass, n[2];
+
+	pldm_thr_table_init(&t[0]);
+	pldm_thr_table_init(&t[1]);
+	t[0].isa = PLDM_CONV_ISA_SCALAR;
+	/* pldm_thr_table_init() picked AVX2 for t[1] if the CPU has it */
+
+	for (i = 0; i < NUM_RANDOM; i++) {
+		/* Ascending from fatal_low to fatal_high */
+		u16 v = (u16)(rnd() % 64);
+
+		for (k = 0; k < PLDM_THRESHOLD_COUNT; k++) {
+			static const u8 order[PLDM_THRESHOLD_COUNT] = {
+				PLDM_THRESHOLD_LOWER_FATAL, PLDM_THRESHOLD_LOWER_CRITICAL, PLDM_THRESHOLD_LOWER_WARNING,
+				PLDM_THRESHOLD_UPPER_WARNING, PLDM_THRESHOLD_UPPER_CRITICAL, PLDM_THRESHOLD_UPPER_FATAL,
+			};
+
+			v = (u16)(v + 1 + rnd() % 64);
+			thr[order[k]] = v;
+		}
+		make_pdr(&pdr, (u16)i, 0.25f, -50.0f, (u16)(rnd() % 16), (u8)(rnd() & ALL_THRESHOLDS), thr);
+		assert(pldm_thr_table_add(&t[0], &pdr) == (long)i);
+		assert(pldm_thr_table_add(&t[1], &pdr) == (long)i);
+	}
+
+	for (pass = 0; pass < 200; pass++) {
+		for (i = 0; i < NUM_RANDOM; i++) {
+			float v;
+
+			switch (rnd() % 16) {
+			case 0:
+				v = NAN;
+				break;
+			case 1:
+				/* Exactly on a threshold */
+				v = t[0].thr[rnd() % PLDM_THRESHOLD_COUNT][i];
+				break;
+			case 2:
+				/* Exactly at a threshold minus or plus hysteresis */
+				k = rnd() % PLDM_THRESHOLD_COUNT;
+				v = k <= PLDM_THRESHOLD_UPPER_FATAL ? t[0].thr[k][i] - t[0].hyst[i] :
+								     t[0].thr[k][i] + t[0].hyst[i];
+				break;
+			default:
+				v = (float)(rnd() % 480) * 0.25f - 60.0f;
+				break;
+			}
+			t[0].value[i] = v;
+			t[1].value[i] = v;
+		}
+		n[0] = pldm_thr_eval(&t[0], ev[0], pass & 1 ? 64 : NUM_RANDOM);
+		n[1] = pldm_thr_eval(&t[1], ev[1], pass & 1 ? 64 : NUM_RANDOM);
+		assert(n[0] == n[1] && !memcmp(ev[0], ev[1], n[0] * sizeof(ev[0][0])));
+		assert(!memcmp(t[0].level, t[1].level, NUM_RANDOM));
+	}
+	pldm_thr_table_fini(&t[0]);
+	pldm_thr_table_fini(&t[1]);
+}
+
+int main(void)
+{
+	test_crossings(PLDM_CONV_ISA_SCALAR);
+	test_crossings(pldm_conv_best_isa());
+	test_event_overflow();
+	test_kernels_agree();
+	return 0;
+}
@@ -0,0 +1,116 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* Boot timings: cards whose commands cannot be sent are skipped, archives survive a
+ * save and load, a header claiming more rows than the file holds is refused, and
+ * events reported out of enum order never produce a negative wait.
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "cuc_sim.h"
+#include "cuc_timings.h"
+
+#define NUM_CARDS  3
+
+static struct cuc_sim sims[NUM_CARDS];
+static struct cuc_xport_ops ops[NUM_CARDS];
+static struct cuc_xport xports[NUM_CARDS];
+
+static int failing_send(void *priv, const struct cuc_pkt *pkt)
+{
+	(void)priv;
+	(void)pkt;
+	return -EIO;
+}
+
+static void test_collect(struct cuc_timings_archive *a)
+{
+	struct cuc_xport *xs[NUM_CARDS];
+	struct cuc_xport_req reqs[2 * NUM_CARDS];
+	static const u32 cards[NUM_CARDS] = { 10, 11, 12 };
+	unsigned int i;
+
+	for (i = 0; i < NUM_CARDS; i++) {
+		cuc_sim_init(&sims[i], i == 1 ? CUC_BOARD_TYPE_KENNEBEC : CUC_BOARD_TYPE_WASHINGTON, 1,
+			     i == 1 ? 1 : 2);
+		xs[i] = &xports[i];
+	}
+	/* JTAG reset released before PERST on card 0 */
+	sims[0].timings_us[TIMING_JTAG_TRST_N_DEASSERTED] = sims[0].timings_us[TIMING_VID_STABLE_ASSERTED] + 1;
+	for (i = 0; i < NUM_CARDS; i++)
+		cuc_sim_xport_init(&xports[i], &ops[i], &sims[i]);
+	/* Nothing reaches card 2 */
+	ops[2].send = failing_send;
+
+	assert(cuc_timings_collect(a, xs, cards, NUM_CARDS, reqs) == 2);
+	assert(a->n == 2 && a->card[0] == 10 && a->card[1] == 11);
+	assert(a->board_type[1] == CUC_BOARD_TYPE_KENNEBEC);
+	assert(reqs[4].status == -EIO && reqs[5].status == -EIO);
+	for (i = 0; i < NUM_CARDS; i++)
+		assert(cuc_xport_idle(&xports[i]));
+}
+
+static void test_save_load(const struct cuc_timings_archive *a)
+{
+	static const char path[] = "timings_test.ctim";
+	struct cuc_timings_archive b;
+	u32 hdr[4];
+	unsigned int i;
+	FILE *f;
+
+	assert(cuc_timings_archive_save(a, path) == 0);
+	cuc_timings_archive_init(&b);
+	assert(cuc_timings_archive_load(&b, path) == (int)a->n);
+	assert(b.n == a->n);
+	for (i = 0; i < TIMING_NUM_ENTRIES; i++)
+		assert(!memcmp(b.col[i], a->col[i], a->n * sizeof(u64)));
+
+	/* A row count the file cannot hold is refused before anything is reserved */
+	f = fopen(path, "r+b");
+	assert(f && fread(hdr, sizeof(hdr), 1, f) == 1);
+	hdr[3] = 0x80000001;
+	assert(!fseek(f, 0, SEEK_SET) && fwrite(hdr, sizeof(hdr), 1, f) == 1);
+	fclose(f);
+	assert(cuc_timings_archive_load(&b, path) == -EPROTO);
+	assert(b.n == a->n && b.cap < 0x80000001);
+	cuc_timings_archive_fini(&b);
+	unlink(path);
+}
+
+static void test_waits(const struct cuc_timings_archive *a)
+{
+	u32 hits[TIMING_NUM_ENTRIES];
+	u64 total[TIMING_NUM_ENTRIES];
+	u8 path[TIMING_NUM_ENTRIES];
+	unsigned int n, i;
+
+	n = cuc_timings_timeline(a, 0, path);
+	assert(n == TIMING_PCIE_LINK_UP_NIC_1 + 1);
+	for (i = 1; i < n; i++)
+		assert(a->col[path[i]][0] >= a->col[path[i - 1]][0]);
+	assert(path[n - 1] == TIMING_PCIE_LINK_UP_NIC_1);
+
+	cuc_timings_waits(a, CUC_BOARD_TYPE_WASHINGTON, hits, total);
+	assert(hits[TIMING_UC_APPLICATION_STARTED] == 0);
+	assert(hits[TIMING_JTAG_TRST_N_DEASSERTED] == 1 && total[TIMING_JTAG_TRST_N_DEASSERTED] == 1);
+	/* PERST 0 now waits on the JTAG reset, not on VID stable */
+	assert(total[TIMING_PERST_NIC_0_N_DEASSERTED] == 10000 - 1);
+	for (i = 0; i < TIMING_NUM_ENTRIES; i++)
+		assert(total[i] < 1000000);
+}
+
+int main(void)
+{
+	struct cuc_timings_archive a;
+
+	cuc_timings_archive_init(&a);
+	test_collect(&a);
+	test_save_load(&a);
+	test_waits(&a);
+	cuc_timings_archive_fini(&a);
+	return 0;
+}
@@ -0,0 +1,204 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* Every view in cuc_view.hpp decodes constant bytes at compile time: the checks are
+ * static_asserts, so this test fails to build rather than to run.
+ */
+
+#include <array>
+#include <cstddef>
+
+#include "cuc_view.hpp"
+
+namespace {
+
+template <std::size_t N>
+using buf = std::array<u8, N>;
+
+/* Store 'size' little-endian bytes of v at 'off' */
+template <std::size_t N>
+constexpr void put(buf<N> &b, std::size_t off, u64 v, std::size_t size)
+{
+	for (std::size_t i = 0; i < size; i++)
+		b[off + i] = (u8)(v >> (8 * i));
+}
+
+template <std::size_t N>
+constexpr void put_f32(buf<N> &b, std::size_t off, float f)
+{
+	put(b, off, std::bit_cast<u32>(f), 4);
+}
+
+/*
+ * uC command views
+ */
+
+constexpr buf<1> error_rsp = { 110 };
+static_assert(cuc::error_rsp_view(error_rsp.data()).error() == 110);
+
+constexpr buf<2> board_info = { CUC_BOARD_TYPE_WASHINGTON, 3 };
+static_assert(cuc::board_info_rsp_view(board_info.data()).board_type() == CUC_BOARD_TYPE_WASHINGTON);
+static_assert(cuc::board_info_rsp_view(board_info.data()).board_rev() == 3);
+
+constexpr buf<6> fan_rpm = { 0x34, 0x12, 0, 0, 55, 1 };
+static_assert(cuc::fan_rpm_rsp_view(fan_rpm.data()).rpm() == 0x1234);
+static_assert(cuc::fan_rpm_rsp_view(fan_rpm.data()).percent() == 55);
+static_assert(cuc::fan_rpm_rsp_view(fan_rpm.data()).is_auto() == 1);
+
+constexpr buf<13> mac = { 1, 0x02, 0, 0, 0, 0, 0xAA, 0x02, 0, 0, 0, 0, 0xBB };
+static_assert(cuc::mac_rsp_view(mac.data()).nic() == 1);
+static_assert(cuc::mac_rsp_view(mac.data()).nic_mac().size() == 6);
+static_assert(cuc::mac_rsp_view(mac.data()).nic_mac()[5] == 0xAA);
+static_assert(cuc::mac_rsp_view(mac.data()).uc_mac()[5] == 0xBB);
+
+constexpr buf<8> intr = { 0x01, 0x02, 0x03, 0x04, 0xFF, 0, 0, 0x80 };
+static_assert(cuc::intr_rsp_view(intr.data()).isr() == 0x04030201);
+static_assert(cuc::intr_rsp_view(intr.data()).ier() == 0x800000FF);
+
+constexpr buf<1> fwu_status = { 2 };
+static_assert(cuc::fwu_status_rsp_view(fwu_status.data()).status() == 2);
+
+constexpr buf<1> nic_id = { 1 };
+static_assert(cuc::nic_id_rsp_view(nic_id.data()).nic() == 1);
+
+constexpr auto timings = [] {
+	buf<sizeof(struct cuc_get_timings_rsp)> b{};
+
+	put(b, 8 * TIMING_UC_FW_INIT_COMPLETE, 0x1122334455ull, 8);
+	return b;
+}();
+static_assert(cuc::timings_rsp_view(timings.data()).entries_us().size() == TIMING_NUM_ENTRIES);
+static_assert(cuc::timings_rsp_view(timings.data()).entries_us()[TIMING_UC_FW_INIT_COMPLETE] == 0x1122334455ull);
+static_assert(cuc::timings_rsp_view(timings.data()).entries_us()[TIMING_UC_APPLICATION_STARTED] == 0);
+
+/*
+ * PLDM views
+ */
+
+constexpr auto reading = [] {
+	buf<sizeof(struct get_sensor_reading_rsp)> b{};
+
+	b[0] = 0x05;  /* Instance ID 5 */
+	b[1] = PLDM_TYPE_PLATFORM_MONITORING_AND_CONTROL;
+	b[2] = PLDM_CMD_GET_SENSOR_READING;
+	put(b, offsetof(struct get_sensor_reading_rsp, sensor_data_size), PLDM_DATA_SIZE_SINT16, 1);
+	put(b, offsetof(struct get_sensor_reading_rsp, present_state), PLDM_SENSOR_STATE_UPPER_WARNING, 1);
+	put(b, offsetof(struct get_sensor_reading_rsp, present_reading), (u16)-40, 2);
+	return b;
+}();
+constexpr cuc::get_sensor_reading_rsp_view reading_view(reading.data(),
+							 offsetof(struct get_sensor_reading_rsp, present_reading) + 2);
+static_assert(reading_view.hdr().instance_id() == 5 && !reading_view.hdr().rq());
+static_assert(reading_view.hdr().pldm_command_code() == PLDM_CMD_GET_SENSOR_READING);
+static_assert(reading_view.completion_code() == PLDM_SUCCESS);
+static_assert(reading_view.present_state() == PLDM_SENSOR_STATE_UPPER_WARNING);
+static_assert(reading_view.reading<PLDM_DATA_SIZE_SINT16>() == -40);
+static_assert(reading_view.reading() == -40);
+/* A 16-bit reading cut short */
+static_assert(!cuc::get_sensor_reading_rsp_view(reading.data(), reading_view.min_size + 1).reading());
+
+constexpr std::size_t ssd_off = offsetof(struct numeric_sensor_pdr, ssd);
+
+constexpr auto numeric = [] {
+	buf<ssd_off + sizeof(struct numeric_sensor_ssd16)> b{};
+
+	put(b, offsetof(struct pdr_hdr, record_handle), 7, 4);
+	put(b, offsetof(struct pdr_hdr, pdr_type), PLDM_PDR_NUMERIC_SENSOR, 1);
+	put(b, offsetof(struct pdr_hdr, data_length), b.size() - sizeof(struct pdr_hdr), 2);
+	put(b, offsetof(struct numeric_sensor_pdr, sensor_id), 42, 2);
+	put(b, offsetof(struct numeric_sensor_pdr, entity_type), 0x8000 | 120, 2);
+	put(b, offsetof(struct numeric_sensor_pdr, sensor_data_size), PLDM_DATA_SIZE_UINT16, 1);
+	put_f32(b, offsetof(struct numeric_sensor_pdr, resolution), 0.5f);
+	put(b, ssd_off + offsetof(struct numeric_sensor_ssd16, hysteresis), 3, 2);
+	put_f32(b, ssd_off + offsetof(struct numeric_sensor_ssd16, update_interval), 0.25f);
+	put(b, ssd_off + offsetof(struct numeric_sensor_ssd16, critical_high), 900, 2);
+	return b;
+}();
+constexpr cuc::pdr_hdr_view numeric_hdr(numeric.data(), numeric.size());
+static_assert(numeric_hdr.record_handle() == 7 && numeric_hdr.complete());
+static_assert(!cuc::pdr_hdr_view(numeric.data(), numeric.size() - 1).complete());
+static_assert(!numeric_hdr.as<cuc::aux_name_pdr_view>());
+constexpr cuc::numeric_sensor_pdr_view numeric_view = *numeric_hdr.as<cuc::numeric_sensor_pdr_view>();
+static_assert(numeric_view.hdr().pdr_type() == PLDM_PDR_NUMERIC_SENSOR);
+static_assert(numeric_view.sensor_id() == 42);
+static_assert(numeric_view.entity_id() == 120 && numeric_view.entity_logical());
+static_assert(numeric_view.resolution() == 0.5f);
+static_assert(numeric_view.visit_ssd([](auto ssd) { return ssd.update_interval(); }) == 0.25f);
+static_assert(numeric_view.visit_ssd([](auto ssd) { return (int)ssd.hysteresis(); }) == 3);
+static_assert(numeric_view.visit_ssd([](auto ssd) {
+	return (int)ssd.threshold(PLDM_THRESHOLD_UPPER_CRITICAL);
+}) == 900);
+static_assert(decltype(cuc::ssd_view<PLDM_DATA_SIZE_SINT16>(nullptr).warning_low()){-1} < 0);
+/* Too short for its size-dependent part */
+static_assert(!cuc::numeric_sensor_pdr_view(numeric.data(), numeric.size() - 1).visit_ssd(
+	[](auto ssd) { return ssd.update_interval(); }));
+
+constexpr std::size_t name_off = offsetof(struct aux_name_pdr, sensor_name);
+
+constexpr auto aux = [] {
+	buf<name_off + 8> b{};
+
+	put(b, offsetof(struct pdr_hdr, pdr_type), PLDM_PDR_SENSOR_AUXILIARY_NAMES, 1);
+	put(b, offsetof(struct aux_name_pdr, sensor_id), 42, 2);
+	put(b, offsetof(struct aux_name_pdr, sensor_count), 1, 1);
+	put(b, name_off, 'T', 2);
+	put(b, name_off + 2, 0x00E9, 2);  /* e acute */
+	put(b, name_off + 4, 'x', 2);
+	return b;
+}();
+constexpr cuc::aux_name_pdr_view aux_view(aux.data(), aux.size());
+static_assert(aux_view.sensor_id() == 42 && aux_view.sensor_count() == 1);
+static_assert(aux_view.name_length() == 3 && aux_view.name_at(1) == 0x00E9);
+/* The name is bounded by the viewed bytes when it has no terminator */
+static_assert(cuc::aux_name_pdr_view(aux.data(), name_off + 4).name_length() == 2);
+
+constexpr auto fru = [] {
+	buf<sizeof(struct fru_record_set_pdr)> b{};
+
+	put(b, offsetof(struct pdr_hdr, pdr_type), PLDM_PDR_FRU_RECORD_SET, 1);
+	put(b, offsetof(struct fru_record_set_pdr, fru_record_set_identifier), 9, 2);
+	put(b, offsetof(struct fru_record_set_pdr, container_id), 0x1234, 2);
+	return b;
+}();
+static_assert(cuc::fru_record_set_pdr_view(fru.data()).fru_record_set_identifier() == 9);
+static_assert(cuc::fru_record_set_pdr_view(fru.data()).container_id() == 0x1234);
+
+constexpr auto get_pdr = [] {
+	buf<sizeof(struct get_pdr_rsp) + sizeof(fru)> b{};
+
+	put(b, offsetof(struct get_pdr_rsp, next_record_handle), 8, 4);
+	put(b, offsetof(struct get_pdr_rsp, transfer_flag), PLDM_XFER_FLAG_START_AND_END, 1);
+	put(b, offsetof(struct get_pdr_rsp, response_count), sizeof(fru), 2);
+	for (std::size_t i = 0; i < sizeof(fru); i++)
+		b[sizeof(struct get_pdr_rsp) + i] = fru[i];
+	return b;
+}();
+constexpr cuc::get_pdr_rsp_view get_pdr_view(get_pdr.data(), get_pdr.size());
+static_assert(get_pdr_view.next_record_handle() == 8);
+static_assert(get_pdr_view.record_data().size() == sizeof(fru));
+static_assert(get_pdr_view.pdr()->pdr_type() == PLDM_PDR_FRU_RECORD_SET);
+static_assert(get_pdr_view.pdr()->as<cuc::fru_record_set_pdr_view>()->fru_record_set_identifier() == 9);
+/* Fewer bytes than response_count */
+static_assert(cuc::get_pdr_rsp_view(get_pdr.data(), get_pdr.size() - 4).record_data().size() == sizeof(fru) - 4);
+
+/*
+ * Packets
+ */
+
+constexpr struct cuc_pkt error_pkt = { CUC_CMD_GET_FAN_RPM, 2, CUC_TYPE_RSP_ERROR, { ENODEV } };
+static_assert(cuc::pkt_view(error_pkt).cmd() == CUC_CMD_GET_FAN_RPM);
+static_assert(cuc::pkt_view(error_pkt).error() == ENODEV);
+static_assert(cuc::pkt_view(error_pkt).payload_len() == 1);
+static_assert(!cuc::pkt_view(error_pkt).as<cuc::fan_rpm_rsp_view>());
+
+constexpr struct cuc_pkt fan_pkt = { CUC_CMD_GET_FAN_RPM, 7, CUC_TYPE_RSP_SUCCESS, { 0x10, 0x27, 0, 0, 40, 0 } };
+static_assert(cuc::pkt_view(fan_pkt).error() == 0);
+static_assert(cuc::pkt_view(fan_pkt).as<cuc::fan_rpm_rsp_view>()->rpm() == 10000);
+static_assert(cuc::pkt_view(fan_pkt).payload_bytes().size() == 6);
+
+} /* namespace */
+
+int main()
+{
+	return 0;
+}
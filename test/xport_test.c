@@ -0,0 +1,181 @@
+/* SPDX-License-Identifier: MIT */
+/* Copyright 2026 Hewlett Packard Enterprise Development LP */
+
+/* Error paths of the cuc_xport engine: send and receive failures while other
+ * requests are queued or on the wire, synchronous completion from
+ * cuc_xport_submit(), -EBUSY and completion reaping by owner.
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "cuc_sim.h"
+
+/* Simulator backend that fails the send or receive with a given call number */
+struct faulty {
+	struct cuc_sim sim;
+	unsigned int sends;
+	unsigned int recvs;
+	unsigned int fail_send;    /* 1-based call number to fail, 0 for none */
+	unsigned int fail_recv;
+};
+
+static int faulty_send(void *priv, const struct cuc_pkt *pkt)
+{
+	struct faulty *f = (struct faulty *)priv;
+
+	if (++f->sends == f->fail_send)
+		return -EIO;
+	return cuc_sim_send(&f->sim, pkt);
+}
+
+static int faulty_recv(void *priv, struct cuc_pkt *pkt, long timeout_us)
+{
+	struct faulty *f = (struct faulty *)priv;
+
+	if (++f->recvs == f->fail_recv)
+		return -ENODEV;
+	return cuc_sim_recv(&f->sim, pkt, timeout_us);
+}
+
+static struct faulty f;
+static struct cuc_xport_ops ops;
+static struct cuc_xport x;
+
+static void setup(unsigned int window)
+{
+	struct cuc_sim_cmd_cfg cfg;
+
+	memset(&f, 0, sizeof(f));
+	cuc_sim_init(&f.sim, CUC_BOARD_TYPE_WASHINGTON, 1, 2);
+	memset(&cfg, 0, sizeof(cfg));
+	cfg.latency_us = 200;
+	cuc_sim_set_cmd_cfg(&f.sim, -1, &cfg);
+	ops.kind = CUC_XPORT_SIM;
+	ops.max_inflight = window;
+	ops.send = faulty_send;
+	ops.recv = faulty_recv;
+	cuc_xport_init(&x, &ops, &f);
+}
+
+static void fan_req(struct cuc_xport_req *r)
+{
+	cuc_xport_req_init(r, CUC_CMD_GET_FAN_RPM, NULL, 0);
+}
+
+/* A send failure on another request must not make cuc_xport_wait() return early */
+static void test_send_error_while_pending(void)
+{
+	struct cuc_xport_req a, b, c;
+	struct cuc_xport_req *reqs[3] = { &a, &b, &c };
+
+	setup(1);
+	fan_req(&a);
+	fan_req(&b);
+	fan_req(&c);
+	f.fail_send = 2;
+	assert(cuc_xport_submit(&x, reqs, 3) == 3);
+
+	/* a is answered, then sending b fails while c is still queued */
+	assert(cuc_xport_wait(&x, &c) == -EIO);
+	assert(c.state == CUC_XPORT_REQ_IDLE);
+	assert(x.pending.head == NULL && x.npending == 0);
+	assert(cuc_xport_wait(&x, &a) == 0);
+	assert(cuc_xport_wait(&x, &b) == -EIO);
+	assert(cuc_xport_idle(&x) && x.done.head == NULL);
+
+	/* The request can be reused right away */
+	fan_req(&c);
+	assert(cuc_xport_exec(&x, &c) == 0);
+}
+
+/* A receive failure while the request is on the wire: it keeps its slot and completes */
+static void test_recv_error_while_inflight(void)
+{
+	struct cuc_xport_req a, b;
+	struct cuc_xport_req *reqs[2] = { &a, &b };
+
+	setup(4);
+	fan_req(&a);
+	fan_req(&b);
+	f.fail_recv = 1;
+	assert(cuc_xport_submit(&x, reqs, 2) == 2);
+	assert(b.state == CUC_XPORT_REQ_INFLIGHT);
+	assert(cuc_xport_wait(&x, &b) == 0);
+	assert(b.state == CUC_XPORT_REQ_IDLE && b.rsp.type == CUC_TYPE_RSP_SUCCESS);
+	assert(cuc_xport_wait(&x, &a) == 0);
+	assert(cuc_xport_idle(&x) && x.done.head == NULL);
+}
+
+static unsigned int done_calls;
+
+static void count_done(struct cuc_xport_req *r)
+{
+	(void)r;
+	done_calls++;
+}
+
+/* A request whose send fails completes before cuc_xport_submit() returns */
+static void test_sync_completion(void)
+{
+	struct cuc_xport_req a, b;
+	struct cuc_xport_req *reqs[2] = { &a, &b };
+
+	setup(4);
+	fan_req(&a);
+	a.done = count_done;
+	f.fail_send = 1;
+	done_calls = 0;
+	assert(cuc_xport_submit(&x, reqs, 1) == 1);
+	assert(done_calls == 1 && a.state == CUC_XPORT_REQ_DONE && a.status == -EIO);
+
+	/* -EBUSY queues nothing */
+	fan_req(&a);
+	fan_req(&b);
+	assert(cuc_xport_submit(&x, &reqs[0], 1) == 1);
+	assert(cuc_xport_submit(&x, reqs, 2) == -EBUSY);
+	assert(b.state == CUC_XPORT_REQ_IDLE && x.npending == 0 && x.ninflight == 1);
+	assert(cuc_xport_wait(&x, &a) == 0);
+}
+
+/* cuc_xport_complete() only returns the caller's own requests */
+static void test_complete_owner(void)
+{
+	static int mine, theirs;
+	struct cuc_xport_req a[3], b[3];
+	struct cuc_xport_req *reqs[6], *out[6];
+	unsigned int i, got = 0;
+	int n;
+
+	setup(8);
+	for (i = 0; i < 3; i++) {
+		fan_req(&a[i]);
+		a[i].owner = &mine;
+		fan_req(&b[i]);
+		b[i].owner = &theirs;
+		reqs[2 * i] = &a[i];
+		reqs[2 * i + 1] = &b[i];
+	}
+	assert(cuc_xport_submit(&x, reqs, 6) == 6);
+	while (got < 3) {
+		n = cuc_xport_complete(&x, &mine, out, 6, 100000);
+		assert(n > 0);
+		for (i = 0; i < (unsigned int)n; i++)
+			assert(out[i]->owner == &mine && out[i]->state == CUC_XPORT_REQ_IDLE);
+		got += (unsigned int)n;
+	}
+	assert(cuc_xport_complete(&x, &mine, out, 6, 0) == 0);
+	for (i = 0; i < 3; i++)
+		assert(cuc_xport_wait(&x, &b[i]) == 0);
+	assert(x.done.head == NULL);
+}
+
+int main(void)
+{
+	test_send_error_while_pending();
+	test_recv_error_while_inflight();
+	test_sync_completion();
+	test_complete_owner();
+	return 0;
+}